@@ -1,19 +1,180 @@
 import Benchmark
 import Foundation
 import GGUF
+import Quants
+import Synchronization
 
-func loadData() -> Data {
-    let url = Bundle.module.url(
-        forResource: "tinyllama-1.1b-chat-v1.0.Q2_K",
-        withExtension: "gguf",
-        subdirectory: "Data"
-    )!
-    return try! Data(contentsOf: url, options: .mappedIfSafe)
+/// The TinyLlama fixture, if it has been downloaded into Data
+func loadData() -> Data? {
+    guard
+        let url = Bundle.module.url(
+            forResource: "tinyllama-1.1b-chat-v1.0.Q2_K",
+            withExtension: "gguf",
+            subdirectory: "Data"
+        )
+    else {
+        return nil
+    }
+    return try? Data(contentsOf: url, options: .mappedIfSafe)
+}
+
+/// Every element type with a dequantization path
+let dequantizedTypes: [GGUF.TensorType] = [
+    .f32, .f16, .bf16, .q4_0, .q4_1, .q5_0, .q5_1, .q8_0, .q8_1, .q2_K, .q3_K, .q4_K, .q5_K,
+    .q6_K, .q8_K, .iq2_XXS, .iq2_XS, .iq2_S, .iq3_XXS, .iq3_S, .iq1_S, .iq1_M, .iq4_NL, .iq4_XS,
+    .tq1_0, .tq2_0, .mxfp4,
+]
+
+/// Tensor sizes whose f32 output fits in L1, fits in L2, and spills to DRAM
+let workingSets: [(name: String, elementCount: Int)] = [
+    ("L1", 4096), ("L2", 256 * 1024), ("DRAM", 16 * 1024 * 1024),
+]
+
+extension BenchmarkMetric {
+    /// Encoded tensor bytes read per second, in MB
+    static let inputMegabytesPerSecond = BenchmarkMetric.custom(
+        "Input MB/s", polarity: .prefersLarger, useScalingFactor: false)
+    /// Elements produced per second, in millions
+    static let megaelementsPerSecond = BenchmarkMetric.custom(
+        "Melements/s", polarity: .prefersLarger, useScalingFactor: false)
+}
+
+/// Single-tensor models shared by the benchmarks, generated on first use
+final class Fixtures: Sendable {
+    static let shared = Fixtures()
+    private let models = Mutex<[String: (GGUF, Data)]>([:])
+
+    func model(_ type: GGUF.TensorType, elementCount: Int) throws -> (GGUF, Data) {
+        let key = "\(type)-\(elementCount)"
+        if let model = models.withLock({ $0[key] }) {
+            return model
+        }
+        let synthetic = SyntheticModel(
+            tensorCount: 1, vocabularySize: 0, tensorTypes: [type], elementsPerTensor: elementCount)
+        let data = try synthetic.makeData()
+        let model = (try GGUF(parsing: data), data)
+        models.withLock { $0[key] = model }
+        return model
+    }
+}
+
+/// Dequantizes tensor 0 once per sample, repeated so each sample covers at least 4 MiB of
+/// output, and records the throughput of the sample
+func measureDequantization(
+    _ benchmark: Benchmark,
+    type: GGUF.TensorType,
+    elementCount: Int,
+    parallelism: Parallelism
+) throws {
+    let (gguf, data) = try Fixtures.shared.model(type, elementCount: elementCount)
+    let inputBytes = gguf.tensorInfos.sizesInBytes[0]
+    let repeats = max(1, (4 << 20) / (elementCount * 4))
+    var output = [Float](repeating: 0, count: elementCount)
+    let clock = ContinuousClock()
+    benchmark.startMeasurement()
+    for _ in benchmark.scaledIterations {
+        let start = clock.now
+        for _ in 0..<repeats {
+            try output.withUnsafeMutableBufferPointer {
+                try gguf.dequantizeTensor(at: 0, from: data, into: $0, parallelism: parallelism)
+            }
+        }
+        let elapsed = clock.now - start
+        let seconds =
+            Double(elapsed.components.seconds) + Double(elapsed.components.attoseconds) * 1e-18
+        benchmark.measurement(
+            .inputMegabytesPerSecond, Int(Double(inputBytes * repeats) / seconds / 1e6))
+        benchmark.measurement(
+            .megaelementsPerSecond, Int(Double(elementCount * repeats) / seconds / 1e6))
+        blackHole(output)
+    }
 }
 
 let benchmarks: @Sendable () -> Void = {
+    // Wall clock may drift 5% at the median before `baseline check` fails; throughput
+    // samples are noisier
+    Benchmark.defaultConfiguration = .init(
+        metrics: [.wallClock, .mallocCountTotal],
+        maxDuration: .seconds(1),
+        maxIterations: 1000,
+        thresholds: [
+            .wallClock: .init(relative: [.p50: 5, .p75: 10]),
+            .inputMegabytesPerSecond: .init(relative: [.p50: 8, .p75: 15]),
+            .megaelementsPerSecond: .init(relative: [.p50: 8, .p75: 15]),
+        ]
+    )
+    let throughputMetrics: [BenchmarkMetric] = [
+        .wallClock, .inputMegabytesPerSecond, .megaelementsPerSecond,
+    ]
+
+    // MARK: Dequantization throughput per format and working set
+
+    for type in dequantizedTypes {
+        for workingSet in workingSets {
+            Benchmark(
+                "Dequantize \(type) \(workingSet.name)",
+                configuration: .init(metrics: throughputMetrics)
+            ) { benchmark in
+                try measureDequantization(
+                    benchmark, type: type, elementCount: workingSet.elementCount,
+                    parallelism: .serial)
+            }
+        }
+    }
+
+    // MARK: Thread scaling
+
+    let cores = ProcessInfo.processInfo.activeProcessorCount
+    let threadCounts = Set([1, 2, 4, 8, 16, cores].filter { $0 <= cores }).sorted()
+    for type in [GGUF.TensorType.q4_K, .q8_0, .iq2_XXS] {
+        for threads in threadCounts {
+            Benchmark(
+                "Dequantize \(type) DRAM \(threads) threads",
+                configuration: .init(metrics: throughputMetrics)
+            ) { benchmark in
+                try measureDequantization(
+                    benchmark, type: type, elementCount: 16 * 1024 * 1024,
+                    parallelism: Parallelism(maxConcurrency: threads))
+            }
+        }
+    }
+
+    // MARK: Parse scaling
+
+    for vocabularySize in [1_000, 32_000, 128_000] {
+        for decoding in [GGUF.MetadataDecoding.eager, .lazy, .packedNumericArrays] {
+            Benchmark("Parse vocabulary \(vocabularySize) \(decoding)") { benchmark in
+                let data = try SyntheticModel(
+                    tensorCount: 16, vocabularySize: vocabularySize, elementsPerTensor: 256
+                ).makeData()
+                benchmark.startMeasurement()
+                for _ in benchmark.scaledIterations {
+                    blackHole(try GGUF(parsing: data, metadataDecoding: decoding))
+                }
+            }
+        }
+    }
+
+    for tensorCount in [16, 256, 4096] {
+        Benchmark("Parse \(tensorCount) tensors") { benchmark in
+            let data = try SyntheticModel(
+                tensorCount: tensorCount, vocabularySize: 1_000, elementsPerTensor: 256
+            ).makeData()
+            benchmark.startMeasurement()
+            for _ in benchmark.scaledIterations {
+                blackHole(try GGUF(parsing: data, metadataDecoding: .lazy))
+            }
+        }
+    }
+
+    // MARK: Real model, when downloaded
+
+    guard loadData() != nil else {
+        return
+    }
+
     Benchmark("Parse Q2_K GGUF") { benchmark in
-        let data = loadData()
+        let data = loadData()!
         benchmark.startMeasurement()
         for _ in benchmark.scaledIterations {
             blackHole(try GGUF(parsing: data))
@@ -21,7 +182,7 @@ let benchmarks: @Sendable () -> Void = {
     }
 
     Benchmark("Load Q2_K float array") { benchmark in
-        let data = loadData()
+        let data = loadData()!
         let gguf = try GGUF(parsing: data)
         benchmark.startMeasurement()
         for _ in benchmark.scaledIterations {
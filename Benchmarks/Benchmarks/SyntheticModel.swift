@@ -0,0 +1,137 @@
+import Foundation
+import GGUF
+import Quants
+
+/// Generates GGUF files in memory, so the suite needs no downloaded fixtures.
+///
+/// The metadata mimics a llama-style model: architecture keys plus a tokenizer with
+/// `vocabularySize` tokens, scores and token types, which dominate parse time of real files.
+/// Tensors cycle through `tensorTypes`; quantizable formats hold quantized pseudo-random
+/// values, the dequantize-only formats hold pseudo-random bytes with a unit scale.
+struct SyntheticModel {
+    var tensorCount = 16
+    var vocabularySize = 32_000
+    var tensorTypes: [GGUF.TensorType] = [.q4_K]
+    /// Elements per tensor, rounded up to a multiple of 256 so every block format fits
+    var elementsPerTensor = 4096 * 16
+    var alignment = 32
+    var seed: UInt64 = 0x5EED
+
+    /// The serialized file
+    func makeData() throws -> Data {
+        var writer = try GGUF.Writer(metadata: metadata)
+        let elementCount = (elementsPerTensor + 255) / 256 * 256
+        var payloads: [GGUF.TensorType: Data] = [:]
+        for index in 0..<tensorCount {
+            let type = tensorTypes[index % tensorTypes.count]
+            if payloads[type] == nil {
+                payloads[type] = Self.payload(of: type, elementCount: elementCount, seed: seed)
+            }
+            try writer.addTensor(
+                name: "blk.\(index / 8).weight_\(index % 8)",
+                dimensions: [256, UInt64(elementCount / 256)],
+                dataType: type,
+                source: .data(payloads[type]!))
+        }
+        return try writer.serializedData()
+    }
+
+    private var metadata: [GGUF.MetadataKeyValue] {
+        let tokens = (0..<vocabularySize).map { GGUF.MetadataValue.string("tok_\($0)") }
+        let scores = (0..<vocabularySize).map { GGUF.MetadataValue.float32(-Float($0)) }
+        let types = (0..<vocabularySize).map { GGUF.MetadataValue.int32($0 < 3 ? 3 : 1) }
+        return [
+            .init(key: "general.architecture", value: .string("llama"), valueType: .string),
+            .init(key: "general.name", value: .string("synthetic"), valueType: .string),
+            .init(key: "general.alignment", value: .uint32(UInt32(alignment)), valueType: .uint32),
+            .init(key: "llama.block_count", value: .uint32(32), valueType: .uint32),
+            .init(key: "llama.embedding_length", value: .uint32(4096), valueType: .uint32),
+            .init(key: "tokenizer.ggml.model", value: .string("llama"), valueType: .string),
+            .init(
+                key: "tokenizer.ggml.tokens", value: .array(.string, tokens), valueType: .array),
+            .init(
+                key: "tokenizer.ggml.scores", value: .array(.float32, scores), valueType: .array),
+            .init(
+                key: "tokenizer.ggml.token_type", value: .array(.int32, types), valueType: .array),
+        ]
+    }
+
+    /// `elementCount` values of `type`
+    static func payload(of type: GGUF.TensorType, elementCount: Int, seed: UInt64) -> Data {
+        var generator = SplitMix64(seed: seed)
+        if let format = type.blockFormat {
+            guard format.isQuantizable else {
+                return randomBlocks(
+                    of: type, count: elementCount / format.blockSize, using: &generator)
+            }
+            let values = randomValues(count: elementCount, using: &generator)
+            return Quantize.quantize(values, format: format, parallelism: .automatic)
+        }
+        let values = randomValues(count: elementCount, using: &generator)
+        switch type {
+        case .f32:
+            return values.withUnsafeBytes { Data($0) }
+        case .f16:
+            return values.map { Float16($0) }.withUnsafeBytes { Data($0) }
+        case .bf16:
+            return values.map { UInt16($0.bitPattern >> 16) }.withUnsafeBytes { Data($0) }
+        default:
+            preconditionFailure("No synthetic payload for \(type)")
+        }
+    }
+
+    /// Roughly normal values with unit variance
+    static func randomValues(count: Int, using generator: inout SplitMix64) -> [Float] {
+        (0..<count).map { _ in
+            // Sum of four uniforms, rescaled
+            var sum: Float = 0
+            for _ in 0..<4 {
+                sum += Float(generator.next() >> 40) / Float(1 << 24)
+            }
+            return (sum - 2) * 1.732
+        }
+    }
+
+    /// Pseudo-random blocks with the f16 scale (and the f16 min or sum that follows it in
+    /// q4_1, q5_1 and q8_1) set to 1, so no block decodes to NaN or Inf
+    static func randomBlocks(
+        of type: GGUF.TensorType, count: Int, using generator: inout SplitMix64
+    ) -> Data {
+        let format = type.blockFormat!
+        var bytes = [UInt8](repeating: 0, count: count * format.bytesPerBlock)
+        for index in bytes.indices {
+            bytes[index] = UInt8(truncatingIfNeeded: generator.next() >> 56)
+        }
+        let scaleOffsets: [Int] =
+            switch type {
+            case .tq1_0, .tq2_0: [format.bytesPerBlock - 2]
+            case .q4_1, .q5_1, .q8_1: [0, 2]
+            case .iq1_M, .mxfp4: []
+            default: [0]
+            }
+        for scaleOffset in scaleOffsets {
+            for block in 0..<count {
+                bytes[block * format.bytesPerBlock + scaleOffset] = 0x00
+                bytes[block * format.bytesPerBlock + scaleOffset + 1] = 0x3C
+            }
+        }
+        return Data(bytes)
+    }
+}
+
+/// Small, seedable generator so every run benchmarks the same data
+struct SplitMix64: RandomNumberGenerator {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E37_79B9_7F4A_7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+}
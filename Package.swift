@@ -15,7 +15,7 @@ let package = Package(
     products: [
         .library(
             name: "GGUF",
-            targets: ["GGUF"]
+            targets: ["GGUF", "Quants"]
         )
     ],
     dependencies: [
@@ -0,0 +1,1665 @@
+/*
+ * GGML Dequantization - AVX2 kernels
+ *
+ * Compiled with per-function target attributes so the rest of the library
+ * keeps the baseline ISA; only called when the dispatcher detects AVX2 + F16C.
+ */
+
+#include "ggml_quants_impl.h"
+
+#include <assert.h>
+
+#if defined(GGML_SIMD_X86)
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2,f16c"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target ("avx2,f16c")
+#endif
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// y[0..7] = (float)q * d
+static inline void store_scaled(float * GGML_RESTRICT y, __m256i q, __m256 d) {
+    _mm256_storeu_ps(y, _mm256_mul_ps(_mm256_cvtepi32_ps(q), d));
+}
+
+// y[0..7] = (float)q * d + m
+static inline void store_scaled_add(float * GGML_RESTRICT y, __m256i q, __m256 d, __m256 m) {
+    _mm256_storeu_ps(y, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(q), d), m));
+}
+
+// y[0..7] = d * (float)q - m
+static inline void store_scaled_sub(float * GGML_RESTRICT y, __m256i q, __m256 d, __m256 m) {
+    _mm256_storeu_ps(y, _mm256_sub_ps(_mm256_mul_ps(d, _mm256_cvtepi32_ps(q)), m));
+}
+
+// 16 unsigned bytes -> y[0..15] = d * q - m
+static inline void store_u8x16_sub(float * GGML_RESTRICT y, __m128i q, float d, float m) {
+    const __m256 vd = _mm256_set1_ps(d);
+    const __m256 vm = _mm256_set1_ps(m);
+    store_scaled_sub(y + 0, _mm256_cvtepu8_epi32(q), vd, vm);
+    store_scaled_sub(y + 8, _mm256_cvtepu8_epi32(_mm_srli_si128(q, 8)), vd, vm);
+}
+
+// 32 unsigned bytes -> y[0..31] = d * q - m
+static inline void store_u8x32_sub(float * GGML_RESTRICT y, __m256i q, float d, float m) {
+    store_u8x16_sub(y +  0, _mm256_castsi256_si128(q), d, m);
+    store_u8x16_sub(y + 16, _mm256_extracti128_si256(q, 1), d, m);
+}
+
+// 16 signed bytes -> y[0..15] = d * q
+static inline void store_i8x16(float * GGML_RESTRICT y, __m128i q, float d) {
+    const __m256 vd = _mm256_set1_ps(d);
+    store_scaled(y + 0, _mm256_cvtepi8_epi32(q), vd);
+    store_scaled(y + 8, _mm256_cvtepi8_epi32(_mm_srli_si128(q, 8)), vd);
+}
+
+// 8 unsigned bytes -> y[0..7] = d * q * s, s being -1 where the byte of neg is set and 1 elsewhere
+static inline void store_u8x8_signed(float * GGML_RESTRICT y, __m128i q, __m128i neg, __m256 d) {
+    const __m256 v = _mm256_mul_ps(d, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(q)));
+    const __m256i sign = _mm256_slli_epi32(_mm256_cvtepi8_epi32(neg), 31);
+    const __m256 s = _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_castsi256_ps(sign));
+    _mm256_storeu_ps(y, _mm256_mul_ps(v, s));
+}
+
+// 32 grid bytes with one sign bit each (bit j of `signs` for byte j) -> y[0..31],
+// d0 scaling the first 16 values and d1 the rest
+static inline void store_grid32_signed(float * GGML_RESTRICT y, __m256i q, uint32_t signs, __m256 d0, __m256 d1) {
+    // Byte j of each lane repeats sign byte j/8, then each copy keeps its own bit
+    const __m256i spread = _mm256_setr_epi8(
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+        2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i bits = _mm256_set1_epi64x((long long) 0x8040201008040201ULL);
+    const __m256i s = _mm256_shuffle_epi8(_mm256_set1_epi32((int) signs), spread);
+    const __m256i neg = _mm256_cmpeq_epi8(_mm256_and_si256(s, bits), bits);
+
+    const __m128i q0 = _mm256_castsi256_si128(q);
+    const __m128i q1 = _mm256_extracti128_si256(q, 1);
+    const __m128i n0 = _mm256_castsi256_si128(neg);
+    const __m128i n1 = _mm256_extracti128_si256(neg, 1);
+    store_u8x8_signed(y +  0, q0, n0, d0);
+    store_u8x8_signed(y +  8, _mm_srli_si128(q0, 8), _mm_srli_si128(n0, 8), d0);
+    store_u8x8_signed(y + 16, q1, n1, d1);
+    store_u8x8_signed(y + 24, _mm_srli_si128(q1, 8), _mm_srli_si128(n1, 8), d1);
+}
+
+// 8 signed bytes -> y[0..7] = d * (q + delta)
+static inline void store_i8x8_offset(float * GGML_RESTRICT y, __m128i q, float delta, __m256 d) {
+    const __m256 v = _mm256_add_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q)), _mm256_set1_ps(delta));
+    _mm256_storeu_ps(y, _mm256_mul_ps(d, v));
+}
+
+// Four sign bytes looked up from the 7-bit indices packed in the low 28 bits of aux
+static inline uint32_t ksigns_x4(uint32_t aux) {
+    return (uint32_t) ksigns_iq2xs[(aux >>  0) & 127]       | (uint32_t) ksigns_iq2xs[(aux >>  7) & 127] <<  8 |
+           (uint32_t) ksigns_iq2xs[(aux >> 14) & 127] << 16 | (uint32_t) ksigns_iq2xs[(aux >> 21) & 127] << 24;
+}
+
+// Base-3 digit n of each of 16 bytes, minus one: the multiply by 3^n rotates
+// digit n to the top of the byte, where * 3 >> 8 reads it off
+static inline __m128i ternary_digits(__m128i q, __m256i pow3) {
+    __m256i t = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(q), pow3);
+    t = _mm256_and_si256(t, _mm256_set1_epi16(0xFF));
+    t = _mm256_srli_epi16(_mm256_mullo_epi16(t, _mm256_set1_epi16(3)), 8);
+    t = _mm256_sub_epi16(t, _mm256_set1_epi16(1));
+    return _mm_packs_epi16(_mm256_castsi256_si128(t), _mm256_extracti128_si256(t, 1));
+}
+
+// ============================================================================
+// Basic types
+// ============================================================================
+
+void dequantize_row_q4_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q4_0 * GGML_RESTRICT x = vx;
+    assert(k % QK4_0 == 0);
+    const int64_t nb = k / QK4_0;
+
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m256i offset = _mm256_set1_epi32(8);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const __m256 d = _mm256_set1_ps(_cvtsh_ss(x[i].d));
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_and_si128(qs, mask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(qs, 4), mask);
+
+        store_scaled(y +  0, _mm256_sub_epi32(_mm256_cvtepu8_epi32(lo), offset), d);
+        store_scaled(y +  8, _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)), offset), d);
+        store_scaled(y + 16, _mm256_sub_epi32(_mm256_cvtepu8_epi32(hi), offset), d);
+        store_scaled(y + 24, _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)), offset), d);
+        y += QK4_0;
+    }
+}
+
+void dequantize_row_q4_1_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q4_1 * GGML_RESTRICT x = vx;
+    assert(k % QK4_1 == 0);
+    const int64_t nb = k / QK4_1;
+
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const __m256 d = _mm256_set1_ps(_cvtsh_ss(x[i].d));
+        const __m256 m = _mm256_set1_ps(_cvtsh_ss(x[i].m));
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_and_si128(qs, mask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(qs, 4), mask);
+
+        store_scaled_add(y +  0, _mm256_cvtepu8_epi32(lo), d, m);
+        store_scaled_add(y +  8, _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)), d, m);
+        store_scaled_add(y + 16, _mm256_cvtepu8_epi32(hi), d, m);
+        store_scaled_add(y + 24, _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)), d, m);
+        y += QK4_1;
+    }
+}
+
+// Bit `e` of qh is the fifth bit of element `e`; returns it as 0 or 16 for elements base..base+7
+static inline __m256i q5_high_bits(__m256i qh, int base) {
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i shift = _mm256_add_epi32(lanes, _mm256_set1_epi32(base));
+    const __m256i bits = _mm256_and_si256(_mm256_srlv_epi32(qh, shift), _mm256_set1_epi32(1));
+    return _mm256_slli_epi32(bits, 4);
+}
+
+void dequantize_row_q5_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q5_0 * GGML_RESTRICT x = vx;
+    assert(k % QK5_0 == 0);
+    const int64_t nb = k / QK5_0;
+
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m256i offset = _mm256_set1_epi32(16);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const __m256 d = _mm256_set1_ps(_cvtsh_ss(x[i].d));
+        uint32_t qh32;
+        memcpy(&qh32, x[i].qh, sizeof(qh32));
+        const __m256i qh = _mm256_set1_epi32((int) qh32);
+
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_and_si128(qs, mask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(qs, 4), mask);
+        const __m128i nibbles[4] = { lo, _mm_srli_si128(lo, 8), hi, _mm_srli_si128(hi, 8) };
+
+        for (int j = 0; j < 4; ++j) {
+            const __m256i q = _mm256_or_si256(_mm256_cvtepu8_epi32(nibbles[j]), q5_high_bits(qh, 8*j));
+            store_scaled(y + 8*j, _mm256_sub_epi32(q, offset), d);
+        }
+        y += QK5_0;
+    }
+}
+
+void dequantize_row_q5_1_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q5_1 * GGML_RESTRICT x = vx;
+    assert(k % QK5_1 == 0);
+    const int64_t nb = k / QK5_1;
+
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const __m256 d = _mm256_set1_ps(_cvtsh_ss(x[i].d));
+        const __m256 m = _mm256_set1_ps(_cvtsh_ss(x[i].m));
+        uint32_t qh32;
+        memcpy(&qh32, x[i].qh, sizeof(qh32));
+        const __m256i qh = _mm256_set1_epi32((int) qh32);
+
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_and_si128(qs, mask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(qs, 4), mask);
+        const __m128i nibbles[4] = { lo, _mm_srli_si128(lo, 8), hi, _mm_srli_si128(hi, 8) };
+
+        for (int j = 0; j < 4; ++j) {
+            const __m256i q = _mm256_or_si256(_mm256_cvtepu8_epi32(nibbles[j]), q5_high_bits(qh, 8*j));
+            store_scaled_add(y + 8*j, q, d, m);
+        }
+        y += QK5_1;
+    }
+}
+
+void dequantize_row_q8_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q8_0 * GGML_RESTRICT x = vx;
+    assert(k % QK8_0 == 0);
+    const int64_t nb = k / QK8_0;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        store_i8x16(y +  0, _mm_loadu_si128((const __m128i *) (x[i].qs +  0)), d);
+        store_i8x16(y + 16, _mm_loadu_si128((const __m128i *) (x[i].qs + 16)), d);
+        y += QK8_0;
+    }
+}
+
+void dequantize_row_q8_1_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q8_1 * GGML_RESTRICT x = vx;
+    assert(k % QK8_1 == 0);
+    const int64_t nb = k / QK8_1;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        store_i8x16(y +  0, _mm_loadu_si128((const __m128i *) (x[i].qs +  0)), d);
+        store_i8x16(y + 16, _mm_loadu_si128((const __m128i *) (x[i].qs + 16)), d);
+        y += QK8_1;
+    }
+}
+
+void dequantize_row_mxfp4_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_mxfp4 * GGML_RESTRICT x = vx;
+    assert(k % QK_MXFP4 == 0);
+    const int64_t nb = k / QK_MXFP4;
+
+    const __m128i values = _mm_loadu_si128((const __m128i *) kvalues_mxfp4);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = GGML_E8M0_TO_FP32_HALF(x[i].e);
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_shuffle_epi8(values, _mm_and_si128(qs, mask));
+        const __m128i hi = _mm_shuffle_epi8(values, _mm_and_si128(_mm_srli_epi16(qs, 4), mask));
+
+        store_i8x16(y +  0, lo, d);
+        store_i8x16(y + 16, hi, d);
+        y += QK_MXFP4;
+    }
+}
+
+// ============================================================================
+// K-quants
+// ============================================================================
+
+void dequantize_row_q2_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q2_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m128i mask = _mm_set1_epi8(0x03);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const float min = _cvtsh_ss(x[i].dmin);
+
+        const uint8_t * q = x[i].qs;
+        const uint8_t * sc = x[i].scales;
+
+        for (int n = 0; n < QK_K; n += 128) {
+            const __m128i q0 = _mm_loadu_si128((const __m128i *) (q +  0));
+            const __m128i q1 = _mm_loadu_si128((const __m128i *) (q + 16));
+            for (int shift = 0; shift < 8; shift += 2) {
+                const __m128i count = _mm_cvtsi32_si128(shift);
+                store_u8x16_sub(y +  0, _mm_and_si128(_mm_srl_epi16(q0, count), mask),
+                                d * (sc[0] & 0xF), min * (sc[0] >> 4));
+                store_u8x16_sub(y + 16, _mm_and_si128(_mm_srl_epi16(q1, count), mask),
+                                d * (sc[1] & 0xF), min * (sc[1] >> 4));
+                y += 32;
+                sc += 2;
+            }
+            q += 32;
+        }
+    }
+}
+
+void dequantize_row_q3_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q3_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m256i mask = _mm256_set1_epi8(0x03);
+    const __m256i four = _mm256_set1_epi8(4);
+
+    int8_t scales[16];
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d_all = _cvtsh_ss(x[i].d);
+
+        const uint8_t * GGML_RESTRICT q = x[i].qs;
+        const __m256i hm = _mm256_loadu_si256((const __m256i *) x[i].hmask);
+
+        unpack_scales_q3_K(x[i].scales, scales);
+
+        int is = 0;
+        int m = 1;
+        for (int n = 0; n < QK_K; n += 128) {
+            const __m256i qs = _mm256_loadu_si256((const __m256i *) q);
+            for (int shift = 0; shift < 8; shift += 2) {
+                const __m256i low = _mm256_and_si256(_mm256_srl_epi16(qs, _mm_cvtsi32_si128(shift)), mask);
+                const __m256i bit = _mm256_and_si256(hm, _mm256_set1_epi8((char) m));
+                const __m256i sub = _mm256_and_si256(_mm256_cmpeq_epi8(bit, _mm256_setzero_si256()), four);
+                const __m256i v = _mm256_sub_epi8(low, sub);
+
+                store_i8x16(y +  0, _mm256_castsi256_si128(v), d_all * (scales[is + 0] - 32));
+                store_i8x16(y + 16, _mm256_extracti128_si256(v, 1), d_all * (scales[is + 1] - 32));
+                y += 32;
+                is += 2;
+                m <<= 1;
+            }
+            q += 32;
+        }
+    }
+}
+
+void dequantize_row_q4_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q4_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const uint8_t * q = x[i].qs;
+
+        const float d   = _cvtsh_ss(x[i].d);
+        const float min = _cvtsh_ss(x[i].dmin);
+
+        int is = 0;
+        uint8_t sc, m;
+        for (int j = 0; j < QK_K; j += 64) {
+            get_scale_min_k4(is + 0, x[i].scales, &sc, &m);
+            const float d1 = d * sc; const float m1 = min * m;
+            get_scale_min_k4(is + 1, x[i].scales, &sc, &m);
+            const float d2 = d * sc; const float m2 = min * m;
+
+            const __m256i qs = _mm256_loadu_si256((const __m256i *) q);
+            store_u8x32_sub(y +  0, _mm256_and_si256(qs, mask), d1, m1);
+            store_u8x32_sub(y + 32, _mm256_and_si256(_mm256_srli_epi16(qs, 4), mask), d2, m2);
+            y += 64;
+            q += 32; is += 2;
+        }
+    }
+}
+
+void dequantize_row_q5_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q5_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    const __m256i sixteen = _mm256_set1_epi8(16);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const uint8_t * ql = x[i].qs;
+        const __m256i qh = _mm256_loadu_si256((const __m256i *) x[i].qh);
+
+        const float d = _cvtsh_ss(x[i].d);
+        const float min = _cvtsh_ss(x[i].dmin);
+
+        int is = 0;
+        uint8_t sc, m;
+        int u1 = 1, u2 = 2;
+        for (int j = 0; j < QK_K; j += 64) {
+            get_scale_min_k4(is + 0, x[i].scales, &sc, &m);
+            const float d1 = d * sc; const float m1 = min * m;
+            get_scale_min_k4(is + 1, x[i].scales, &sc, &m);
+            const float d2 = d * sc; const float m2 = min * m;
+
+            const __m256i qs = _mm256_loadu_si256((const __m256i *) ql);
+            const __m256i bit1 = _mm256_and_si256(qh, _mm256_set1_epi8((char) u1));
+            const __m256i bit2 = _mm256_and_si256(qh, _mm256_set1_epi8((char) u2));
+            const __m256i h1 = _mm256_andnot_si256(_mm256_cmpeq_epi8(bit1, _mm256_setzero_si256()), sixteen);
+            const __m256i h2 = _mm256_andnot_si256(_mm256_cmpeq_epi8(bit2, _mm256_setzero_si256()), sixteen);
+
+            store_u8x32_sub(y +  0, _mm256_add_epi8(_mm256_and_si256(qs, mask), h1), d1, m1);
+            store_u8x32_sub(y + 32, _mm256_add_epi8(_mm256_and_si256(_mm256_srli_epi16(qs, 4), mask), h2), d2, m2);
+            y += 64;
+            ql += 32; is += 2;
+            u1 <<= 2; u2 <<= 2;
+        }
+    }
+}
+
+void dequantize_row_q6_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q6_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m256i mask_lo = _mm256_set1_epi8(0x0F);
+    const __m256i mask_hi = _mm256_set1_epi8(0x03);
+    const __m256i offset = _mm256_set1_epi8(32);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+
+        const uint8_t * GGML_RESTRICT ql = x[i].ql;
+        const uint8_t * GGML_RESTRICT qh = x[i].qh;
+        const int8_t  * GGML_RESTRICT sc = x[i].scales;
+
+        for (int n = 0; n < QK_K; n += 128) {
+            const __m256i l0 = _mm256_loadu_si256((const __m256i *) (ql +  0));
+            const __m256i l1 = _mm256_loadu_si256((const __m256i *) (ql + 32));
+            const __m256i h  = _mm256_loadu_si256((const __m256i *) qh);
+
+            const __m256i h0 = _mm256_slli_epi16(_mm256_and_si256(h, mask_hi), 4);
+            const __m256i h1 = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(h, 2), mask_hi), 4);
+            const __m256i h2 = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(h, 4), mask_hi), 4);
+            const __m256i h3 = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(h, 6), mask_hi), 4);
+
+            const __m256i q[4] = {
+                _mm256_sub_epi8(_mm256_or_si256(_mm256_and_si256(l0, mask_lo), h0), offset),
+                _mm256_sub_epi8(_mm256_or_si256(_mm256_and_si256(l1, mask_lo), h1), offset),
+                _mm256_sub_epi8(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(l0, 4), mask_lo), h2), offset),
+                _mm256_sub_epi8(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(l1, 4), mask_lo), h3), offset),
+            };
+
+            for (int j = 0; j < 4; ++j) {
+                store_i8x16(y + 32*j +  0, _mm256_castsi256_si128(q[j]), d * sc[2*j + 0]);
+                store_i8x16(y + 32*j + 16, _mm256_extracti128_si256(q[j], 1), d * sc[2*j + 1]);
+            }
+            y  += 128;
+            ql += 64;
+            qh += 32;
+            sc += 8;
+        }
+    }
+}
+
+void dequantize_row_q8_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q8_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        for (int j = 0; j < QK_K; j += 16) {
+            store_i8x16(y + j, _mm_loadu_si128((const __m128i *) (x[i].qs + j)), x[i].d);
+        }
+        y += QK_K;
+    }
+}
+
+// ============================================================================
+// IQ types
+// ============================================================================
+
+void dequantize_row_iq4_nl_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq4_nl * GGML_RESTRICT x = vx;
+    assert(k % QK4_NL == 0);
+    const int64_t nb = k / QK4_NL;
+
+    const __m128i values = _mm_loadu_si128((const __m128i *) kvalues_iq4nl);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_shuffle_epi8(values, _mm_and_si128(qs, mask));
+        const __m128i hi = _mm_shuffle_epi8(values, _mm_and_si128(_mm_srli_epi16(qs, 4), mask));
+
+        store_i8x16(y +  0, lo, d);
+        store_i8x16(y + 16, hi, d);
+        y += QK4_NL;
+    }
+}
+
+void dequantize_row_iq4_xs_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq4_xs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m128i values = _mm_loadu_si128((const __m128i *) kvalues_iq4nl);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+
+        for (int ib = 0; ib < QK_K/32; ++ib) {
+            const int ls = ((x[i].scales_l[ib/2] >> 4*(ib%2)) & 0xf) | (((x[i].scales_h >> 2*ib) & 3) << 4);
+            const float dl = d * (ls - 32);
+            const __m128i q = _mm_loadu_si128((const __m128i *) qs);
+            store_i8x16(y +  0, _mm_shuffle_epi8(values, _mm_and_si128(q, mask)), dl);
+            store_i8x16(y + 16, _mm_shuffle_epi8(values, _mm_and_si128(_mm_srli_epi16(q, 4), mask)), dl);
+            y  += 32;
+            qs += 16;
+        }
+    }
+}
+
+// The 2- and 3-bit IQ kernels gather the four (IQ2) or eight (IQ3) grid
+// points of a 32-value sub-block into one register, then widen and sign them.
+
+void dequantize_row_iq2_xxs_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq2_xxs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            uint32_t aux32[2];
+            memcpy(aux32, x[i].qs + 4*ib32, sizeof(aux32));
+            const __m256 db = _mm256_set1_ps(d * (0.5f + (aux32[1] >> 28)) * 0.25f);
+            const __m128i idx = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int) aux32[0]));
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq2xxs_grid, idx, 8);
+            store_grid32_signed(y, q, ksigns_x4(aux32[1]), db, db);
+            y += 32;
+        }
+    }
+}
+
+void dequantize_row_iq2_xs_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq2_xs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m128i index_mask = _mm_set1_epi32(511);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            const uint16_t * qs = x[i].qs + 4*ib32;
+            const __m256 db0 = _mm256_set1_ps(d * (0.5f + (x[i].scales[ib32] & 0xf)) * 0.25f);
+            const __m256 db1 = _mm256_set1_ps(d * (0.5f + (x[i].scales[ib32] >>  4)) * 0.25f);
+            const __m128i packed = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *) qs));
+            const __m128i idx = _mm_and_si128(packed, index_mask);
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq2xs_grid, idx, 8);
+            const uint32_t signs = (uint32_t) ksigns_iq2xs[qs[0] >> 9]       | (uint32_t) ksigns_iq2xs[qs[1] >> 9] <<  8 |
+                                   (uint32_t) ksigns_iq2xs[qs[2] >> 9] << 16 | (uint32_t) ksigns_iq2xs[qs[3] >> 9] << 24;
+            store_grid32_signed(y, q, signs, db0, db1);
+            y += 32;
+        }
+    }
+}
+
+void dequantize_row_iq2_s_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq2_s * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    // Bits 2l..2l+1 of qh land in bits 8..9 of index l
+    const __m128i high_shift = _mm_setr_epi32(8, 6, 4, 2);
+    const __m128i high_mask = _mm_set1_epi32(0x300);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * signs = qs + QK_K/8;
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            const __m256 db0 = _mm256_set1_ps(d * (0.5f + (x[i].scales[ib32] & 0xf)) * 0.25f);
+            const __m256 db1 = _mm256_set1_ps(d * (0.5f + (x[i].scales[ib32] >>  4)) * 0.25f);
+            uint32_t low, sign_bits;
+            memcpy(&low, qs, sizeof(low));
+            memcpy(&sign_bits, signs, sizeof(sign_bits));
+            const __m128i high = _mm_sllv_epi32(_mm_set1_epi32(x[i].qh[ib32]), high_shift);
+            const __m128i idx = _mm_or_si128(_mm_cvtepu8_epi32(_mm_cvtsi32_si128((int) low)),
+                                             _mm_and_si128(high, high_mask));
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq2s_grid, idx, 8);
+            store_grid32_signed(y, q, sign_bits, db0, db1);
+            y += 32;
+            qs += 4;
+            signs += 4;
+        }
+    }
+}
+
+void dequantize_row_iq3_xxs_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq3_xxs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * scales_and_signs = qs + QK_K/4;
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            uint32_t aux32;
+            memcpy(&aux32, scales_and_signs + 4*ib32, sizeof(aux32));
+            const __m256 db = _mm256_set1_ps(d * (0.5f + (aux32 >> 28)) * 0.5f);
+            const __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) qs));
+            const __m256i q = _mm256_i32gather_epi32((const int *) iq3xxs_grid, idx, 4);
+            store_grid32_signed(y, q, ksigns_x4(aux32), db, db);
+            y += 32;
+            qs += 8;
+        }
+    }
+}
+
+void dequantize_row_iq3_s_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq3_s * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    // Bit j of qh lands in bit 8 of index j
+    const __m256i high_shift = _mm256_setr_epi32(8, 7, 6, 5, 4, 3, 2, 1);
+    const __m256i high_mask = _mm256_set1_epi32(256);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * signs = x[i].signs;
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            const __m256 db = _mm256_set1_ps(d * (1 + 2*((x[i].scales[ib32/2] >> 4*(ib32%2)) & 0xf)));
+            uint32_t sign_bits;
+            memcpy(&sign_bits, signs, sizeof(sign_bits));
+            const __m256i high = _mm256_sllv_epi32(_mm256_set1_epi32(x[i].qh[ib32]), high_shift);
+            const __m256i idx = _mm256_or_si256(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) qs)),
+                                                _mm256_and_si256(high, high_mask));
+            const __m256i q = _mm256_i32gather_epi32((const int *) iq3s_grid, idx, 4);
+            store_grid32_signed(y, q, sign_bits, db, db);
+            y += 32;
+            qs += 8;
+            signs += 4;
+        }
+    }
+}
+
+void dequantize_row_iq1_s_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq1_s * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    // Bits 3l..3l+2 of qh land in bits 8..10 of index l
+    const __m128i high_shift = _mm_setr_epi32(0, 3, 6, 9);
+    const __m128i high_mask = _mm_set1_epi32(0x700);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+
+        for (int ib = 0; ib < QK_K/32; ++ib) {
+            const uint16_t qh = x[i].qh[ib];
+            const __m256 dl = _mm256_set1_ps(d * (2*((qh >> 12) & 7) + 1));
+            const float delta = qh & 0x8000 ? -IQ1S_DELTA : IQ1S_DELTA;
+            uint32_t low;
+            memcpy(&low, qs, sizeof(low));
+            const __m128i high = _mm_srlv_epi32(_mm_set1_epi32(qh << 8), high_shift);
+            const __m128i idx = _mm_or_si128(_mm_cvtepu8_epi32(_mm_cvtsi32_si128((int) low)),
+                                             _mm_and_si128(high, high_mask));
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq1s_grid, idx, 8);
+            const __m128i q0 = _mm256_castsi256_si128(q);
+            const __m128i q1 = _mm256_extracti128_si256(q, 1);
+            store_i8x8_offset(y +  0, q0, delta, dl);
+            store_i8x8_offset(y +  8, _mm_srli_si128(q0, 8), delta, dl);
+            store_i8x8_offset(y + 16, q1, delta, dl);
+            store_i8x8_offset(y + 24, _mm_srli_si128(q1, 8), delta, dl);
+            y += 32;
+            qs += 4;
+        }
+    }
+}
+
+void dequantize_row_iq1_m_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq1_m * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    // Nibble l of the two qh bytes, read as one 16-bit word, lands in bits 8..10 of index l
+    const __m128i high_shift = _mm_setr_epi32(0, 4, 8, 12);
+    const __m128i high_mask = _mm_set1_epi32(0x700);
+
+    for (int64_t i = 0; i < nb; i++) {
+        uint16_t sc[4];
+        memcpy(sc, x[i].scales, sizeof(sc));
+        const float d = _cvtsh_ss(iq1m_scale(sc));
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * qh = x[i].qh;
+
+        for (int ib = 0; ib < QK_K/32; ++ib) {
+            const __m256 dl1 = _mm256_set1_ps(d * (2*((sc[ib/2] >> (6*(ib%2)+0)) & 0x7) + 1));
+            const __m256 dl2 = _mm256_set1_ps(d * (2*((sc[ib/2] >> (6*(ib%2)+3)) & 0x7) + 1));
+            uint32_t low;
+            memcpy(&low, qs, sizeof(low));
+            const __m128i high = _mm_srlv_epi32(_mm_set1_epi32((qh[0] | qh[1] << 8) << 8), high_shift);
+            const __m128i idx = _mm_or_si128(_mm_cvtepu8_epi32(_mm_cvtsi32_si128((int) low)),
+                                             _mm_and_si128(high, high_mask));
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq1s_grid, idx, 8);
+            const __m128i q0 = _mm256_castsi256_si128(q);
+            const __m128i q1 = _mm256_extracti128_si256(q, 1);
+            store_i8x8_offset(y +  0, q0, qh[0] & 0x08 ? -IQ1M_DELTA : IQ1M_DELTA, dl1);
+            store_i8x8_offset(y +  8, _mm_srli_si128(q0, 8), qh[0] & 0x80 ? -IQ1M_DELTA : IQ1M_DELTA, dl1);
+            store_i8x8_offset(y + 16, q1, qh[1] & 0x08 ? -IQ1M_DELTA : IQ1M_DELTA, dl2);
+            store_i8x8_offset(y + 24, _mm_srli_si128(q1, 8), qh[1] & 0x80 ? -IQ1M_DELTA : IQ1M_DELTA, dl2);
+            y += 32;
+            qs += 4;
+            qh += 2;
+        }
+    }
+}
+
+// ============================================================================
+// Ternary types
+// ============================================================================
+
+void dequantize_row_tq1_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_tq1_0 * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    static const uint16_t pow3[5] = {1, 3, 9, 27, 81};
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const __m128i q0 = _mm_loadu_si128((const __m128i *) (x[i].qs +  0));
+        const __m128i q1 = _mm_loadu_si128((const __m128i *) (x[i].qs + 16));
+        const __m128i q2 = _mm_loadu_si128((const __m128i *) (x[i].qs + 32));
+
+        for (int n = 0; n < 5; ++n) {
+            const __m256i p = _mm256_set1_epi16((short) pow3[n]);
+            store_i8x16(y +  0, ternary_digits(q0, p), d);
+            store_i8x16(y + 16, ternary_digits(q1, p), d);
+            y += 32;
+        }
+        for (int n = 0; n < 5; ++n) {
+            store_i8x16(y, ternary_digits(q2, _mm256_set1_epi16((short) pow3[n])), d);
+            y += 16;
+        }
+
+        // The four qh bytes, repeated once per digit in output order
+        uint32_t qh;
+        memcpy(&qh, x[i].qh, sizeof(qh));
+        const __m256i p = _mm256_setr_epi16(1, 1, 1, 1, 3, 3, 3, 3, 9, 9, 9, 9, 27, 27, 27, 27);
+        store_i8x16(y, ternary_digits(_mm_set1_epi32((int) qh), p), d);
+        y += 16;
+    }
+}
+
+void dequantize_row_tq2_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_tq2_0 * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m128i mask = _mm_set1_epi8(0x03);
+    const __m128i one = _mm_set1_epi8(1);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+
+        for (int j = 0; j < QK_K/4; j += 32) {
+            const __m128i q0 = _mm_loadu_si128((const __m128i *) (x[i].qs + j +  0));
+            const __m128i q1 = _mm_loadu_si128((const __m128i *) (x[i].qs + j + 16));
+            for (int l = 0; l < 4; ++l) {
+                const __m128i count = _mm_cvtsi32_si128(2*l);
+                store_i8x16(y +  0, _mm_sub_epi8(_mm_and_si128(_mm_srl_epi16(q0, count), mask), one), d);
+                store_i8x16(y + 16, _mm_sub_epi8(_mm_and_si128(_mm_srl_epi16(q1, count), mask), one), d);
+                y += 32;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Dot products
+// ============================================================================
+
+static inline float hsum_float_8(const __m256 x) {
+    __m128 res = _mm256_extractf128_ps(x, 1);
+    res = _mm_add_ps(res, _mm256_castps256_ps128(x));
+    res = _mm_add_ps(res, _mm_movehl_ps(res, res));
+    res = _mm_add_ss(res, _mm_movehdup_ps(res));
+    return _mm_cvtss_f32(res);
+}
+
+// Sum of pairwise signed byte products, widened to 8 x i32
+static inline __m256i mul_sum_i8_pairs(const __m256i x, const __m256i y) {
+    // maddubs needs an unsigned left operand: move the sign of x onto y
+    const __m256i ax = _mm256_sign_epi8(x, x);
+    const __m256i sy = _mm256_sign_epi8(y, x);
+    const __m256i dot = _mm256_maddubs_epi16(ax, sy);
+    return _mm256_madd_epi16(dot, _mm256_set1_epi16(1));
+}
+
+// 32 nibbles -> 32 bytes: low nibbles in bytes 0..15, high nibbles in 16..31
+static inline __m256i bytes_from_nibbles_32(const uint8_t * rsi) {
+    const __m128i tmp = _mm_loadu_si128((const __m128i *) rsi);
+    const __m256i bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(tmp), _mm_srli_epi16(tmp, 4), 1);
+    return _mm256_and_si256(bytes, _mm256_set1_epi8(0x0F));
+}
+
+// Two 16-bit lane scales: lanes 0..7 get lo, lanes 8..15 get hi
+static inline __m256i scales_i16_pair(int lo, int hi) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi16(lo)), _mm_set1_epi16(hi), 1);
+}
+
+float ggml_vec_dot_f32_avx2(const float * GGML_RESTRICT x, const float * GGML_RESTRICT y, int64_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+
+    int64_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(x + i +  0), _mm256_loadu_ps(y + i +  0)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(x + i +  8), _mm256_loadu_ps(y + i +  8)));
+        acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(_mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(y + i + 16)));
+        acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(_mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(y + i + 24)));
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+
+    float sum = hsum_float_8(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+    for (; i < n; ++i) {
+        sum += x[i]*y[i];
+    }
+    return sum;
+}
+
+float ggml_vec_dot_q4_0_q8_0_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK8_0 == 0);
+    const int64_t nb = n / QK8_0;
+
+    const block_q4_0 * GGML_RESTRICT x = vx;
+    const block_q8_0 * GGML_RESTRICT y = vy;
+
+    __m256 acc = _mm256_setzero_ps();
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        const __m256 d = _mm256_set1_ps(_cvtsh_ss(x[ib].d) * _cvtsh_ss(y[ib].d));
+
+        const __m256i qx = _mm256_sub_epi8(bytes_from_nibbles_32(x[ib].qs), _mm256_set1_epi8(8));
+        const __m256i qy = _mm256_loadu_si256((const __m256i *) y[ib].qs);
+
+        const __m256 q = _mm256_cvtepi32_ps(mul_sum_i8_pairs(qx, qy));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(d, q));
+    }
+
+    return hsum_float_8(acc);
+}
+
+float ggml_vec_dot_q8_0_q8_0_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK8_0 == 0);
+    const int64_t nb = n / QK8_0;
+
+    const block_q8_0 * GGML_RESTRICT x = vx;
+    const block_q8_0 * GGML_RESTRICT y = vy;
+
+    __m256 acc = _mm256_setzero_ps();
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        const __m256 d = _mm256_set1_ps(_cvtsh_ss(x[ib].d) * _cvtsh_ss(y[ib].d));
+
+        const __m256i qx = _mm256_loadu_si256((const __m256i *) x[ib].qs);
+        const __m256i qy = _mm256_loadu_si256((const __m256i *) y[ib].qs);
+
+        const __m256 q = _mm256_cvtepi32_ps(mul_sum_i8_pairs(qx, qy));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(d, q));
+    }
+
+    return hsum_float_8(acc);
+}
+
+float ggml_vec_dot_q4_K_q8_K_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int64_t nb = n / QK_K;
+
+    const block_q4_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    const __m256i m4 = _mm256_set1_epi8(0xF);
+
+    __m256 acc = _mm256_setzero_ps();
+    float summs = 0.0f;
+
+    for (int64_t i = 0; i < nb; ++i) {
+        const float d    = y[i].d * _cvtsh_ss(x[i].d);
+        const float dmin = y[i].d * _cvtsh_ss(x[i].dmin);
+
+        const uint8_t * GGML_RESTRICT q4 = x[i].qs;
+        const  int8_t * GGML_RESTRICT q8 = y[i].qs;
+
+        __m256i sumi = _mm256_setzero_si256();
+        int mins = 0;
+        uint8_t sc_lo, m_lo, sc_hi, m_hi;
+
+        for (int j = 0; j < QK_K/64; ++j) {
+            get_scale_min_k4(2*j + 0, x[i].scales, &sc_lo, &m_lo);
+            get_scale_min_k4(2*j + 1, x[i].scales, &sc_hi, &m_hi);
+            mins += m_lo * (y[i].bsums[4*j + 0] + y[i].bsums[4*j + 1]);
+            mins += m_hi * (y[i].bsums[4*j + 2] + y[i].bsums[4*j + 3]);
+
+            const __m256i q4bits = _mm256_loadu_si256((const __m256i *) q4);
+            const __m256i q4l = _mm256_and_si256(q4bits, m4);
+            const __m256i q4h = _mm256_and_si256(_mm256_srli_epi16(q4bits, 4), m4);
+
+            const __m256i q8l = _mm256_loadu_si256((const __m256i *) (q8 +  0));
+            const __m256i q8h = _mm256_loadu_si256((const __m256i *) (q8 + 32));
+
+            // Nibbles are unsigned, so maddubs applies directly
+            const __m256i pl = _mm256_madd_epi16(_mm256_maddubs_epi16(q4l, q8l), _mm256_set1_epi16(sc_lo));
+            const __m256i ph = _mm256_madd_epi16(_mm256_maddubs_epi16(q4h, q8h), _mm256_set1_epi16(sc_hi));
+            sumi = _mm256_add_epi32(sumi, _mm256_add_epi32(pl, ph));
+
+            q4 += 32;
+            q8 += 64;
+        }
+
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(d), _mm256_cvtepi32_ps(sumi)));
+        summs += dmin * mins;
+    }
+
+    return hsum_float_8(acc) - summs;
+}
+
+float ggml_vec_dot_q6_K_q8_K_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int64_t nb = n / QK_K;
+
+    const block_q6_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    const __m256i m4 = _mm256_set1_epi8(0xF);
+    const __m256i m2 = _mm256_set1_epi8(3);
+    const __m256i m32s = _mm256_set1_epi8(32);
+
+    __m256 acc = _mm256_setzero_ps();
+
+    for (int64_t i = 0; i < nb; ++i) {
+        const float d = y[i].d * _cvtsh_ss(x[i].d);
+
+        const uint8_t * GGML_RESTRICT ql = x[i].ql;
+        const uint8_t * GGML_RESTRICT qh = x[i].qh;
+        const  int8_t * GGML_RESTRICT q8 = y[i].qs;
+        const  int8_t * GGML_RESTRICT sc = x[i].scales;
+
+        __m256i sumi = _mm256_setzero_si256();
+
+        for (int j = 0; j < QK_K/128; ++j) {
+            const __m256i ql0 = _mm256_loadu_si256((const __m256i *) (ql +  0));
+            const __m256i ql1 = _mm256_loadu_si256((const __m256i *) (ql + 32));
+            const __m256i qhb = _mm256_loadu_si256((const __m256i *) qh);
+
+            // Unsigned 6-bit quants; the -32 offset is applied through m32s below
+            __m256i q[4];
+            q[0] = _mm256_or_si256(_mm256_and_si256(ql0, m4), _mm256_slli_epi16(_mm256_and_si256(qhb, m2), 4));
+            q[1] = _mm256_or_si256(_mm256_and_si256(ql1, m4), _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(qhb, 2), m2), 4));
+            q[2] = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(ql0, 4), m4), _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(qhb, 4), m2), 4));
+            q[3] = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(ql1, 4), m4), _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(qhb, 6), m2), 4));
+
+            for (int k = 0; k < 4; ++k) {
+                const __m256i q8k = _mm256_loadu_si256((const __m256i *) (q8 + 32*k));
+                const __m256i p = _mm256_sub_epi16(_mm256_maddubs_epi16(q[k], q8k), _mm256_maddubs_epi16(m32s, q8k));
+                sumi = _mm256_add_epi32(sumi, _mm256_madd_epi16(p, scales_i16_pair(sc[2*k], sc[2*k + 1])));
+            }
+
+            ql += 64;
+            qh += 32;
+            q8 += 128;
+            sc += 8;
+        }
+
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(d), _mm256_cvtepi32_ps(sumi)));
+    }
+
+    return hsum_float_8(acc);
+}
+
+// ============================================================================
+// Interleaved dot products
+// ============================================================================
+
+// The eight rows of a group sit in the eight 32-bit lanes: each 32-byte load
+// holds one 4-byte chunk per row, dotted with the same four activations.
+
+// Four activation bytes broadcast to every 32-bit lane
+static inline __m256i broadcast_i8x4(const int8_t * q) {
+    int32_t v;
+    memcpy(&v, q, sizeof(v));
+    return _mm256_set1_epi32(v);
+}
+
+// Per-lane sum of four unsigned-by-signed byte products
+static inline __m256i mul_sum_u8x4(const __m256i x, const __m256i y) {
+    return _mm256_madd_epi16(_mm256_maddubs_epi16(x, y), _mm256_set1_epi16(1));
+}
+
+void ggml_gemv_q4_0x8_q8_0_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    assert(n % QK8_0 == 0);
+    const int64_t nb = n / QK8_0;
+
+    const block_q4_0x8 * GGML_RESTRICT x = vx;
+    const block_q8_0   * GGML_RESTRICT y = vy;
+
+    const __m256i m4 = _mm256_set1_epi8(0xF);
+
+    __m256 acc = _mm256_setzero_ps();
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        __m256i sumi = _mm256_setzero_si256();
+        for (int c = 0; c < QK4_0/8; ++c) {
+            const __m256i q = _mm256_loadu_si256((const __m256i *) (x[ib].qs + 32*c));
+            const __m256i lo = _mm256_and_si256(q, m4);
+            const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(q, 4), m4);
+            sumi = _mm256_add_epi32(sumi, mul_sum_u8x4(lo, broadcast_i8x4(y[ib].qs + 4*c)));
+            sumi = _mm256_add_epi32(sumi, mul_sum_u8x4(hi, broadcast_i8x4(y[ib].qs + QK8_0/2 + 4*c)));
+        }
+
+        // Nibbles go in unsigned; the -8 offset comes off as 8 * sum(y)
+        int ysum = 0;
+        for (int j = 0; j < QK8_0; ++j) {
+            ysum += y[ib].qs[j];
+        }
+        sumi = _mm256_sub_epi32(sumi, _mm256_set1_epi32(8*ysum));
+
+        const __m256 dx = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) x[ib].d));
+        const __m256 dy = _mm256_set1_ps(_cvtsh_ss(y[ib].d));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(sumi), dx), dy));
+    }
+
+    _mm256_storeu_ps(s, acc);
+}
+
+void ggml_gemv_q8_0x8_q8_0_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    assert(n % QK8_0 == 0);
+    const int64_t nb = n / QK8_0;
+
+    const block_q8_0x8 * GGML_RESTRICT x = vx;
+    const block_q8_0   * GGML_RESTRICT y = vy;
+
+    __m256 acc = _mm256_setzero_ps();
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        __m256i sumi = _mm256_setzero_si256();
+        for (int c = 0; c < QK8_0/4; ++c) {
+            const __m256i q = _mm256_loadu_si256((const __m256i *) (x[ib].qs + 32*c));
+            sumi = _mm256_add_epi32(sumi, mul_sum_i8_pairs(q, broadcast_i8x4(y[ib].qs + 4*c)));
+        }
+
+        const __m256 dx = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) x[ib].d));
+        const __m256 dy = _mm256_set1_ps(_cvtsh_ss(y[ib].d));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_cvtepi32_ps(sumi), _mm256_mul_ps(dx, dy)));
+    }
+
+    _mm256_storeu_ps(s, acc);
+}
+
+void ggml_gemv_q4_Kx8_q8_K_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    assert(n % QK_K == 0);
+    const int64_t nb = n / QK_K;
+
+    const block_q4_Kx8 * GGML_RESTRICT x = vx;
+    const block_q8_K   * GGML_RESTRICT y = vy;
+
+    const __m256i m4 = _mm256_set1_epi8(0xF);
+
+    __m256 acc = _mm256_setzero_ps();
+
+    for (int64_t i = 0; i < nb; ++i) {
+        const uint8_t * GGML_RESTRICT q4 = x[i].qs;
+        const  int8_t * GGML_RESTRICT q8 = y[i].qs;
+
+        __m256i isum  = _mm256_setzero_si256();
+        __m256i summs = _mm256_setzero_si256();
+
+        for (int j = 0; j < QK_K/64; ++j) {
+            __m256i sum_lo = _mm256_setzero_si256();
+            __m256i sum_hi = _mm256_setzero_si256();
+            for (int c = 0; c < 8; ++c) {
+                const __m256i q = _mm256_loadu_si256((const __m256i *) (q4 + 32*c));
+                const __m256i lo = _mm256_and_si256(q, m4);
+                const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(q, 4), m4);
+                sum_lo = _mm256_add_epi32(sum_lo, mul_sum_u8x4(lo, broadcast_i8x4(q8 + 4*c)));
+                sum_hi = _mm256_add_epi32(sum_hi, mul_sum_u8x4(hi, broadcast_i8x4(q8 + 32 + 4*c)));
+            }
+
+            const __m256i sc_lo = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) x[i].scales[2*j + 0]));
+            const __m256i sc_hi = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) x[i].scales[2*j + 1]));
+            const __m256i m_lo  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) x[i].mins[2*j + 0]));
+            const __m256i m_hi  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) x[i].mins[2*j + 1]));
+            isum  = _mm256_add_epi32(isum, _mm256_mullo_epi32(sc_lo, sum_lo));
+            isum  = _mm256_add_epi32(isum, _mm256_mullo_epi32(sc_hi, sum_hi));
+            summs = _mm256_add_epi32(summs, _mm256_mullo_epi32(m_lo, _mm256_set1_epi32(y[i].bsums[4*j + 0] + y[i].bsums[4*j + 1])));
+            summs = _mm256_add_epi32(summs, _mm256_mullo_epi32(m_hi, _mm256_set1_epi32(y[i].bsums[4*j + 2] + y[i].bsums[4*j + 3])));
+
+            q4 += 8*32;
+            q8 += 64;
+        }
+
+        const __m256 yd   = _mm256_set1_ps(y[i].d);
+        const __m256 d    = _mm256_mul_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) x[i].d)), yd);
+        const __m256 dmin = _mm256_mul_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) x[i].dmin)), yd);
+        acc = _mm256_add_ps(acc, _mm256_sub_ps(_mm256_mul_ps(d, _mm256_cvtepi32_ps(isum)),
+                                               _mm256_mul_ps(dmin, _mm256_cvtepi32_ps(summs))));
+    }
+
+    _mm256_storeu_ps(s, acc);
+}
+
+// ============================================================================
+// Quantization
+// ============================================================================
+
+static inline __m256 abs_ps(__m256 x) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+}
+
+static inline float hmax_float_8(const __m256 x) {
+    __m128 res = _mm_max_ps(_mm256_extractf128_ps(x, 1), _mm256_castps256_ps128(x));
+    res = _mm_max_ps(res, _mm_movehl_ps(res, res));
+    res = _mm_max_ss(res, _mm_movehdup_ps(res));
+    return _mm_cvtss_f32(res);
+}
+
+static inline float hmin_float_8(const __m256 x) {
+    __m128 res = _mm_min_ps(_mm256_extractf128_ps(x, 1), _mm256_castps256_ps128(x));
+    res = _mm_min_ps(res, _mm_movehl_ps(res, res));
+    res = _mm_min_ss(res, _mm_movehdup_ps(res));
+    return _mm_cvtss_f32(res);
+}
+
+static inline int hsum_i32_8(const __m256i a) {
+    const __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extractf128_si256(a, 1));
+    const __m128i hi64 = _mm_unpackhi_epi64(sum128, sum128);
+    const __m128i sum64 = _mm_add_epi32(hi64, sum128);
+    const __m128i hi32  = _mm_shuffle_epi32(sum64, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_cvtsi128_si32(_mm_add_epi32(sum64, hi32));
+}
+
+// Largest |x[0..n-1]|, n a multiple of 8
+static inline float amax_f32(const float * GGML_RESTRICT x, int n) {
+    __m256 acc = _mm256_setzero_ps();
+    for (int j = 0; j < n; j += 8) {
+        acc = _mm256_max_ps(acc, abs_ps(_mm256_loadu_ps(x + j)));
+    }
+    return hmax_float_8(acc);
+}
+
+// roundf: nearest, ties away from zero (_mm256_round_ps only rounds ties to even)
+static inline __m256 round_away_ps(const __m256 v) {
+    const __m256 t = _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    const __m256 half = _mm256_cmp_ps(abs_ps(_mm256_sub_ps(v, t)), _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+    const __m256 step = _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(v, _mm256_set1_ps(-0.0f)));
+    return _mm256_add_ps(t, _mm256_and_ps(half, step));
+}
+
+// Four vectors of 8 x i32 (in element order) -> 32 x i8 with signed saturation
+static inline __m256i pack_i32_to_i8(__m256i a, __m256i b, __m256i c, __m256i d) {
+    const __m256i ab = _mm256_packs_epi32(a, b);
+    const __m256i cd = _mm256_packs_epi32(c, d);
+    const __m256i abcd = _mm256_packs_epi16(ab, cd);
+    // packs works per 128-bit lane; restore element order
+    return _mm256_permutevar8x32_epi32(abcd, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+// Packs 32 values in 0..15 as qs[j] = q[j] | q[j + 16] << 4
+static inline void store_nibbles_32(uint8_t * GGML_RESTRICT qs, __m256i q) {
+    const __m128i lo = _mm256_castsi256_si128(q);
+    const __m128i hi = _mm256_extracti128_si256(q, 1);
+    _mm_storeu_si128((__m128i *) qs, _mm_or_si128(lo, _mm_slli_epi16(hi, 4)));
+}
+
+// min(15, (int)(x * id + offset)) for 8 values
+static inline __m256i quantize_nibble_8(__m256 x, __m256 id, __m256 offset) {
+    const __m256i q = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(x, id), offset));
+    return _mm256_min_epi32(q, _mm256_set1_epi32(15));
+}
+
+void quantize_row_q4_0_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK4_0 == 0);
+    const int64_t nb = k / QK4_0;
+    block_q4_0 * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float amax = amax_f32(x, QK4_0);
+        const float max = signed_amax_f32(x, QK4_0, amax);
+
+        const float d  = max / -8;
+        const float id = d ? 1.0f/d : 0.0f;
+
+        y[i].d = GGML_FP32_TO_FP16(d);
+
+        const __m256 vid = _mm256_set1_ps(id);
+        const __m256 offset = _mm256_set1_ps(8.5f);
+        const __m256i q = pack_i32_to_i8(
+            quantize_nibble_8(_mm256_loadu_ps(x +  0), vid, offset),
+            quantize_nibble_8(_mm256_loadu_ps(x +  8), vid, offset),
+            quantize_nibble_8(_mm256_loadu_ps(x + 16), vid, offset),
+            quantize_nibble_8(_mm256_loadu_ps(x + 24), vid, offset));
+        store_nibbles_32(y[i].qs, q);
+        x += QK4_0;
+    }
+}
+
+void quantize_row_q4_1_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK4_1 == 0);
+    const int64_t nb = k / QK4_1;
+    block_q4_1 * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        __m256 vmin = _mm256_loadu_ps(x);
+        __m256 vmax = vmin;
+        for (int j = 8; j < QK4_1; j += 8) {
+            const __m256 v = _mm256_loadu_ps(x + j);
+            vmin = _mm256_min_ps(vmin, v);
+            vmax = _mm256_max_ps(vmax, v);
+        }
+        float min = hmin_float_8(vmin);
+        const float max = hmax_float_8(vmax);
+        if (min == 0.0f) {
+            min = first_zero_f32(x, QK4_1);
+        }
+
+        const float d  = (max - min) / ((1 << 4) - 1);
+        const float id = d ? 1.0f/d : 0.0f;
+
+        y[i].d = GGML_FP32_TO_FP16(d);
+        y[i].m = GGML_FP32_TO_FP16(min);
+
+        const __m256 vid = _mm256_set1_ps(id);
+        const __m256 vm = _mm256_set1_ps(min);
+        const __m256 offset = _mm256_set1_ps(0.5f);
+        const __m256i q = pack_i32_to_i8(
+            quantize_nibble_8(_mm256_sub_ps(_mm256_loadu_ps(x +  0), vm), vid, offset),
+            quantize_nibble_8(_mm256_sub_ps(_mm256_loadu_ps(x +  8), vm), vid, offset),
+            quantize_nibble_8(_mm256_sub_ps(_mm256_loadu_ps(x + 16), vm), vid, offset),
+            quantize_nibble_8(_mm256_sub_ps(_mm256_loadu_ps(x + 24), vm), vid, offset));
+        store_nibbles_32(y[i].qs, q);
+        x += QK4_1;
+    }
+}
+
+// roundf(x * id) for 32 values, as 32 x i8; *sum receives their total
+static inline __m256i quantize_i8_32(const float * GGML_RESTRICT x, float id, int * sum) {
+    const __m256 vid = _mm256_set1_ps(id);
+    const __m256i q0 = _mm256_cvtps_epi32(round_away_ps(_mm256_mul_ps(_mm256_loadu_ps(x +  0), vid)));
+    const __m256i q1 = _mm256_cvtps_epi32(round_away_ps(_mm256_mul_ps(_mm256_loadu_ps(x +  8), vid)));
+    const __m256i q2 = _mm256_cvtps_epi32(round_away_ps(_mm256_mul_ps(_mm256_loadu_ps(x + 16), vid)));
+    const __m256i q3 = _mm256_cvtps_epi32(round_away_ps(_mm256_mul_ps(_mm256_loadu_ps(x + 24), vid)));
+    if (sum) {
+        *sum = hsum_i32_8(_mm256_add_epi32(_mm256_add_epi32(q0, q1), _mm256_add_epi32(q2, q3)));
+    }
+    return pack_i32_to_i8(q0, q1, q2, q3);
+}
+
+void quantize_row_q8_0_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK8_0 == 0);
+    const int64_t nb = k / QK8_0;
+    block_q8_0 * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float amax = amax_f32(x, QK8_0);
+
+        const float d = amax / ((1 << 7) - 1);
+        const float id = d ? 1.0f/d : 0.0f;
+
+        y[i].d = GGML_FP32_TO_FP16(d);
+        _mm256_storeu_si256((__m256i *) y[i].qs, quantize_i8_32(x, id, NULL));
+        x += QK8_0;
+    }
+}
+
+void quantize_row_q8_1_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK8_1 == 0);
+    const int64_t nb = k / QK8_1;
+    block_q8_1 * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float amax = amax_f32(x, QK8_1);
+
+        const float d = amax / ((1 << 7) - 1);
+        const float id = d ? 1.0f/d : 0.0f;
+
+        int sum = 0;
+        y[i].d = GGML_FP32_TO_FP16(d);
+        _mm256_storeu_si256((__m256i *) y[i].qs, quantize_i8_32(x, id, &sum));
+        y[i].s = GGML_FP32_TO_FP16(sum*d);
+        x += QK8_1;
+    }
+}
+
+void quantize_row_q8_K_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+    block_q8_K * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float amax = amax_f32(x, QK_K);
+        if (!amax) {
+            y[i].d = 0;
+            memset(y[i].qs, 0, QK_K);
+            memset(y[i].bsums, 0, sizeof(y[i].bsums));
+            x += QK_K;
+            continue;
+        }
+        const float max = signed_amax_f32(x, QK_K, amax);
+        const float iscale = -127.f/max;
+
+        const __m256 vscale = _mm256_set1_ps(iscale);
+        const __m256i vmax = _mm256_set1_epi32(127);
+        for (int j = 0; j < QK_K; j += 32) {
+            __m256i q[4];
+            for (int l = 0; l < 4; ++l) {
+                const __m256 v = _mm256_mul_ps(_mm256_loadu_ps(x + j + 8*l), vscale);
+                q[l] = _mm256_min_epi32(_mm256_cvtps_epi32(_mm256_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)), vmax);
+            }
+            _mm256_storeu_si256((__m256i *) (y[i].qs + j), pack_i32_to_i8(q[0], q[1], q[2], q[3]));
+            y[i].bsums[j/16 + 0] = hsum_i32_8(_mm256_add_epi32(q[0], q[1]));
+            y[i].bsums[j/16 + 1] = hsum_i32_8(_mm256_add_epi32(q[2], q[3]));
+        }
+        y[i].d = 1/iscale;
+        x += QK_K;
+    }
+}
+
+// ============================================================================
+// Half precision output
+// ============================================================================
+
+void ggml_fp32_to_fp16_row_avx2(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n) {
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(x + i);
+        // F16C keeps NaN payloads, the scalar encoder does not
+        if (_mm256_movemask_ps(_mm256_cmp_ps(v, v, _CMP_UNORD_Q))) {
+            ggml_fp32_to_fp16_row_ref(x + i, y + i, 8);
+            continue;
+        }
+        _mm_storeu_si128((__m128i *) (y + i), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    }
+    ggml_fp32_to_fp16_row_ref(x + i, y + i, n - i);
+}
+
+// Upper halves of 8 floats rounded to nearest even; NaNs are truncated and made quiet
+static inline __m256i fp32_to_bf16_x8(__m256i w) {
+    const __m256i hi = _mm256_srli_epi32(w, 16);
+    const __m256i bias = _mm256_add_epi32(_mm256_set1_epi32(0x7FFF), _mm256_and_si256(hi, _mm256_set1_epi32(1)));
+    const __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(w, bias), 16);
+    const __m256i abs = _mm256_and_si256(w, _mm256_set1_epi32(0x7FFFFFFF));
+    const __m256i nan = _mm256_cmpgt_epi32(abs, _mm256_set1_epi32(0x7F800000));
+    return _mm256_blendv_epi8(rounded, _mm256_or_si256(hi, _mm256_set1_epi32(64)), nan);
+}
+
+void ggml_fp32_to_bf16_row_avx2(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n) {
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i h0 = fp32_to_bf16_x8(_mm256_loadu_si256((const __m256i *) (x + i + 0)));
+        const __m256i h1 = fp32_to_bf16_x8(_mm256_loadu_si256((const __m256i *) (x + i + 8)));
+        // packus interleaves the 128-bit lanes; the permute restores element order
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(h0, h1), 0xD8);
+        _mm256_storeu_si256((__m256i *) (y + i), packed);
+    }
+    ggml_fp32_to_bf16_row_ref(x + i, y + i, n - i);
+}
+
+// ============================================================================
+// Element conversion
+// ============================================================================
+
+void ggml_fp16_to_fp32_row_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm256_storeu_ps(y + i + 0, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) (x + i*2 + 0))));
+        _mm256_storeu_ps(y + i + 8, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) (x + i*2 + 16))));
+    }
+    ggml_fp16_to_fp32_row(x + i*2, y + i, n - i);
+}
+
+void ggml_bf16_to_fp32_row_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i h = _mm256_loadu_si256((const __m256i *) (x + i*2));
+        const __m256i lo = _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(h)), 16);
+        const __m256i hi = _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(h, 1)), 16);
+        _mm256_storeu_si256((__m256i *) (y + i + 0), lo);
+        _mm256_storeu_si256((__m256i *) (y + i + 8), hi);
+    }
+    ggml_bf16_to_fp32_row(x + i*2, y + i, n - i);
+}
+
+void ggml_f64_to_fp32_row_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd((const double *) (x + i*8 + 0)));
+        const __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd((const double *) (x + i*8 + 32)));
+        _mm256_storeu_ps(y + i, _mm256_set_m128(hi, lo));
+    }
+    ggml_f64_to_fp32_row_ref(x + i*8, y + i, n - i);
+}
+
+void ggml_i8_to_fp32_row_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i q = _mm_loadu_si128((const __m128i *) (x + i));
+        _mm256_storeu_ps(y + i + 0, _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q)));
+        _mm256_storeu_ps(y + i + 8, _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(q, 8))));
+    }
+    ggml_i8_to_fp32_row_ref(x + i, y + i, n - i);
+}
+
+void ggml_i16_to_fp32_row_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i q = _mm256_loadu_si256((const __m256i *) (x + i*2));
+        const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(q));
+        const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(q, 1));
+        _mm256_storeu_ps(y + i + 0, _mm256_cvtepi32_ps(lo));
+        _mm256_storeu_ps(y + i + 8, _mm256_cvtepi32_ps(hi));
+    }
+    ggml_i16_to_fp32_row_ref(x + i*2, y + i, n - i);
+}
+
+void ggml_i32_to_fp32_row_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i lo = _mm256_loadu_si256((const __m256i *) (x + i*4 + 0));
+        const __m256i hi = _mm256_loadu_si256((const __m256i *) (x + i*4 + 32));
+        _mm256_storeu_ps(y + i + 0, _mm256_cvtepi32_ps(lo));
+        _mm256_storeu_ps(y + i + 8, _mm256_cvtepi32_ps(hi));
+    }
+    ggml_i32_to_fp32_row_ref(x + i*4, y + i, n - i);
+}
+
+// ============================================================================
+// Non-finite scans
+// ============================================================================
+
+// Number of 16-bit lanes of v whose exponent bits are all set
+static inline int count_exp16_x16(__m256i v, __m256i mask) {
+    const __m256i e = _mm256_cmpeq_epi16(_mm256_and_si256(v, mask), mask);
+    // Each 16-bit lane sets two mask bits
+    return __builtin_popcount((unsigned) _mm256_movemask_epi8(e)) / 2;
+}
+
+// Number of 32-bit lanes of v whose masked bits equal mask
+static inline int count_exp32_x8(__m256i v, __m256i mask) {
+    const __m256i e = _mm256_cmpeq_epi32(_mm256_and_si256(v, mask), mask);
+    return __builtin_popcount((unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(e)));
+}
+
+// Scale fields are gathered eight blocks at a time; contiguous payloads use plain loads.
+// The 32-bit gather of a 16-bit field reads two bytes past it, so the last element is
+// always left to the scalar tail.
+static int64_t count_nonfinite16_avx2(const uint8_t * GGML_RESTRICT x, int64_t n, size_t stride,
+                                      uint16_t exponent, int64_t (*ref)(const void *, int64_t, size_t)) {
+    int64_t count = 0;
+    int64_t i = 0;
+    if (stride == sizeof(uint16_t)) {
+        const __m256i mask = _mm256_set1_epi16((short) exponent);
+        for (; i + 16 <= n; i += 16) {
+            count += count_exp16_x16(_mm256_loadu_si256((const __m256i *) (x + i*2)), mask);
+        }
+    } else if (stride <= INT32_MAX / 8) {
+        const __m256i mask = _mm256_set1_epi32(exponent);
+        const int s = (int) stride;
+        const __m256i offsets = _mm256_setr_epi32(0, s, 2*s, 3*s, 4*s, 5*s, 6*s, 7*s);
+        for (; i + 8 < n; i += 8) {
+            const __m256i v = _mm256_i32gather_epi32((const int *) (x + i*stride), offsets, 1);
+            count += count_exp32_x8(v, mask);
+        }
+    }
+    return count + ref(x + i*stride, n - i, stride);
+}
+
+int64_t ggml_count_nonfinite_fp16_avx2(const void * GGML_RESTRICT x, int64_t n, size_t stride) {
+    return count_nonfinite16_avx2(x, n, stride, 0x7C00, ggml_count_nonfinite_fp16_ref);
+}
+
+int64_t ggml_count_nonfinite_bf16_avx2(const void * GGML_RESTRICT x, int64_t n, size_t stride) {
+    return count_nonfinite16_avx2(x, n, stride, 0x7F80, ggml_count_nonfinite_bf16_ref);
+}
+
+int64_t ggml_count_nonfinite_f32_avx2(const void * GGML_RESTRICT vx, int64_t n, size_t stride) {
+    const uint8_t * x = vx;
+    const __m256i mask = _mm256_set1_epi32(0x7F800000);
+    int64_t count = 0;
+    int64_t i = 0;
+    if (stride == sizeof(float)) {
+        for (; i + 32 <= n; i += 32) {
+            count += count_exp32_x8(_mm256_loadu_si256((const __m256i *) (x + i*4 +  0)), mask);
+            count += count_exp32_x8(_mm256_loadu_si256((const __m256i *) (x + i*4 + 32)), mask);
+            count += count_exp32_x8(_mm256_loadu_si256((const __m256i *) (x + i*4 + 64)), mask);
+            count += count_exp32_x8(_mm256_loadu_si256((const __m256i *) (x + i*4 + 96)), mask);
+        }
+    } else if (stride <= INT32_MAX / 8) {
+        const int s = (int) stride;
+        const __m256i offsets = _mm256_setr_epi32(0, s, 2*s, 3*s, 4*s, 5*s, 6*s, 7*s);
+        for (; i + 8 <= n; i += 8) {
+            const __m256i v = _mm256_i32gather_epi32((const int *) (x + i*stride), offsets, 1);
+            count += count_exp32_x8(v, mask);
+        }
+    }
+    return count + ggml_count_nonfinite_f32_ref(x + i*stride, n - i, stride);
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+// ((l0+l4) + (l2+l6)) + ((l1+l5) + (l3+l7)), matching the scalar reference
+static inline float reduce_lanes_ps(__m256 v) {
+    const __m128 t = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    const __m128 u = _mm_add_ps(t, _mm_movehl_ps(t, t));
+    return _mm_cvtss_f32(_mm_add_ss(u, _mm_movehdup_ps(u)));
+}
+
+void ggml_stats_f32_avx2(const float * GGML_RESTRICT x, int64_t n, ggml_stats * GGML_RESTRICT acc) {
+    for (int64_t start = 0; start < n; start += QK_K) {
+        const float * t = x + start;
+        const int64_t len = n - start < QK_K ? n - start : QK_K;
+
+        __m256 s = _mm256_setzero_ps();
+        __m256 q = _mm256_setzero_ps();
+        // min_ps(v, m) returns m when v is NaN, like `v < m ? v : m`
+        __m256 mn = _mm256_set1_ps(INFINITY);
+        __m256 mx = _mm256_set1_ps(-INFINITY);
+        int64_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            const __m256 v = _mm256_loadu_ps(t + i);
+            s = _mm256_add_ps(s, v);
+            q = _mm256_add_ps(q, _mm256_mul_ps(v, v));
+            mn = _mm256_min_ps(v, mn);
+            mx = _mm256_max_ps(v, mx);
+        }
+        float sum = reduce_lanes_ps(s);
+        float sumsq = reduce_lanes_ps(q);
+        float lanes_min[8];
+        float lanes_max[8];
+        _mm256_storeu_ps(lanes_min, mn);
+        _mm256_storeu_ps(lanes_max, mx);
+        float min = lanes_min[0];
+        float max = lanes_max[0];
+        for (int j = 1; j < 8; ++j) {
+            min = lanes_min[j] < min ? lanes_min[j] : min;
+            max = lanes_max[j] > max ? lanes_max[j] : max;
+        }
+        for (; i < len; ++i) {
+            sum += t[i];
+            sumsq += t[i]*t[i];
+            min = t[i] < min ? t[i] : min;
+            max = t[i] > max ? t[i] : max;
+        }
+
+        const float mean = (float) ((double) sum / (double) len);
+        const __m256 vmean = _mm256_set1_ps(mean);
+        __m256 m = _mm256_setzero_ps();
+        i = 0;
+        for (; i + 8 <= len; i += 8) {
+            const __m256 d = _mm256_sub_ps(_mm256_loadu_ps(t + i), vmean);
+            m = _mm256_add_ps(m, _mm256_mul_ps(d, d));
+        }
+        float m2 = reduce_lanes_ps(m);
+        for (; i < len; ++i) {
+            const float d = t[i] - mean;
+            m2 += d*d;
+        }
+        ggml_stats_add_tile(acc, len, sum, sumsq, mean, m2, min, max);
+    }
+}
+
+void ggml_histogram_f32_avx2(const float * GGML_RESTRICT x, int64_t n, float lo, float scale,
+                             int64_t bins, int64_t * GGML_RESTRICT counts) {
+    assert(bins > 0 && bins <= (1 << 24));
+    const __m256 vlo = _mm256_set1_ps(lo);
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 top = _mm256_set1_ps((float) (bins - 1));
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), vlo), vscale);
+        const int ordered = _mm256_movemask_ps(_mm256_cmp_ps(t, t, _CMP_ORD_Q));
+        // max_ps(t, 0) is `t > 0 ? t : 0` and min_ps(c, top) is `c < top ? c : top`
+        const __m256 c = _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()), top);
+        int32_t index[8];
+        _mm256_storeu_si256((__m256i *) index, _mm256_cvttps_epi32(c));
+        for (int j = 0; j < 8; ++j) {
+            counts[index[j]] += (ordered >> j) & 1;
+        }
+    }
+    ggml_histogram_f32_ref(x + i, n - i, lo, scale, bins, counts);
+}
+
+void ggml_diff_f32_avx2(const float * GGML_RESTRICT a, const float * GGML_RESTRICT b, int64_t n,
+                        ggml_diff * GGML_RESTRICT acc) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    for (int64_t start = 0; start < n; start += QK_K) {
+        const float * ta = a + start;
+        const float * tb = b + start;
+        const int64_t len = n - start < QK_K ? n - start : QK_K;
+
+        __m256 sd = _mm256_setzero_ps();
+        __m256 ab = _mm256_setzero_ps();
+        __m256 aa = _mm256_setzero_ps();
+        __m256 bb = _mm256_setzero_ps();
+        // max_ps(e, m) returns m when e is NaN, like `e > m ? e : m`
+        __m256 mx = _mm256_setzero_ps();
+        int64_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            const __m256 x = _mm256_loadu_ps(ta + i);
+            const __m256 y = _mm256_loadu_ps(tb + i);
+            const __m256 d = _mm256_sub_ps(x, y);
+            sd = _mm256_add_ps(sd, _mm256_mul_ps(d, d));
+            ab = _mm256_add_ps(ab, _mm256_mul_ps(x, y));
+            aa = _mm256_add_ps(aa, _mm256_mul_ps(x, x));
+            bb = _mm256_add_ps(bb, _mm256_mul_ps(y, y));
+            mx = _mm256_max_ps(_mm256_and_ps(d, abs_mask), mx);
+        }
+        float sumsq_diff = reduce_lanes_ps(sd);
+        float dot = reduce_lanes_ps(ab);
+        float sumsq_a = reduce_lanes_ps(aa);
+        float sumsq_b = reduce_lanes_ps(bb);
+        float lanes_max[8];
+        _mm256_storeu_ps(lanes_max, mx);
+        float max_abs = lanes_max[0];
+        for (int j = 1; j < 8; ++j) {
+            max_abs = lanes_max[j] > max_abs ? lanes_max[j] : max_abs;
+        }
+        for (; i < len; ++i) {
+            const float d = ta[i] - tb[i];
+            const float e = fabsf(d);
+            sumsq_diff += d*d;
+            dot += ta[i]*tb[i];
+            sumsq_a += ta[i]*ta[i];
+            sumsq_b += tb[i]*tb[i];
+            max_abs = e > max_abs ? e : max_abs;
+        }
+        ggml_diff_add_tile(acc, len, sumsq_diff, dot, sumsq_a, sumsq_b, max_abs);
+    }
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // GGML_SIMD_X86
@@ -0,0 +1,881 @@
+/*
+ * GGML Dequantization - AVX-512 kernels
+ *
+ * Same structure as the AVX2 kernels, but widens 16 quants per instruction.
+ * Only called when the dispatcher detects AVX-512 F/BW/VL.
+ */
+
+#include "ggml_quants_impl.h"
+
+#include <assert.h>
+
+#if defined(GGML_SIMD_X86)
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f,avx512bw,avx512vl,avx2,f16c"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target ("avx512f,avx512bw,avx512vl,avx2,f16c")
+#endif
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// y[0..15] = (float)q * d
+static inline void store_scaled(float * GGML_RESTRICT y, __m512i q, __m512 d) {
+    _mm512_storeu_ps(y, _mm512_mul_ps(_mm512_cvtepi32_ps(q), d));
+}
+
+// y[0..15] = (float)q * d + m
+static inline void store_scaled_add(float * GGML_RESTRICT y, __m512i q, __m512 d, __m512 m) {
+    _mm512_storeu_ps(y, _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(q), d), m));
+}
+
+// 16 unsigned bytes -> y[0..15] = d * q - m
+static inline void store_u8x16_sub(float * GGML_RESTRICT y, __m128i q, float d, float m) {
+    const __m512 v = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(q));
+    _mm512_storeu_ps(y, _mm512_sub_ps(_mm512_mul_ps(_mm512_set1_ps(d), v), _mm512_set1_ps(m)));
+}
+
+// 32 unsigned bytes -> y[0..31] = d * q - m
+static inline void store_u8x32_sub(float * GGML_RESTRICT y, __m256i q, float d, float m) {
+    store_u8x16_sub(y +  0, _mm256_castsi256_si128(q), d, m);
+    store_u8x16_sub(y + 16, _mm256_extracti128_si256(q, 1), d, m);
+}
+
+// 16 signed bytes -> y[0..15] = d * q
+static inline void store_i8x16(float * GGML_RESTRICT y, __m128i q, float d) {
+    store_scaled(y, _mm512_cvtepi8_epi32(q), _mm512_set1_ps(d));
+}
+
+// 16 unsigned bytes -> y[0..15] = d * q * s, s being -1 where the bit of neg is set and 1 elsewhere
+static inline void store_u8x16_signed(float * GGML_RESTRICT y, __m128i q, __mmask16 neg, __m512 d) {
+    const __m512 v = _mm512_mul_ps(d, _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(q)));
+    const __m512 s = _mm512_mask_blend_ps(neg, _mm512_set1_ps(1.0f), _mm512_set1_ps(-1.0f));
+    _mm512_storeu_ps(y, _mm512_mul_ps(v, s));
+}
+
+// 32 grid bytes with one sign bit each (bit j of `signs` for byte j) -> y[0..31],
+// d0 scaling the first 16 values and d1 the rest. The sign bits already are the lane mask.
+static inline void store_grid32_signed(float * GGML_RESTRICT y, __m256i q, uint32_t signs, __m512 d0, __m512 d1) {
+    store_u8x16_signed(y +  0, _mm256_castsi256_si128(q), (__mmask16) signs, d0);
+    store_u8x16_signed(y + 16, _mm256_extracti128_si256(q, 1), (__mmask16) (signs >> 16), d1);
+}
+
+// 16 signed bytes -> y[0..15] = d * (q + delta), delta given per lane
+static inline void store_i8x16_offset(float * GGML_RESTRICT y, __m128i q, __m512 delta, __m512 d) {
+    const __m512 v = _mm512_add_ps(_mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(q)), delta);
+    _mm512_storeu_ps(y, _mm512_mul_ps(d, v));
+}
+
+// Four sign bytes looked up from the 7-bit indices packed in the low 28 bits of aux
+static inline uint32_t ksigns_x4(uint32_t aux) {
+    return (uint32_t) ksigns_iq2xs[(aux >>  0) & 127]       | (uint32_t) ksigns_iq2xs[(aux >>  7) & 127] <<  8 |
+           (uint32_t) ksigns_iq2xs[(aux >> 14) & 127] << 16 | (uint32_t) ksigns_iq2xs[(aux >> 21) & 127] << 24;
+}
+
+// Base-3 digit n of each of 16 bytes, minus one (see the AVX2 version)
+static inline __m128i ternary_digits(__m128i q, __m256i pow3) {
+    __m256i t = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(q), pow3);
+    t = _mm256_and_si256(t, _mm256_set1_epi16(0xFF));
+    t = _mm256_srli_epi16(_mm256_mullo_epi16(t, _mm256_set1_epi16(3)), 8);
+    return _mm256_cvtepi16_epi8(_mm256_sub_epi16(t, _mm256_set1_epi16(1)));
+}
+
+// ============================================================================
+// Basic types
+// ============================================================================
+
+void dequantize_row_q4_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q4_0 * GGML_RESTRICT x = vx;
+    assert(k % QK4_0 == 0);
+    const int64_t nb = k / QK4_0;
+
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m512i offset = _mm512_set1_epi32(8);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const __m512 d = _mm512_set1_ps(_cvtsh_ss(x[i].d));
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_and_si128(qs, mask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(qs, 4), mask);
+
+        store_scaled(y +  0, _mm512_sub_epi32(_mm512_cvtepu8_epi32(lo), offset), d);
+        store_scaled(y + 16, _mm512_sub_epi32(_mm512_cvtepu8_epi32(hi), offset), d);
+        y += QK4_0;
+    }
+}
+
+void dequantize_row_q4_1_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q4_1 * GGML_RESTRICT x = vx;
+    assert(k % QK4_1 == 0);
+    const int64_t nb = k / QK4_1;
+
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const __m512 d = _mm512_set1_ps(_cvtsh_ss(x[i].d));
+        const __m512 m = _mm512_set1_ps(_cvtsh_ss(x[i].m));
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_and_si128(qs, mask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(qs, 4), mask);
+
+        store_scaled_add(y +  0, _mm512_cvtepu8_epi32(lo), d, m);
+        store_scaled_add(y + 16, _mm512_cvtepu8_epi32(hi), d, m);
+        y += QK4_1;
+    }
+}
+
+void dequantize_row_q5_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q5_0 * GGML_RESTRICT x = vx;
+    assert(k % QK5_0 == 0);
+    const int64_t nb = k / QK5_0;
+
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m512i sixteen = _mm512_set1_epi32(16);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const __m512 d = _mm512_set1_ps(_cvtsh_ss(x[i].d));
+        uint32_t qh;
+        memcpy(&qh, x[i].qh, sizeof(qh));
+
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m512i lo = _mm512_cvtepu8_epi32(_mm_and_si128(qs, mask));
+        const __m512i hi = _mm512_cvtepu8_epi32(_mm_and_si128(_mm_srli_epi16(qs, 4), mask));
+
+        // Bit e of qh is the fifth bit of element e, which maps directly onto a lane mask
+        const __m512i q0 = _mm512_mask_add_epi32(lo, (__mmask16) (qh & 0xFFFF), lo, sixteen);
+        const __m512i q1 = _mm512_mask_add_epi32(hi, (__mmask16) (qh >> 16), hi, sixteen);
+
+        store_scaled(y +  0, _mm512_sub_epi32(q0, sixteen), d);
+        store_scaled(y + 16, _mm512_sub_epi32(q1, sixteen), d);
+        y += QK5_0;
+    }
+}
+
+void dequantize_row_q5_1_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q5_1 * GGML_RESTRICT x = vx;
+    assert(k % QK5_1 == 0);
+    const int64_t nb = k / QK5_1;
+
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m512i sixteen = _mm512_set1_epi32(16);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const __m512 d = _mm512_set1_ps(_cvtsh_ss(x[i].d));
+        const __m512 m = _mm512_set1_ps(_cvtsh_ss(x[i].m));
+        uint32_t qh;
+        memcpy(&qh, x[i].qh, sizeof(qh));
+
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m512i lo = _mm512_cvtepu8_epi32(_mm_and_si128(qs, mask));
+        const __m512i hi = _mm512_cvtepu8_epi32(_mm_and_si128(_mm_srli_epi16(qs, 4), mask));
+
+        const __m512i q0 = _mm512_mask_add_epi32(lo, (__mmask16) (qh & 0xFFFF), lo, sixteen);
+        const __m512i q1 = _mm512_mask_add_epi32(hi, (__mmask16) (qh >> 16), hi, sixteen);
+
+        store_scaled_add(y +  0, q0, d, m);
+        store_scaled_add(y + 16, q1, d, m);
+        y += QK5_1;
+    }
+}
+
+void dequantize_row_q8_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q8_0 * GGML_RESTRICT x = vx;
+    assert(k % QK8_0 == 0);
+    const int64_t nb = k / QK8_0;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        store_i8x16(y +  0, _mm_loadu_si128((const __m128i *) (x[i].qs +  0)), d);
+        store_i8x16(y + 16, _mm_loadu_si128((const __m128i *) (x[i].qs + 16)), d);
+        y += QK8_0;
+    }
+}
+
+void dequantize_row_q8_1_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q8_1 * GGML_RESTRICT x = vx;
+    assert(k % QK8_1 == 0);
+    const int64_t nb = k / QK8_1;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        store_i8x16(y +  0, _mm_loadu_si128((const __m128i *) (x[i].qs +  0)), d);
+        store_i8x16(y + 16, _mm_loadu_si128((const __m128i *) (x[i].qs + 16)), d);
+        y += QK8_1;
+    }
+}
+
+void dequantize_row_mxfp4_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_mxfp4 * GGML_RESTRICT x = vx;
+    assert(k % QK_MXFP4 == 0);
+    const int64_t nb = k / QK_MXFP4;
+
+    const __m128i values = _mm_loadu_si128((const __m128i *) kvalues_mxfp4);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = GGML_E8M0_TO_FP32_HALF(x[i].e);
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_shuffle_epi8(values, _mm_and_si128(qs, mask));
+        const __m128i hi = _mm_shuffle_epi8(values, _mm_and_si128(_mm_srli_epi16(qs, 4), mask));
+
+        store_i8x16(y +  0, lo, d);
+        store_i8x16(y + 16, hi, d);
+        y += QK_MXFP4;
+    }
+}
+
+// ============================================================================
+// K-quants
+// ============================================================================
+
+void dequantize_row_q2_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q2_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m128i mask = _mm_set1_epi8(0x03);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const float min = _cvtsh_ss(x[i].dmin);
+
+        const uint8_t * q = x[i].qs;
+        const uint8_t * sc = x[i].scales;
+
+        for (int n = 0; n < QK_K; n += 128) {
+            const __m128i q0 = _mm_loadu_si128((const __m128i *) (q +  0));
+            const __m128i q1 = _mm_loadu_si128((const __m128i *) (q + 16));
+            for (int shift = 0; shift < 8; shift += 2) {
+                const __m128i count = _mm_cvtsi32_si128(shift);
+                store_u8x16_sub(y +  0, _mm_and_si128(_mm_srl_epi16(q0, count), mask),
+                                d * (sc[0] & 0xF), min * (sc[0] >> 4));
+                store_u8x16_sub(y + 16, _mm_and_si128(_mm_srl_epi16(q1, count), mask),
+                                d * (sc[1] & 0xF), min * (sc[1] >> 4));
+                y += 32;
+                sc += 2;
+            }
+            q += 32;
+        }
+    }
+}
+
+void dequantize_row_q3_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q3_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m256i mask = _mm256_set1_epi8(0x03);
+    const __m256i four = _mm256_set1_epi8(4);
+
+    int8_t scales[16];
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d_all = _cvtsh_ss(x[i].d);
+
+        const uint8_t * GGML_RESTRICT q = x[i].qs;
+        const __m256i hm = _mm256_loadu_si256((const __m256i *) x[i].hmask);
+
+        unpack_scales_q3_K(x[i].scales, scales);
+
+        int is = 0;
+        int m = 1;
+        for (int n = 0; n < QK_K; n += 128) {
+            const __m256i qs = _mm256_loadu_si256((const __m256i *) q);
+            for (int shift = 0; shift < 8; shift += 2) {
+                const __m256i low = _mm256_and_si256(_mm256_srl_epi16(qs, _mm_cvtsi32_si128(shift)), mask);
+                // Subtract 4 wherever the high bit is clear
+                const __mmask32 clear = _mm256_testn_epi8_mask(hm, _mm256_set1_epi8((char) m));
+                const __m256i v = _mm256_mask_sub_epi8(low, clear, low, four);
+
+                store_i8x16(y +  0, _mm256_castsi256_si128(v), d_all * (scales[is + 0] - 32));
+                store_i8x16(y + 16, _mm256_extracti128_si256(v, 1), d_all * (scales[is + 1] - 32));
+                y += 32;
+                is += 2;
+                m <<= 1;
+            }
+            q += 32;
+        }
+    }
+}
+
+void dequantize_row_q4_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q4_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const uint8_t * q = x[i].qs;
+
+        const float d   = _cvtsh_ss(x[i].d);
+        const float min = _cvtsh_ss(x[i].dmin);
+
+        int is = 0;
+        uint8_t sc, m;
+        for (int j = 0; j < QK_K; j += 64) {
+            get_scale_min_k4(is + 0, x[i].scales, &sc, &m);
+            const float d1 = d * sc; const float m1 = min * m;
+            get_scale_min_k4(is + 1, x[i].scales, &sc, &m);
+            const float d2 = d * sc; const float m2 = min * m;
+
+            const __m256i qs = _mm256_loadu_si256((const __m256i *) q);
+            store_u8x32_sub(y +  0, _mm256_and_si256(qs, mask), d1, m1);
+            store_u8x32_sub(y + 32, _mm256_and_si256(_mm256_srli_epi16(qs, 4), mask), d2, m2);
+            y += 64;
+            q += 32; is += 2;
+        }
+    }
+}
+
+void dequantize_row_q5_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q5_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    const __m256i sixteen = _mm256_set1_epi8(16);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const uint8_t * ql = x[i].qs;
+        const __m256i qh = _mm256_loadu_si256((const __m256i *) x[i].qh);
+
+        const float d = _cvtsh_ss(x[i].d);
+        const float min = _cvtsh_ss(x[i].dmin);
+
+        int is = 0;
+        uint8_t sc, m;
+        int u1 = 1, u2 = 2;
+        for (int j = 0; j < QK_K; j += 64) {
+            get_scale_min_k4(is + 0, x[i].scales, &sc, &m);
+            const float d1 = d * sc; const float m1 = min * m;
+            get_scale_min_k4(is + 1, x[i].scales, &sc, &m);
+            const float d2 = d * sc; const float m2 = min * m;
+
+            const __m256i qs = _mm256_loadu_si256((const __m256i *) ql);
+            const __m256i lo = _mm256_and_si256(qs, mask);
+            const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(qs, 4), mask);
+            const __mmask32 set1 = _mm256_test_epi8_mask(qh, _mm256_set1_epi8((char) u1));
+            const __mmask32 set2 = _mm256_test_epi8_mask(qh, _mm256_set1_epi8((char) u2));
+
+            store_u8x32_sub(y +  0, _mm256_mask_add_epi8(lo, set1, lo, sixteen), d1, m1);
+            store_u8x32_sub(y + 32, _mm256_mask_add_epi8(hi, set2, hi, sixteen), d2, m2);
+            y += 64;
+            ql += 32; is += 2;
+            u1 <<= 2; u2 <<= 2;
+        }
+    }
+}
+
+void dequantize_row_q6_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q6_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m256i mask_lo = _mm256_set1_epi8(0x0F);
+    const __m256i mask_hi = _mm256_set1_epi8(0x03);
+    const __m256i offset = _mm256_set1_epi8(32);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+
+        const uint8_t * GGML_RESTRICT ql = x[i].ql;
+        const uint8_t * GGML_RESTRICT qh = x[i].qh;
+        const int8_t  * GGML_RESTRICT sc = x[i].scales;
+
+        for (int n = 0; n < QK_K; n += 128) {
+            const __m256i l0 = _mm256_loadu_si256((const __m256i *) (ql +  0));
+            const __m256i l1 = _mm256_loadu_si256((const __m256i *) (ql + 32));
+            const __m256i h  = _mm256_loadu_si256((const __m256i *) qh);
+
+            const __m256i h0 = _mm256_slli_epi16(_mm256_and_si256(h, mask_hi), 4);
+            const __m256i h1 = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(h, 2), mask_hi), 4);
+            const __m256i h2 = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(h, 4), mask_hi), 4);
+            const __m256i h3 = _mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(h, 6), mask_hi), 4);
+
+            const __m256i q[4] = {
+                _mm256_sub_epi8(_mm256_or_si256(_mm256_and_si256(l0, mask_lo), h0), offset),
+                _mm256_sub_epi8(_mm256_or_si256(_mm256_and_si256(l1, mask_lo), h1), offset),
+                _mm256_sub_epi8(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(l0, 4), mask_lo), h2), offset),
+                _mm256_sub_epi8(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(l1, 4), mask_lo), h3), offset),
+            };
+
+            for (int j = 0; j < 4; ++j) {
+                store_i8x16(y + 32*j +  0, _mm256_castsi256_si128(q[j]), d * sc[2*j + 0]);
+                store_i8x16(y + 32*j + 16, _mm256_extracti128_si256(q[j], 1), d * sc[2*j + 1]);
+            }
+            y  += 128;
+            ql += 64;
+            qh += 32;
+            sc += 8;
+        }
+    }
+}
+
+void dequantize_row_q8_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q8_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        for (int j = 0; j < QK_K; j += 16) {
+            store_i8x16(y + j, _mm_loadu_si128((const __m128i *) (x[i].qs + j)), x[i].d);
+        }
+        y += QK_K;
+    }
+}
+
+// ============================================================================
+// IQ types
+// ============================================================================
+
+void dequantize_row_iq4_nl_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq4_nl * GGML_RESTRICT x = vx;
+    assert(k % QK4_NL == 0);
+    const int64_t nb = k / QK4_NL;
+
+    const __m128i values = _mm_loadu_si128((const __m128i *) kvalues_iq4nl);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const __m128i qs = _mm_loadu_si128((const __m128i *) x[i].qs);
+        const __m128i lo = _mm_shuffle_epi8(values, _mm_and_si128(qs, mask));
+        const __m128i hi = _mm_shuffle_epi8(values, _mm_and_si128(_mm_srli_epi16(qs, 4), mask));
+
+        store_i8x16(y +  0, lo, d);
+        store_i8x16(y + 16, hi, d);
+        y += QK4_NL;
+    }
+}
+
+void dequantize_row_iq4_xs_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq4_xs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m128i values = _mm_loadu_si128((const __m128i *) kvalues_iq4nl);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+
+        for (int ib = 0; ib < QK_K/32; ++ib) {
+            const int ls = ((x[i].scales_l[ib/2] >> 4*(ib%2)) & 0xf) | (((x[i].scales_h >> 2*ib) & 3) << 4);
+            const float dl = d * (ls - 32);
+            const __m128i q = _mm_loadu_si128((const __m128i *) qs);
+            store_i8x16(y +  0, _mm_shuffle_epi8(values, _mm_and_si128(q, mask)), dl);
+            store_i8x16(y + 16, _mm_shuffle_epi8(values, _mm_and_si128(_mm_srli_epi16(q, 4), mask)), dl);
+            y  += 32;
+            qs += 16;
+        }
+    }
+}
+
+// Grid points are gathered as in the AVX2 kernels; the stored or looked-up
+// sign bits are used directly as the blend mask.
+
+void dequantize_row_iq2_xxs_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq2_xxs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            uint32_t aux32[2];
+            memcpy(aux32, x[i].qs + 4*ib32, sizeof(aux32));
+            const __m512 db = _mm512_set1_ps(d * (0.5f + (aux32[1] >> 28)) * 0.25f);
+            const __m128i idx = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int) aux32[0]));
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq2xxs_grid, idx, 8);
+            store_grid32_signed(y, q, ksigns_x4(aux32[1]), db, db);
+            y += 32;
+        }
+    }
+}
+
+void dequantize_row_iq2_xs_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq2_xs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m128i index_mask = _mm_set1_epi32(511);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            const uint16_t * qs = x[i].qs + 4*ib32;
+            const __m512 db0 = _mm512_set1_ps(d * (0.5f + (x[i].scales[ib32] & 0xf)) * 0.25f);
+            const __m512 db1 = _mm512_set1_ps(d * (0.5f + (x[i].scales[ib32] >>  4)) * 0.25f);
+            const __m128i packed = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *) qs));
+            const __m128i idx = _mm_and_si128(packed, index_mask);
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq2xs_grid, idx, 8);
+            const uint32_t signs = (uint32_t) ksigns_iq2xs[qs[0] >> 9]       | (uint32_t) ksigns_iq2xs[qs[1] >> 9] <<  8 |
+                                   (uint32_t) ksigns_iq2xs[qs[2] >> 9] << 16 | (uint32_t) ksigns_iq2xs[qs[3] >> 9] << 24;
+            store_grid32_signed(y, q, signs, db0, db1);
+            y += 32;
+        }
+    }
+}
+
+void dequantize_row_iq2_s_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq2_s * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    // Bits 2l..2l+1 of qh land in bits 8..9 of index l
+    const __m128i high_shift = _mm_setr_epi32(8, 6, 4, 2);
+    const __m128i high_mask = _mm_set1_epi32(0x300);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * signs = qs + QK_K/8;
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            const __m512 db0 = _mm512_set1_ps(d * (0.5f + (x[i].scales[ib32] & 0xf)) * 0.25f);
+            const __m512 db1 = _mm512_set1_ps(d * (0.5f + (x[i].scales[ib32] >>  4)) * 0.25f);
+            uint32_t low, sign_bits;
+            memcpy(&low, qs, sizeof(low));
+            memcpy(&sign_bits, signs, sizeof(sign_bits));
+            const __m128i high = _mm_sllv_epi32(_mm_set1_epi32(x[i].qh[ib32]), high_shift);
+            const __m128i idx = _mm_or_si128(_mm_cvtepu8_epi32(_mm_cvtsi32_si128((int) low)),
+                                             _mm_and_si128(high, high_mask));
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq2s_grid, idx, 8);
+            store_grid32_signed(y, q, sign_bits, db0, db1);
+            y += 32;
+            qs += 4;
+            signs += 4;
+        }
+    }
+}
+
+void dequantize_row_iq3_xxs_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq3_xxs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * scales_and_signs = qs + QK_K/4;
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            uint32_t aux32;
+            memcpy(&aux32, scales_and_signs + 4*ib32, sizeof(aux32));
+            const __m512 db = _mm512_set1_ps(d * (0.5f + (aux32 >> 28)) * 0.5f);
+            const __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) qs));
+            const __m256i q = _mm256_i32gather_epi32((const int *) iq3xxs_grid, idx, 4);
+            store_grid32_signed(y, q, ksigns_x4(aux32), db, db);
+            y += 32;
+            qs += 8;
+        }
+    }
+}
+
+void dequantize_row_iq3_s_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq3_s * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    // Bit j of qh lands in bit 8 of index j
+    const __m256i high_shift = _mm256_setr_epi32(8, 7, 6, 5, 4, 3, 2, 1);
+    const __m256i high_mask = _mm256_set1_epi32(256);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * signs = x[i].signs;
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            const __m512 db = _mm512_set1_ps(d * (1 + 2*((x[i].scales[ib32/2] >> 4*(ib32%2)) & 0xf)));
+            uint32_t sign_bits;
+            memcpy(&sign_bits, signs, sizeof(sign_bits));
+            const __m256i high = _mm256_sllv_epi32(_mm256_set1_epi32(x[i].qh[ib32]), high_shift);
+            const __m256i idx = _mm256_or_si256(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) qs)),
+                                                _mm256_and_si256(high, high_mask));
+            const __m256i q = _mm256_i32gather_epi32((const int *) iq3s_grid, idx, 4);
+            store_grid32_signed(y, q, sign_bits, db, db);
+            y += 32;
+            qs += 8;
+            signs += 4;
+        }
+    }
+}
+
+void dequantize_row_iq1_s_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq1_s * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    // Bits 3l..3l+2 of qh land in bits 8..10 of index l
+    const __m128i high_shift = _mm_setr_epi32(0, 3, 6, 9);
+    const __m128i high_mask = _mm_set1_epi32(0x700);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const uint8_t * qs = x[i].qs;
+
+        for (int ib = 0; ib < QK_K/32; ++ib) {
+            const uint16_t qh = x[i].qh[ib];
+            const __m512 dl = _mm512_set1_ps(d * (2*((qh >> 12) & 7) + 1));
+            const __m512 delta = _mm512_set1_ps(qh & 0x8000 ? -IQ1S_DELTA : IQ1S_DELTA);
+            uint32_t low;
+            memcpy(&low, qs, sizeof(low));
+            const __m128i high = _mm_srlv_epi32(_mm_set1_epi32(qh << 8), high_shift);
+            const __m128i idx = _mm_or_si128(_mm_cvtepu8_epi32(_mm_cvtsi32_si128((int) low)),
+                                             _mm_and_si128(high, high_mask));
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq1s_grid, idx, 8);
+            store_i8x16_offset(y +  0, _mm256_castsi256_si128(q), delta, dl);
+            store_i8x16_offset(y + 16, _mm256_extracti128_si256(q, 1), delta, dl);
+            y += 32;
+            qs += 4;
+        }
+    }
+}
+
+void dequantize_row_iq1_m_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq1_m * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    // Nibble l of the two qh bytes, read as one 16-bit word, lands in bits 8..10 of index l
+    const __m128i high_shift = _mm_setr_epi32(0, 4, 8, 12);
+    const __m128i high_mask = _mm_set1_epi32(0x700);
+
+    for (int64_t i = 0; i < nb; i++) {
+        uint16_t sc[4];
+        memcpy(sc, x[i].scales, sizeof(sc));
+        const float d = _cvtsh_ss(iq1m_scale(sc));
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * qh = x[i].qh;
+
+        for (int ib = 0; ib < QK_K/32; ++ib) {
+            const __m512 dl1 = _mm512_set1_ps(d * (2*((sc[ib/2] >> (6*(ib%2)+0)) & 0x7) + 1));
+            const __m512 dl2 = _mm512_set1_ps(d * (2*((sc[ib/2] >> (6*(ib%2)+3)) & 0x7) + 1));
+            // Bit 3 of each qh nibble negates the delta of its 8 values
+            const __mmask16 neg1 = (qh[0] & 0x08 ? 0x00FF : 0) | (qh[0] & 0x80 ? 0xFF00 : 0);
+            const __mmask16 neg2 = (qh[1] & 0x08 ? 0x00FF : 0) | (qh[1] & 0x80 ? 0xFF00 : 0);
+            const __m512 delta = _mm512_set1_ps(IQ1M_DELTA);
+            uint32_t low;
+            memcpy(&low, qs, sizeof(low));
+            const __m128i high = _mm_srlv_epi32(_mm_set1_epi32((qh[0] | qh[1] << 8) << 8), high_shift);
+            const __m128i idx = _mm_or_si128(_mm_cvtepu8_epi32(_mm_cvtsi32_si128((int) low)),
+                                             _mm_and_si128(high, high_mask));
+            const __m256i q = _mm256_i32gather_epi64((const long long *) iq1s_grid, idx, 8);
+            store_i8x16_offset(y +  0, _mm256_castsi256_si128(q), _mm512_mask_blend_ps(neg1, delta, _mm512_set1_ps(-IQ1M_DELTA)), dl1);
+            store_i8x16_offset(y + 16, _mm256_extracti128_si256(q, 1), _mm512_mask_blend_ps(neg2, delta, _mm512_set1_ps(-IQ1M_DELTA)), dl2);
+            y += 32;
+            qs += 4;
+            qh += 2;
+        }
+    }
+}
+
+// ============================================================================
+// Ternary types
+// ============================================================================
+
+void dequantize_row_tq1_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_tq1_0 * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    static const uint16_t pow3[5] = {1, 3, 9, 27, 81};
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+        const __m128i q0 = _mm_loadu_si128((const __m128i *) (x[i].qs +  0));
+        const __m128i q1 = _mm_loadu_si128((const __m128i *) (x[i].qs + 16));
+        const __m128i q2 = _mm_loadu_si128((const __m128i *) (x[i].qs + 32));
+
+        for (int n = 0; n < 5; ++n) {
+            const __m256i p = _mm256_set1_epi16((short) pow3[n]);
+            store_i8x16(y +  0, ternary_digits(q0, p), d);
+            store_i8x16(y + 16, ternary_digits(q1, p), d);
+            y += 32;
+        }
+        for (int n = 0; n < 5; ++n) {
+            store_i8x16(y, ternary_digits(q2, _mm256_set1_epi16((short) pow3[n])), d);
+            y += 16;
+        }
+
+        // The four qh bytes, repeated once per digit in output order
+        uint32_t qh;
+        memcpy(&qh, x[i].qh, sizeof(qh));
+        const __m256i p = _mm256_setr_epi16(1, 1, 1, 1, 3, 3, 3, 3, 9, 9, 9, 9, 27, 27, 27, 27);
+        store_i8x16(y, ternary_digits(_mm_set1_epi32((int) qh), p), d);
+        y += 16;
+    }
+}
+
+void dequantize_row_tq2_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_tq2_0 * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const __m128i mask = _mm_set1_epi8(0x03);
+    const __m128i one = _mm_set1_epi8(1);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = _cvtsh_ss(x[i].d);
+
+        for (int j = 0; j < QK_K/4; j += 32) {
+            const __m128i q0 = _mm_loadu_si128((const __m128i *) (x[i].qs + j +  0));
+            const __m128i q1 = _mm_loadu_si128((const __m128i *) (x[i].qs + j + 16));
+            for (int l = 0; l < 4; ++l) {
+                const __m128i count = _mm_cvtsi32_si128(2*l);
+                store_i8x16(y +  0, _mm_sub_epi8(_mm_and_si128(_mm_srl_epi16(q0, count), mask), one), d);
+                store_i8x16(y + 16, _mm_sub_epi8(_mm_and_si128(_mm_srl_epi16(q1, count), mask), one), d);
+                y += 32;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Dot products
+// ============================================================================
+
+// The integer dot products reuse the AVX2 kernels; only the f32 dot gains
+// from the wider registers without VNNI.
+float ggml_vec_dot_f32_avx512(const float * GGML_RESTRICT x, const float * GGML_RESTRICT y, int64_t n) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps();
+    __m512 acc3 = _mm512_setzero_ps();
+
+    int64_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        acc0 = _mm512_add_ps(acc0, _mm512_mul_ps(_mm512_loadu_ps(x + i +  0), _mm512_loadu_ps(y + i +  0)));
+        acc1 = _mm512_add_ps(acc1, _mm512_mul_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16)));
+        acc2 = _mm512_add_ps(acc2, _mm512_mul_ps(_mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(y + i + 32)));
+        acc3 = _mm512_add_ps(acc3, _mm512_mul_ps(_mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(y + i + 48)));
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_add_ps(acc0, _mm512_mul_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+    }
+
+    float sum = _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+    for (; i < n; ++i) {
+        sum += x[i]*y[i];
+    }
+    return sum;
+}
+
+// ============================================================================
+// Half precision output
+// ============================================================================
+
+void ggml_fp32_to_fp16_row_avx512(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n) {
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512 v = _mm512_loadu_ps(x + i);
+        // The hardware keeps NaN payloads, the scalar encoder does not
+        if (_mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q)) {
+            ggml_fp32_to_fp16_row_ref(x + i, y + i, 16);
+            continue;
+        }
+        _mm256_storeu_si256((__m256i *) (y + i), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    }
+    ggml_fp32_to_fp16_row_ref(x + i, y + i, n - i);
+}
+
+// Integer rounding rather than AVX512-BF16's vcvtneps2bf16, which flushes
+// denormal inputs to zero and would not match the scalar reference.
+void ggml_fp32_to_bf16_row_avx512(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n) {
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i round_bias = _mm512_set1_epi32(0x7FFF);
+    const __m512i abs_mask = _mm512_set1_epi32(0x7FFFFFFF);
+    const __m512i inf = _mm512_set1_epi32(0x7F800000);
+    const __m512i quiet = _mm512_set1_epi32(64);
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i w = _mm512_loadu_si512(x + i);
+        const __m512i hi = _mm512_srli_epi32(w, 16);
+        const __m512i bias = _mm512_add_epi32(round_bias, _mm512_and_si512(hi, one));
+        const __m512i rounded = _mm512_srli_epi32(_mm512_add_epi32(w, bias), 16);
+        const __mmask16 nan = _mm512_cmpgt_epi32_mask(_mm512_and_si512(w, abs_mask), inf);
+        const __m512i h = _mm512_mask_blend_epi32(nan, rounded, _mm512_or_si512(hi, quiet));
+        _mm256_storeu_si256((__m256i *) (y + i), _mm512_cvtepi32_epi16(h));
+    }
+    ggml_fp32_to_bf16_row_ref(x + i, y + i, n - i);
+}
+
+// ============================================================================
+// Element conversion
+// ============================================================================
+
+void ggml_fp16_to_fp32_row_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(y + i, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i *) (x + i*2))));
+    }
+    ggml_fp16_to_fp32_row(x + i*2, y + i, n - i);
+}
+
+void ggml_bf16_to_fp32_row_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i w = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *) (x + i*2)));
+        _mm512_storeu_si512(y + i, _mm512_slli_epi32(w, 16));
+    }
+    ggml_bf16_to_fp32_row(x + i*2, y + i, n - i);
+}
+
+void ggml_f64_to_fp32_row_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm256_storeu_ps(y + i + 0, _mm512_cvtpd_ps(_mm512_loadu_pd(x + i*8 + 0)));
+        _mm256_storeu_ps(y + i + 8, _mm512_cvtpd_ps(_mm512_loadu_pd(x + i*8 + 64)));
+    }
+    ggml_f64_to_fp32_row_ref(x + i*8, y + i, n - i);
+}
+
+void ggml_i8_to_fp32_row_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i q = _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *) (x + i)));
+        _mm512_storeu_ps(y + i, _mm512_cvtepi32_ps(q));
+    }
+    ggml_i8_to_fp32_row_ref(x + i, y + i, n - i);
+}
+
+void ggml_i16_to_fp32_row_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i q = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *) (x + i*2)));
+        _mm512_storeu_ps(y + i, _mm512_cvtepi32_ps(q));
+    }
+    ggml_i16_to_fp32_row_ref(x + i*2, y + i, n - i);
+}
+
+void ggml_i32_to_fp32_row_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(y + i, _mm512_cvtepi32_ps(_mm512_loadu_si512(x + i*4)));
+    }
+    ggml_i32_to_fp32_row_ref(x + i*4, y + i, n - i);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // GGML_SIMD_X86
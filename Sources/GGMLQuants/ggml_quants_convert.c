@@ -0,0 +1,54 @@
+/*
+ * GGML Conversion - Plain element types
+ *
+ * Scalar f64 and integer row widenings to f32. Inputs come straight from
+ * tensor data and may sit at any address, so elements are read with memcpy.
+ * Conversions round to nearest even like a C cast.
+ */
+
+#include "ggml_quants_impl.h"
+
+#include <string.h>
+
+void ggml_f64_to_fp32_row_ref(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    for (int64_t i = 0; i < n; ++i) {
+        double v;
+        memcpy(&v, x + i*sizeof(v), sizeof(v));
+        y[i] = (float) v;
+    }
+}
+
+void ggml_i8_to_fp32_row_ref(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const int8_t * x = vx;
+    for (int64_t i = 0; i < n; ++i) {
+        y[i] = (float) x[i];
+    }
+}
+
+void ggml_i16_to_fp32_row_ref(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    for (int64_t i = 0; i < n; ++i) {
+        int16_t v;
+        memcpy(&v, x + i*sizeof(v), sizeof(v));
+        y[i] = (float) v;
+    }
+}
+
+void ggml_i32_to_fp32_row_ref(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    for (int64_t i = 0; i < n; ++i) {
+        int32_t v;
+        memcpy(&v, x + i*sizeof(v), sizeof(v));
+        y[i] = (float) v;
+    }
+}
+
+void ggml_i64_to_fp32_row_ref(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    for (int64_t i = 0; i < n; ++i) {
+        int64_t v;
+        memcpy(&v, x + i*sizeof(v), sizeof(v));
+        y[i] = (float) v;
+    }
+}
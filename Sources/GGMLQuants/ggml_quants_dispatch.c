@@ -0,0 +1,865 @@
+/*
+ * GGML Dequantization - Runtime CPU dispatch
+ *
+ * Selects the widest SIMD kernel set supported by the host and routes the
+ * public dequantize_row_* entry points to it.
+ */
+
+#include "ggml_quants_impl.h"
+
+#include <stdatomic.h>
+
+// ============================================================================
+// Kernel tables
+// ============================================================================
+
+static const ggml_dequantize_kernels kernels_scalar = {
+    .q4_0    = (ggml_dequantize_row_t) dequantize_row_q4_0_ref,
+    .q4_1    = (ggml_dequantize_row_t) dequantize_row_q4_1_ref,
+    .q5_0    = (ggml_dequantize_row_t) dequantize_row_q5_0_ref,
+    .q5_1    = (ggml_dequantize_row_t) dequantize_row_q5_1_ref,
+    .q8_0    = (ggml_dequantize_row_t) dequantize_row_q8_0_ref,
+    .q8_1    = (ggml_dequantize_row_t) dequantize_row_q8_1_ref,
+    .q2_K    = (ggml_dequantize_row_t) dequantize_row_q2_K_ref,
+    .q3_K    = (ggml_dequantize_row_t) dequantize_row_q3_K_ref,
+    .q4_K    = (ggml_dequantize_row_t) dequantize_row_q4_K_ref,
+    .q5_K    = (ggml_dequantize_row_t) dequantize_row_q5_K_ref,
+    .q6_K    = (ggml_dequantize_row_t) dequantize_row_q6_K_ref,
+    .q8_K    = (ggml_dequantize_row_t) dequantize_row_q8_K_ref,
+    .iq4_nl  = (ggml_dequantize_row_t) dequantize_row_iq4_nl_ref,
+    .iq2_xxs = (ggml_dequantize_row_t) dequantize_row_iq2_xxs_ref,
+    .iq2_xs  = (ggml_dequantize_row_t) dequantize_row_iq2_xs_ref,
+    .iq2_s   = (ggml_dequantize_row_t) dequantize_row_iq2_s_ref,
+    .iq3_xxs = (ggml_dequantize_row_t) dequantize_row_iq3_xxs_ref,
+    .iq3_s   = (ggml_dequantize_row_t) dequantize_row_iq3_s_ref,
+    .iq1_s   = (ggml_dequantize_row_t) dequantize_row_iq1_s_ref,
+    .iq1_m   = (ggml_dequantize_row_t) dequantize_row_iq1_m_ref,
+    .iq4_xs  = (ggml_dequantize_row_t) dequantize_row_iq4_xs_ref,
+    .tq1_0   = (ggml_dequantize_row_t) dequantize_row_tq1_0_ref,
+    .tq2_0   = (ggml_dequantize_row_t) dequantize_row_tq2_0_ref,
+    .mxfp4   = (ggml_dequantize_row_t) dequantize_row_mxfp4_ref,
+};
+
+#if defined(GGML_SIMD_ARM_NEON)
+static const ggml_dequantize_kernels kernels_neon = {
+    .q4_0    = dequantize_row_q4_0_neon,
+    .q4_1    = dequantize_row_q4_1_neon,
+    .q5_0    = dequantize_row_q5_0_neon,
+    .q5_1    = dequantize_row_q5_1_neon,
+    .q8_0    = dequantize_row_q8_0_neon,
+    .q8_1    = dequantize_row_q8_1_neon,
+    .q2_K    = dequantize_row_q2_K_neon,
+    .q3_K    = dequantize_row_q3_K_neon,
+    .q4_K    = dequantize_row_q4_K_neon,
+    .q5_K    = dequantize_row_q5_K_neon,
+    .q6_K    = dequantize_row_q6_K_neon,
+    .q8_K    = dequantize_row_q8_K_neon,
+    .iq4_nl  = dequantize_row_iq4_nl_neon,
+    .iq2_xxs = dequantize_row_iq2_xxs_neon,
+    .iq2_xs  = dequantize_row_iq2_xs_neon,
+    .iq2_s   = dequantize_row_iq2_s_neon,
+    .iq3_xxs = dequantize_row_iq3_xxs_neon,
+    .iq3_s   = dequantize_row_iq3_s_neon,
+    .iq1_s   = dequantize_row_iq1_s_neon,
+    .iq1_m   = dequantize_row_iq1_m_neon,
+    .iq4_xs  = dequantize_row_iq4_xs_neon,
+    .tq1_0   = dequantize_row_tq1_0_neon,
+    .tq2_0   = dequantize_row_tq2_0_neon,
+    .mxfp4   = dequantize_row_mxfp4_neon,
+};
+#endif
+
+#if defined(GGML_SIMD_X86)
+static const ggml_dequantize_kernels kernels_avx2 = {
+    .q4_0    = dequantize_row_q4_0_avx2,
+    .q4_1    = dequantize_row_q4_1_avx2,
+    .q5_0    = dequantize_row_q5_0_avx2,
+    .q5_1    = dequantize_row_q5_1_avx2,
+    .q8_0    = dequantize_row_q8_0_avx2,
+    .q8_1    = dequantize_row_q8_1_avx2,
+    .q2_K    = dequantize_row_q2_K_avx2,
+    .q3_K    = dequantize_row_q3_K_avx2,
+    .q4_K    = dequantize_row_q4_K_avx2,
+    .q5_K    = dequantize_row_q5_K_avx2,
+    .q6_K    = dequantize_row_q6_K_avx2,
+    .q8_K    = dequantize_row_q8_K_avx2,
+    .iq4_nl  = dequantize_row_iq4_nl_avx2,
+    .iq2_xxs = dequantize_row_iq2_xxs_avx2,
+    .iq2_xs  = dequantize_row_iq2_xs_avx2,
+    .iq2_s   = dequantize_row_iq2_s_avx2,
+    .iq3_xxs = dequantize_row_iq3_xxs_avx2,
+    .iq3_s   = dequantize_row_iq3_s_avx2,
+    .iq1_s   = dequantize_row_iq1_s_avx2,
+    .iq1_m   = dequantize_row_iq1_m_avx2,
+    .iq4_xs  = dequantize_row_iq4_xs_avx2,
+    .tq1_0   = dequantize_row_tq1_0_avx2,
+    .tq2_0   = dequantize_row_tq2_0_avx2,
+    .mxfp4   = dequantize_row_mxfp4_avx2,
+};
+
+static const ggml_dequantize_kernels kernels_avx512 = {
+    .q4_0    = dequantize_row_q4_0_avx512,
+    .q4_1    = dequantize_row_q4_1_avx512,
+    .q5_0    = dequantize_row_q5_0_avx512,
+    .q5_1    = dequantize_row_q5_1_avx512,
+    .q8_0    = dequantize_row_q8_0_avx512,
+    .q8_1    = dequantize_row_q8_1_avx512,
+    .q2_K    = dequantize_row_q2_K_avx512,
+    .q3_K    = dequantize_row_q3_K_avx512,
+    .q4_K    = dequantize_row_q4_K_avx512,
+    .q5_K    = dequantize_row_q5_K_avx512,
+    .q6_K    = dequantize_row_q6_K_avx512,
+    .q8_K    = dequantize_row_q8_K_avx512,
+    .iq4_nl  = dequantize_row_iq4_nl_avx512,
+    .iq2_xxs = dequantize_row_iq2_xxs_avx512,
+    .iq2_xs  = dequantize_row_iq2_xs_avx512,
+    .iq2_s   = dequantize_row_iq2_s_avx512,
+    .iq3_xxs = dequantize_row_iq3_xxs_avx512,
+    .iq3_s   = dequantize_row_iq3_s_avx512,
+    .iq1_s   = dequantize_row_iq1_s_avx512,
+    .iq1_m   = dequantize_row_iq1_m_avx512,
+    .iq4_xs  = dequantize_row_iq4_xs_avx512,
+    .tq1_0   = dequantize_row_tq1_0_avx512,
+    .tq2_0   = dequantize_row_tq2_0_avx512,
+    .mxfp4   = dequantize_row_mxfp4_avx512,
+};
+#endif
+
+// ============================================================================
+// CPU feature detection
+// ============================================================================
+
+#if defined(GGML_SIMD_X86)
+static bool cpu_has_avx2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+}
+
+static bool cpu_has_avx512(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+           __builtin_cpu_supports("avx512vl");
+}
+#endif
+
+bool ggml_simd_level_available(ggml_simd_level level) {
+    switch (level) {
+        case GGML_SIMD_SCALAR:
+            return true;
+        case GGML_SIMD_NEON:
+#if defined(GGML_SIMD_ARM_NEON)
+            return true;
+#else
+            return false;
+#endif
+        case GGML_SIMD_AVX2:
+#if defined(GGML_SIMD_X86)
+            return cpu_has_avx2();
+#else
+            return false;
+#endif
+        case GGML_SIMD_AVX512:
+#if defined(GGML_SIMD_X86)
+            return cpu_has_avx2() && cpu_has_avx512();
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+// -1 until the first lookup; detection is idempotent so racing initializers are harmless
+static _Atomic int cached_best_level = -1;
+
+ggml_simd_level ggml_simd_level_best(void) {
+    int level = atomic_load_explicit(&cached_best_level, memory_order_relaxed);
+    if (level < 0) {
+        level = GGML_SIMD_SCALAR;
+        for (int candidate = GGML_SIMD_AVX512; candidate > GGML_SIMD_SCALAR; --candidate) {
+            if (ggml_simd_level_available((ggml_simd_level) candidate)) {
+                level = candidate;
+                break;
+            }
+        }
+        atomic_store_explicit(&cached_best_level, level, memory_order_relaxed);
+    }
+    return (ggml_simd_level) level;
+}
+
+const ggml_dequantize_kernels * ggml_get_dequantize_kernels(ggml_simd_level level) {
+    if (!ggml_simd_level_available(level)) {
+        return NULL;
+    }
+    switch (level) {
+        case GGML_SIMD_SCALAR:
+            return &kernels_scalar;
+#if defined(GGML_SIMD_ARM_NEON)
+        case GGML_SIMD_NEON:
+            return &kernels_neon;
+#endif
+#if defined(GGML_SIMD_X86)
+        case GGML_SIMD_AVX2:
+            return &kernels_avx2;
+        case GGML_SIMD_AVX512:
+            return &kernels_avx512;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+// ============================================================================
+// Dispatching entry points
+// ============================================================================
+
+static _Atomic(const ggml_dequantize_kernels *) active_kernels = NULL;
+
+static inline const ggml_dequantize_kernels * get_active_kernels(void) {
+    const ggml_dequantize_kernels * kernels = atomic_load_explicit(&active_kernels, memory_order_acquire);
+    if (kernels == NULL) {
+        kernels = ggml_get_dequantize_kernels(ggml_simd_level_best());
+        atomic_store_explicit(&active_kernels, kernels, memory_order_release);
+    }
+    return kernels;
+}
+
+void dequantize_row_q4_0(const block_q4_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q4_0(x, y, k);
+}
+
+void dequantize_row_q4_1(const block_q4_1 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q4_1(x, y, k);
+}
+
+void dequantize_row_q5_0(const block_q5_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q5_0(x, y, k);
+}
+
+void dequantize_row_q5_1(const block_q5_1 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q5_1(x, y, k);
+}
+
+void dequantize_row_q8_0(const block_q8_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q8_0(x, y, k);
+}
+
+void dequantize_row_q8_1(const block_q8_1 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q8_1(x, y, k);
+}
+
+void dequantize_row_q2_K(const block_q2_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q2_K(x, y, k);
+}
+
+void dequantize_row_q3_K(const block_q3_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q3_K(x, y, k);
+}
+
+void dequantize_row_q4_K(const block_q4_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q4_K(x, y, k);
+}
+
+void dequantize_row_q5_K(const block_q5_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q5_K(x, y, k);
+}
+
+void dequantize_row_q6_K(const block_q6_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q6_K(x, y, k);
+}
+
+void dequantize_row_q8_K(const block_q8_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->q8_K(x, y, k);
+}
+
+void dequantize_row_iq4_nl(const block_iq4_nl * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->iq4_nl(x, y, k);
+}
+
+void dequantize_row_iq2_xxs(const block_iq2_xxs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->iq2_xxs(x, y, k);
+}
+
+void dequantize_row_iq2_xs(const block_iq2_xs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->iq2_xs(x, y, k);
+}
+
+void dequantize_row_iq2_s(const block_iq2_s * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->iq2_s(x, y, k);
+}
+
+void dequantize_row_iq3_xxs(const block_iq3_xxs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->iq3_xxs(x, y, k);
+}
+
+void dequantize_row_iq3_s(const block_iq3_s * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->iq3_s(x, y, k);
+}
+
+void dequantize_row_iq1_s(const block_iq1_s * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->iq1_s(x, y, k);
+}
+
+void dequantize_row_iq1_m(const block_iq1_m * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->iq1_m(x, y, k);
+}
+
+void dequantize_row_iq4_xs(const block_iq4_xs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->iq4_xs(x, y, k);
+}
+
+void dequantize_row_tq1_0(const block_tq1_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->tq1_0(x, y, k);
+}
+
+void dequantize_row_tq2_0(const block_tq2_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->tq2_0(x, y, k);
+}
+
+void dequantize_row_mxfp4(const block_mxfp4 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k) {
+    get_active_kernels()->mxfp4(x, y, k);
+}
+
+// ============================================================================
+// Dot product kernel tables
+// ============================================================================
+
+static const ggml_vec_dot_kernels vec_dot_kernels_scalar = {
+    .f32         = ggml_vec_dot_f32_ref,
+    .q4_0_q8_0   = ggml_vec_dot_q4_0_q8_0_ref,
+    .q4_1_q8_1   = ggml_vec_dot_q4_1_q8_1_ref,
+    .q5_0_q8_0   = ggml_vec_dot_q5_0_q8_0_ref,
+    .q5_1_q8_1   = ggml_vec_dot_q5_1_q8_1_ref,
+    .q8_0_q8_0   = ggml_vec_dot_q8_0_q8_0_ref,
+    .q2_K_q8_K   = ggml_vec_dot_q2_K_q8_K_ref,
+    .q3_K_q8_K   = ggml_vec_dot_q3_K_q8_K_ref,
+    .q4_K_q8_K   = ggml_vec_dot_q4_K_q8_K_ref,
+    .q5_K_q8_K   = ggml_vec_dot_q5_K_q8_K_ref,
+    .q6_K_q8_K   = ggml_vec_dot_q6_K_q8_K_ref,
+    .q8_K_q8_K   = ggml_vec_dot_q8_K_q8_K_ref,
+    .iq4_nl_q8_0 = ggml_vec_dot_iq4_nl_q8_0_ref,
+};
+
+#if defined(GGML_SIMD_ARM_NEON)
+static const ggml_vec_dot_kernels vec_dot_kernels_neon = {
+    .f32         = ggml_vec_dot_f32_neon,
+    .q4_0_q8_0   = ggml_vec_dot_q4_0_q8_0_neon,
+    .q4_1_q8_1   = ggml_vec_dot_q4_1_q8_1_ref,
+    .q5_0_q8_0   = ggml_vec_dot_q5_0_q8_0_ref,
+    .q5_1_q8_1   = ggml_vec_dot_q5_1_q8_1_ref,
+    .q8_0_q8_0   = ggml_vec_dot_q8_0_q8_0_neon,
+    .q2_K_q8_K   = ggml_vec_dot_q2_K_q8_K_ref,
+    .q3_K_q8_K   = ggml_vec_dot_q3_K_q8_K_ref,
+    .q4_K_q8_K   = ggml_vec_dot_q4_K_q8_K_neon,
+    .q5_K_q8_K   = ggml_vec_dot_q5_K_q8_K_ref,
+    .q6_K_q8_K   = ggml_vec_dot_q6_K_q8_K_neon,
+    .q8_K_q8_K   = ggml_vec_dot_q8_K_q8_K_ref,
+    .iq4_nl_q8_0 = ggml_vec_dot_iq4_nl_q8_0_ref,
+};
+#endif
+
+#if defined(GGML_SIMD_X86)
+static const ggml_vec_dot_kernels vec_dot_kernels_avx2 = {
+    .f32         = ggml_vec_dot_f32_avx2,
+    .q4_0_q8_0   = ggml_vec_dot_q4_0_q8_0_avx2,
+    .q4_1_q8_1   = ggml_vec_dot_q4_1_q8_1_ref,
+    .q5_0_q8_0   = ggml_vec_dot_q5_0_q8_0_ref,
+    .q5_1_q8_1   = ggml_vec_dot_q5_1_q8_1_ref,
+    .q8_0_q8_0   = ggml_vec_dot_q8_0_q8_0_avx2,
+    .q2_K_q8_K   = ggml_vec_dot_q2_K_q8_K_ref,
+    .q3_K_q8_K   = ggml_vec_dot_q3_K_q8_K_ref,
+    .q4_K_q8_K   = ggml_vec_dot_q4_K_q8_K_avx2,
+    .q5_K_q8_K   = ggml_vec_dot_q5_K_q8_K_ref,
+    .q6_K_q8_K   = ggml_vec_dot_q6_K_q8_K_avx2,
+    .q8_K_q8_K   = ggml_vec_dot_q8_K_q8_K_ref,
+    .iq4_nl_q8_0 = ggml_vec_dot_iq4_nl_q8_0_ref,
+};
+
+static const ggml_vec_dot_kernels vec_dot_kernels_avx512 = {
+    .f32         = ggml_vec_dot_f32_avx512,
+    .q4_0_q8_0   = ggml_vec_dot_q4_0_q8_0_avx2,
+    .q4_1_q8_1   = ggml_vec_dot_q4_1_q8_1_ref,
+    .q5_0_q8_0   = ggml_vec_dot_q5_0_q8_0_ref,
+    .q5_1_q8_1   = ggml_vec_dot_q5_1_q8_1_ref,
+    .q8_0_q8_0   = ggml_vec_dot_q8_0_q8_0_avx2,
+    .q2_K_q8_K   = ggml_vec_dot_q2_K_q8_K_ref,
+    .q3_K_q8_K   = ggml_vec_dot_q3_K_q8_K_ref,
+    .q4_K_q8_K   = ggml_vec_dot_q4_K_q8_K_avx2,
+    .q5_K_q8_K   = ggml_vec_dot_q5_K_q8_K_ref,
+    .q6_K_q8_K   = ggml_vec_dot_q6_K_q8_K_avx2,
+    .q8_K_q8_K   = ggml_vec_dot_q8_K_q8_K_ref,
+    .iq4_nl_q8_0 = ggml_vec_dot_iq4_nl_q8_0_ref,
+};
+#endif
+
+const ggml_vec_dot_kernels * ggml_get_vec_dot_kernels(ggml_simd_level level) {
+    if (!ggml_simd_level_available(level)) {
+        return NULL;
+    }
+    switch (level) {
+        case GGML_SIMD_SCALAR:
+            return &vec_dot_kernels_scalar;
+#if defined(GGML_SIMD_ARM_NEON)
+        case GGML_SIMD_NEON:
+            return &vec_dot_kernels_neon;
+#endif
+#if defined(GGML_SIMD_X86)
+        case GGML_SIMD_AVX2:
+            return &vec_dot_kernels_avx2;
+        case GGML_SIMD_AVX512:
+            return &vec_dot_kernels_avx512;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+// ============================================================================
+// Interleaved dot product kernel tables
+// ============================================================================
+
+static const ggml_gemv_kernels gemv_kernels_scalar = {
+    .q4_0x4_q8_0 = ggml_gemv_q4_0x4_q8_0_ref,
+    .q4_0x8_q8_0 = ggml_gemv_q4_0x8_q8_0_ref,
+    .q8_0x4_q8_0 = ggml_gemv_q8_0x4_q8_0_ref,
+    .q8_0x8_q8_0 = ggml_gemv_q8_0x8_q8_0_ref,
+    .q4_Kx4_q8_K = ggml_gemv_q4_Kx4_q8_K_ref,
+    .q4_Kx8_q8_K = ggml_gemv_q4_Kx8_q8_K_ref,
+};
+
+#if defined(GGML_SIMD_ARM_NEON)
+static const ggml_gemv_kernels gemv_kernels_neon = {
+    .q4_0x4_q8_0 = ggml_gemv_q4_0x4_q8_0_neon,
+    .q4_0x8_q8_0 = ggml_gemv_q4_0x8_q8_0_ref,
+    .q8_0x4_q8_0 = ggml_gemv_q8_0x4_q8_0_neon,
+    .q8_0x8_q8_0 = ggml_gemv_q8_0x8_q8_0_ref,
+    .q4_Kx4_q8_K = ggml_gemv_q4_Kx4_q8_K_neon,
+    .q4_Kx8_q8_K = ggml_gemv_q4_Kx8_q8_K_ref,
+};
+#endif
+
+#if defined(GGML_SIMD_X86)
+// AVX-512 reuses the AVX2 kernels: eight rows already fill a 256-bit register
+static const ggml_gemv_kernels gemv_kernels_avx2 = {
+    .q4_0x4_q8_0 = ggml_gemv_q4_0x4_q8_0_ref,
+    .q4_0x8_q8_0 = ggml_gemv_q4_0x8_q8_0_avx2,
+    .q8_0x4_q8_0 = ggml_gemv_q8_0x4_q8_0_ref,
+    .q8_0x8_q8_0 = ggml_gemv_q8_0x8_q8_0_avx2,
+    .q4_Kx4_q8_K = ggml_gemv_q4_Kx4_q8_K_ref,
+    .q4_Kx8_q8_K = ggml_gemv_q4_Kx8_q8_K_avx2,
+};
+#endif
+
+const ggml_gemv_kernels * ggml_get_gemv_kernels(ggml_simd_level level) {
+    if (!ggml_simd_level_available(level)) {
+        return NULL;
+    }
+    switch (level) {
+        case GGML_SIMD_SCALAR:
+            return &gemv_kernels_scalar;
+#if defined(GGML_SIMD_ARM_NEON)
+        case GGML_SIMD_NEON:
+            return &gemv_kernels_neon;
+#endif
+#if defined(GGML_SIMD_X86)
+        case GGML_SIMD_AVX2:
+        case GGML_SIMD_AVX512:
+            return &gemv_kernels_avx2;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+// ============================================================================
+// Quantization kernel tables
+// ============================================================================
+
+static const ggml_quantize_kernels quantize_kernels_scalar = {
+    .q4_0   = (ggml_quantize_row_t) quantize_row_q4_0_ref,
+    .q4_1   = (ggml_quantize_row_t) quantize_row_q4_1_ref,
+    .q5_0   = (ggml_quantize_row_t) quantize_row_q5_0_ref,
+    .q5_1   = (ggml_quantize_row_t) quantize_row_q5_1_ref,
+    .q8_0   = (ggml_quantize_row_t) quantize_row_q8_0_ref,
+    .q8_1   = (ggml_quantize_row_t) quantize_row_q8_1_ref,
+    .q2_K   = (ggml_quantize_row_t) quantize_row_q2_K_ref,
+    .q3_K   = (ggml_quantize_row_t) quantize_row_q3_K_ref,
+    .q4_K   = (ggml_quantize_row_t) quantize_row_q4_K_ref,
+    .q5_K   = (ggml_quantize_row_t) quantize_row_q5_K_ref,
+    .q6_K   = (ggml_quantize_row_t) quantize_row_q6_K_ref,
+    .q8_K   = (ggml_quantize_row_t) quantize_row_q8_K_ref,
+    .iq4_nl = (ggml_quantize_row_t) quantize_row_iq4_nl_ref,
+};
+
+#if defined(GGML_SIMD_ARM_NEON)
+static const ggml_quantize_kernels quantize_kernels_neon = {
+    .q4_0   = quantize_row_q4_0_neon,
+    .q4_1   = quantize_row_q4_1_neon,
+    .q5_0   = (ggml_quantize_row_t) quantize_row_q5_0_ref,
+    .q5_1   = (ggml_quantize_row_t) quantize_row_q5_1_ref,
+    .q8_0   = quantize_row_q8_0_neon,
+    .q8_1   = quantize_row_q8_1_neon,
+    .q2_K   = (ggml_quantize_row_t) quantize_row_q2_K_ref,
+    .q3_K   = (ggml_quantize_row_t) quantize_row_q3_K_ref,
+    .q4_K   = (ggml_quantize_row_t) quantize_row_q4_K_ref,
+    .q5_K   = (ggml_quantize_row_t) quantize_row_q5_K_ref,
+    .q6_K   = (ggml_quantize_row_t) quantize_row_q6_K_ref,
+    .q8_K   = quantize_row_q8_K_neon,
+    .iq4_nl = (ggml_quantize_row_t) quantize_row_iq4_nl_ref,
+};
+#endif
+
+#if defined(GGML_SIMD_X86)
+static const ggml_quantize_kernels quantize_kernels_avx2 = {
+    .q4_0   = quantize_row_q4_0_avx2,
+    .q4_1   = quantize_row_q4_1_avx2,
+    .q5_0   = (ggml_quantize_row_t) quantize_row_q5_0_ref,
+    .q5_1   = (ggml_quantize_row_t) quantize_row_q5_1_ref,
+    .q8_0   = quantize_row_q8_0_avx2,
+    .q8_1   = quantize_row_q8_1_avx2,
+    .q2_K   = (ggml_quantize_row_t) quantize_row_q2_K_ref,
+    .q3_K   = (ggml_quantize_row_t) quantize_row_q3_K_ref,
+    .q4_K   = (ggml_quantize_row_t) quantize_row_q4_K_ref,
+    .q5_K   = (ggml_quantize_row_t) quantize_row_q5_K_ref,
+    .q6_K   = (ggml_quantize_row_t) quantize_row_q6_K_ref,
+    .q8_K   = quantize_row_q8_K_avx2,
+    .iq4_nl = (ggml_quantize_row_t) quantize_row_iq4_nl_ref,
+};
+
+// The quantizers are bound by the amax/min search and fp16 stores, so the
+// AVX-512 level shares the AVX2 kernels.
+static const ggml_quantize_kernels quantize_kernels_avx512 = {
+    .q4_0   = quantize_row_q4_0_avx2,
+    .q4_1   = quantize_row_q4_1_avx2,
+    .q5_0   = (ggml_quantize_row_t) quantize_row_q5_0_ref,
+    .q5_1   = (ggml_quantize_row_t) quantize_row_q5_1_ref,
+    .q8_0   = quantize_row_q8_0_avx2,
+    .q8_1   = quantize_row_q8_1_avx2,
+    .q2_K   = (ggml_quantize_row_t) quantize_row_q2_K_ref,
+    .q3_K   = (ggml_quantize_row_t) quantize_row_q3_K_ref,
+    .q4_K   = (ggml_quantize_row_t) quantize_row_q4_K_ref,
+    .q5_K   = (ggml_quantize_row_t) quantize_row_q5_K_ref,
+    .q6_K   = (ggml_quantize_row_t) quantize_row_q6_K_ref,
+    .q8_K   = quantize_row_q8_K_avx2,
+    .iq4_nl = (ggml_quantize_row_t) quantize_row_iq4_nl_ref,
+};
+#endif
+
+const ggml_quantize_kernels * ggml_get_quantize_kernels(ggml_simd_level level) {
+    if (!ggml_simd_level_available(level)) {
+        return NULL;
+    }
+    switch (level) {
+        case GGML_SIMD_SCALAR:
+            return &quantize_kernels_scalar;
+#if defined(GGML_SIMD_ARM_NEON)
+        case GGML_SIMD_NEON:
+            return &quantize_kernels_neon;
+#endif
+#if defined(GGML_SIMD_X86)
+        case GGML_SIMD_AVX2:
+            return &quantize_kernels_avx2;
+        case GGML_SIMD_AVX512:
+            return &quantize_kernels_avx512;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+static _Atomic(const ggml_quantize_kernels *) active_quantize_kernels = NULL;
+
+static inline const ggml_quantize_kernels * get_active_quantize_kernels(void) {
+    const ggml_quantize_kernels * kernels = atomic_load_explicit(&active_quantize_kernels, memory_order_acquire);
+    if (kernels == NULL) {
+        kernels = ggml_get_quantize_kernels(ggml_simd_level_best());
+        atomic_store_explicit(&active_quantize_kernels, kernels, memory_order_release);
+    }
+    return kernels;
+}
+
+void quantize_row_q4_0(const float * GGML_RESTRICT x, block_q4_0 * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q4_0(x, y, k);
+}
+
+void quantize_row_q4_1(const float * GGML_RESTRICT x, block_q4_1 * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q4_1(x, y, k);
+}
+
+void quantize_row_q5_0(const float * GGML_RESTRICT x, block_q5_0 * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q5_0(x, y, k);
+}
+
+void quantize_row_q5_1(const float * GGML_RESTRICT x, block_q5_1 * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q5_1(x, y, k);
+}
+
+void quantize_row_q8_0(const float * GGML_RESTRICT x, block_q8_0 * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q8_0(x, y, k);
+}
+
+void quantize_row_q8_1(const float * GGML_RESTRICT x, block_q8_1 * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q8_1(x, y, k);
+}
+
+void quantize_row_q2_K(const float * GGML_RESTRICT x, block_q2_K * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q2_K(x, y, k);
+}
+
+void quantize_row_q3_K(const float * GGML_RESTRICT x, block_q3_K * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q3_K(x, y, k);
+}
+
+void quantize_row_q4_K(const float * GGML_RESTRICT x, block_q4_K * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q4_K(x, y, k);
+}
+
+void quantize_row_q5_K(const float * GGML_RESTRICT x, block_q5_K * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q5_K(x, y, k);
+}
+
+void quantize_row_q6_K(const float * GGML_RESTRICT x, block_q6_K * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q6_K(x, y, k);
+}
+
+void quantize_row_q8_K(const float * GGML_RESTRICT x, block_q8_K * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->q8_K(x, y, k);
+}
+
+void quantize_row_iq4_nl(const float * GGML_RESTRICT x, block_iq4_nl * GGML_RESTRICT y, int64_t k) {
+    get_active_quantize_kernels()->iq4_nl(x, y, k);
+}
+
+// ============================================================================
+// Half precision kernel tables
+// ============================================================================
+
+static const ggml_half_kernels half_kernels_scalar = {
+    .fp16 = ggml_fp32_to_fp16_row_ref,
+    .bf16 = ggml_fp32_to_bf16_row_ref,
+};
+
+#if defined(GGML_SIMD_ARM_NEON)
+static const ggml_half_kernels half_kernels_neon = {
+    .fp16 = ggml_fp32_to_fp16_row_neon,
+    .bf16 = ggml_fp32_to_bf16_row_neon,
+};
+#endif
+
+#if defined(GGML_SIMD_X86)
+static const ggml_half_kernels half_kernels_avx2 = {
+    .fp16 = ggml_fp32_to_fp16_row_avx2,
+    .bf16 = ggml_fp32_to_bf16_row_avx2,
+};
+
+static const ggml_half_kernels half_kernels_avx512 = {
+    .fp16 = ggml_fp32_to_fp16_row_avx512,
+    .bf16 = ggml_fp32_to_bf16_row_avx512,
+};
+#endif
+
+const ggml_half_kernels * ggml_get_half_kernels(ggml_simd_level level) {
+    if (!ggml_simd_level_available(level)) {
+        return NULL;
+    }
+    switch (level) {
+        case GGML_SIMD_SCALAR:
+            return &half_kernels_scalar;
+#if defined(GGML_SIMD_ARM_NEON)
+        case GGML_SIMD_NEON:
+            return &half_kernels_neon;
+#endif
+#if defined(GGML_SIMD_X86)
+        case GGML_SIMD_AVX2:
+            return &half_kernels_avx2;
+        case GGML_SIMD_AVX512:
+            return &half_kernels_avx512;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+static _Atomic(const ggml_half_kernels *) active_half_kernels = NULL;
+
+static inline const ggml_half_kernels * get_active_half_kernels(void) {
+    const ggml_half_kernels * kernels = atomic_load_explicit(&active_half_kernels, memory_order_acquire);
+    if (kernels == NULL) {
+        kernels = ggml_get_half_kernels(ggml_simd_level_best());
+        atomic_store_explicit(&active_half_kernels, kernels, memory_order_release);
+    }
+    return kernels;
+}
+
+void ggml_fp32_to_fp16_row(const float * GGML_RESTRICT x, ggml_fp16_t * GGML_RESTRICT y, int64_t n) {
+    get_active_half_kernels()->fp16(x, y, n);
+}
+
+void ggml_fp32_to_bf16_row(const float * GGML_RESTRICT x, ggml_bf16_t * GGML_RESTRICT y, int64_t n) {
+    get_active_half_kernels()->bf16(x, y, n);
+}
+
+// ============================================================================
+// Element conversion kernel tables
+// ============================================================================
+
+static const ggml_convert_kernels convert_kernels_scalar = {
+    .fp16 = ggml_fp16_to_fp32_row,
+    .bf16 = ggml_bf16_to_fp32_row,
+    .f64  = ggml_f64_to_fp32_row_ref,
+    .i8   = ggml_i8_to_fp32_row_ref,
+    .i16  = ggml_i16_to_fp32_row_ref,
+    .i32  = ggml_i32_to_fp32_row_ref,
+    .i64  = ggml_i64_to_fp32_row_ref,
+};
+
+#if defined(GGML_SIMD_ARM_NEON)
+static const ggml_convert_kernels convert_kernels_neon = {
+    .fp16 = ggml_fp16_to_fp32_row_neon,
+    .bf16 = ggml_bf16_to_fp32_row_neon,
+    .f64  = ggml_f64_to_fp32_row_neon,
+    .i8   = ggml_i8_to_fp32_row_neon,
+    .i16  = ggml_i16_to_fp32_row_neon,
+    .i32  = ggml_i32_to_fp32_row_neon,
+    .i64  = ggml_i64_to_fp32_row_ref,
+};
+#endif
+
+#if defined(GGML_SIMD_X86)
+static const ggml_convert_kernels convert_kernels_avx2 = {
+    .fp16 = ggml_fp16_to_fp32_row_avx2,
+    .bf16 = ggml_bf16_to_fp32_row_avx2,
+    .f64  = ggml_f64_to_fp32_row_avx2,
+    .i8   = ggml_i8_to_fp32_row_avx2,
+    .i16  = ggml_i16_to_fp32_row_avx2,
+    .i32  = ggml_i32_to_fp32_row_avx2,
+    .i64  = ggml_i64_to_fp32_row_ref,
+};
+
+static const ggml_convert_kernels convert_kernels_avx512 = {
+    .fp16 = ggml_fp16_to_fp32_row_avx512,
+    .bf16 = ggml_bf16_to_fp32_row_avx512,
+    .f64  = ggml_f64_to_fp32_row_avx512,
+    .i8   = ggml_i8_to_fp32_row_avx512,
+    .i16  = ggml_i16_to_fp32_row_avx512,
+    .i32  = ggml_i32_to_fp32_row_avx512,
+    .i64  = ggml_i64_to_fp32_row_ref,
+};
+#endif
+
+const ggml_convert_kernels * ggml_get_convert_kernels(ggml_simd_level level) {
+    if (!ggml_simd_level_available(level)) {
+        return NULL;
+    }
+    switch (level) {
+        case GGML_SIMD_SCALAR:
+            return &convert_kernels_scalar;
+#if defined(GGML_SIMD_ARM_NEON)
+        case GGML_SIMD_NEON:
+            return &convert_kernels_neon;
+#endif
+#if defined(GGML_SIMD_X86)
+        case GGML_SIMD_AVX2:
+            return &convert_kernels_avx2;
+        case GGML_SIMD_AVX512:
+            return &convert_kernels_avx512;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+// ============================================================================
+// Non-finite scan kernel tables
+// ============================================================================
+
+static const ggml_finite_kernels finite_kernels_scalar = {
+    .fp16 = ggml_count_nonfinite_fp16_ref,
+    .bf16 = ggml_count_nonfinite_bf16_ref,
+    .f32 = ggml_count_nonfinite_f32_ref,
+};
+
+#if defined(GGML_SIMD_ARM_NEON)
+static const ggml_finite_kernels finite_kernels_neon = {
+    .fp16 = ggml_count_nonfinite_fp16_neon,
+    .bf16 = ggml_count_nonfinite_bf16_neon,
+    .f32 = ggml_count_nonfinite_f32_neon,
+};
+#endif
+
+#if defined(GGML_SIMD_X86)
+// The scans are bound by memory bandwidth; AVX-512 reuses the AVX2 kernels
+static const ggml_finite_kernels finite_kernels_avx2 = {
+    .fp16 = ggml_count_nonfinite_fp16_avx2,
+    .bf16 = ggml_count_nonfinite_bf16_avx2,
+    .f32 = ggml_count_nonfinite_f32_avx2,
+};
+#endif
+
+const ggml_finite_kernels * ggml_get_finite_kernels(ggml_simd_level level) {
+    if (!ggml_simd_level_available(level)) {
+        return NULL;
+    }
+    switch (level) {
+        case GGML_SIMD_SCALAR:
+            return &finite_kernels_scalar;
+#if defined(GGML_SIMD_ARM_NEON)
+        case GGML_SIMD_NEON:
+            return &finite_kernels_neon;
+#endif
+#if defined(GGML_SIMD_X86)
+        case GGML_SIMD_AVX2:
+        case GGML_SIMD_AVX512:
+            return &finite_kernels_avx2;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+// ============================================================================
+// Statistics kernel tables
+// ============================================================================
+
+static const ggml_stats_kernels stats_kernels_scalar = {
+    .stats = ggml_stats_f32_ref,
+    .histogram = ggml_histogram_f32_ref,
+    .diff = ggml_diff_f32_ref,
+};
+
+#if defined(GGML_SIMD_ARM_NEON)
+static const ggml_stats_kernels stats_kernels_neon = {
+    .stats = ggml_stats_f32_neon,
+    .histogram = ggml_histogram_f32_neon,
+    .diff = ggml_diff_f32_neon,
+};
+#endif
+
+#if defined(GGML_SIMD_X86)
+// Eight lanes are part of the bit-exact contract, so AVX-512 reuses the AVX2 kernels
+static const ggml_stats_kernels stats_kernels_avx2 = {
+    .stats = ggml_stats_f32_avx2,
+    .histogram = ggml_histogram_f32_avx2,
+    .diff = ggml_diff_f32_avx2,
+};
+#endif
+
+const ggml_stats_kernels * ggml_get_stats_kernels(ggml_simd_level level) {
+    if (!ggml_simd_level_available(level)) {
+        return NULL;
+    }
+    switch (level) {
+        case GGML_SIMD_SCALAR:
+            return &stats_kernels_scalar;
+#if defined(GGML_SIMD_ARM_NEON)
+        case GGML_SIMD_NEON:
+            return &stats_kernels_neon;
+#endif
+#if defined(GGML_SIMD_X86)
+        case GGML_SIMD_AVX2:
+        case GGML_SIMD_AVX512:
+            return &stats_kernels_avx2;
+#endif
+        default:
+            return NULL;
+    }
+}
@@ -0,0 +1,473 @@
+/*
+ * GGML Dot Products - Scalar reference implementations
+ *
+ * Dot products between a quantized row and an activation vector, computed
+ * block by block without materializing the row as floats. Integer kernels
+ * take activations quantized to Q8_0, Q8_1 or Q8_K (see the vec_dot pairs in
+ * ggml_vec_dot_kernels).
+ */
+
+#include "ggml_quants_impl.h"
+
+#include <assert.h>
+
+// ============================================================================
+// Dot products - f32
+// ============================================================================
+
+float ggml_vec_dot_f32_ref(const float * GGML_RESTRICT x, const float * GGML_RESTRICT y, int64_t n) {
+    float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int j = 0; j < 4; ++j) {
+            sum[j] += x[i + j]*y[i + j];
+        }
+    }
+    for (; i < n; ++i) {
+        sum[0] += x[i]*y[i];
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+float ggml_vec_dot_dequantized_f32(ggml_dequantize_row_t dequantize, ggml_vec_dot_f32_t dot,
+                                   int64_t block_size, size_t type_size,
+                                   const void * GGML_RESTRICT vx, const float * GGML_RESTRICT y, int64_t n) {
+    assert(n % block_size == 0);
+    assert(QK_K % block_size == 0);
+
+    // Decode one tile at a time so the floats never leave L1
+    float tmp[QK_K];
+    const uint8_t * x = vx;
+    float sum = 0.0f;
+    for (int64_t i = 0; i < n; i += QK_K) {
+        const int64_t len = n - i < QK_K ? n - i : QK_K;
+        dequantize(x + (i / block_size) * type_size, tmp, len);
+        sum += dot(tmp, y + i, len);
+    }
+    return sum;
+}
+
+// ============================================================================
+// Dot products - Basic types
+// ============================================================================
+
+float ggml_vec_dot_q4_0_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    const int qk = QK8_0;
+    assert(n % qk == 0);
+    const int nb = n / qk;
+
+    const block_q4_0 * GGML_RESTRICT x = vx;
+    const block_q8_0 * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int ib = 0; ib < nb; ++ib) {
+        int sumi0 = 0;
+        int sumi1 = 0;
+
+        for (int j = 0; j < qk/2; ++j) {
+            const int v0 = (x[ib].qs[j] & 0x0F) - 8;
+            const int v1 = (x[ib].qs[j] >>   4) - 8;
+
+            sumi0 += (v0 * y[ib].qs[j]);
+            sumi1 += (v1 * y[ib].qs[j + qk/2]);
+        }
+
+        int sumi = sumi0 + sumi1;
+        sumf += sumi*GGML_FP16_TO_FP32(x[ib].d)*GGML_FP16_TO_FP32(y[ib].d);
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q4_1_q8_1_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    const int qk = QK8_1;
+    assert(n % qk == 0);
+    const int nb = n / qk;
+
+    const block_q4_1 * GGML_RESTRICT x = vx;
+    const block_q8_1 * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int ib = 0; ib < nb; ++ib) {
+        int sumi0 = 0;
+        int sumi1 = 0;
+
+        for (int j = 0; j < qk/2; ++j) {
+            const int v0 = (x[ib].qs[j] & 0x0F);
+            const int v1 = (x[ib].qs[j] >>   4);
+
+            sumi0 += (v0 * y[ib].qs[j]);
+            sumi1 += (v1 * y[ib].qs[j + qk/2]);
+        }
+
+        int sumi = sumi0 + sumi1;
+        sumf += (GGML_FP16_TO_FP32(x[ib].d)*GGML_FP16_TO_FP32(y[ib].d))*sumi + GGML_FP16_TO_FP32(x[ib].m)*GGML_FP16_TO_FP32(y[ib].s);
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q5_0_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    const int qk = QK8_0;
+    assert(n % qk == 0);
+    const int nb = n / qk;
+
+    const block_q5_0 * GGML_RESTRICT x = vx;
+    const block_q8_0 * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int ib = 0; ib < nb; ++ib) {
+        uint32_t qh;
+        memcpy(&qh, x[ib].qh, sizeof(qh));
+
+        int sumi0 = 0;
+        int sumi1 = 0;
+
+        for (int j = 0; j < qk/2; ++j) {
+            const uint8_t xh_0 = ((qh & (1u << (j + 0 ))) >> (j + 0 )) << 4;
+            const uint8_t xh_1 = ((qh & (1u << (j + 16))) >> (j + 12));
+
+            const int32_t x0 = (int8_t)(((x[ib].qs[j] & 0x0F) | xh_0) - 16);
+            const int32_t x1 = (int8_t)(((x[ib].qs[j] >>   4) | xh_1) - 16);
+
+            sumi0 += (x0 * y[ib].qs[j]);
+            sumi1 += (x1 * y[ib].qs[j + qk/2]);
+        }
+
+        int sumi = sumi0 + sumi1;
+        sumf += (GGML_FP16_TO_FP32(x[ib].d)*GGML_FP16_TO_FP32(y[ib].d)) * sumi;
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q5_1_q8_1_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    const int qk = QK8_1;
+    assert(n % qk == 0);
+    const int nb = n / qk;
+
+    const block_q5_1 * GGML_RESTRICT x = vx;
+    const block_q8_1 * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int ib = 0; ib < nb; ++ib) {
+        uint32_t qh;
+        memcpy(&qh, x[ib].qh, sizeof(qh));
+
+        int sumi0 = 0;
+        int sumi1 = 0;
+
+        for (int j = 0; j < qk/2; ++j) {
+            const uint8_t xh_0 = ((qh >> (j +  0)) << 4) & 0x10;
+            const uint8_t xh_1 = ((qh >> (j + 12))     ) & 0x10;
+
+            const int32_t x0 = (x[ib].qs[j] & 0xF) | xh_0;
+            const int32_t x1 = (x[ib].qs[j] >>  4) | xh_1;
+
+            sumi0 += (x0 * y[ib].qs[j]);
+            sumi1 += (x1 * y[ib].qs[j + qk/2]);
+        }
+
+        int sumi = sumi0 + sumi1;
+        sumf += (GGML_FP16_TO_FP32(x[ib].d)*GGML_FP16_TO_FP32(y[ib].d))*sumi + GGML_FP16_TO_FP32(x[ib].m)*GGML_FP16_TO_FP32(y[ib].s);
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q8_0_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    const int qk = QK8_0;
+    assert(n % qk == 0);
+    const int nb = n / qk;
+
+    const block_q8_0 * GGML_RESTRICT x = vx;
+    const block_q8_0 * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int ib = 0; ib < nb; ++ib) {
+        int sumi = 0;
+
+        for (int j = 0; j < qk; j++) {
+            sumi += x[ib].qs[j]*y[ib].qs[j];
+        }
+
+        sumf += sumi*(GGML_FP16_TO_FP32(x[ib].d)*GGML_FP16_TO_FP32(y[ib].d));
+    }
+
+    return sumf;
+}
+
+// ============================================================================
+// Dot products - K-quants
+// ============================================================================
+
+float ggml_vec_dot_q2_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int nb = n / QK_K;
+
+    const block_q2_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int i = 0; i < nb; ++i) {
+        const uint8_t * q2 = x[i].qs;
+        const  int8_t * q8 = y[i].qs;
+        const uint8_t * sc = x[i].scales;
+
+        int summs = 0;
+        for (int j = 0; j < 16; ++j) {
+            summs += y[i].bsums[j] * (sc[j] >> 4);
+        }
+
+        const float dall = y[i].d * GGML_FP16_TO_FP32(x[i].d);
+        const float dmin = y[i].d * GGML_FP16_TO_FP32(x[i].dmin);
+
+        int isum = 0;
+        int is = 0;
+        int d;
+        for (int k = 0; k < QK_K/128; ++k) {
+            int shift = 0;
+            for (int j = 0; j < 4; ++j) {
+                d = sc[is++] & 0xF;
+                int isuml = 0;
+                for (int l =  0; l < 16; ++l) isuml += q8[l] * ((q2[l] >> shift) & 3);
+                isum += d * isuml;
+                d = sc[is++] & 0xF;
+                isuml = 0;
+                for (int l = 16; l < 32; ++l) isuml += q8[l] * ((q2[l] >> shift) & 3);
+                isum += d * isuml;
+                shift += 2;
+                q8 += 32;
+            }
+            q2 += 32;
+        }
+        sumf += dall * isum - dmin * summs;
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q3_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int nb = n / QK_K;
+
+    const block_q3_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    int8_t scales[16];
+
+    float sumf = 0;
+
+    for (int i = 0; i < nb; ++i) {
+        const uint8_t * GGML_RESTRICT q = x[i].qs;
+        const uint8_t * GGML_RESTRICT hm = x[i].hmask;
+        const  int8_t * GGML_RESTRICT q8 = y[i].qs;
+        uint8_t m = 1;
+
+        unpack_scales_q3_K(x[i].scales, scales);
+
+        int isum = 0;
+        int is = 0;
+        for (int n = 0; n < QK_K; n += 128) {
+            int shift = 0;
+            for (int j = 0; j < 4; ++j) {
+                int isuml = 0;
+                for (int l = 0; l < 16; ++l) {
+                    isuml += q8[l] * ((int8_t)((q[l+ 0] >> shift) & 3) - ((hm[l+ 0] & m) ? 0 : 4));
+                }
+                isum += (scales[is++] - 32) * isuml;
+
+                isuml = 0;
+                for (int l = 0; l < 16; ++l) {
+                    isuml += q8[l+16] * ((int8_t)((q[l+16] >> shift) & 3) - ((hm[l+16] & m) ? 0 : 4));
+                }
+                isum += (scales[is++] - 32) * isuml;
+
+                shift += 2;
+                m <<= 1;
+                q8 += 32;
+            }
+            q += 32;
+        }
+        sumf += GGML_FP16_TO_FP32(x[i].d) * y[i].d * isum;
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q4_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int nb = n / QK_K;
+
+    const block_q4_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int i = 0; i < nb; ++i) {
+        const uint8_t * GGML_RESTRICT q4 = x[i].qs;
+        const  int8_t * GGML_RESTRICT q8 = y[i].qs;
+
+        int isum = 0;
+        int summs = 0;
+        uint8_t sc, m;
+        for (int j = 0; j < QK_K/64; ++j) {
+            int sum_lo = 0;
+            int sum_hi = 0;
+            for (int l = 0; l < 32; ++l) {
+                sum_lo += q8[l +  0] * (q4[l] & 0xF);
+                sum_hi += q8[l + 32] * (q4[l] >>  4);
+            }
+            get_scale_min_k4(2*j + 0, x[i].scales, &sc, &m);
+            isum  += sc * sum_lo;
+            summs += m * (y[i].bsums[4*j + 0] + y[i].bsums[4*j + 1]);
+            get_scale_min_k4(2*j + 1, x[i].scales, &sc, &m);
+            isum  += sc * sum_hi;
+            summs += m * (y[i].bsums[4*j + 2] + y[i].bsums[4*j + 3]);
+            q4 += 32;
+            q8 += 64;
+        }
+        const float d    = GGML_FP16_TO_FP32(x[i].d)    * y[i].d;
+        const float dmin = GGML_FP16_TO_FP32(x[i].dmin) * y[i].d;
+        sumf += d * isum - dmin * summs;
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q5_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int nb = n / QK_K;
+
+    const block_q5_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int i = 0; i < nb; ++i) {
+        const uint8_t * GGML_RESTRICT ql = x[i].qs;
+        const uint8_t * GGML_RESTRICT qh = x[i].qh;
+        const  int8_t * GGML_RESTRICT q8 = y[i].qs;
+
+        int isum = 0;
+        int summs = 0;
+        uint8_t sc, m;
+        uint8_t u1 = 1, u2 = 2;
+        for (int j = 0; j < QK_K/64; ++j) {
+            int sum_lo = 0;
+            int sum_hi = 0;
+            for (int l = 0; l < 32; ++l) {
+                sum_lo += q8[l +  0] * ((ql[l] & 0xF) + (qh[l] & u1 ? 16 : 0));
+                sum_hi += q8[l + 32] * ((ql[l]  >> 4) + (qh[l] & u2 ? 16 : 0));
+            }
+            get_scale_min_k4(2*j + 0, x[i].scales, &sc, &m);
+            isum  += sc * sum_lo;
+            summs += m * (y[i].bsums[4*j + 0] + y[i].bsums[4*j + 1]);
+            get_scale_min_k4(2*j + 1, x[i].scales, &sc, &m);
+            isum  += sc * sum_hi;
+            summs += m * (y[i].bsums[4*j + 2] + y[i].bsums[4*j + 3]);
+            ql += 32;
+            q8 += 64;
+            u1 <<= 2; u2 <<= 2;
+        }
+        const float d    = GGML_FP16_TO_FP32(x[i].d)    * y[i].d;
+        const float dmin = GGML_FP16_TO_FP32(x[i].dmin) * y[i].d;
+        sumf += d * isum - dmin * summs;
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q6_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int nb = n / QK_K;
+
+    const block_q6_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    int8_t aux8[QK_K];
+
+    float sumf = 0;
+
+    for (int i = 0; i < nb; ++i) {
+        const uint8_t * GGML_RESTRICT ql = x[i].ql;
+        const uint8_t * GGML_RESTRICT qh = x[i].qh;
+        int8_t * GGML_RESTRICT a = aux8;
+        for (int n = 0; n < QK_K; n += 128) {
+            for (int l = 0; l < 32; ++l) {
+                a[l +  0] = (int8_t)((ql[l +  0] & 0xF) | (((qh[l] >> 0) & 3) << 4)) - 32;
+                a[l + 32] = (int8_t)((ql[l + 32] & 0xF) | (((qh[l] >> 2) & 3) << 4)) - 32;
+                a[l + 64] = (int8_t)((ql[l +  0]  >> 4) | (((qh[l] >> 4) & 3) << 4)) - 32;
+                a[l + 96] = (int8_t)((ql[l + 32]  >> 4) | (((qh[l] >> 6) & 3) << 4)) - 32;
+            }
+            a  += 128;
+            ql += 64;
+            qh += 32;
+        }
+
+        // Element e of the block uses scale e/16
+        int isum = 0;
+        for (int j = 0; j < QK_K/16; ++j) {
+            int isuml = 0;
+            for (int l = 0; l < 16; ++l) {
+                isuml += y[i].qs[16*j + l] * aux8[16*j + l];
+            }
+            isum += x[i].scales[j] * isuml;
+        }
+        sumf += GGML_FP16_TO_FP32(x[i].d) * y[i].d * isum;
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q8_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int nb = n / QK_K;
+
+    const block_q8_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int i = 0; i < nb; ++i) {
+        int isum = 0;
+        for (int j = 0; j < QK_K; ++j) {
+            isum += x[i].qs[j] * y[i].qs[j];
+        }
+        sumf += x[i].d * y[i].d * isum;
+    }
+
+    return sumf;
+}
+
+// ============================================================================
+// Dot products - IQ types
+// ============================================================================
+
+float ggml_vec_dot_iq4_nl_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK4_NL == 0);
+    const int nb = n / QK4_NL;
+
+    const block_iq4_nl * GGML_RESTRICT x = vx;
+    const block_q8_0   * GGML_RESTRICT y = vy;
+
+    float sumf = 0;
+
+    for (int ib = 0; ib < nb; ++ib) {
+        const float d = GGML_FP16_TO_FP32(y[ib].d)*GGML_FP16_TO_FP32(x[ib].d);
+        int sumi1 = 0, sumi2 = 0;
+        for (int j = 0; j < QK4_NL/2; ++j) {
+            sumi1 += y[ib].qs[j+       0] * kvalues_iq4nl[x[ib].qs[j] & 0xf];
+            sumi2 += y[ib].qs[j+QK4_NL/2] * kvalues_iq4nl[x[ib].qs[j] >>  4];
+        }
+        sumf += d * (sumi1 + sumi2);
+    }
+
+    return sumf;
+}
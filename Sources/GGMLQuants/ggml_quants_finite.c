@@ -0,0 +1,42 @@
+/*
+ * GGML Verification - Non-finite value scans
+ *
+ * Scalar references for counting NaN and infinite values in f16, bf16 and f32
+ * data. Values are tested on their exponent bits alone, so the scans never
+ * convert to float and work on any byte alignment.
+ */
+
+#include "ggml_quants_impl.h"
+
+int64_t ggml_count_nonfinite_fp16_ref(const void * GGML_RESTRICT vx, int64_t n, size_t stride) {
+    const uint8_t * x = vx;
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        uint16_t h;
+        memcpy(&h, x + i*stride, sizeof(h));
+        count += (h & 0x7C00) == 0x7C00;
+    }
+    return count;
+}
+
+int64_t ggml_count_nonfinite_bf16_ref(const void * GGML_RESTRICT vx, int64_t n, size_t stride) {
+    const uint8_t * x = vx;
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        uint16_t h;
+        memcpy(&h, x + i*stride, sizeof(h));
+        count += (h & 0x7F80) == 0x7F80;
+    }
+    return count;
+}
+
+int64_t ggml_count_nonfinite_f32_ref(const void * GGML_RESTRICT vx, int64_t n, size_t stride) {
+    const uint8_t * x = vx;
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        uint32_t w;
+        memcpy(&w, x + i*stride, sizeof(w));
+        count += (w & 0x7F800000) == 0x7F800000;
+    }
+    return count;
+}
@@ -0,0 +1,58 @@
+/*
+ * GGML Dequantization - Half precision output
+ *
+ * Scalar f32 <-> f16/bf16 row conversions and the tiled decoder that writes
+ * quantized rows straight to 16-bit floats.
+ */
+
+#include "ggml_quants_impl.h"
+
+#include <assert.h>
+#include <string.h>
+
+void ggml_fp32_to_fp16_row_ref(const float * GGML_RESTRICT x, ggml_fp16_t * GGML_RESTRICT y, int64_t n) {
+    for (int64_t i = 0; i < n; ++i) {
+        y[i] = GGML_FP32_TO_FP16(x[i]);
+    }
+}
+
+void ggml_fp32_to_bf16_row_ref(const float * GGML_RESTRICT x, ggml_bf16_t * GGML_RESTRICT y, int64_t n) {
+    for (int64_t i = 0; i < n; ++i) {
+        y[i] = GGML_FP32_TO_BF16(x[i]);
+    }
+}
+
+// The widenings read tensor data in place, which may sit at an odd address
+void ggml_fp16_to_fp32_row(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    for (int64_t i = 0; i < n; ++i) {
+        ggml_fp16_t h;
+        memcpy(&h, x + i*sizeof(h), sizeof(h));
+        y[i] = GGML_FP16_TO_FP32(h);
+    }
+}
+
+void ggml_bf16_to_fp32_row(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    for (int64_t i = 0; i < n; ++i) {
+        ggml_bf16_t h;
+        memcpy(&h, x + i*sizeof(h), sizeof(h));
+        y[i] = GGML_BF16_TO_FP32(h);
+    }
+}
+
+void ggml_dequantize_row_half(ggml_dequantize_row_t dequantize, ggml_from_float_t convert,
+                              int64_t block_size, size_t type_size,
+                              const void * GGML_RESTRICT vx, uint16_t * GGML_RESTRICT y, int64_t k) {
+    assert(k % block_size == 0);
+    assert(QK_K % block_size == 0);
+
+    // Same tiling as ggml_vec_dot_dequantized_f32: the tile stays in L1
+    float tmp[QK_K];
+    const uint8_t * x = vx;
+    for (int64_t i = 0; i < k; i += QK_K) {
+        const int64_t len = k - i < QK_K ? k - i : QK_K;
+        dequantize(x + (i / block_size) * type_size, tmp, len);
+        convert(tmp, y + i, len);
+    }
+}
@@ -0,0 +1,410 @@
+/*
+ * GGML Dequantization - Internal helpers
+ *
+ * Shared by the scalar reference kernels and the SIMD implementations.
+ * Not part of the public module interface.
+ */
+
+#pragma once
+
+#include "ggml_quants.h"
+
+#include <string.h>
+
+// Every SIMD level must produce bit-identical output to the scalar reference,
+// so multiply/add pairs are never contracted into fused multiply-adds.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define GGML_SIMD_X86 1
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define GGML_SIMD_ARM_NEON 1
+#endif
+
+// ============================================================================
+// Lookup tables
+// ============================================================================
+
+// Lookup table for IQ4_NL (non-linear 4-bit quantization)
+static const int8_t kvalues_iq4nl[16] = {
+    -127, -104, -83, -65, -49, -35, -22, -10, 1, 13, 25, 38, 53, 69, 89, 113,
+};
+
+// e2m1 code -> value, doubled so it stays integral (GGML_E8M0_TO_FP32_HALF halves it back)
+static const int8_t kvalues_mxfp4[16] = {
+    0, 1, 2, 3, 4, 6, 8, 12, 0, -1, -2, -3, -4, -6, -8, -12,
+};
+
+// IQ grids and sign tables, defined once in ggml_quants_grids.c
+extern const uint8_t  ksigns_iq2xs[128];
+extern const uint8_t  kmask_iq2xs[8];
+extern const uint64_t iq2xxs_grid[256];
+extern const uint64_t iq2xs_grid[512];
+extern const uint64_t iq2s_grid[1024];
+extern const uint32_t iq3xxs_grid[256];
+extern const uint32_t iq3s_grid[512];
+extern const uint64_t iq1s_grid[NGRID_IQ1S];
+
+static inline void get_scale_min_k4(int j, const uint8_t * GGML_RESTRICT q, uint8_t * GGML_RESTRICT d, uint8_t * GGML_RESTRICT m) {
+    if (j < 4) {
+        *d = q[j] & 63; *m = q[j + 4] & 63;
+    } else {
+        *d = (q[j+4] & 0xF) | ((q[j-4] >> 6) << 4);
+        *m = (q[j+4] >>  4) | ((q[j-0] >> 6) << 4);
+    }
+}
+
+// The IQ1_M super-block scale, spread over the top nibbles of the four scale words
+static inline ggml_half iq1m_scale(const uint16_t * GGML_RESTRICT sc) {
+    return (ggml_half) ((sc[0] >> 12) | ((sc[1] >> 8) & 0x00f0) | ((sc[2] >> 4) & 0x0f00) | (sc[3] & 0xf000));
+}
+
+// Round to nearest, ties to even; valid for |fval| <= 4194303
+static inline int nearest_int(float fval) {
+    float val = fval + 12582912.f;
+    int i; memcpy(&i, &val, sizeof(int));
+    return (i & 0x007fffff) - 0x00400000;
+}
+
+// The value of largest magnitude, given that magnitude. The first such value wins,
+// matching the strict `>` search of the scalar quantizers.
+static inline float signed_amax_f32(const float * GGML_RESTRICT x, int n, float amax) {
+    if (!amax) {
+        return 0.0f;
+    }
+    for (int j = 0; j < n; ++j) {
+        if (fabsf(x[j]) == amax) {
+            return x[j];
+        }
+    }
+    return 0.0f;
+}
+
+// The first zero in x, keeping its sign (SIMD min/max do not order +0 and -0)
+static inline float first_zero_f32(const float * GGML_RESTRICT x, int n) {
+    for (int j = 0; j < n; ++j) {
+        if (x[j] == 0.0f) {
+            return x[j];
+        }
+    }
+    return 0.0f;
+}
+
+// Unpacks the 6-bit Q3_K scales into 16 signed bytes (still offset by 32)
+static inline void unpack_scales_q3_K(const uint8_t * GGML_RESTRICT packed, int8_t * GGML_RESTRICT scales) {
+    const uint32_t kmask1 = 0x03030303;
+    const uint32_t kmask2 = 0x0f0f0f0f;
+
+    uint32_t aux[4];
+    memcpy(aux, packed, 12);
+    uint32_t tmp = aux[2];
+    aux[2] = ((aux[0] >> 4) & kmask2) | (((tmp >> 4) & kmask1) << 4);
+    aux[3] = ((aux[1] >> 4) & kmask2) | (((tmp >> 6) & kmask1) << 4);
+    aux[0] = (aux[0] & kmask2) | (((tmp >> 0) & kmask1) << 4);
+    aux[1] = (aux[1] & kmask2) | (((tmp >> 2) & kmask1) << 4);
+    memcpy(scales, aux, 16);
+}
+
+// ============================================================================
+// SIMD kernels
+// ============================================================================
+
+#if defined(GGML_SIMD_X86)
+void dequantize_row_q4_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q4_1_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q5_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q5_1_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q8_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q2_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q3_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q4_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q5_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q6_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q8_K_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq4_nl_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q8_1_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq2_xxs_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq2_xs_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq2_s_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq3_xxs_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq3_s_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq1_s_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq1_m_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq4_xs_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_tq1_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_tq2_0_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_mxfp4_avx2(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+
+void dequantize_row_q4_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q4_1_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q5_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q5_1_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q8_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q2_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q3_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q4_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q5_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q6_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q8_K_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq4_nl_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q8_1_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq2_xxs_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq2_xs_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq2_s_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq3_xxs_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq3_s_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq1_s_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq1_m_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq4_xs_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_tq1_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_tq2_0_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_mxfp4_avx512(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+#endif
+
+#if defined(GGML_SIMD_ARM_NEON)
+void dequantize_row_q4_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q4_1_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q5_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q5_1_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q8_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q2_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q3_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q4_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q5_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q6_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q8_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq4_nl_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_q8_1_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq2_xxs_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq2_xs_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq2_s_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq3_xxs_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq3_s_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq1_s_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq1_m_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_iq4_xs_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_tq1_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_tq2_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+void dequantize_row_mxfp4_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k);
+#endif
+
+// ============================================================================
+// Dot products
+// ============================================================================
+
+float ggml_vec_dot_f32_ref(const float * GGML_RESTRICT x, const float * GGML_RESTRICT y, int64_t n);
+
+float ggml_vec_dot_q4_0_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q4_1_q8_1_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q5_0_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q5_1_q8_1_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q8_0_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q2_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q3_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q4_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q5_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q6_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q8_K_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_iq4_nl_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+
+// Only the formats that dominate real models have vectorized integer dots;
+// the remaining pairs fall back to the scalar reference at every level.
+#if defined(GGML_SIMD_X86)
+float ggml_vec_dot_f32_avx2(const float * GGML_RESTRICT x, const float * GGML_RESTRICT y, int64_t n);
+float ggml_vec_dot_q4_0_q8_0_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q8_0_q8_0_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q4_K_q8_K_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q6_K_q8_K_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+
+float ggml_vec_dot_f32_avx512(const float * GGML_RESTRICT x, const float * GGML_RESTRICT y, int64_t n);
+#endif
+
+#if defined(GGML_SIMD_ARM_NEON)
+float ggml_vec_dot_f32_neon(const float * GGML_RESTRICT x, const float * GGML_RESTRICT y, int64_t n);
+float ggml_vec_dot_q4_0_q8_0_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q8_0_q8_0_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q4_K_q8_K_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+float ggml_vec_dot_q6_K_q8_K_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+#endif
+
+// ============================================================================
+// Interleaved dot products
+// ============================================================================
+
+void ggml_gemv_q4_0x4_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+void ggml_gemv_q4_0x8_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+void ggml_gemv_q8_0x4_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+void ggml_gemv_q8_0x8_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+void ggml_gemv_q4_Kx4_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+void ggml_gemv_q4_Kx8_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+
+// Each level vectorizes the interleave that fills its registers: eight 32-bit
+// lanes for AVX2 and four for NEON. The other width uses the scalar reference.
+#if defined(GGML_SIMD_X86)
+void ggml_gemv_q4_0x8_q8_0_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+void ggml_gemv_q8_0x8_q8_0_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+void ggml_gemv_q4_Kx8_q8_K_avx2(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+#endif
+
+#if defined(GGML_SIMD_ARM_NEON)
+void ggml_gemv_q4_0x4_q8_0_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+void ggml_gemv_q8_0x4_q8_0_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+void ggml_gemv_q4_Kx4_q8_K_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+#endif
+
+// ============================================================================
+// Quantization
+// ============================================================================
+
+// Scale-and-round formats are vectorized; the K-quants and IQ4_NL run an
+// iterative scale/min search and use the scalar reference at every level.
+#if defined(GGML_SIMD_X86)
+void quantize_row_q4_0_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+void quantize_row_q4_1_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+void quantize_row_q8_0_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+void quantize_row_q8_1_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+void quantize_row_q8_K_avx2(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+#endif
+
+#if defined(GGML_SIMD_ARM_NEON)
+void quantize_row_q4_0_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+void quantize_row_q4_1_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+void quantize_row_q8_0_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+void quantize_row_q8_1_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+void quantize_row_q8_K_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k);
+#endif
+
+// ============================================================================
+// Half precision output
+// ============================================================================
+
+#if defined(GGML_SIMD_X86)
+void ggml_fp32_to_fp16_row_avx2(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n);
+void ggml_fp32_to_bf16_row_avx2(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n);
+
+void ggml_fp32_to_fp16_row_avx512(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n);
+void ggml_fp32_to_bf16_row_avx512(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n);
+#endif
+
+#if defined(GGML_SIMD_ARM_NEON)
+void ggml_fp32_to_fp16_row_neon(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n);
+void ggml_fp32_to_bf16_row_neon(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n);
+#endif
+
+// ============================================================================
+// Element conversion
+// ============================================================================
+
+// No level has an exact vector i64 -> f32 conversion, so every table uses
+// ggml_i64_to_fp32_row_ref; a detour through f64 would round twice.
+
+#if defined(GGML_SIMD_X86)
+void ggml_fp16_to_fp32_row_avx2(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_bf16_to_fp32_row_avx2(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_f64_to_fp32_row_avx2(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_i8_to_fp32_row_avx2(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_i16_to_fp32_row_avx2(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_i32_to_fp32_row_avx2(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+
+void ggml_fp16_to_fp32_row_avx512(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_bf16_to_fp32_row_avx512(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_f64_to_fp32_row_avx512(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_i8_to_fp32_row_avx512(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_i16_to_fp32_row_avx512(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_i32_to_fp32_row_avx512(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+#endif
+
+#if defined(GGML_SIMD_ARM_NEON)
+void ggml_fp16_to_fp32_row_neon(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_bf16_to_fp32_row_neon(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_f64_to_fp32_row_neon(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_i8_to_fp32_row_neon(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_i16_to_fp32_row_neon(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+void ggml_i32_to_fp32_row_neon(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+#endif
+
+// ============================================================================
+// Non-finite scans
+// ============================================================================
+
+int64_t ggml_count_nonfinite_fp16_ref(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+int64_t ggml_count_nonfinite_bf16_ref(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+int64_t ggml_count_nonfinite_f32_ref(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+
+#if defined(GGML_SIMD_X86)
+int64_t ggml_count_nonfinite_fp16_avx2(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+int64_t ggml_count_nonfinite_bf16_avx2(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+int64_t ggml_count_nonfinite_f32_avx2(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+#endif
+
+#if defined(GGML_SIMD_ARM_NEON)
+int64_t ggml_count_nonfinite_fp16_neon(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+int64_t ggml_count_nonfinite_bf16_neon(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+int64_t ggml_count_nonfinite_f32_neon(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+#endif
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+void ggml_stats_f32_ref(const float * GGML_RESTRICT x, int64_t n, ggml_stats * GGML_RESTRICT acc);
+void ggml_histogram_f32_ref(const float * GGML_RESTRICT x, int64_t n, float lo, float scale,
+                            int64_t bins, int64_t * GGML_RESTRICT counts);
+void ggml_diff_f32_ref(const float * GGML_RESTRICT a, const float * GGML_RESTRICT b, int64_t n,
+                       ggml_diff * GGML_RESTRICT acc);
+
+// Folds one tile into `acc` from its f32 partial results. `m2_around` is the
+// sum of squared deviations from `mean_f`, the tile mean rounded to f32; the
+// deviation from the exact mean is corrected here in double.
+static inline void ggml_stats_add_tile(ggml_stats * GGML_RESTRICT acc, int64_t n,
+                                       float sum, float sumsq, float mean_f, float m2_around,
+                                       float min, float max) {
+    const double mean = (double) sum / (double) n;
+    const double shift = mean - (double) mean_f;
+    ggml_stats tile = {
+        .count = n,
+        .mean = mean,
+        .m2 = (double) m2_around - (double) n * shift * shift,
+        .sumsq = sumsq,
+        .min = min,
+        .max = max,
+    };
+    if (tile.m2 < 0) {
+        tile.m2 = 0;
+    }
+    ggml_stats_merge(acc, &tile);
+}
+
+// Folds the f32 partial sums of one tile into `acc`
+static inline void ggml_diff_add_tile(ggml_diff * GGML_RESTRICT acc, int64_t n,
+                                      float sumsq_diff, float dot, float sumsq_a, float sumsq_b,
+                                      float max_abs) {
+    acc->count += n;
+    acc->sumsq_diff += sumsq_diff;
+    acc->dot += dot;
+    acc->sumsq_a += sumsq_a;
+    acc->sumsq_b += sumsq_b;
+    acc->max_abs = max_abs > acc->max_abs ? max_abs : acc->max_abs;
+}
+
+#if defined(GGML_SIMD_X86)
+void ggml_stats_f32_avx2(const float * GGML_RESTRICT x, int64_t n, ggml_stats * GGML_RESTRICT acc);
+void ggml_histogram_f32_avx2(const float * GGML_RESTRICT x, int64_t n, float lo, float scale,
+                             int64_t bins, int64_t * GGML_RESTRICT counts);
+void ggml_diff_f32_avx2(const float * GGML_RESTRICT a, const float * GGML_RESTRICT b, int64_t n,
+                        ggml_diff * GGML_RESTRICT acc);
+#endif
+
+#if defined(GGML_SIMD_ARM_NEON)
+void ggml_stats_f32_neon(const float * GGML_RESTRICT x, int64_t n, ggml_stats * GGML_RESTRICT acc);
+void ggml_histogram_f32_neon(const float * GGML_RESTRICT x, int64_t n, float lo, float scale,
+                             int64_t bins, int64_t * GGML_RESTRICT counts);
+void ggml_diff_f32_neon(const float * GGML_RESTRICT a, const float * GGML_RESTRICT b, int64_t n,
+                        ggml_diff * GGML_RESTRICT acc);
+#endif
@@ -0,0 +1,1569 @@
+/*
+ * GGML Dequantization - NEON kernels
+ *
+ * NEON is part of the AArch64 baseline, so these kernels are always
+ * available on 64-bit ARM hosts.
+ */
+
+#include "ggml_quants_impl.h"
+
+#include <assert.h>
+
+#if defined(GGML_SIMD_ARM_NEON)
+
+#include <arm_neon.h>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static inline float fp16_to_fp32(ggml_fp16_t h) {
+    __fp16 value;
+    memcpy(&value, &h, sizeof(value));
+    return (float) value;
+}
+
+static inline float32x4_t u16x4_to_f32(uint16x4_t v) {
+    return vcvtq_f32_u32(vmovl_u16(v));
+}
+
+static inline float32x4_t s16x4_to_f32(int16x4_t v) {
+    return vcvtq_f32_s32(vmovl_s16(v));
+}
+
+// 16 unsigned bytes -> y[0..15] = d * q - m
+static inline void store_u8x16_sub(float * GGML_RESTRICT y, uint8x16_t q, float d, float m) {
+    const float32x4_t vm = vdupq_n_f32(m);
+    const uint16x8_t lo = vmovl_u8(vget_low_u8(q));
+    const uint16x8_t hi = vmovl_u8(vget_high_u8(q));
+    vst1q_f32(y +  0, vsubq_f32(vmulq_n_f32(u16x4_to_f32(vget_low_u16(lo)),  d), vm));
+    vst1q_f32(y +  4, vsubq_f32(vmulq_n_f32(u16x4_to_f32(vget_high_u16(lo)), d), vm));
+    vst1q_f32(y +  8, vsubq_f32(vmulq_n_f32(u16x4_to_f32(vget_low_u16(hi)),  d), vm));
+    vst1q_f32(y + 12, vsubq_f32(vmulq_n_f32(u16x4_to_f32(vget_high_u16(hi)), d), vm));
+}
+
+// 16 unsigned bytes -> y[0..15] = q * d + m
+static inline void store_u8x16_add(float * GGML_RESTRICT y, uint8x16_t q, float d, float m) {
+    const float32x4_t vm = vdupq_n_f32(m);
+    const uint16x8_t lo = vmovl_u8(vget_low_u8(q));
+    const uint16x8_t hi = vmovl_u8(vget_high_u8(q));
+    vst1q_f32(y +  0, vaddq_f32(vmulq_n_f32(u16x4_to_f32(vget_low_u16(lo)),  d), vm));
+    vst1q_f32(y +  4, vaddq_f32(vmulq_n_f32(u16x4_to_f32(vget_high_u16(lo)), d), vm));
+    vst1q_f32(y +  8, vaddq_f32(vmulq_n_f32(u16x4_to_f32(vget_low_u16(hi)),  d), vm));
+    vst1q_f32(y + 12, vaddq_f32(vmulq_n_f32(u16x4_to_f32(vget_high_u16(hi)), d), vm));
+}
+
+// 16 signed bytes -> y[0..15] = q * d
+static inline void store_i8x16(float * GGML_RESTRICT y, int8x16_t q, float d) {
+    const int16x8_t lo = vmovl_s8(vget_low_s8(q));
+    const int16x8_t hi = vmovl_s8(vget_high_s8(q));
+    vst1q_f32(y +  0, vmulq_n_f32(s16x4_to_f32(vget_low_s16(lo)),  d));
+    vst1q_f32(y +  4, vmulq_n_f32(s16x4_to_f32(vget_high_s16(lo)), d));
+    vst1q_f32(y +  8, vmulq_n_f32(s16x4_to_f32(vget_low_s16(hi)),  d));
+    vst1q_f32(y + 12, vmulq_n_f32(s16x4_to_f32(vget_high_s16(hi)), d));
+}
+
+// Expands bits 0..15 of qh into 16 bytes holding 0x10 where the bit is set
+static inline uint8x16_t q5_high_bits(uint32_t qh) {
+    static const uint8_t bit_masks[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128,
+    };
+    const uint8x16_t bytes = vcombine_u8(vdup_n_u8((uint8_t) (qh & 0xFF)), vdup_n_u8((uint8_t) ((qh >> 8) & 0xFF)));
+    return vandq_u8(vtstq_u8(bytes, vld1q_u8(bit_masks)), vdupq_n_u8(0x10));
+}
+
+// 8 unsigned bytes -> y[0..7] = d * q * s, s being -1 where the byte of neg is set and 1 elsewhere
+static inline void store_u8x8_signed(float * GGML_RESTRICT y, uint8x8_t q, uint8x8_t neg, float d) {
+    const uint32x4_t one = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));
+    const uint32x4_t sign_bit = vdupq_n_u32(0x80000000);
+    const uint16x8_t q16 = vmovl_u8(q);
+    const int16x8_t n16 = vmovl_s8(vreinterpret_s8_u8(neg));
+    const uint32x4_t s0 = vorrq_u32(one, vandq_u32(vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(n16))),  sign_bit));
+    const uint32x4_t s1 = vorrq_u32(one, vandq_u32(vreinterpretq_u32_s32(vmovl_s16(vget_high_s16(n16))), sign_bit));
+    vst1q_f32(y + 0, vmulq_f32(vmulq_n_f32(u16x4_to_f32(vget_low_u16(q16)),  d), vreinterpretq_f32_u32(s0)));
+    vst1q_f32(y + 4, vmulq_f32(vmulq_n_f32(u16x4_to_f32(vget_high_u16(q16)), d), vreinterpretq_f32_u32(s1)));
+}
+
+// Four 8-value grid points with one sign bit each (bit j of `signs` for value j) -> y[0..31],
+// d0 scaling the first 16 values and d1 the rest
+static inline void store_grid32_signed(float * GGML_RESTRICT y, const uint64_t * GGML_RESTRICT grid, uint32_t signs, float d0, float d1) {
+    static const uint8_t bit_masks[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x8_t bits = vld1_u8(bit_masks);
+    for (int l = 0; l < 4; ++l) {
+        const uint8x8_t neg = vtst_u8(vdup_n_u8((uint8_t) (signs >> 8*l)), bits);
+        store_u8x8_signed(y + 8*l, vcreate_u8(grid[l]), neg, l < 2 ? d0 : d1);
+    }
+}
+
+// 8 signed bytes -> y[0..7] = d * (q + delta)
+static inline void store_i8x8_offset(float * GGML_RESTRICT y, int8x8_t q, float delta, float d) {
+    const float32x4_t vdelta = vdupq_n_f32(delta);
+    const int16x8_t q16 = vmovl_s8(q);
+    vst1q_f32(y + 0, vmulq_n_f32(vaddq_f32(s16x4_to_f32(vget_low_s16(q16)),  vdelta), d));
+    vst1q_f32(y + 4, vmulq_n_f32(vaddq_f32(s16x4_to_f32(vget_high_s16(q16)), vdelta), d));
+}
+
+// Four sign bytes looked up from the 7-bit indices packed in the low 28 bits of aux
+static inline uint32_t ksigns_x4(uint32_t aux) {
+    return (uint32_t) ksigns_iq2xs[(aux >>  0) & 127]       | (uint32_t) ksigns_iq2xs[(aux >>  7) & 127] <<  8 |
+           (uint32_t) ksigns_iq2xs[(aux >> 14) & 127] << 16 | (uint32_t) ksigns_iq2xs[(aux >> 21) & 127] << 24;
+}
+
+// Base-3 digit n of each of 16 bytes, minus one: the wrapping multiply by 3^n
+// rotates digit n to the top of the byte, where * 3 >> 8 reads it off
+static inline int8x16_t ternary_digits(uint8x16_t q, uint8x16_t pow3) {
+    const uint8x16_t t = vmulq_u8(q, pow3);
+    const uint8x8_t lo = vshrn_n_u16(vmull_u8(vget_low_u8(t),  vdup_n_u8(3)), 8);
+    const uint8x8_t hi = vshrn_n_u16(vmull_u8(vget_high_u8(t), vdup_n_u8(3)), 8);
+    return vsubq_s8(vreinterpretq_s8_u8(vcombine_u8(lo, hi)), vdupq_n_s8(1));
+}
+
+// ============================================================================
+// Basic types
+// ============================================================================
+
+void dequantize_row_q4_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q4_0 * GGML_RESTRICT x = vx;
+    assert(k % QK4_0 == 0);
+    const int64_t nb = k / QK4_0;
+
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    const int8x16_t offset = vdupq_n_s8(8);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const uint8x16_t qs = vld1q_u8(x[i].qs);
+        const int8x16_t lo = vsubq_s8(vreinterpretq_s8_u8(vandq_u8(qs, mask)), offset);
+        const int8x16_t hi = vsubq_s8(vreinterpretq_s8_u8(vshrq_n_u8(qs, 4)), offset);
+
+        store_i8x16(y +  0, lo, d);
+        store_i8x16(y + 16, hi, d);
+        y += QK4_0;
+    }
+}
+
+void dequantize_row_q4_1_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q4_1 * GGML_RESTRICT x = vx;
+    assert(k % QK4_1 == 0);
+    const int64_t nb = k / QK4_1;
+
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const float m = fp16_to_fp32(x[i].m);
+        const uint8x16_t qs = vld1q_u8(x[i].qs);
+
+        store_u8x16_add(y +  0, vandq_u8(qs, mask), d, m);
+        store_u8x16_add(y + 16, vshrq_n_u8(qs, 4), d, m);
+        y += QK4_1;
+    }
+}
+
+void dequantize_row_q5_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q5_0 * GGML_RESTRICT x = vx;
+    assert(k % QK5_0 == 0);
+    const int64_t nb = k / QK5_0;
+
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    const int8x16_t offset = vdupq_n_s8(16);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        uint32_t qh;
+        memcpy(&qh, x[i].qh, sizeof(qh));
+
+        const uint8x16_t qs = vld1q_u8(x[i].qs);
+        const uint8x16_t lo = vorrq_u8(vandq_u8(qs, mask), q5_high_bits(qh));
+        const uint8x16_t hi = vorrq_u8(vshrq_n_u8(qs, 4), q5_high_bits(qh >> 16));
+
+        store_i8x16(y +  0, vsubq_s8(vreinterpretq_s8_u8(lo), offset), d);
+        store_i8x16(y + 16, vsubq_s8(vreinterpretq_s8_u8(hi), offset), d);
+        y += QK5_0;
+    }
+}
+
+void dequantize_row_q5_1_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q5_1 * GGML_RESTRICT x = vx;
+    assert(k % QK5_1 == 0);
+    const int64_t nb = k / QK5_1;
+
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const float m = fp16_to_fp32(x[i].m);
+        uint32_t qh;
+        memcpy(&qh, x[i].qh, sizeof(qh));
+
+        const uint8x16_t qs = vld1q_u8(x[i].qs);
+        store_u8x16_add(y +  0, vorrq_u8(vandq_u8(qs, mask), q5_high_bits(qh)), d, m);
+        store_u8x16_add(y + 16, vorrq_u8(vshrq_n_u8(qs, 4), q5_high_bits(qh >> 16)), d, m);
+        y += QK5_1;
+    }
+}
+
+void dequantize_row_q8_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q8_0 * GGML_RESTRICT x = vx;
+    assert(k % QK8_0 == 0);
+    const int64_t nb = k / QK8_0;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        store_i8x16(y +  0, vld1q_s8(x[i].qs +  0), d);
+        store_i8x16(y + 16, vld1q_s8(x[i].qs + 16), d);
+        y += QK8_0;
+    }
+}
+
+void dequantize_row_q8_1_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q8_1 * GGML_RESTRICT x = vx;
+    assert(k % QK8_1 == 0);
+    const int64_t nb = k / QK8_1;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        store_i8x16(y +  0, vld1q_s8(x[i].qs +  0), d);
+        store_i8x16(y + 16, vld1q_s8(x[i].qs + 16), d);
+        y += QK8_1;
+    }
+}
+
+void dequantize_row_mxfp4_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_mxfp4 * GGML_RESTRICT x = vx;
+    assert(k % QK_MXFP4 == 0);
+    const int64_t nb = k / QK_MXFP4;
+
+    const int8x16_t values = vld1q_s8(kvalues_mxfp4);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = GGML_E8M0_TO_FP32_HALF(x[i].e);
+        const uint8x16_t qs = vld1q_u8(x[i].qs);
+
+        store_i8x16(y +  0, vqtbl1q_s8(values, vandq_u8(qs, mask)), d);
+        store_i8x16(y + 16, vqtbl1q_s8(values, vshrq_n_u8(qs, 4)), d);
+        y += QK_MXFP4;
+    }
+}
+
+// ============================================================================
+// K-quants
+// ============================================================================
+
+void dequantize_row_q2_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q2_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const uint8x16_t mask = vdupq_n_u8(0x03);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const float min = fp16_to_fp32(x[i].dmin);
+
+        const uint8_t * q = x[i].qs;
+        const uint8_t * sc = x[i].scales;
+
+        for (int n = 0; n < QK_K; n += 128) {
+            const uint8x16_t q0 = vld1q_u8(q +  0);
+            const uint8x16_t q1 = vld1q_u8(q + 16);
+            for (int shift = 0; shift < 8; shift += 2) {
+                const int8x16_t count = vdupq_n_s8((int8_t) -shift);
+                store_u8x16_sub(y +  0, vandq_u8(vshlq_u8(q0, count), mask),
+                                d * (sc[0] & 0xF), min * (sc[0] >> 4));
+                store_u8x16_sub(y + 16, vandq_u8(vshlq_u8(q1, count), mask),
+                                d * (sc[1] & 0xF), min * (sc[1] >> 4));
+                y += 32;
+                sc += 2;
+            }
+            q += 32;
+        }
+    }
+}
+
+void dequantize_row_q3_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q3_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const uint8x16_t mask = vdupq_n_u8(0x03);
+    const uint8x16_t four = vdupq_n_u8(4);
+
+    int8_t scales[16];
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d_all = fp16_to_fp32(x[i].d);
+
+        const uint8_t * GGML_RESTRICT q = x[i].qs;
+        const uint8x16_t hm0 = vld1q_u8(x[i].hmask +  0);
+        const uint8x16_t hm1 = vld1q_u8(x[i].hmask + 16);
+
+        unpack_scales_q3_K(x[i].scales, scales);
+
+        int is = 0;
+        uint8_t m = 1;
+        for (int n = 0; n < QK_K; n += 128) {
+            const uint8x16_t q0 = vld1q_u8(q +  0);
+            const uint8x16_t q1 = vld1q_u8(q + 16);
+            for (int shift = 0; shift < 8; shift += 2) {
+                const int8x16_t count = vdupq_n_s8((int8_t) -shift);
+                const uint8x16_t bit = vdupq_n_u8(m);
+                // Subtract 4 wherever the high bit is clear
+                const uint8x16_t sub0 = vbicq_u8(four, vtstq_u8(hm0, bit));
+                const uint8x16_t sub1 = vbicq_u8(four, vtstq_u8(hm1, bit));
+                const int8x16_t v0 = vreinterpretq_s8_u8(vsubq_u8(vandq_u8(vshlq_u8(q0, count), mask), sub0));
+                const int8x16_t v1 = vreinterpretq_s8_u8(vsubq_u8(vandq_u8(vshlq_u8(q1, count), mask), sub1));
+
+                store_i8x16(y +  0, v0, d_all * (scales[is + 0] - 32));
+                store_i8x16(y + 16, v1, d_all * (scales[is + 1] - 32));
+                y += 32;
+                is += 2;
+                m <<= 1;
+            }
+            q += 32;
+        }
+    }
+}
+
+void dequantize_row_q4_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q4_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const uint8_t * q = x[i].qs;
+
+        const float d   = fp16_to_fp32(x[i].d);
+        const float min = fp16_to_fp32(x[i].dmin);
+
+        int is = 0;
+        uint8_t sc, m;
+        for (int j = 0; j < QK_K; j += 64) {
+            get_scale_min_k4(is + 0, x[i].scales, &sc, &m);
+            const float d1 = d * sc; const float m1 = min * m;
+            get_scale_min_k4(is + 1, x[i].scales, &sc, &m);
+            const float d2 = d * sc; const float m2 = min * m;
+
+            const uint8x16_t q0 = vld1q_u8(q +  0);
+            const uint8x16_t q1 = vld1q_u8(q + 16);
+            store_u8x16_sub(y +  0, vandq_u8(q0, mask), d1, m1);
+            store_u8x16_sub(y + 16, vandq_u8(q1, mask), d1, m1);
+            store_u8x16_sub(y + 32, vshrq_n_u8(q0, 4), d2, m2);
+            store_u8x16_sub(y + 48, vshrq_n_u8(q1, 4), d2, m2);
+            y += 64;
+            q += 32; is += 2;
+        }
+    }
+}
+
+void dequantize_row_q5_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q5_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    const uint8x16_t sixteen = vdupq_n_u8(16);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const uint8_t * ql = x[i].qs;
+        const uint8x16_t qh0 = vld1q_u8(x[i].qh +  0);
+        const uint8x16_t qh1 = vld1q_u8(x[i].qh + 16);
+
+        const float d = fp16_to_fp32(x[i].d);
+        const float min = fp16_to_fp32(x[i].dmin);
+
+        int is = 0;
+        uint8_t sc, m;
+        uint8_t u1 = 1, u2 = 2;
+        for (int j = 0; j < QK_K; j += 64) {
+            get_scale_min_k4(is + 0, x[i].scales, &sc, &m);
+            const float d1 = d * sc; const float m1 = min * m;
+            get_scale_min_k4(is + 1, x[i].scales, &sc, &m);
+            const float d2 = d * sc; const float m2 = min * m;
+
+            const uint8x16_t q0 = vld1q_u8(ql +  0);
+            const uint8x16_t q1 = vld1q_u8(ql + 16);
+            const uint8x16_t b1 = vdupq_n_u8(u1);
+            const uint8x16_t b2 = vdupq_n_u8(u2);
+
+            store_u8x16_sub(y +  0, vaddq_u8(vandq_u8(q0, mask), vandq_u8(vtstq_u8(qh0, b1), sixteen)), d1, m1);
+            store_u8x16_sub(y + 16, vaddq_u8(vandq_u8(q1, mask), vandq_u8(vtstq_u8(qh1, b1), sixteen)), d1, m1);
+            store_u8x16_sub(y + 32, vaddq_u8(vshrq_n_u8(q0, 4), vandq_u8(vtstq_u8(qh0, b2), sixteen)), d2, m2);
+            store_u8x16_sub(y + 48, vaddq_u8(vshrq_n_u8(q1, 4), vandq_u8(vtstq_u8(qh1, b2), sixteen)), d2, m2);
+            y += 64;
+            ql += 32; is += 2;
+            u1 <<= 2; u2 <<= 2;
+        }
+    }
+}
+
+void dequantize_row_q6_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q6_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const uint8x16_t mask_lo = vdupq_n_u8(0x0F);
+    const uint8x16_t mask_hi = vdupq_n_u8(0x03);
+    const int8x16_t offset = vdupq_n_s8(32);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+
+        const uint8_t * GGML_RESTRICT ql = x[i].ql;
+        const uint8_t * GGML_RESTRICT qh = x[i].qh;
+        const int8_t  * GGML_RESTRICT sc = x[i].scales;
+
+        for (int n = 0; n < QK_K; n += 128) {
+            // Two 16-element halves per 32-element group, each with its own scale
+            for (int half = 0; half < 2; ++half) {
+                const uint8x16_t l0 = vld1q_u8(ql + 16*half +  0);
+                const uint8x16_t l1 = vld1q_u8(ql + 16*half + 32);
+                const uint8x16_t h  = vld1q_u8(qh + 16*half);
+
+                const uint8x16_t q1 = vorrq_u8(vandq_u8(l0, mask_lo), vshlq_n_u8(vandq_u8(h, mask_hi), 4));
+                const uint8x16_t q2 = vorrq_u8(vandq_u8(l1, mask_lo), vshlq_n_u8(vandq_u8(vshrq_n_u8(h, 2), mask_hi), 4));
+                const uint8x16_t q3 = vorrq_u8(vshrq_n_u8(l0, 4), vshlq_n_u8(vandq_u8(vshrq_n_u8(h, 4), mask_hi), 4));
+                const uint8x16_t q4 = vorrq_u8(vshrq_n_u8(l1, 4), vshlq_n_u8(vshrq_n_u8(h, 6), 4));
+
+                float * yh = y + 16*half;
+                store_i8x16(yh +  0, vsubq_s8(vreinterpretq_s8_u8(q1), offset), d * sc[half + 0]);
+                store_i8x16(yh + 32, vsubq_s8(vreinterpretq_s8_u8(q2), offset), d * sc[half + 2]);
+                store_i8x16(yh + 64, vsubq_s8(vreinterpretq_s8_u8(q3), offset), d * sc[half + 4]);
+                store_i8x16(yh + 96, vsubq_s8(vreinterpretq_s8_u8(q4), offset), d * sc[half + 6]);
+            }
+            y  += 128;
+            ql += 64;
+            qh += 32;
+            sc += 8;
+        }
+    }
+}
+
+void dequantize_row_q8_K_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_q8_K * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        for (int j = 0; j < QK_K; j += 16) {
+            store_i8x16(y + j, vld1q_s8(x[i].qs + j), x[i].d);
+        }
+        y += QK_K;
+    }
+}
+
+// ============================================================================
+// IQ types
+// ============================================================================
+
+void dequantize_row_iq4_nl_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq4_nl * GGML_RESTRICT x = vx;
+    assert(k % QK4_NL == 0);
+    const int64_t nb = k / QK4_NL;
+
+    const int8x16_t values = vld1q_s8(kvalues_iq4nl);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const uint8x16_t qs = vld1q_u8(x[i].qs);
+
+        store_i8x16(y +  0, vqtbl1q_s8(values, vandq_u8(qs, mask)), d);
+        store_i8x16(y + 16, vqtbl1q_s8(values, vshrq_n_u8(qs, 4)), d);
+        y += QK4_NL;
+    }
+}
+
+void dequantize_row_iq4_xs_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq4_xs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const int8x16_t values = vld1q_s8(kvalues_iq4nl);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const uint8_t * qs = x[i].qs;
+
+        for (int ib = 0; ib < QK_K/32; ++ib) {
+            const int ls = ((x[i].scales_l[ib/2] >> 4*(ib%2)) & 0xf) | (((x[i].scales_h >> 2*ib) & 3) << 4);
+            const float dl = d * (ls - 32);
+            const uint8x16_t q = vld1q_u8(qs);
+            store_i8x16(y +  0, vqtbl1q_s8(values, vandq_u8(q, mask)), dl);
+            store_i8x16(y + 16, vqtbl1q_s8(values, vshrq_n_u8(q, 4)), dl);
+            y  += 32;
+            qs += 16;
+        }
+    }
+}
+
+// NEON has no gather, so the 2- and 3-bit IQ kernels load each grid point
+// with one 64-bit lookup and widen and sign all eight values in registers.
+
+void dequantize_row_iq2_xxs_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq2_xxs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            uint32_t aux32[2];
+            memcpy(aux32, x[i].qs + 4*ib32, sizeof(aux32));
+            const float db = d * (0.5f + (aux32[1] >> 28)) * 0.25f;
+            const uint64_t grid[4] = {
+                iq2xxs_grid[(aux32[0] >>  0) & 0xFF], iq2xxs_grid[(aux32[0] >>  8) & 0xFF],
+                iq2xxs_grid[(aux32[0] >> 16) & 0xFF], iq2xxs_grid[(aux32[0] >> 24) & 0xFF],
+            };
+            store_grid32_signed(y, grid, ksigns_x4(aux32[1]), db, db);
+            y += 32;
+        }
+    }
+}
+
+void dequantize_row_iq2_xs_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq2_xs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            const uint16_t * qs = x[i].qs + 4*ib32;
+            const float db0 = d * (0.5f + (x[i].scales[ib32] & 0xf)) * 0.25f;
+            const float db1 = d * (0.5f + (x[i].scales[ib32] >>  4)) * 0.25f;
+            const uint64_t grid[4] = {
+                iq2xs_grid[qs[0] & 511], iq2xs_grid[qs[1] & 511], iq2xs_grid[qs[2] & 511], iq2xs_grid[qs[3] & 511],
+            };
+            const uint32_t signs = (uint32_t) ksigns_iq2xs[qs[0] >> 9]       | (uint32_t) ksigns_iq2xs[qs[1] >> 9] <<  8 |
+                                   (uint32_t) ksigns_iq2xs[qs[2] >> 9] << 16 | (uint32_t) ksigns_iq2xs[qs[3] >> 9] << 24;
+            store_grid32_signed(y, grid, signs, db0, db1);
+            y += 32;
+        }
+    }
+}
+
+void dequantize_row_iq2_s_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq2_s * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * signs = qs + QK_K/8;
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            const float db0 = d * (0.5f + (x[i].scales[ib32] & 0xf)) * 0.25f;
+            const float db1 = d * (0.5f + (x[i].scales[ib32] >>  4)) * 0.25f;
+            const int qh = x[i].qh[ib32];
+            const uint64_t grid[4] = {
+                iq2s_grid[qs[0] | ((qh << 8) & 0x300)], iq2s_grid[qs[1] | ((qh << 6) & 0x300)],
+                iq2s_grid[qs[2] | ((qh << 4) & 0x300)], iq2s_grid[qs[3] | ((qh << 2) & 0x300)],
+            };
+            uint32_t sign_bits;
+            memcpy(&sign_bits, signs, sizeof(sign_bits));
+            store_grid32_signed(y, grid, sign_bits, db0, db1);
+            y += 32;
+            qs += 4;
+            signs += 4;
+        }
+    }
+}
+
+void dequantize_row_iq3_xxs_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq3_xxs * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * scales_and_signs = qs + QK_K/4;
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            uint32_t aux32;
+            memcpy(&aux32, scales_and_signs + 4*ib32, sizeof(aux32));
+            const float db = d * (0.5f + (aux32 >> 28)) * 0.5f;
+            uint64_t grid[4];
+            for (int l = 0; l < 4; ++l) {
+                grid[l] = iq3xxs_grid[qs[2*l+0]] | (uint64_t) iq3xxs_grid[qs[2*l+1]] << 32;
+            }
+            store_grid32_signed(y, grid, ksigns_x4(aux32), db, db);
+            y += 32;
+            qs += 8;
+        }
+    }
+}
+
+void dequantize_row_iq3_s_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq3_s * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * signs = x[i].signs;
+
+        for (int ib32 = 0; ib32 < QK_K/32; ++ib32) {
+            const float db = d * (1 + 2*((x[i].scales[ib32/2] >> 4*(ib32%2)) & 0xf));
+            const int qh = x[i].qh[ib32];
+            uint64_t grid[4];
+            for (int l = 0; l < 4; ++l) {
+                grid[l] = iq3s_grid[qs[2*l+0] | ((qh << (8-2*l)) & 256)] |
+                          (uint64_t) iq3s_grid[qs[2*l+1] | ((qh << (7-2*l)) & 256)] << 32;
+            }
+            uint32_t sign_bits;
+            memcpy(&sign_bits, signs, sizeof(sign_bits));
+            store_grid32_signed(y, grid, sign_bits, db, db);
+            y += 32;
+            qs += 8;
+            signs += 4;
+        }
+    }
+}
+
+void dequantize_row_iq1_s_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq1_s * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const uint8_t * qs = x[i].qs;
+
+        for (int ib = 0; ib < QK_K/32; ++ib) {
+            const uint16_t qh = x[i].qh[ib];
+            const float dl = d * (2*((qh >> 12) & 7) + 1);
+            const float delta = qh & 0x8000 ? -IQ1S_DELTA : IQ1S_DELTA;
+            for (int l = 0; l < 4; ++l) {
+                const uint64_t grid = iq1s_grid[qs[l] | (((qh >> 3*l) & 7) << 8)];
+                store_i8x8_offset(y, vreinterpret_s8_u64(vcreate_u64(grid)), delta, dl);
+                y += 8;
+            }
+            qs += 4;
+        }
+    }
+}
+
+void dequantize_row_iq1_m_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_iq1_m * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    for (int64_t i = 0; i < nb; i++) {
+        uint16_t sc[4];
+        memcpy(sc, x[i].scales, sizeof(sc));
+        const float d = fp16_to_fp32(iq1m_scale(sc));
+        const uint8_t * qs = x[i].qs;
+        const uint8_t * qh = x[i].qh;
+
+        for (int ib = 0; ib < QK_K/32; ++ib) {
+            const float dl1 = d * (2*((sc[ib/2] >> (6*(ib%2)+0)) & 0x7) + 1);
+            const float dl2 = d * (2*((sc[ib/2] >> (6*(ib%2)+3)) & 0x7) + 1);
+            for (int l = 0; l < 4; ++l) {
+                // Nibble l of the two qh bytes: three index bits, then the delta sign
+                const int nibble = (qh[l/2] >> 4*(l%2)) & 0xF;
+                const uint64_t grid = iq1s_grid[qs[l] | ((nibble & 7) << 8)];
+                const float delta = nibble & 8 ? -IQ1M_DELTA : IQ1M_DELTA;
+                store_i8x8_offset(y, vreinterpret_s8_u64(vcreate_u64(grid)), delta, l < 2 ? dl1 : dl2);
+                y += 8;
+            }
+            qs += 4;
+            qh += 2;
+        }
+    }
+}
+
+// ============================================================================
+// Ternary types
+// ============================================================================
+
+void dequantize_row_tq1_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_tq1_0 * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    static const uint8_t pow3[5] = {1, 3, 9, 27, 81};
+    // The four qh bytes, repeated once per digit in output order
+    static const uint8_t pow3_qh[16] = {1, 1, 1, 1, 3, 3, 3, 3, 9, 9, 9, 9, 27, 27, 27, 27};
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+        const uint8x16_t q0 = vld1q_u8(x[i].qs +  0);
+        const uint8x16_t q1 = vld1q_u8(x[i].qs + 16);
+        const uint8x16_t q2 = vld1q_u8(x[i].qs + 32);
+
+        for (int n = 0; n < 5; ++n) {
+            const uint8x16_t p = vdupq_n_u8(pow3[n]);
+            store_i8x16(y +  0, ternary_digits(q0, p), d);
+            store_i8x16(y + 16, ternary_digits(q1, p), d);
+            y += 32;
+        }
+        for (int n = 0; n < 5; ++n) {
+            store_i8x16(y, ternary_digits(q2, vdupq_n_u8(pow3[n])), d);
+            y += 16;
+        }
+
+        uint32_t qh;
+        memcpy(&qh, x[i].qh, sizeof(qh));
+        store_i8x16(y, ternary_digits(vreinterpretq_u8_u32(vdupq_n_u32(qh)), vld1q_u8(pow3_qh)), d);
+        y += 16;
+    }
+}
+
+void dequantize_row_tq2_0_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t k) {
+    const block_tq2_0 * GGML_RESTRICT x = vx;
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+
+    const uint8x16_t mask = vdupq_n_u8(0x03);
+    const int8x16_t one = vdupq_n_s8(1);
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float d = fp16_to_fp32(x[i].d);
+
+        for (int j = 0; j < QK_K/4; j += 32) {
+            const uint8x16_t q0 = vld1q_u8(x[i].qs + j +  0);
+            const uint8x16_t q1 = vld1q_u8(x[i].qs + j + 16);
+            for (int l = 0; l < 4; ++l) {
+                const int8x16_t shift = vdupq_n_s8((int8_t) (-2*l));
+                const uint8x16_t t0 = vandq_u8(vshlq_u8(q0, shift), mask);
+                const uint8x16_t t1 = vandq_u8(vshlq_u8(q1, shift), mask);
+                store_i8x16(y +  0, vsubq_s8(vreinterpretq_s8_u8(t0), one), d);
+                store_i8x16(y + 16, vsubq_s8(vreinterpretq_s8_u8(t1), one), d);
+                y += 32;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Dot products
+// ============================================================================
+
+// acc += pairwise-widened products of 16 signed bytes (no dotprod extension needed)
+static inline int32x4_t dot_s8x16(int32x4_t acc, int8x16_t a, int8x16_t b) {
+    const int16x8_t p0 = vmull_s8(vget_low_s8(a),  vget_low_s8(b));
+    const int16x8_t p1 = vmull_s8(vget_high_s8(a), vget_high_s8(b));
+    return vpadalq_s16(vpadalq_s16(acc, p0), p1);
+}
+
+float ggml_vec_dot_f32_neon(const float * GGML_RESTRICT x, const float * GGML_RESTRICT y, int64_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    float32x4_t acc2 = vdupq_n_f32(0.0f);
+    float32x4_t acc3 = vdupq_n_f32(0.0f);
+
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(x + i +  0), vld1q_f32(y + i +  0)));
+        acc1 = vaddq_f32(acc1, vmulq_f32(vld1q_f32(x + i +  4), vld1q_f32(y + i +  4)));
+        acc2 = vaddq_f32(acc2, vmulq_f32(vld1q_f32(x + i +  8), vld1q_f32(y + i +  8)));
+        acc3 = vaddq_f32(acc3, vmulq_f32(vld1q_f32(x + i + 12), vld1q_f32(y + i + 12)));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(x + i), vld1q_f32(y + i)));
+    }
+
+    float sum = vaddvq_f32(vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3)));
+    for (; i < n; ++i) {
+        sum += x[i]*y[i];
+    }
+    return sum;
+}
+
+float ggml_vec_dot_q4_0_q8_0_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK8_0 == 0);
+    const int64_t nb = n / QK8_0;
+
+    const block_q4_0 * GGML_RESTRICT x = vx;
+    const block_q8_0 * GGML_RESTRICT y = vy;
+
+    const uint8x16_t m4b = vdupq_n_u8(0x0F);
+    const int8x16_t s8b = vdupq_n_s8(8);
+
+    float32x4_t acc = vdupq_n_f32(0.0f);
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        const uint8x16_t qs = vld1q_u8(x[ib].qs);
+        const int8x16_t lo = vsubq_s8(vreinterpretq_s8_u8(vandq_u8(qs, m4b)), s8b);
+        const int8x16_t hi = vsubq_s8(vreinterpretq_s8_u8(vshrq_n_u8(qs, 4)), s8b);
+
+        int32x4_t sumi = vdupq_n_s32(0);
+        sumi = dot_s8x16(sumi, lo, vld1q_s8(y[ib].qs +  0));
+        sumi = dot_s8x16(sumi, hi, vld1q_s8(y[ib].qs + 16));
+
+        const float d = fp16_to_fp32(x[ib].d) * fp16_to_fp32(y[ib].d);
+        acc = vaddq_f32(acc, vmulq_n_f32(vcvtq_f32_s32(sumi), d));
+    }
+
+    return vaddvq_f32(acc);
+}
+
+float ggml_vec_dot_q8_0_q8_0_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK8_0 == 0);
+    const int64_t nb = n / QK8_0;
+
+    const block_q8_0 * GGML_RESTRICT x = vx;
+    const block_q8_0 * GGML_RESTRICT y = vy;
+
+    float32x4_t acc = vdupq_n_f32(0.0f);
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        int32x4_t sumi = vdupq_n_s32(0);
+        sumi = dot_s8x16(sumi, vld1q_s8(x[ib].qs +  0), vld1q_s8(y[ib].qs +  0));
+        sumi = dot_s8x16(sumi, vld1q_s8(x[ib].qs + 16), vld1q_s8(y[ib].qs + 16));
+
+        const float d = fp16_to_fp32(x[ib].d) * fp16_to_fp32(y[ib].d);
+        acc = vaddq_f32(acc, vmulq_n_f32(vcvtq_f32_s32(sumi), d));
+    }
+
+    return vaddvq_f32(acc);
+}
+
+float ggml_vec_dot_q4_K_q8_K_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int64_t nb = n / QK_K;
+
+    const block_q4_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    const uint8x16_t m4b = vdupq_n_u8(0x0F);
+
+    float sumf = 0.0f;
+
+    for (int64_t i = 0; i < nb; ++i) {
+        const uint8_t * GGML_RESTRICT q4 = x[i].qs;
+        const  int8_t * GGML_RESTRICT q8 = y[i].qs;
+
+        int isum = 0;
+        int mins = 0;
+        uint8_t sc_lo, m_lo, sc_hi, m_hi;
+
+        for (int j = 0; j < QK_K/64; ++j) {
+            get_scale_min_k4(2*j + 0, x[i].scales, &sc_lo, &m_lo);
+            get_scale_min_k4(2*j + 1, x[i].scales, &sc_hi, &m_hi);
+            mins += m_lo * (y[i].bsums[4*j + 0] + y[i].bsums[4*j + 1]);
+            mins += m_hi * (y[i].bsums[4*j + 2] + y[i].bsums[4*j + 3]);
+
+            const uint8x16_t q4b0 = vld1q_u8(q4 +  0);
+            const uint8x16_t q4b1 = vld1q_u8(q4 + 16);
+
+            int32x4_t lo = vdupq_n_s32(0);
+            lo = dot_s8x16(lo, vreinterpretq_s8_u8(vandq_u8(q4b0, m4b)), vld1q_s8(q8 +  0));
+            lo = dot_s8x16(lo, vreinterpretq_s8_u8(vandq_u8(q4b1, m4b)), vld1q_s8(q8 + 16));
+
+            int32x4_t hi = vdupq_n_s32(0);
+            hi = dot_s8x16(hi, vreinterpretq_s8_u8(vshrq_n_u8(q4b0, 4)), vld1q_s8(q8 + 32));
+            hi = dot_s8x16(hi, vreinterpretq_s8_u8(vshrq_n_u8(q4b1, 4)), vld1q_s8(q8 + 48));
+
+            isum += sc_lo * vaddvq_s32(lo) + sc_hi * vaddvq_s32(hi);
+
+            q4 += 32;
+            q8 += 64;
+        }
+
+        const float d    = fp16_to_fp32(x[i].d)    * y[i].d;
+        const float dmin = fp16_to_fp32(x[i].dmin) * y[i].d;
+        sumf += d * isum - dmin * mins;
+    }
+
+    return sumf;
+}
+
+float ggml_vec_dot_q6_K_q8_K_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n) {
+    assert(n % QK_K == 0);
+    const int64_t nb = n / QK_K;
+
+    const block_q6_K * GGML_RESTRICT x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    const uint8x16_t m4b = vdupq_n_u8(0x0F);
+    const uint8x16_t m2b = vdupq_n_u8(3);
+    const int8x16_t s32b = vdupq_n_s8(32);
+
+    float sumf = 0.0f;
+
+    for (int64_t i = 0; i < nb; ++i) {
+        const uint8_t * GGML_RESTRICT ql = x[i].ql;
+        const uint8_t * GGML_RESTRICT qh = x[i].qh;
+        const  int8_t * GGML_RESTRICT q8 = y[i].qs;
+        const  int8_t * GGML_RESTRICT sc = x[i].scales;
+
+        int isum = 0;
+
+        for (int j = 0; j < QK_K/128; ++j) {
+            for (int h = 0; h < 2; ++h) {
+                // 16-byte halves of the 32-element groups; group k uses scales sc[2k + h]
+                const uint8x16_t ql0 = vld1q_u8(ql + 16*h);
+                const uint8x16_t ql1 = vld1q_u8(ql + 16*h + 32);
+                const uint8x16_t qhb = vld1q_u8(qh + 16*h);
+
+                int8x16_t q[4];
+                q[0] = vsubq_s8(vreinterpretq_s8_u8(vorrq_u8(vandq_u8(ql0, m4b), vshlq_n_u8(vandq_u8(qhb, m2b), 4))), s32b);
+                q[1] = vsubq_s8(vreinterpretq_s8_u8(vorrq_u8(vandq_u8(ql1, m4b), vshlq_n_u8(vandq_u8(vshrq_n_u8(qhb, 2), m2b), 4))), s32b);
+                q[2] = vsubq_s8(vreinterpretq_s8_u8(vorrq_u8(vshrq_n_u8(ql0, 4), vshlq_n_u8(vandq_u8(vshrq_n_u8(qhb, 4), m2b), 4))), s32b);
+                q[3] = vsubq_s8(vreinterpretq_s8_u8(vorrq_u8(vshrq_n_u8(ql1, 4), vshlq_n_u8(vshrq_n_u8(qhb, 6), 4))), s32b);
+
+                for (int k = 0; k < 4; ++k) {
+                    const int32x4_t p = dot_s8x16(vdupq_n_s32(0), q[k], vld1q_s8(q8 + 32*k + 16*h));
+                    isum += sc[2*k + h] * vaddvq_s32(p);
+                }
+            }
+
+            ql += 64;
+            qh += 32;
+            q8 += 128;
+            sc += 8;
+        }
+
+        sumf += fp16_to_fp32(x[i].d) * y[i].d * isum;
+    }
+
+    return sumf;
+}
+
+// ============================================================================
+// Interleaved dot products
+// ============================================================================
+
+// The four rows of a group sit in the four 32-bit lanes: each 16-byte load
+// holds one 4-byte chunk per row, dotted with the same four activations.
+
+// Four activation bytes repeated in every 32-bit lane
+static inline int8x16_t broadcast_s8x4(const int8_t * q) {
+    int32_t v;
+    memcpy(&v, q, sizeof(v));
+    return vreinterpretq_s8_s32(vdupq_n_s32(v));
+}
+
+// acc[r] += sum of the four byte products in lane r
+static inline int32x4_t dot_s8x4x4(int32x4_t acc, int8x16_t a, int8x16_t b) {
+    const int16x8_t p0 = vmull_s8(vget_low_s8(a),  vget_low_s8(b));
+    const int16x8_t p1 = vmull_s8(vget_high_s8(a), vget_high_s8(b));
+    return vaddq_s32(acc, vpaddq_s32(vpaddlq_s16(p0), vpaddlq_s16(p1)));
+}
+
+// Four unsigned bytes widened to the four 32-bit lanes
+static inline int32x4_t u8x4_to_s32(const uint8_t * q) {
+    uint32_t v;
+    memcpy(&v, q, sizeof(v));
+    const uint8x8_t b = vreinterpret_u8_u32(vdup_n_u32(v));
+    return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(b))));
+}
+
+static inline float32x4_t fp16x4_to_f32(const ggml_half * h) {
+    const float v[4] = { fp16_to_fp32(h[0]), fp16_to_fp32(h[1]), fp16_to_fp32(h[2]), fp16_to_fp32(h[3]) };
+    return vld1q_f32(v);
+}
+
+void ggml_gemv_q4_0x4_q8_0_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    assert(n % QK8_0 == 0);
+    const int64_t nb = n / QK8_0;
+
+    const block_q4_0x4 * GGML_RESTRICT x = vx;
+    const block_q8_0   * GGML_RESTRICT y = vy;
+
+    const uint8x16_t m4b = vdupq_n_u8(0x0F);
+    const int8x16_t s8b = vdupq_n_s8(8);
+
+    float32x4_t acc = vdupq_n_f32(0.0f);
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        int32x4_t sumi = vdupq_n_s32(0);
+        for (int c = 0; c < QK4_0/8; ++c) {
+            const uint8x16_t qs = vld1q_u8(x[ib].qs + 16*c);
+            const int8x16_t lo = vsubq_s8(vreinterpretq_s8_u8(vandq_u8(qs, m4b)), s8b);
+            const int8x16_t hi = vsubq_s8(vreinterpretq_s8_u8(vshrq_n_u8(qs, 4)), s8b);
+            sumi = dot_s8x4x4(sumi, lo, broadcast_s8x4(y[ib].qs + 4*c));
+            sumi = dot_s8x4x4(sumi, hi, broadcast_s8x4(y[ib].qs + QK8_0/2 + 4*c));
+        }
+
+        const float32x4_t dx = fp16x4_to_f32(x[ib].d);
+        acc = vaddq_f32(acc, vmulq_n_f32(vmulq_f32(vcvtq_f32_s32(sumi), dx), fp16_to_fp32(y[ib].d)));
+    }
+
+    vst1q_f32(s, acc);
+}
+
+void ggml_gemv_q8_0x4_q8_0_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    assert(n % QK8_0 == 0);
+    const int64_t nb = n / QK8_0;
+
+    const block_q8_0x4 * GGML_RESTRICT x = vx;
+    const block_q8_0   * GGML_RESTRICT y = vy;
+
+    float32x4_t acc = vdupq_n_f32(0.0f);
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        int32x4_t sumi = vdupq_n_s32(0);
+        for (int c = 0; c < QK8_0/4; ++c) {
+            sumi = dot_s8x4x4(sumi, vld1q_s8(x[ib].qs + 16*c), broadcast_s8x4(y[ib].qs + 4*c));
+        }
+
+        const float32x4_t d = vmulq_n_f32(fp16x4_to_f32(x[ib].d), fp16_to_fp32(y[ib].d));
+        acc = vaddq_f32(acc, vmulq_f32(vcvtq_f32_s32(sumi), d));
+    }
+
+    vst1q_f32(s, acc);
+}
+
+void ggml_gemv_q4_Kx4_q8_K_neon(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    assert(n % QK_K == 0);
+    const int64_t nb = n / QK_K;
+
+    const block_q4_Kx4 * GGML_RESTRICT x = vx;
+    const block_q8_K   * GGML_RESTRICT y = vy;
+
+    const uint8x16_t m4b = vdupq_n_u8(0x0F);
+
+    float32x4_t acc = vdupq_n_f32(0.0f);
+
+    for (int64_t i = 0; i < nb; ++i) {
+        const uint8_t * GGML_RESTRICT q4 = x[i].qs;
+        const  int8_t * GGML_RESTRICT q8 = y[i].qs;
+
+        int32x4_t isum  = vdupq_n_s32(0);
+        int32x4_t summs = vdupq_n_s32(0);
+
+        for (int j = 0; j < QK_K/64; ++j) {
+            int32x4_t sum_lo = vdupq_n_s32(0);
+            int32x4_t sum_hi = vdupq_n_s32(0);
+            for (int c = 0; c < 8; ++c) {
+                const uint8x16_t qs = vld1q_u8(q4 + 16*c);
+                sum_lo = dot_s8x4x4(sum_lo, vreinterpretq_s8_u8(vandq_u8(qs, m4b)), broadcast_s8x4(q8 + 4*c));
+                sum_hi = dot_s8x4x4(sum_hi, vreinterpretq_s8_u8(vshrq_n_u8(qs, 4)), broadcast_s8x4(q8 + 32 + 4*c));
+            }
+
+            const int32x4_t sc_lo = u8x4_to_s32(x[i].scales[2*j + 0]);
+            const int32x4_t sc_hi = u8x4_to_s32(x[i].scales[2*j + 1]);
+            const int32x4_t m_lo  = u8x4_to_s32(x[i].mins[2*j + 0]);
+            const int32x4_t m_hi  = u8x4_to_s32(x[i].mins[2*j + 1]);
+            isum  = vmlaq_s32(isum, sc_lo, sum_lo);
+            isum  = vmlaq_s32(isum, sc_hi, sum_hi);
+            summs = vmlaq_n_s32(summs, m_lo, y[i].bsums[4*j + 0] + y[i].bsums[4*j + 1]);
+            summs = vmlaq_n_s32(summs, m_hi, y[i].bsums[4*j + 2] + y[i].bsums[4*j + 3]);
+
+            q4 += 8*16;
+            q8 += 64;
+        }
+
+        const float32x4_t d    = vmulq_n_f32(fp16x4_to_f32(x[i].d),    y[i].d);
+        const float32x4_t dmin = vmulq_n_f32(fp16x4_to_f32(x[i].dmin), y[i].d);
+        acc = vaddq_f32(acc, vsubq_f32(vmulq_f32(d, vcvtq_f32_s32(isum)), vmulq_f32(dmin, vcvtq_f32_s32(summs))));
+    }
+
+    vst1q_f32(s, acc);
+}
+
+// ============================================================================
+// Quantization
+// ============================================================================
+
+// Largest |x[0..n-1]|, n a multiple of 4
+static inline float amax_f32(const float * GGML_RESTRICT x, int n) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (int j = 0; j < n; j += 4) {
+        acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(x + j)));
+    }
+    return vmaxvq_f32(acc);
+}
+
+// Four vectors of 4 x i32 (in element order) -> 16 x i8 with signed saturation
+static inline int8x16_t pack_i32_to_i8(int32x4_t a, int32x4_t b, int32x4_t c, int32x4_t d) {
+    const int16x8_t ab = vcombine_s16(vqmovn_s32(a), vqmovn_s32(b));
+    const int16x8_t cd = vcombine_s16(vqmovn_s32(c), vqmovn_s32(d));
+    return vcombine_s8(vqmovn_s16(ab), vqmovn_s16(cd));
+}
+
+// min(15, (int)(x * id + offset)) for 16 values, as bytes
+static inline uint8x16_t quantize_nibble_16(const float * GGML_RESTRICT x, float32x4_t m, float id, float offset) {
+    int32x4_t q[4];
+    for (int l = 0; l < 4; ++l) {
+        const float32x4_t v = vmulq_n_f32(vsubq_f32(vld1q_f32(x + 4*l), m), id);
+        q[l] = vminq_s32(vcvtq_s32_f32(vaddq_f32(v, vdupq_n_f32(offset))), vdupq_n_s32(15));
+    }
+    return vreinterpretq_u8_s8(pack_i32_to_i8(q[0], q[1], q[2], q[3]));
+}
+
+void quantize_row_q4_0_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK4_0 == 0);
+    const int64_t nb = k / QK4_0;
+    block_q4_0 * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float amax = amax_f32(x, QK4_0);
+        const float max = signed_amax_f32(x, QK4_0, amax);
+
+        const float d  = max / -8;
+        const float id = d ? 1.0f/d : 0.0f;
+
+        y[i].d = GGML_FP32_TO_FP16(d);
+
+        // x - 0 is exact, so the shared helper matches x * id
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const uint8x16_t lo = quantize_nibble_16(x +  0, zero, id, 8.5f);
+        const uint8x16_t hi = quantize_nibble_16(x + 16, zero, id, 8.5f);
+        vst1q_u8(y[i].qs, vorrq_u8(lo, vshlq_n_u8(hi, 4)));
+        x += QK4_0;
+    }
+}
+
+void quantize_row_q4_1_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK4_1 == 0);
+    const int64_t nb = k / QK4_1;
+    block_q4_1 * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        float32x4_t vmin = vld1q_f32(x);
+        float32x4_t vmax = vmin;
+        for (int j = 4; j < QK4_1; j += 4) {
+            const float32x4_t v = vld1q_f32(x + j);
+            vmin = vminq_f32(vmin, v);
+            vmax = vmaxq_f32(vmax, v);
+        }
+        float min = vminvq_f32(vmin);
+        const float max = vmaxvq_f32(vmax);
+        if (min == 0.0f) {
+            min = first_zero_f32(x, QK4_1);
+        }
+
+        const float d  = (max - min) / ((1 << 4) - 1);
+        const float id = d ? 1.0f/d : 0.0f;
+
+        y[i].d = GGML_FP32_TO_FP16(d);
+        y[i].m = GGML_FP32_TO_FP16(min);
+
+        const float32x4_t vm = vdupq_n_f32(min);
+        const uint8x16_t lo = quantize_nibble_16(x +  0, vm, id, 0.5f);
+        const uint8x16_t hi = quantize_nibble_16(x + 16, vm, id, 0.5f);
+        vst1q_u8(y[i].qs, vorrq_u8(lo, vshlq_n_u8(hi, 4)));
+        x += QK4_1;
+    }
+}
+
+// roundf(x * id) for 32 values into qs; returns their total
+static inline int quantize_i8_32(const float * GGML_RESTRICT x, float id, int8_t * GGML_RESTRICT qs) {
+    int32x4_t sum = vdupq_n_s32(0);
+    for (int j = 0; j < 32; j += 16) {
+        int32x4_t q[4];
+        for (int l = 0; l < 4; ++l) {
+            // vrndaq rounds ties away from zero, like roundf
+            q[l] = vcvtq_s32_f32(vrndaq_f32(vmulq_n_f32(vld1q_f32(x + j + 4*l), id)));
+            sum = vaddq_s32(sum, q[l]);
+        }
+        vst1q_s8(qs + j, pack_i32_to_i8(q[0], q[1], q[2], q[3]));
+    }
+    return vaddvq_s32(sum);
+}
+
+void quantize_row_q8_0_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK8_0 == 0);
+    const int64_t nb = k / QK8_0;
+    block_q8_0 * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float amax = amax_f32(x, QK8_0);
+
+        const float d = amax / ((1 << 7) - 1);
+        const float id = d ? 1.0f/d : 0.0f;
+
+        y[i].d = GGML_FP32_TO_FP16(d);
+        quantize_i8_32(x, id, y[i].qs);
+        x += QK8_0;
+    }
+}
+
+void quantize_row_q8_1_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK8_1 == 0);
+    const int64_t nb = k / QK8_1;
+    block_q8_1 * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float amax = amax_f32(x, QK8_1);
+
+        const float d = amax / ((1 << 7) - 1);
+        const float id = d ? 1.0f/d : 0.0f;
+
+        y[i].d = GGML_FP32_TO_FP16(d);
+        const int sum = quantize_i8_32(x, id, y[i].qs);
+        y[i].s = GGML_FP32_TO_FP16(sum*d);
+        x += QK8_1;
+    }
+}
+
+void quantize_row_q8_K_neon(const float * GGML_RESTRICT x, void * GGML_RESTRICT vy, int64_t k) {
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+    block_q8_K * GGML_RESTRICT y = vy;
+
+    for (int64_t i = 0; i < nb; i++) {
+        const float amax = amax_f32(x, QK_K);
+        if (!amax) {
+            y[i].d = 0;
+            memset(y[i].qs, 0, QK_K);
+            memset(y[i].bsums, 0, sizeof(y[i].bsums));
+            x += QK_K;
+            continue;
+        }
+        const float max = signed_amax_f32(x, QK_K, amax);
+        const float iscale = -127.f/max;
+
+        for (int j = 0; j < QK_K; j += 16) {
+            int32x4_t q[4];
+            for (int l = 0; l < 4; ++l) {
+                // vcvtnq rounds ties to even, like nearest_int
+                const int32x4_t v = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(x + j + 4*l), iscale));
+                q[l] = vminq_s32(v, vdupq_n_s32(127));
+            }
+            vst1q_s8(y[i].qs + j, pack_i32_to_i8(q[0], q[1], q[2], q[3]));
+            y[i].bsums[j/16] = vaddvq_s32(vaddq_s32(vaddq_s32(q[0], q[1]), vaddq_s32(q[2], q[3])));
+        }
+        y[i].d = 1/iscale;
+        x += QK_K;
+    }
+}
+
+
+// ============================================================================
+// Half precision output
+// ============================================================================
+
+static inline bool any_nan_f32x4(float32x4_t v) {
+    return vmaxvq_u32(vmvnq_u32(vceqq_f32(v, v))) != 0;
+}
+
+void ggml_fp32_to_fp16_row_neon(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n) {
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t v0 = vld1q_f32(x + i + 0);
+        const float32x4_t v1 = vld1q_f32(x + i + 4);
+        // The hardware keeps NaN payloads, the scalar encoder does not
+        if (any_nan_f32x4(v0) || any_nan_f32x4(v1)) {
+            ggml_fp32_to_fp16_row_ref(x + i, y + i, 8);
+            continue;
+        }
+        const float16x8_t h = vcvt_high_f16_f32(vcvt_f16_f32(v0), v1);
+        vst1q_u16(y + i, vreinterpretq_u16_f16(h));
+    }
+    ggml_fp32_to_fp16_row_ref(x + i, y + i, n - i);
+}
+
+// Upper halves of 4 floats rounded to nearest even; NaNs are truncated and made quiet
+static inline uint16x4_t fp32_to_bf16_x4(uint32x4_t w) {
+    const uint32x4_t hi = vshrq_n_u32(w, 16);
+    const uint32x4_t bias = vaddq_u32(vdupq_n_u32(0x7FFF), vandq_u32(hi, vdupq_n_u32(1)));
+    const uint32x4_t rounded = vshrq_n_u32(vaddq_u32(w, bias), 16);
+    const uint32x4_t nan = vcgtq_u32(vandq_u32(w, vdupq_n_u32(0x7FFFFFFF)), vdupq_n_u32(0x7F800000));
+    return vmovn_u32(vbslq_u32(nan, vorrq_u32(hi, vdupq_n_u32(64)), rounded));
+}
+
+void ggml_fp32_to_bf16_row_neon(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n) {
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const uint16x4_t lo = fp32_to_bf16_x4(vreinterpretq_u32_f32(vld1q_f32(x + i + 0)));
+        const uint16x4_t hi = fp32_to_bf16_x4(vreinterpretq_u32_f32(vld1q_f32(x + i + 4)));
+        vst1q_u16(y + i, vcombine_u16(lo, hi));
+    }
+    ggml_fp32_to_bf16_row_ref(x + i, y + i, n - i);
+}
+
+// ============================================================================
+// Element conversion
+// ============================================================================
+
+// Loads go through bytes: tensor data may sit at any address
+
+void ggml_fp16_to_fp32_row_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const float16x8_t h = vreinterpretq_f16_u8(vld1q_u8(x + i*2));
+        vst1q_f32(y + i + 0, vcvt_f32_f16(vget_low_f16(h)));
+        vst1q_f32(y + i + 4, vcvt_high_f32_f16(h));
+    }
+    ggml_fp16_to_fp32_row(x + i*2, y + i, n - i);
+}
+
+void ggml_bf16_to_fp32_row_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const uint16x8_t h = vreinterpretq_u16_u8(vld1q_u8(x + i*2));
+        vst1q_f32(y + i + 0, vreinterpretq_f32_u32(vshll_n_u16(vget_low_u16(h), 16)));
+        vst1q_f32(y + i + 4, vreinterpretq_f32_u32(vshll_n_u16(vget_high_u16(h), 16)));
+    }
+    ggml_bf16_to_fp32_row(x + i*2, y + i, n - i);
+}
+
+void ggml_f64_to_fp32_row_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float64x2_t lo = vreinterpretq_f64_u8(vld1q_u8(x + i*8 + 0));
+        const float64x2_t hi = vreinterpretq_f64_u8(vld1q_u8(x + i*8 + 16));
+        vst1q_f32(y + i, vcvt_high_f32_f64(vcvt_f32_f64(lo), hi));
+    }
+    ggml_f64_to_fp32_row_ref(x + i*8, y + i, n - i);
+}
+
+void ggml_i8_to_fp32_row_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const int8x16_t q = vld1q_s8((const int8_t *) (x + i));
+        const int16x8_t lo = vmovl_s8(vget_low_s8(q));
+        const int16x8_t hi = vmovl_s8(vget_high_s8(q));
+        vst1q_f32(y + i +  0, vcvtq_f32_s32(vmovl_s16(vget_low_s16(lo))));
+        vst1q_f32(y + i +  4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(lo))));
+        vst1q_f32(y + i +  8, vcvtq_f32_s32(vmovl_s16(vget_low_s16(hi))));
+        vst1q_f32(y + i + 12, vcvtq_f32_s32(vmovl_s16(vget_high_s16(hi))));
+    }
+    ggml_i8_to_fp32_row_ref(x + i, y + i, n - i);
+}
+
+void ggml_i16_to_fp32_row_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t q = vreinterpretq_s16_u8(vld1q_u8(x + i*2));
+        vst1q_f32(y + i + 0, vcvtq_f32_s32(vmovl_s16(vget_low_s16(q))));
+        vst1q_f32(y + i + 4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(q))));
+    }
+    ggml_i16_to_fp32_row_ref(x + i*2, y + i, n - i);
+}
+
+void ggml_i32_to_fp32_row_neon(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int64_t n) {
+    const uint8_t * x = vx;
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int32x4_t lo = vreinterpretq_s32_u8(vld1q_u8(x + i*4 + 0));
+        const int32x4_t hi = vreinterpretq_s32_u8(vld1q_u8(x + i*4 + 16));
+        vst1q_f32(y + i + 0, vcvtq_f32_s32(lo));
+        vst1q_f32(y + i + 4, vcvtq_f32_s32(hi));
+    }
+    ggml_i32_to_fp32_row_ref(x + i*4, y + i, n - i);
+}
+
+// ============================================================================
+// Non-finite scans
+// ============================================================================
+
+// NEON has no gather, so strided scale fields use the scalar reference; only
+// contiguous payloads are vectorized.
+
+static int64_t count_nonfinite16_neon(const uint8_t * GGML_RESTRICT x, int64_t n, size_t stride,
+                                      uint16_t exponent, int64_t (*ref)(const void *, int64_t, size_t)) {
+    if (stride != sizeof(uint16_t)) {
+        return ref(x, n, stride);
+    }
+    const uint16x8_t mask = vdupq_n_u16(exponent);
+    int64_t count = 0;
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const uint16x8_t v0 = vreinterpretq_u16_u8(vld1q_u8(x + i*2));
+        const uint16x8_t v1 = vreinterpretq_u16_u8(vld1q_u8(x + i*2 + 16));
+        // Matching lanes are all ones; shifting leaves 1 per lane, so the sum is at most 16
+        const uint16x8_t e0 = vshrq_n_u16(vceqq_u16(vandq_u16(v0, mask), mask), 15);
+        const uint16x8_t e1 = vshrq_n_u16(vceqq_u16(vandq_u16(v1, mask), mask), 15);
+        count += vaddvq_u16(vaddq_u16(e0, e1));
+    }
+    return count + ref(x + i*2, n - i, stride);
+}
+
+int64_t ggml_count_nonfinite_fp16_neon(const void * GGML_RESTRICT x, int64_t n, size_t stride) {
+    return count_nonfinite16_neon(x, n, stride, 0x7C00, ggml_count_nonfinite_fp16_ref);
+}
+
+int64_t ggml_count_nonfinite_bf16_neon(const void * GGML_RESTRICT x, int64_t n, size_t stride) {
+    return count_nonfinite16_neon(x, n, stride, 0x7F80, ggml_count_nonfinite_bf16_ref);
+}
+
+int64_t ggml_count_nonfinite_f32_neon(const void * GGML_RESTRICT vx, int64_t n, size_t stride) {
+    const uint8_t * x = vx;
+    if (stride != sizeof(float)) {
+        return ggml_count_nonfinite_f32_ref(x, n, stride);
+    }
+    const uint32x4_t mask = vdupq_n_u32(0x7F800000);
+    int64_t count = 0;
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const uint32x4_t v0 = vreinterpretq_u32_u8(vld1q_u8(x + i*4));
+        const uint32x4_t v1 = vreinterpretq_u32_u8(vld1q_u8(x + i*4 + 16));
+        const uint32x4_t e0 = vshrq_n_u32(vceqq_u32(vandq_u32(v0, mask), mask), 31);
+        const uint32x4_t e1 = vshrq_n_u32(vceqq_u32(vandq_u32(v1, mask), mask), 31);
+        count += vaddvq_u32(vaddq_u32(e0, e1));
+    }
+    return count + ggml_count_nonfinite_f32_ref(x + i*4, n - i, stride);
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+// Lanes 0-3 in `a` and 4-7 in `b`, reduced as ((l0+l4) + (l2+l6)) + ((l1+l5) + (l3+l7))
+// to match the scalar reference; vaddvq_f32 pairs the lanes differently.
+static inline float reduce_lanes_f32x4x2(float32x4_t a, float32x4_t b) {
+    const float32x4_t t = vaddq_f32(a, b);
+    const float32x2_t u = vadd_f32(vget_low_f32(t), vget_high_f32(t));
+    return vget_lane_f32(u, 0) + vget_lane_f32(u, 1);
+}
+
+// `v < m ? v : m` lane by lane; vminq_f32 would propagate NaNs
+static inline float32x4_t min_skip_nan(float32x4_t v, float32x4_t m) {
+    return vbslq_f32(vcltq_f32(v, m), v, m);
+}
+
+static inline float32x4_t max_skip_nan(float32x4_t v, float32x4_t m) {
+    return vbslq_f32(vcgtq_f32(v, m), v, m);
+}
+
+void ggml_stats_f32_neon(const float * GGML_RESTRICT x, int64_t n, ggml_stats * GGML_RESTRICT acc) {
+    for (int64_t start = 0; start < n; start += QK_K) {
+        const float * t = x + start;
+        const int64_t len = n - start < QK_K ? n - start : QK_K;
+
+        float32x4_t s0 = vdupq_n_f32(0.0f), s1 = vdupq_n_f32(0.0f);
+        float32x4_t q0 = vdupq_n_f32(0.0f), q1 = vdupq_n_f32(0.0f);
+        float32x4_t mn0 = vdupq_n_f32(INFINITY), mn1 = vdupq_n_f32(INFINITY);
+        float32x4_t mx0 = vdupq_n_f32(-INFINITY), mx1 = vdupq_n_f32(-INFINITY);
+        int64_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            const float32x4_t v0 = vld1q_f32(t + i);
+            const float32x4_t v1 = vld1q_f32(t + i + 4);
+            s0 = vaddq_f32(s0, v0);
+            s1 = vaddq_f32(s1, v1);
+            q0 = vaddq_f32(q0, vmulq_f32(v0, v0));
+            q1 = vaddq_f32(q1, vmulq_f32(v1, v1));
+            mn0 = min_skip_nan(v0, mn0);
+            mn1 = min_skip_nan(v1, mn1);
+            mx0 = max_skip_nan(v0, mx0);
+            mx1 = max_skip_nan(v1, mx1);
+        }
+        float sum = reduce_lanes_f32x4x2(s0, s1);
+        float sumsq = reduce_lanes_f32x4x2(q0, q1);
+        float lanes_min[8];
+        float lanes_max[8];
+        vst1q_f32(lanes_min, mn0);
+        vst1q_f32(lanes_min + 4, mn1);
+        vst1q_f32(lanes_max, mx0);
+        vst1q_f32(lanes_max + 4, mx1);
+        float min = lanes_min[0];
+        float max = lanes_max[0];
+        for (int j = 1; j < 8; ++j) {
+            min = lanes_min[j] < min ? lanes_min[j] : min;
+            max = lanes_max[j] > max ? lanes_max[j] : max;
+        }
+        for (; i < len; ++i) {
+            sum += t[i];
+            sumsq += t[i]*t[i];
+            min = t[i] < min ? t[i] : min;
+            max = t[i] > max ? t[i] : max;
+        }
+
+        const float mean = (float) ((double) sum / (double) len);
+        const float32x4_t vmean = vdupq_n_f32(mean);
+        float32x4_t m0 = vdupq_n_f32(0.0f), m1 = vdupq_n_f32(0.0f);
+        i = 0;
+        for (; i + 8 <= len; i += 8) {
+            const float32x4_t d0 = vsubq_f32(vld1q_f32(t + i), vmean);
+            const float32x4_t d1 = vsubq_f32(vld1q_f32(t + i + 4), vmean);
+            m0 = vaddq_f32(m0, vmulq_f32(d0, d0));
+            m1 = vaddq_f32(m1, vmulq_f32(d1, d1));
+        }
+        float m2 = reduce_lanes_f32x4x2(m0, m1);
+        for (; i < len; ++i) {
+            const float d = t[i] - mean;
+            m2 += d*d;
+        }
+        ggml_stats_add_tile(acc, len, sum, sumsq, mean, m2, min, max);
+    }
+}
+
+void ggml_histogram_f32_neon(const float * GGML_RESTRICT x, int64_t n, float lo, float scale,
+                             int64_t bins, int64_t * GGML_RESTRICT counts) {
+    assert(bins > 0 && bins <= (1 << 24));
+    const float32x4_t vlo = vdupq_n_f32(lo);
+    const float32x4_t vscale = vdupq_n_f32(scale);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t top = vdupq_n_f32((float) (bins - 1));
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t t = vmulq_f32(vsubq_f32(vld1q_f32(x + i), vlo), vscale);
+        const uint32x4_t ordered = vceqq_f32(t, t);
+        const float32x4_t c = min_skip_nan(max_skip_nan(t, zero), top);
+        int32_t index[4];
+        uint32_t keep[4];
+        vst1q_s32(index, vcvtq_s32_f32(c));
+        vst1q_u32(keep, ordered);
+        for (int j = 0; j < 4; ++j) {
+            counts[index[j]] += keep[j] & 1;
+        }
+    }
+    ggml_histogram_f32_ref(x + i, n - i, lo, scale, bins, counts);
+}
+
+void ggml_diff_f32_neon(const float * GGML_RESTRICT a, const float * GGML_RESTRICT b, int64_t n,
+                        ggml_diff * GGML_RESTRICT acc) {
+    for (int64_t start = 0; start < n; start += QK_K) {
+        const float * ta = a + start;
+        const float * tb = b + start;
+        const int64_t len = n - start < QK_K ? n - start : QK_K;
+
+        float32x4_t sd0 = vdupq_n_f32(0.0f), sd1 = vdupq_n_f32(0.0f);
+        float32x4_t ab0 = vdupq_n_f32(0.0f), ab1 = vdupq_n_f32(0.0f);
+        float32x4_t aa0 = vdupq_n_f32(0.0f), aa1 = vdupq_n_f32(0.0f);
+        float32x4_t bb0 = vdupq_n_f32(0.0f), bb1 = vdupq_n_f32(0.0f);
+        float32x4_t mx0 = vdupq_n_f32(0.0f), mx1 = vdupq_n_f32(0.0f);
+        int64_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            const float32x4_t x0 = vld1q_f32(ta + i);
+            const float32x4_t x1 = vld1q_f32(ta + i + 4);
+            const float32x4_t y0 = vld1q_f32(tb + i);
+            const float32x4_t y1 = vld1q_f32(tb + i + 4);
+            const float32x4_t d0 = vsubq_f32(x0, y0);
+            const float32x4_t d1 = vsubq_f32(x1, y1);
+            sd0 = vaddq_f32(sd0, vmulq_f32(d0, d0));
+            sd1 = vaddq_f32(sd1, vmulq_f32(d1, d1));
+            ab0 = vaddq_f32(ab0, vmulq_f32(x0, y0));
+            ab1 = vaddq_f32(ab1, vmulq_f32(x1, y1));
+            aa0 = vaddq_f32(aa0, vmulq_f32(x0, x0));
+            aa1 = vaddq_f32(aa1, vmulq_f32(x1, x1));
+            bb0 = vaddq_f32(bb0, vmulq_f32(y0, y0));
+            bb1 = vaddq_f32(bb1, vmulq_f32(y1, y1));
+            mx0 = max_skip_nan(vabsq_f32(d0), mx0);
+            mx1 = max_skip_nan(vabsq_f32(d1), mx1);
+        }
+        float sumsq_diff = reduce_lanes_f32x4x2(sd0, sd1);
+        float dot = reduce_lanes_f32x4x2(ab0, ab1);
+        float sumsq_a = reduce_lanes_f32x4x2(aa0, aa1);
+        float sumsq_b = reduce_lanes_f32x4x2(bb0, bb1);
+        float lanes_max[8];
+        vst1q_f32(lanes_max, mx0);
+        vst1q_f32(lanes_max + 4, mx1);
+        float max_abs = lanes_max[0];
+        for (int j = 1; j < 8; ++j) {
+            max_abs = lanes_max[j] > max_abs ? lanes_max[j] : max_abs;
+        }
+        for (; i < len; ++i) {
+            const float d = ta[i] - tb[i];
+            const float e = fabsf(d);
+            sumsq_diff += d*d;
+            dot += ta[i]*tb[i];
+            sumsq_a += ta[i]*ta[i];
+            sumsq_b += tb[i]*tb[i];
+            max_abs = e > max_abs ? e : max_abs;
+        }
+        ggml_diff_add_tile(acc, len, sumsq_diff, dot, sumsq_a, sumsq_b, max_abs);
+    }
+}
+
+#endif // GGML_SIMD_ARM_NEON
@@ -0,0 +1,323 @@
+/*
+ * GGML Repacking - Interleaved layouts and scalar reference kernels
+ *
+ * Q4_0, Q8_0 and Q4_K rows are regrouped so the blocks at the same column of
+ * N = 4 or 8 consecutive rows sit next to each other (see block_q4_0x4 and
+ * friends). A matrix-vector kernel then reads one chunk per row with a single
+ * vector load and produces N outputs per pass over the activations.
+ *
+ * The references keep the per-row float operations of the plain vec_dot
+ * references, so a repacked matvec returns exactly what the original rows do.
+ */
+
+#include "ggml_quants_impl.h"
+
+#include <assert.h>
+#include <string.h>
+
+static_assert(sizeof(block_q4_0x4) == 4*sizeof(block_q4_0), "wrong q4_0x4 block size/padding");
+static_assert(sizeof(block_q4_0x8) == 8*sizeof(block_q4_0), "wrong q4_0x8 block size/padding");
+static_assert(sizeof(block_q8_0x4) == 4*sizeof(block_q8_0), "wrong q8_0x4 block size/padding");
+static_assert(sizeof(block_q8_0x8) == 8*sizeof(block_q8_0), "wrong q8_0x8 block size/padding");
+static_assert(sizeof(block_q4_Kx4) == 4*(2*sizeof(ggml_half) + 2*QK_K/32 + QK_K/2), "wrong q4_Kx4 block size/padding");
+static_assert(sizeof(block_q4_Kx8) == 8*(2*sizeof(ggml_half) + 2*QK_K/32 + QK_K/2), "wrong q4_Kx8 block size/padding");
+
+// Every layout is a run of per-row fp16 scales followed by fixed-size
+// per-row sections, so the generic code below addresses them by `n` alone:
+//   q4_0xN: d[n]            qs[16n]
+//   q8_0xN: d[n]            qs[32n]
+//   q4_KxN: d[n] dmin[n]    scales[8][n] mins[8][n] qs[128n]
+#define Q4_0XN_SIZE(n) ((size_t)(n) * sizeof(block_q4_0))
+#define Q8_0XN_SIZE(n) ((size_t)(n) * sizeof(block_q8_0))
+#define Q4_KXN_SIZE(n) ((size_t)(n) * (2*sizeof(ggml_half) + 2*QK_K/32 + QK_K/2))
+
+// Copies `len` quant bytes of one row into chunk-interleaved position `r`
+static inline void interleave_chunks(uint8_t * GGML_RESTRICT dst, const uint8_t * GGML_RESTRICT src, int n, int r, int len) {
+    for (int c = 0; c < len/4; ++c) {
+        memcpy(dst + (c*n + r)*4, src + c*4, 4);
+    }
+}
+
+// Byte `j` of row `r` in chunk-interleaved quants
+static inline uint8_t interleaved_byte(const uint8_t * GGML_RESTRICT qs, int n, int r, int j) {
+    return qs[((j/4)*n + r)*4 + j%4];
+}
+
+// ============================================================================
+// Repacking
+// ============================================================================
+
+void ggml_repack_q4_0(const block_q4_0 * GGML_RESTRICT x, void * GGML_RESTRICT vy, int n, int64_t nrows, int64_t k) {
+    assert(n == 4 || n == 8);
+    assert(nrows % n == 0 && k % QK4_0 == 0);
+    const int64_t nb = k / QK4_0;
+    uint8_t * y = vy;
+
+    for (int64_t g = 0; g < nrows; g += n) {
+        for (int64_t ib = 0; ib < nb; ++ib) {
+            ggml_half * d = (ggml_half *) y;
+            uint8_t * qs = y + n*sizeof(ggml_half);
+            for (int r = 0; r < n; ++r) {
+                const block_q4_0 * b = &x[(g + r)*nb + ib];
+                d[r] = b->d;
+                interleave_chunks(qs, b->qs, n, r, QK4_0/2);
+            }
+            y += Q4_0XN_SIZE(n);
+        }
+    }
+}
+
+void ggml_repack_q8_0(const block_q8_0 * GGML_RESTRICT x, void * GGML_RESTRICT vy, int n, int64_t nrows, int64_t k) {
+    assert(n == 4 || n == 8);
+    assert(nrows % n == 0 && k % QK8_0 == 0);
+    const int64_t nb = k / QK8_0;
+    uint8_t * y = vy;
+
+    for (int64_t g = 0; g < nrows; g += n) {
+        for (int64_t ib = 0; ib < nb; ++ib) {
+            ggml_half * d = (ggml_half *) y;
+            uint8_t * qs = y + n*sizeof(ggml_half);
+            for (int r = 0; r < n; ++r) {
+                const block_q8_0 * b = &x[(g + r)*nb + ib];
+                d[r] = b->d;
+                interleave_chunks(qs, (const uint8_t *) b->qs, n, r, QK8_0);
+            }
+            y += Q8_0XN_SIZE(n);
+        }
+    }
+}
+
+void ggml_repack_q4_K(const block_q4_K * GGML_RESTRICT x, void * GGML_RESTRICT vy, int n, int64_t nrows, int64_t k) {
+    assert(n == 4 || n == 8);
+    assert(nrows % n == 0 && k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+    uint8_t * y = vy;
+
+    for (int64_t g = 0; g < nrows; g += n) {
+        for (int64_t ib = 0; ib < nb; ++ib) {
+            ggml_half * d    = (ggml_half *) y;
+            ggml_half * dmin = d + n;
+            uint8_t * scales = y + 2*n*sizeof(ggml_half);
+            uint8_t * mins   = scales + (QK_K/32)*n;
+            uint8_t * qs     = mins + (QK_K/32)*n;
+            for (int r = 0; r < n; ++r) {
+                const block_q4_K * b = &x[(g + r)*nb + ib];
+                d[r] = b->d;
+                dmin[r] = b->dmin;
+                for (int s = 0; s < QK_K/32; ++s) {
+                    get_scale_min_k4(s, b->scales, &scales[s*n + r], &mins[s*n + r]);
+                }
+                interleave_chunks(qs, b->qs, n, r, QK_K/2);
+            }
+            y += Q4_KXN_SIZE(n);
+        }
+    }
+}
+
+// ============================================================================
+// Dequantization
+// ============================================================================
+
+void ggml_dequantize_repacked_q4_0(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int n, int64_t k) {
+    assert(k % QK4_0 == 0);
+    const int64_t nb = k / QK4_0;
+    const uint8_t * x = vx;
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        const ggml_half * d = (const ggml_half *) x;
+        const uint8_t * qs = x + n*sizeof(ggml_half);
+        for (int r = 0; r < n; ++r) {
+            float * GGML_RESTRICT out = y + r*k + ib*QK4_0;
+            const float dr = GGML_FP16_TO_FP32(d[r]);
+            for (int j = 0; j < QK4_0/2; ++j) {
+                const uint8_t q = interleaved_byte(qs, n, r, j);
+                out[j]           = ((q & 0x0F) - 8)*dr;
+                out[j + QK4_0/2] = ((q >>   4) - 8)*dr;
+            }
+        }
+        x += Q4_0XN_SIZE(n);
+    }
+}
+
+void ggml_dequantize_repacked_q8_0(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int n, int64_t k) {
+    assert(k % QK8_0 == 0);
+    const int64_t nb = k / QK8_0;
+    const uint8_t * x = vx;
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        const ggml_half * d = (const ggml_half *) x;
+        const uint8_t * qs = x + n*sizeof(ggml_half);
+        for (int r = 0; r < n; ++r) {
+            float * GGML_RESTRICT out = y + r*k + ib*QK8_0;
+            const float dr = GGML_FP16_TO_FP32(d[r]);
+            for (int j = 0; j < QK8_0; ++j) {
+                out[j] = (int8_t) interleaved_byte(qs, n, r, j)*dr;
+            }
+        }
+        x += Q8_0XN_SIZE(n);
+    }
+}
+
+void ggml_dequantize_repacked_q4_K(const void * GGML_RESTRICT vx, float * GGML_RESTRICT y, int n, int64_t k) {
+    assert(k % QK_K == 0);
+    const int64_t nb = k / QK_K;
+    const uint8_t * x = vx;
+
+    for (int64_t ib = 0; ib < nb; ++ib) {
+        const ggml_half * d    = (const ggml_half *) x;
+        const ggml_half * dmin = d + n;
+        const uint8_t * scales = x + 2*n*sizeof(ggml_half);
+        const uint8_t * mins   = scales + (QK_K/32)*n;
+        const uint8_t * qs     = mins + (QK_K/32)*n;
+        for (int r = 0; r < n; ++r) {
+            float * GGML_RESTRICT out = y + r*k + ib*QK_K;
+            const float dr   = GGML_FP16_TO_FP32(d[r]);
+            const float minr = GGML_FP16_TO_FP32(dmin[r]);
+            for (int j = 0; j < QK_K/64; ++j) {
+                const float d1 = dr * scales[(2*j + 0)*n + r]; const float m1 = minr * mins[(2*j + 0)*n + r];
+                const float d2 = dr * scales[(2*j + 1)*n + r]; const float m2 = minr * mins[(2*j + 1)*n + r];
+                for (int l = 0; l < 32; ++l) {
+                    const uint8_t q = interleaved_byte(qs, n, r, 32*j + l);
+                    out[64*j + l]      = d1 * (q & 0xF) - m1;
+                    out[64*j + l + 32] = d2 * (q  >> 4) - m2;
+                }
+            }
+        }
+        x += Q4_KXN_SIZE(n);
+    }
+}
+
+// ============================================================================
+// Interleaved dot products
+// ============================================================================
+
+static void gemv_q4_0_q8_0(int n, const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t k) {
+    const int qk = QK8_0;
+    assert(k % qk == 0);
+    const int nb = k / qk;
+
+    const uint8_t * x = vx;
+    const block_q8_0 * GGML_RESTRICT y = vy;
+
+    float sumf[8] = { 0 };
+
+    for (int ib = 0; ib < nb; ++ib) {
+        const ggml_half * d = (const ggml_half *) x;
+        const uint8_t * qs = x + n*sizeof(ggml_half);
+        for (int r = 0; r < n; ++r) {
+            int sumi0 = 0;
+            int sumi1 = 0;
+
+            for (int j = 0; j < qk/2; ++j) {
+                const uint8_t q = interleaved_byte(qs, n, r, j);
+                const int v0 = (q & 0x0F) - 8;
+                const int v1 = (q >>   4) - 8;
+
+                sumi0 += (v0 * y[ib].qs[j]);
+                sumi1 += (v1 * y[ib].qs[j + qk/2]);
+            }
+
+            int sumi = sumi0 + sumi1;
+            sumf[r] += sumi*GGML_FP16_TO_FP32(d[r])*GGML_FP16_TO_FP32(y[ib].d);
+        }
+        x += Q4_0XN_SIZE(n);
+    }
+
+    memcpy(s, sumf, n*sizeof(float));
+}
+
+static void gemv_q8_0_q8_0(int n, const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t k) {
+    const int qk = QK8_0;
+    assert(k % qk == 0);
+    const int nb = k / qk;
+
+    const uint8_t * x = vx;
+    const block_q8_0 * GGML_RESTRICT y = vy;
+
+    float sumf[8] = { 0 };
+
+    for (int ib = 0; ib < nb; ++ib) {
+        const ggml_half * d = (const ggml_half *) x;
+        const uint8_t * qs = x + n*sizeof(ggml_half);
+        for (int r = 0; r < n; ++r) {
+            int sumi = 0;
+
+            for (int j = 0; j < qk; j++) {
+                sumi += (int8_t) interleaved_byte(qs, n, r, j)*y[ib].qs[j];
+            }
+
+            sumf[r] += sumi*(GGML_FP16_TO_FP32(d[r])*GGML_FP16_TO_FP32(y[ib].d));
+        }
+        x += Q8_0XN_SIZE(n);
+    }
+
+    memcpy(s, sumf, n*sizeof(float));
+}
+
+static void gemv_q4_K_q8_K(int n, const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t k) {
+    assert(k % QK_K == 0);
+    const int nb = k / QK_K;
+
+    const uint8_t * x = vx;
+    const block_q8_K * GGML_RESTRICT y = vy;
+
+    float sumf[8] = { 0 };
+
+    for (int i = 0; i < nb; ++i) {
+        const ggml_half * d    = (const ggml_half *) x;
+        const ggml_half * dmin = d + n;
+        const uint8_t * scales = x + 2*n*sizeof(ggml_half);
+        const uint8_t * mins   = scales + (QK_K/32)*n;
+        const uint8_t * qs     = mins + (QK_K/32)*n;
+        for (int r = 0; r < n; ++r) {
+            const int8_t * GGML_RESTRICT q8 = y[i].qs;
+
+            int isum = 0;
+            int summs = 0;
+            for (int j = 0; j < QK_K/64; ++j) {
+                int sum_lo = 0;
+                int sum_hi = 0;
+                for (int l = 0; l < 32; ++l) {
+                    const uint8_t q = interleaved_byte(qs, n, r, 32*j + l);
+                    sum_lo += q8[l +  0] * (q & 0xF);
+                    sum_hi += q8[l + 32] * (q >>  4);
+                }
+                isum  += scales[(2*j + 0)*n + r] * sum_lo;
+                summs += mins[(2*j + 0)*n + r] * (y[i].bsums[4*j + 0] + y[i].bsums[4*j + 1]);
+                isum  += scales[(2*j + 1)*n + r] * sum_hi;
+                summs += mins[(2*j + 1)*n + r] * (y[i].bsums[4*j + 2] + y[i].bsums[4*j + 3]);
+                q8 += 64;
+            }
+            const float dr    = GGML_FP16_TO_FP32(d[r])    * y[i].d;
+            const float dminr = GGML_FP16_TO_FP32(dmin[r]) * y[i].d;
+            sumf[r] += dr * isum - dminr * summs;
+        }
+        x += Q4_KXN_SIZE(n);
+    }
+
+    memcpy(s, sumf, n*sizeof(float));
+}
+
+void ggml_gemv_q4_0x4_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    gemv_q4_0_q8_0(4, vx, vy, s, n);
+}
+
+void ggml_gemv_q4_0x8_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    gemv_q4_0_q8_0(8, vx, vy, s, n);
+}
+
+void ggml_gemv_q8_0x4_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    gemv_q8_0_q8_0(4, vx, vy, s, n);
+}
+
+void ggml_gemv_q8_0x8_q8_0_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    gemv_q8_0_q8_0(8, vx, vy, s, n);
+}
+
+void ggml_gemv_q4_Kx4_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    gemv_q4_K_q8_K(4, vx, vy, s, n);
+}
+
+void ggml_gemv_q4_Kx8_q8_K_ref(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n) {
+    gemv_q4_K_q8_K(8, vx, vy, s, n);
+}
@@ -0,0 +1,249 @@
+/*
+ * GGML Statistics - Streaming summaries and histograms
+ *
+ * Scalar references, the Chan merge, error metrics between two rows and
+ * the tiled drivers that decode quantized rows straight into the
+ * accumulators.
+ *
+ * The references keep eight f32 lanes per QK_K tile and reduce them as
+ * ((l0+l4) + (l2+l6)) + ((l1+l5) + (l3+l7)), the order of the AVX2 and NEON
+ * horizontal sums, so every level returns the same bits.
+ */
+
+#include "ggml_quants_impl.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+void ggml_stats_init(ggml_stats * s) {
+    s->count = 0;
+    s->mean = 0.0;
+    s->m2 = 0.0;
+    s->sumsq = 0.0;
+    s->min = INFINITY;
+    s->max = -INFINITY;
+}
+
+void ggml_stats_merge(ggml_stats * GGML_RESTRICT acc, const ggml_stats * GGML_RESTRICT other) {
+    if (other->count == 0) {
+        return;
+    }
+    if (acc->count == 0) {
+        *acc = *other;
+        return;
+    }
+    const double na = (double) acc->count;
+    const double nb = (double) other->count;
+    const double n = na + nb;
+    const double delta = other->mean - acc->mean;
+    acc->mean += delta * (nb / n);
+    acc->m2 += other->m2 + delta * delta * (na * nb / n);
+    acc->sumsq += other->sumsq;
+    acc->count += other->count;
+    acc->min = other->min < acc->min ? other->min : acc->min;
+    acc->max = other->max > acc->max ? other->max : acc->max;
+}
+
+static inline float reduce_lanes(const float l[8]) {
+    const float t0 = l[0] + l[4];
+    const float t1 = l[1] + l[5];
+    const float t2 = l[2] + l[6];
+    const float t3 = l[3] + l[7];
+    return (t0 + t2) + (t1 + t3);
+}
+
+void ggml_stats_f32_ref(const float * GGML_RESTRICT x, int64_t n, ggml_stats * GGML_RESTRICT acc) {
+    for (int64_t start = 0; start < n; start += QK_K) {
+        const float * t = x + start;
+        const int64_t len = n - start < QK_K ? n - start : QK_K;
+
+        float s[8] = {0}, q[8] = {0};
+        float mn[8], mx[8];
+        for (int j = 0; j < 8; ++j) {
+            mn[j] = INFINITY;
+            mx[j] = -INFINITY;
+        }
+        int64_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            for (int j = 0; j < 8; ++j) {
+                const float v = t[i + j];
+                s[j] += v;
+                q[j] += v*v;
+                mn[j] = v < mn[j] ? v : mn[j];
+                mx[j] = v > mx[j] ? v : mx[j];
+            }
+        }
+        float sum = reduce_lanes(s);
+        float sumsq = reduce_lanes(q);
+        float min = mn[0];
+        float max = mx[0];
+        for (int j = 1; j < 8; ++j) {
+            min = mn[j] < min ? mn[j] : min;
+            max = mx[j] > max ? mx[j] : max;
+        }
+        for (; i < len; ++i) {
+            sum += t[i];
+            sumsq += t[i]*t[i];
+            min = t[i] < min ? t[i] : min;
+            max = t[i] > max ? t[i] : max;
+        }
+
+        // Second pass over the tile, still in L1, for the squared deviations
+        const float mean = (float) ((double) sum / (double) len);
+        float m[8] = {0};
+        i = 0;
+        for (; i + 8 <= len; i += 8) {
+            for (int j = 0; j < 8; ++j) {
+                const float d = t[i + j] - mean;
+                m[j] += d*d;
+            }
+        }
+        float m2 = reduce_lanes(m);
+        for (; i < len; ++i) {
+            const float d = t[i] - mean;
+            m2 += d*d;
+        }
+        ggml_stats_add_tile(acc, len, sum, sumsq, mean, m2, min, max);
+    }
+}
+
+void ggml_histogram_f32_ref(const float * GGML_RESTRICT x, int64_t n, float lo, float scale,
+                            int64_t bins, int64_t * GGML_RESTRICT counts) {
+    assert(bins > 0 && bins <= (1 << 24));
+    const float top = (float) (bins - 1);
+    for (int64_t i = 0; i < n; ++i) {
+        const float t = (x[i] - lo) * scale;
+        if (t != t) {
+            continue;
+        }
+        float c = t > 0.0f ? t : 0.0f;
+        c = c < top ? c : top;
+        counts[(int32_t) c] += 1;
+    }
+}
+
+void ggml_diff_f32_ref(const float * GGML_RESTRICT a, const float * GGML_RESTRICT b, int64_t n,
+                       ggml_diff * GGML_RESTRICT acc) {
+    for (int64_t start = 0; start < n; start += QK_K) {
+        const float * ta = a + start;
+        const float * tb = b + start;
+        const int64_t len = n - start < QK_K ? n - start : QK_K;
+
+        float sd[8] = {0}, ab[8] = {0}, aa[8] = {0}, bb[8] = {0}, mx[8] = {0};
+        int64_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            for (int j = 0; j < 8; ++j) {
+                const float x = ta[i + j];
+                const float y = tb[i + j];
+                const float d = x - y;
+                const float e = fabsf(d);
+                sd[j] += d*d;
+                ab[j] += x*y;
+                aa[j] += x*x;
+                bb[j] += y*y;
+                mx[j] = e > mx[j] ? e : mx[j];
+            }
+        }
+        float sumsq_diff = reduce_lanes(sd);
+        float dot = reduce_lanes(ab);
+        float sumsq_a = reduce_lanes(aa);
+        float sumsq_b = reduce_lanes(bb);
+        float max_abs = mx[0];
+        for (int j = 1; j < 8; ++j) {
+            max_abs = mx[j] > max_abs ? mx[j] : max_abs;
+        }
+        for (; i < len; ++i) {
+            const float d = ta[i] - tb[i];
+            const float e = fabsf(d);
+            sumsq_diff += d*d;
+            dot += ta[i]*tb[i];
+            sumsq_a += ta[i]*ta[i];
+            sumsq_b += tb[i]*tb[i];
+            max_abs = e > max_abs ? e : max_abs;
+        }
+        ggml_diff_add_tile(acc, len, sumsq_diff, dot, sumsq_a, sumsq_b, max_abs);
+    }
+}
+
+void ggml_diff_merge(ggml_diff * GGML_RESTRICT acc, const ggml_diff * GGML_RESTRICT other) {
+    acc->count += other->count;
+    acc->sumsq_diff += other->sumsq_diff;
+    acc->dot += other->dot;
+    acc->sumsq_a += other->sumsq_a;
+    acc->sumsq_b += other->sumsq_b;
+    acc->max_abs = other->max_abs > acc->max_abs ? other->max_abs : acc->max_abs;
+}
+
+// Decodes `len` values starting at element i; NULL reads f32 values at any alignment
+static inline void decode_tile(ggml_dequantize_row_t dequantize, int64_t block_size, size_t type_size,
+                               const uint8_t * x, int64_t i, float * GGML_RESTRICT y, int64_t len) {
+    if (dequantize == NULL) {
+        memcpy(y, x + i*sizeof(float), len*sizeof(float));
+    } else {
+        dequantize(x + (i / block_size) * type_size, y, len);
+    }
+}
+
+int64_t ggml_dequantize_row_diff(ggml_dequantize_row_t dequantize_a, int64_t block_size_a, size_t type_size_a,
+                                 const void * GGML_RESTRICT xa,
+                                 ggml_dequantize_row_t dequantize_b, int64_t block_size_b, size_t type_size_b,
+                                 const void * GGML_RESTRICT xb,
+                                 int same_encoding, ggml_diff_row_t diff, int64_t k,
+                                 ggml_diff * GGML_RESTRICT acc) {
+    assert(k % block_size_a == 0 && k % block_size_b == 0);
+    assert(QK_K % block_size_a == 0 && QK_K % block_size_b == 0);
+
+    float ta[QK_K];
+    float tb[QK_K];
+    const uint8_t * a = xa;
+    const uint8_t * b = xb;
+    int64_t tiles = 0;
+    for (int64_t i = 0; i < k; i += QK_K) {
+        const int64_t len = k - i < QK_K ? k - i : QK_K;
+        if (same_encoding) {
+            // memcmp is vectorized by the C library and stops at the first difference
+            const size_t offset = (size_t) (i / block_size_a) * type_size_a;
+            const size_t size = (size_t) (len / block_size_a) * type_size_a;
+            if (memcmp(a + offset, b + offset, size) == 0) {
+                continue;
+            }
+        }
+        decode_tile(dequantize_a, block_size_a, type_size_a, a, i, ta, len);
+        decode_tile(dequantize_b, block_size_b, type_size_b, b, i, tb, len);
+        diff(ta, tb, len, acc);
+        tiles += 1;
+    }
+    return tiles;
+}
+
+void ggml_dequantize_row_stats(ggml_dequantize_row_t dequantize, ggml_stats_row_t stats,
+                               int64_t block_size, size_t type_size,
+                               const void * GGML_RESTRICT vx, int64_t k, ggml_stats * GGML_RESTRICT acc) {
+    assert(k % block_size == 0);
+    assert(QK_K % block_size == 0);
+
+    float tmp[QK_K];
+    const uint8_t * x = vx;
+    for (int64_t i = 0; i < k; i += QK_K) {
+        const int64_t len = k - i < QK_K ? k - i : QK_K;
+        dequantize(x + (i / block_size) * type_size, tmp, len);
+        stats(tmp, len, acc);
+    }
+}
+
+void ggml_dequantize_row_histogram(ggml_dequantize_row_t dequantize, ggml_histogram_row_t histogram,
+                                   int64_t block_size, size_t type_size,
+                                   const void * GGML_RESTRICT vx, int64_t k,
+                                   float lo, float scale, int64_t bins, int64_t * GGML_RESTRICT counts) {
+    assert(k % block_size == 0);
+    assert(QK_K % block_size == 0);
+
+    float tmp[QK_K];
+    const uint8_t * x = vx;
+    for (int64_t i = 0; i < k; i += QK_K) {
+        const int64_t len = k - i < QK_K ? k - i : QK_K;
+        dequantize(x + (i / block_size) * type_size, tmp, len);
+        histogram(tmp, len, lo, scale, bins, counts);
+    }
+}
@@ -40,6 +40,7 @@ extern "C" {
 typedef uint16_t ggml_fp16_t;
 typedef uint16_t ggml_half;
 typedef uint32_t ggml_half2;
+typedef uint16_t ggml_bf16_t;
 
 // ============================================================================
 // FP16 conversion functions
@@ -115,6 +116,22 @@ static inline ggml_fp16_t ggml_compute_fp32_to_fp16(float f) {
 #define GGML_FP16_TO_FP32(x) ggml_compute_fp16_to_fp32(x)
 #define GGML_FP32_TO_FP16(x) ggml_compute_fp32_to_fp16(x)
 
+// BF16 conversion: rounds to nearest even; NaNs keep their payload and are made quiet
+static inline ggml_bf16_t ggml_compute_fp32_to_bf16(float f) {
+    const uint32_t w = fp32_to_bits(f);
+    if ((w & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000)) {
+        return (ggml_bf16_t) ((w >> 16) | 64);
+    }
+    return (ggml_bf16_t) ((w + (UINT32_C(0x7FFF) + ((w >> 16) & 1))) >> 16);
+}
+
+static inline float ggml_compute_bf16_to_fp32(ggml_bf16_t h) {
+    return fp32_from_bits((uint32_t) h << 16);
+}
+
+#define GGML_BF16_TO_FP32(x) ggml_compute_bf16_to_fp32(x)
+#define GGML_FP32_TO_BF16(x) ggml_compute_fp32_to_bf16(x)
+
 // E8M0 to FP32 conversion for MXFP4
 static inline float ggml_compute_e8m0_to_fp32_half(uint8_t x) {
     uint32_t bits;
@@ -210,6 +227,13 @@ typedef struct {
     uint8_t qs[QK4_NL/2];
 } block_iq4_nl;
 
+// MXFP4 quantization (4.25 bits per weight, OCP microscaling format)
+// 32 weights per block; e2m1 values sharing a power-of-two scale
+typedef struct {
+    uint8_t e;                // E8M0 shared exponent
+    uint8_t qs[QK_MXFP4/2];   // e2m1 codes
+} block_mxfp4;
+
 // ============================================================================
 // K-quantization structures (super-block based, 256 weights per block)
 // ============================================================================
@@ -257,20 +281,355 @@ typedef struct {
 
 // 8-bit quantization (used for temporary quantization)
 typedef struct {
-    ggml_half d;         // delta
+    float   d;           // delta
     int8_t  qs[QK_K];    // quants
     int16_t bsums[QK_K/16]; // sum of quants in blocks of 16
 } block_q8_K;
 
+// ============================================================================
+// IQ and ternary structures (super-block based, 256 weights per block)
+// ============================================================================
+
+// The IQ2/IQ3/IQ1 types store indices into fixed grids of 8 (IQ2, IQ1) or
+// 4 (IQ3) values, with sign bits either stored or looked up in ksigns_iq2xs.
+
+// 2.0625 bits per weight
+typedef struct {
+    ggml_half d;
+    uint16_t qs[QK_K/8]; // per 32: four 8-bit grid indices, then 4x7 sign bits and a 4-bit scale
+} block_iq2_xxs;
+
+// 2.3125 bits per weight
+typedef struct {
+    ggml_half d;
+    uint16_t qs[QK_K/8];      // 9-bit grid index and 7 sign bits per 8 weights
+    uint8_t  scales[QK_K/32]; // two 4-bit scales per 32 weights
+} block_iq2_xs;
+
+// 2.5625 bits per weight
+typedef struct {
+    ggml_half d;
+    uint8_t qs[QK_K/4];      // low 8 bits of the grid indices, then one sign byte per 8 weights
+    uint8_t qh[QK_K/32];     // high 2 bits of the grid indices
+    uint8_t scales[QK_K/32]; // two 4-bit scales per 32 weights
+} block_iq2_s;
+
+// 3.0625 bits per weight
+typedef struct {
+    ggml_half d;
+    uint8_t qs[3*QK_K/8]; // 8-bit grid indices, then 4x7 sign bits and a 4-bit scale per 32 weights
+} block_iq3_xxs;
+
+// 3.4375 bits per weight
+typedef struct {
+    ggml_half d;
+    uint8_t qs[QK_K/4];          // low 8 bits of the grid indices
+    uint8_t qh[QK_K/32];         // high bit of the grid indices
+    uint8_t signs[QK_K/8];       // one sign bit per weight
+    uint8_t scales[IQ3S_N_SCALE]; // 4-bit scales
+} block_iq3_s;
+
+// 1.5625 bits per weight
+typedef struct {
+    ggml_half d;
+    uint8_t  qs[QK_K/8];  // low 8 bits of the grid indices
+    uint16_t qh[QK_K/32]; // high 3 bits of four indices, a 3-bit scale and the delta sign
+} block_iq1_s;
+
+// 1.75 bits per weight
+typedef struct {
+    uint8_t qs[QK_K/8];      // low 8 bits of the grid indices
+    uint8_t qh[QK_K/16];     // high 3 bits and the delta sign, one nibble per index
+    uint8_t scales[QK_K/32]; // 3-bit scales; the fp16 super-block scale is spread over the top nibbles
+} block_iq1_m;
+
+// IQ4_XS quantization (4.25 bits per weight): IQ4_NL values with 6-bit sub-block scales
+typedef struct {
+    ggml_half d;
+    uint16_t scales_h;          // high 2 bits of the scales
+    uint8_t  scales_l[QK_K/64]; // low 4 bits of the scales
+    uint8_t  qs[QK_K/2];
+} block_iq4_xs;
+
+// 1.6875 bits per weight: five ternary digits per byte
+typedef struct {
+    uint8_t qs[(QK_K - 4 * QK_K / 64) / 5]; // 5 elements per byte (3^5 = 243 < 256)
+    uint8_t qh[QK_K/64];                    // 4 elements per byte
+    ggml_half d;
+} block_tq1_0;
+
+// 2.0625 bits per weight
+typedef struct {
+    uint8_t qs[QK_K/4]; // 2 bits per element
+    ggml_half d;
+} block_tq2_0;
+
+// ============================================================================
+// Interleaved (repacked) structures
+// ============================================================================
+
+// The blocks at the same column of 4 or 8 consecutive rows, stored together so
+// one vector load feeds one output lane per row. Quants are interleaved in
+// 4-byte chunks: chunk c of row r lives at qs[(c*N + r)*4].
+
+typedef struct {
+    ggml_half d[4];
+    uint8_t qs[QK4_0 * 2];
+} block_q4_0x4;
+
+typedef struct {
+    ggml_half d[8];
+    uint8_t qs[QK4_0 * 4];
+} block_q4_0x8;
+
+typedef struct {
+    ggml_half d[4];
+    int8_t qs[QK8_0 * 4];
+} block_q8_0x4;
+
+typedef struct {
+    ggml_half d[8];
+    int8_t qs[QK8_0 * 8];
+} block_q8_0x8;
+
+// The 6-bit sub-block scales and mins are decoded at repack time, sub-block
+// major, so a kernel reads the values of all N rows with one load.
+typedef struct {
+    ggml_half d[4];
+    ggml_half dmin[4];
+    uint8_t scales[QK_K/32][4];
+    uint8_t mins[QK_K/32][4];
+    uint8_t qs[QK_K * 2];
+} block_q4_Kx4;
+
+typedef struct {
+    ggml_half d[8];
+    ggml_half dmin[8];
+    uint8_t scales[QK_K/32][8];
+    uint8_t mins[QK_K/32][8];
+    uint8_t qs[QK_K * 4];
+} block_q4_Kx8;
+
+// ============================================================================
+// SIMD dispatch
+// ============================================================================
+
+// Instruction sets with dedicated dequantization kernels.
+// Levels are ordered by vector width; the dispatcher picks the widest one
+// that is both compiled in and supported by the host CPU.
+typedef enum {
+    GGML_SIMD_SCALAR = 0,
+    GGML_SIMD_NEON   = 1,
+    GGML_SIMD_AVX2   = 2,
+    GGML_SIMD_AVX512 = 3,
+} ggml_simd_level;
+
+typedef void (*ggml_dequantize_row_t)(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+
+// Dequantization kernels for a single SIMD level
+typedef struct {
+    ggml_dequantize_row_t q4_0;
+    ggml_dequantize_row_t q4_1;
+    ggml_dequantize_row_t q5_0;
+    ggml_dequantize_row_t q5_1;
+    ggml_dequantize_row_t q8_0;
+    ggml_dequantize_row_t q8_1;
+    ggml_dequantize_row_t q2_K;
+    ggml_dequantize_row_t q3_K;
+    ggml_dequantize_row_t q4_K;
+    ggml_dequantize_row_t q5_K;
+    ggml_dequantize_row_t q6_K;
+    ggml_dequantize_row_t q8_K;
+    ggml_dequantize_row_t iq4_nl;
+    ggml_dequantize_row_t iq2_xxs;
+    ggml_dequantize_row_t iq2_xs;
+    ggml_dequantize_row_t iq2_s;
+    ggml_dequantize_row_t iq3_xxs;
+    ggml_dequantize_row_t iq3_s;
+    ggml_dequantize_row_t iq1_s;
+    ggml_dequantize_row_t iq1_m;
+    ggml_dequantize_row_t iq4_xs;
+    ggml_dequantize_row_t tq1_0;
+    ggml_dequantize_row_t tq2_0;
+    ggml_dequantize_row_t mxfp4;
+} ggml_dequantize_kernels;
+
+// Widest SIMD level usable on this host (detected once, then cached)
+GGML_API ggml_simd_level ggml_simd_level_best(void);
+
+// Whether kernels for `level` are compiled in and supported by the host CPU
+GGML_API bool ggml_simd_level_available(ggml_simd_level level);
+
+// Kernel table for `level`, or NULL if the level is not available
+GGML_API const ggml_dequantize_kernels * ggml_get_dequantize_kernels(ggml_simd_level level);
+
+// Dot product of two f32 vectors
+typedef float (*ggml_vec_dot_f32_t)(const float * GGML_RESTRICT x, const float * GGML_RESTRICT y, int64_t n);
+
+// Dot product of a quantized row with activations quantized to the paired Q8 type
+typedef float (*ggml_vec_dot_t)(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, int64_t n);
+
+// Dot product kernels for a single SIMD level, named <weights>_<activations>
+typedef struct {
+    ggml_vec_dot_f32_t f32;
+    ggml_vec_dot_t q4_0_q8_0;
+    ggml_vec_dot_t q4_1_q8_1;
+    ggml_vec_dot_t q5_0_q8_0;
+    ggml_vec_dot_t q5_1_q8_1;
+    ggml_vec_dot_t q8_0_q8_0;
+    ggml_vec_dot_t q2_K_q8_K;
+    ggml_vec_dot_t q3_K_q8_K;
+    ggml_vec_dot_t q4_K_q8_K;
+    ggml_vec_dot_t q5_K_q8_K;
+    ggml_vec_dot_t q6_K_q8_K;
+    ggml_vec_dot_t q8_K_q8_K;
+    ggml_vec_dot_t iq4_nl_q8_0;
+} ggml_vec_dot_kernels;
+
+// Dot product kernel table for `level`, or NULL if the level is not available
+GGML_API const ggml_vec_dot_kernels * ggml_get_vec_dot_kernels(ggml_simd_level level);
+
+typedef void (*ggml_quantize_row_t)(const float * GGML_RESTRICT x, void * GGML_RESTRICT y, int64_t k);
+
+// Quantization kernels for a single SIMD level
+typedef struct {
+    ggml_quantize_row_t q4_0;
+    ggml_quantize_row_t q4_1;
+    ggml_quantize_row_t q5_0;
+    ggml_quantize_row_t q5_1;
+    ggml_quantize_row_t q8_0;
+    ggml_quantize_row_t q8_1;
+    ggml_quantize_row_t q2_K;
+    ggml_quantize_row_t q3_K;
+    ggml_quantize_row_t q4_K;
+    ggml_quantize_row_t q5_K;
+    ggml_quantize_row_t q6_K;
+    ggml_quantize_row_t q8_K;
+    ggml_quantize_row_t iq4_nl;
+} ggml_quantize_kernels;
+
+// Quantization kernel table for `level`, or NULL if the level is not available
+GGML_API const ggml_quantize_kernels * ggml_get_quantize_kernels(ggml_simd_level level);
+
+// Dot products of one group of N interleaved rows with activations quantized
+// to the paired Q8 type, writing N results to `s`
+typedef void (*ggml_gemv_t)(const void * GGML_RESTRICT vx, const void * GGML_RESTRICT vy, float * GGML_RESTRICT s, int64_t n);
+
+// Interleaved dot product kernels for a single SIMD level, named
+// <weights>x<rows>_<activations>. Every level matches the scalar reference
+// bit for bit; the per-row float math follows the plain vec_dot references.
+typedef struct {
+    ggml_gemv_t q4_0x4_q8_0;
+    ggml_gemv_t q4_0x8_q8_0;
+    ggml_gemv_t q8_0x4_q8_0;
+    ggml_gemv_t q8_0x8_q8_0;
+    ggml_gemv_t q4_Kx4_q8_K;
+    ggml_gemv_t q4_Kx8_q8_K;
+} ggml_gemv_kernels;
+
+// Interleaved dot product kernel table for `level`, or NULL if the level is not available
+GGML_API const ggml_gemv_kernels * ggml_get_gemv_kernels(ggml_simd_level level);
+
+typedef void (*ggml_from_float_t)(const float * GGML_RESTRICT x, uint16_t * GGML_RESTRICT y, int64_t n);
+
+// f32 -> 16-bit float conversion kernels for a single SIMD level
+typedef struct {
+    ggml_from_float_t fp16;
+    ggml_from_float_t bf16;
+} ggml_half_kernels;
+
+// Half precision conversion kernel table for `level`, or NULL if the level is not available
+GGML_API const ggml_half_kernels * ggml_get_half_kernels(ggml_simd_level level);
+
+// Plain element type -> f32 widening kernels for a single SIMD level. Shaped
+// like row decoders with one element per block; inputs may be unaligned.
+typedef struct {
+    ggml_dequantize_row_t fp16;
+    ggml_dequantize_row_t bf16;
+    ggml_dequantize_row_t f64;
+    ggml_dequantize_row_t i8;
+    ggml_dequantize_row_t i16;
+    ggml_dequantize_row_t i32;
+    ggml_dequantize_row_t i64;
+} ggml_convert_kernels;
+
+// Element conversion kernel table for `level`, or NULL if the level is not available
+GGML_API const ggml_convert_kernels * ggml_get_convert_kernels(ggml_simd_level level);
+
+// Counts the NaN and infinite values among n floats placed `stride` bytes apart.
+// A stride of the element size scans a contiguous payload; a stride of the block
+// size scans one scale field per block. No alignment is required.
+typedef int64_t (*ggml_count_nonfinite_t)(const void * GGML_RESTRICT x, int64_t n, size_t stride);
+
+// Non-finite value scans for a single SIMD level
+typedef struct {
+    ggml_count_nonfinite_t fp16;
+    ggml_count_nonfinite_t bf16;
+    ggml_count_nonfinite_t f32;
+} ggml_finite_kernels;
+
+// Non-finite scan kernel table for `level`, or NULL if the level is not available
+GGML_API const ggml_finite_kernels * ggml_get_finite_kernels(ggml_simd_level level);
+
+// Running summary of a sequence of floats. Kernels summarize QK_K-element tiles
+// in f32 and fold them in with Chan's parallel update in double, so summaries of
+// separate chunks can be merged with ggml_stats_merge. min and max skip NaNs.
+typedef struct {
+    int64_t count;
+    double mean;
+    double m2;    // sum of squared deviations from the mean
+    double sumsq; // sum of squares
+    float min;
+    float max;
+} ggml_stats;
+
+// Folds n floats into `acc`
+typedef void (*ggml_stats_row_t)(const float * GGML_RESTRICT x, int64_t n, ggml_stats * GGML_RESTRICT acc);
+
+// Adds n floats to `bins` counters. Value x lands in bin (x - lo) * scale,
+// truncated and clamped to [0, bins - 1]; NaNs are not counted.
+typedef void (*ggml_histogram_row_t)(const float * GGML_RESTRICT x, int64_t n, float lo, float scale,
+                                     int64_t bins, int64_t * GGML_RESTRICT counts);
+
+// Running error metrics between two sequences of floats a and b. Tiles are
+// accumulated in f32 and added up in double; a zeroed struct is empty.
+typedef struct {
+    int64_t count;
+    double sumsq_diff; // sum of (a - b)^2
+    double dot;        // sum of a * b
+    double sumsq_a;    // sum of a^2
+    double sumsq_b;    // sum of b^2
+    float max_abs;     // largest |a - b|, skipping NaNs
+} ggml_diff;
+
+// Folds n pairs a[i], b[i] into `acc`
+typedef void (*ggml_diff_row_t)(const float * GGML_RESTRICT a, const float * GGML_RESTRICT b, int64_t n,
+                                ggml_diff * GGML_RESTRICT acc);
+
+// Statistics kernels for a single SIMD level. Every level matches the scalar
+// reference bit for bit: the references keep eight lanes and reduce them in
+// the order the vector kernels do.
+typedef struct {
+    ggml_stats_row_t stats;
+    ggml_histogram_row_t histogram;
+    ggml_diff_row_t diff;
+} ggml_stats_kernels;
+
+// Statistics kernel table for `level`, or NULL if the level is not available
+GGML_API const ggml_stats_kernels * ggml_get_stats_kernels(ggml_simd_level level);
+
 // ============================================================================
 // Function declarations - Dequantization
 // ============================================================================
 
+// Entry points dispatch to the widest available SIMD level.
+
 GGML_API void dequantize_row_q4_0(const block_q4_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
 GGML_API void dequantize_row_q4_1(const block_q4_1 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
 GGML_API void dequantize_row_q5_0(const block_q5_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
 GGML_API void dequantize_row_q5_1(const block_q5_1 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
 GGML_API void dequantize_row_q8_0(const block_q8_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q8_1(const block_q8_1 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
 
 GGML_API void dequantize_row_q2_K(const block_q2_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
 GGML_API void dequantize_row_q3_K(const block_q3_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
@@ -280,6 +639,182 @@ GGML_API void dequantize_row_q6_K(const block_q6_K * GGML_RESTRICT x, float * GG
 GGML_API void dequantize_row_q8_K(const block_q8_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
 
 GGML_API void dequantize_row_iq4_nl(const block_iq4_nl * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq2_xxs(const block_iq2_xxs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq2_xs(const block_iq2_xs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq2_s(const block_iq2_s * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq3_xxs(const block_iq3_xxs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq3_s(const block_iq3_s * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq1_s(const block_iq1_s * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq1_m(const block_iq1_m * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq4_xs(const block_iq4_xs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+
+GGML_API void dequantize_row_tq1_0(const block_tq1_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_tq2_0(const block_tq2_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_mxfp4(const block_mxfp4 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+
+// Scalar reference implementations, used as the fallback and as the
+// ground truth the SIMD kernels are tested against.
+GGML_API void dequantize_row_q4_0_ref(const block_q4_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q4_1_ref(const block_q4_1 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q5_0_ref(const block_q5_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q5_1_ref(const block_q5_1 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q8_0_ref(const block_q8_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q8_1_ref(const block_q8_1 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+
+GGML_API void dequantize_row_q2_K_ref(const block_q2_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q3_K_ref(const block_q3_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q4_K_ref(const block_q4_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q5_K_ref(const block_q5_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q6_K_ref(const block_q6_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_q8_K_ref(const block_q8_K * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+
+GGML_API void dequantize_row_iq4_nl_ref(const block_iq4_nl * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq2_xxs_ref(const block_iq2_xxs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq2_xs_ref(const block_iq2_xs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq2_s_ref(const block_iq2_s * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq3_xxs_ref(const block_iq3_xxs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq3_s_ref(const block_iq3_s * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq1_s_ref(const block_iq1_s * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq1_m_ref(const block_iq1_m * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_iq4_xs_ref(const block_iq4_xs * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+
+GGML_API void dequantize_row_tq1_0_ref(const block_tq1_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_tq2_0_ref(const block_tq2_0 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+GGML_API void dequantize_row_mxfp4_ref(const block_mxfp4 * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t k);
+
+// ============================================================================
+// Function declarations - Quantization
+// ============================================================================
+
+// Entry points dispatch to the widest available SIMD level. Q8_0, Q8_1 and
+// Q8_K double as the activation layouts for the integer dot products.
+
+GGML_API void quantize_row_q4_0(const float * GGML_RESTRICT x, block_q4_0 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q4_1(const float * GGML_RESTRICT x, block_q4_1 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q5_0(const float * GGML_RESTRICT x, block_q5_0 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q5_1(const float * GGML_RESTRICT x, block_q5_1 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q8_0(const float * GGML_RESTRICT x, block_q8_0 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q8_1(const float * GGML_RESTRICT x, block_q8_1 * GGML_RESTRICT y, int64_t k);
+
+GGML_API void quantize_row_q2_K(const float * GGML_RESTRICT x, block_q2_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q3_K(const float * GGML_RESTRICT x, block_q3_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q4_K(const float * GGML_RESTRICT x, block_q4_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q5_K(const float * GGML_RESTRICT x, block_q5_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q6_K(const float * GGML_RESTRICT x, block_q6_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q8_K(const float * GGML_RESTRICT x, block_q8_K * GGML_RESTRICT y, int64_t k);
+
+GGML_API void quantize_row_iq4_nl(const float * GGML_RESTRICT x, block_iq4_nl * GGML_RESTRICT y, int64_t k);
+
+// Scalar reference implementations, including the scale/min search of the
+// K-quants and IQ4_NL. SIMD kernels produce bit-identical blocks.
+GGML_API void quantize_row_q4_0_ref(const float * GGML_RESTRICT x, block_q4_0 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q4_1_ref(const float * GGML_RESTRICT x, block_q4_1 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q5_0_ref(const float * GGML_RESTRICT x, block_q5_0 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q5_1_ref(const float * GGML_RESTRICT x, block_q5_1 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q8_0_ref(const float * GGML_RESTRICT x, block_q8_0 * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q8_1_ref(const float * GGML_RESTRICT x, block_q8_1 * GGML_RESTRICT y, int64_t k);
+
+GGML_API void quantize_row_q2_K_ref(const float * GGML_RESTRICT x, block_q2_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q3_K_ref(const float * GGML_RESTRICT x, block_q3_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q4_K_ref(const float * GGML_RESTRICT x, block_q4_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q5_K_ref(const float * GGML_RESTRICT x, block_q5_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q6_K_ref(const float * GGML_RESTRICT x, block_q6_K * GGML_RESTRICT y, int64_t k);
+GGML_API void quantize_row_q8_K_ref(const float * GGML_RESTRICT x, block_q8_K * GGML_RESTRICT y, int64_t k);
+
+GGML_API void quantize_row_iq4_nl_ref(const float * GGML_RESTRICT x, block_iq4_nl * GGML_RESTRICT y, int64_t k);
+
+// ============================================================================
+// Function declarations - Half precision output
+// ============================================================================
+
+// Entry points dispatch to the widest available SIMD level. Every level rounds
+// to nearest even and matches the scalar reference bit for bit, NaNs included.
+GGML_API void ggml_fp32_to_fp16_row(const float * GGML_RESTRICT x, ggml_fp16_t * GGML_RESTRICT y, int64_t n);
+GGML_API void ggml_fp32_to_bf16_row(const float * GGML_RESTRICT x, ggml_bf16_t * GGML_RESTRICT y, int64_t n);
+
+GGML_API void ggml_fp32_to_fp16_row_ref(const float * GGML_RESTRICT x, ggml_fp16_t * GGML_RESTRICT y, int64_t n);
+GGML_API void ggml_fp32_to_bf16_row_ref(const float * GGML_RESTRICT x, ggml_bf16_t * GGML_RESTRICT y, int64_t n);
+
+// 16-bit floats widened to f32, shaped like row decoders (one element per
+// 2-byte block) so they can feed ggml_dequantize_row_half.
+GGML_API void ggml_fp16_to_fp32_row(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+GGML_API void ggml_bf16_to_fp32_row(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+
+// Scalar f64 and integer widenings with the same shape. Every level matches
+// them bit for bit: integers and f64 round to nearest even like a C cast.
+GGML_API void ggml_f64_to_fp32_row_ref(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+GGML_API void ggml_i8_to_fp32_row_ref(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+GGML_API void ggml_i16_to_fp32_row_ref(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+GGML_API void ggml_i32_to_fp32_row_ref(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+GGML_API void ggml_i64_to_fp32_row_ref(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int64_t n);
+
+// Decodes a row one QK_K tile at a time into a stack buffer and narrows each
+// tile with `convert`, so the f32 values never round-trip through memory.
+GGML_API void ggml_dequantize_row_half(ggml_dequantize_row_t dequantize, ggml_from_float_t convert,
+                                       int64_t block_size, size_t type_size,
+                                       const void * GGML_RESTRICT vx, uint16_t * GGML_RESTRICT y, int64_t k);
+
+// ============================================================================
+// Function declarations - Statistics
+// ============================================================================
+
+// An empty summary: count 0, min +inf, max -inf
+GGML_API void ggml_stats_init(ggml_stats * s);
+
+// Folds `other` into `acc`
+GGML_API void ggml_stats_merge(ggml_stats * GGML_RESTRICT acc, const ggml_stats * GGML_RESTRICT other);
+
+// Decodes a row one QK_K tile at a time into a stack buffer and folds each
+// tile into `acc`, so the f32 values never round-trip through memory.
+GGML_API void ggml_dequantize_row_stats(ggml_dequantize_row_t dequantize, ggml_stats_row_t stats,
+                                        int64_t block_size, size_t type_size,
+                                        const void * GGML_RESTRICT vx, int64_t k, ggml_stats * GGML_RESTRICT acc);
+
+// Same tiling as ggml_dequantize_row_stats, feeding a histogram
+GGML_API void ggml_dequantize_row_histogram(ggml_dequantize_row_t dequantize, ggml_histogram_row_t histogram,
+                                            int64_t block_size, size_t type_size,
+                                            const void * GGML_RESTRICT vx, int64_t k,
+                                            float lo, float scale, int64_t bins, int64_t * GGML_RESTRICT counts);
+
+// Folds `other` into `acc`
+GGML_API void ggml_diff_merge(ggml_diff * GGML_RESTRICT acc, const ggml_diff * GGML_RESTRICT other);
+
+// Compares two rows of k values one QK_K tile at a time. Each side is decoded
+// with its own row decoder into a stack buffer; a NULL decoder reads f32
+// values. With `same_encoding` set, tiles whose bytes are equal are skipped
+// without decoding. Returns the number of tiles folded into `acc`.
+GGML_API int64_t ggml_dequantize_row_diff(ggml_dequantize_row_t dequantize_a, int64_t block_size_a, size_t type_size_a,
+                                          const void * GGML_RESTRICT xa,
+                                          ggml_dequantize_row_t dequantize_b, int64_t block_size_b, size_t type_size_b,
+                                          const void * GGML_RESTRICT xb,
+                                          int same_encoding, ggml_diff_row_t diff, int64_t k,
+                                          ggml_diff * GGML_RESTRICT acc);
+
+// ============================================================================
+// Function declarations - Dot products
+// ============================================================================
+
+// Dot product of a quantized row with f32 activations. The row is decoded one
+// QK_K tile at a time into a stack buffer, so it never round-trips through memory.
+GGML_API float ggml_vec_dot_dequantized_f32(ggml_dequantize_row_t dequantize, ggml_vec_dot_f32_t dot,
+                                            int64_t block_size, size_t type_size,
+                                            const void * GGML_RESTRICT vx, const float * GGML_RESTRICT y, int64_t n);
+
+// ============================================================================
+// Function declarations - Repacking
+// ============================================================================
+
+// Interleaves `nrows` rows of `k` elements into groups of `n` rows (4 or 8).
+// `nrows` must be a multiple of `n`; group g holds rows g*n ..< (g+1)*n.
+GGML_API void ggml_repack_q4_0(const block_q4_0 * GGML_RESTRICT x, void * GGML_RESTRICT y, int n, int64_t nrows, int64_t k);
+GGML_API void ggml_repack_q8_0(const block_q8_0 * GGML_RESTRICT x, void * GGML_RESTRICT y, int n, int64_t nrows, int64_t k);
+GGML_API void ggml_repack_q4_K(const block_q4_K * GGML_RESTRICT x, void * GGML_RESTRICT y, int n, int64_t nrows, int64_t k);
+
+// Decodes one group of `n` interleaved rows of `k` elements into n*k floats,
+// row-major. Values match dequantize_row_*_ref of the original rows.
+GGML_API void ggml_dequantize_repacked_q4_0(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int n, int64_t k);
+GGML_API void ggml_dequantize_repacked_q8_0(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int n, int64_t k);
+GGML_API void ggml_dequantize_repacked_q4_K(const void * GGML_RESTRICT x, float * GGML_RESTRICT y, int n, int64_t k);
 
 #ifdef __cplusplus
 }
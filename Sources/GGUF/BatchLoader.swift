@@ -0,0 +1,445 @@
+import Dispatch
+import Foundation
+import Synchronization
+
+extension GGUF {
+    /// Tensors to load with `loadTensors(_:from:options:_:)`
+    public enum TensorSelection: Sendable {
+        case all
+        /// Indices into tensorInfos, which must be in range; repeated indices load once
+        case indices([Int])
+        /// Tensor names; loading throws `invalidTensorName` for a name not in the file
+        case names([String])
+        /// Every tensor whose info satisfies the predicate
+        case matching(@Sendable (TensorInfo) -> Bool)
+    }
+
+    /// Tuning for `loadTensors(_:from:options:_:)`
+    public struct BatchLoadOptions: Sendable {
+        /// Number of worker threads
+        public var maxConcurrency: Int
+        /// Elements per task. Tensors are cut into tasks of about this size on block
+        /// boundaries, so a 500 MB embedding spreads over every worker while a norm vector is
+        /// a single task.
+        public var taskSize: Int
+
+        public init(
+            maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount,
+            taskSize: Int = 1 << 18
+        ) {
+            self.maxConcurrency = max(1, maxConcurrency)
+            self.taskSize = max(1, taskSize)
+        }
+    }
+
+    /// Dequantized values of one tensor loaded by `loadTensors(_:from:options:_:)`. The
+    /// values are written by the loader's workers once and never change afterwards.
+    public final class TensorValues: RandomAccessCollection, @unchecked Sendable {
+        /// Index of the tensor in tensorInfos array
+        public let tensorIndex: Int
+        private let buffer: UnsafeMutableBufferPointer<Float>
+
+        init(tensorIndex: Int, count: Int) {
+            self.tensorIndex = tensorIndex
+            self.buffer = .allocate(capacity: count)
+        }
+
+        deinit {
+            buffer.deallocate()
+        }
+
+        public var startIndex: Int { 0 }
+        public var endIndex: Int { buffer.count }
+
+        public subscript(position: Int) -> Float {
+            precondition(indices.contains(position), "Index out of range")
+            return buffer[position]
+        }
+
+        /// Calls `body` with the values in place
+        public func withUnsafeBufferPointer<R>(
+            _ body: (UnsafeBufferPointer<Float>) throws -> R
+        ) rethrows -> R {
+            try body(UnsafeBufferPointer(buffer))
+        }
+
+        /// Destination of the elements in `range`
+        fileprivate func slice(_ range: Range<Int>) -> UnsafeMutableBufferPointer<Float> {
+            UnsafeMutableBufferPointer(rebasing: buffer[range])
+        }
+    }
+
+    /// Dequantizes a batch of tensors on a work-stealing pool, handing each tensor over as
+    /// soon as its last task finishes.
+    ///
+    /// Every selected tensor is cut into block-aligned tasks of about `options.taskSize`
+    /// elements. Tasks are dealt round-robin to per-worker queues in selection order, so the
+    /// workers cooperate on the first tensors first and deliveries start early. A worker that
+    /// runs out of tasks steals from the back of another worker's queue, which keeps the
+    /// threads busy however unevenly the tensor sizes are spread.
+    ///
+    /// Each tensor's output is allocated when its first task starts, and the loader lets go of
+    /// it once delivered.
+    /// - Parameters:
+    ///   - selection: Tensors to load
+    ///   - fileData: The complete GGUF file data
+    ///   - options: Worker count and task size
+    ///   - body: Receives each tensor's values. Called concurrently from worker threads, in
+    ///     completion order.
+    /// - Throws: `invalidTensorName` for an unknown name, otherwise the first error thrown by
+    ///   a conversion or by `body`; remaining tasks are skipped
+    public func loadTensors(
+        _ selection: TensorSelection,
+        from fileData: Data,
+        options: BatchLoadOptions = BatchLoadOptions(),
+        _ body: @Sendable (_ values: TensorValues) throws -> Void
+    ) throws {
+        let indices = try tensorIndices(of: selection)
+        let loader = BatchLoader(gguf: self, tensorIndices: indices, options: options)
+        loader.run(fileData: fileData, deliver: body)
+        if let error = loader.error {
+            throw error
+        }
+    }
+
+    /// Dequantizes a batch of tensors like `loadTensors(_:from:options:_:)` and yields them
+    /// in completion order. The work runs on background threads; ending iteration early
+    /// cancels the remaining tasks.
+    ///
+    /// At most `options.maxConcurrency` finished tensors wait for the consumer. A worker that
+    /// finishes one more blocks until the consumer takes one, so a slow consumer holds the
+    /// loading back instead of letting outputs pile up.
+    /// - Throws: `invalidTensorName` for an unknown name
+    public func tensorValues(
+        _ selection: TensorSelection,
+        from fileData: Data,
+        options: BatchLoadOptions = BatchLoadOptions()
+    ) throws -> AsyncThrowingStream<TensorValues, any Swift.Error> {
+        let indices = try tensorIndices(of: selection)
+        let loader = BatchLoader(gguf: self, tensorIndices: indices, options: options)
+        let delivery = Delivery(loader: loader, capacity: options.maxConcurrency)
+        DispatchQueue.global().async {
+            loader.run(fileData: fileData) { delivery.put($0) }
+            delivery.finish(throwing: loader.error)
+        }
+        let owner = DeliveryOwner(delivery)
+        return AsyncThrowingStream {
+            try await owner.delivery.next()
+        }
+    }
+
+    /// Indices of the selected tensors, in selection order without repeats
+    func tensorIndices(of selection: TensorSelection) throws -> [Int] {
+        let indices: [Int]
+        switch selection {
+        case .all:
+            return Array(tensorInfos.indices)
+        case .indices(let selected):
+            for index in selected {
+                precondition(tensorInfos.indices.contains(index), "Tensor index out of range")
+            }
+            indices = selected
+        case .names(let names):
+            indices = try names.map { name in
+                guard let index = tensorInfos.index(named: name) else {
+                    throw Error.invalidTensorName(name)
+                }
+                return index
+            }
+        case .matching(let predicate):
+            return tensorInfos.indices.filter { predicate(tensorInfos[$0]) }
+        }
+        var seen = Set<Int>()
+        return indices.filter { seen.insert($0).inserted }
+    }
+}
+
+/// WorkItem queues and per-tensor progress of one batch load
+private final class BatchLoader: Sendable {
+    /// Block-aligned slice of one tensor
+    struct WorkItem {
+        /// Position of the tensor in `slots`
+        let slot: Int
+        let elements: Range<Int>
+    }
+
+    /// Output and outstanding task count of one tensor
+    final class Slot: Sendable {
+        let tensorIndex: Int
+        let count: Int
+        let remaining: Atomic<Int>
+        /// Allocated by the first task to start, released on delivery
+        private let output = Mutex<GGUF.TensorValues?>(nil)
+
+        init(tensorIndex: Int, count: Int, taskCount: Int) {
+            self.tensorIndex = tensorIndex
+            self.count = count
+            remaining = Atomic(taskCount)
+        }
+
+        /// The output, allocated on first use
+        var values: GGUF.TensorValues {
+            output.withLock { output in
+                if let values = output {
+                    return values
+                }
+                let values = GGUF.TensorValues(tensorIndex: tensorIndex, count: count)
+                output = values
+                return values
+            }
+        }
+
+        /// Hands the output over, leaving the slot empty
+        func take() -> GGUF.TensorValues {
+            let values = self.values
+            output.withLock { $0 = nil }
+            return values
+        }
+    }
+
+    /// Owner takes from the front, thieves from the back
+    final class WorkQueue: Sendable {
+        private let tasks: Mutex<(items: [WorkItem], front: Int, back: Int)>
+
+        init(_ items: [WorkItem]) {
+            tasks = Mutex((items, 0, items.count))
+        }
+
+        func popFront() -> WorkItem? {
+            tasks.withLock { queue in
+                guard queue.front < queue.back else {
+                    return nil
+                }
+                queue.front += 1
+                return queue.items[queue.front - 1]
+            }
+        }
+
+        func popBack() -> WorkItem? {
+            tasks.withLock { queue in
+                guard queue.front < queue.back else {
+                    return nil
+                }
+                queue.back -= 1
+                return queue.items[queue.back]
+            }
+        }
+    }
+
+    private let gguf: GGUF
+    private let slots: [Slot]
+    private let queues: [WorkQueue]
+    private let failure = Mutex<(any Error)?>(nil)
+    /// Set on the first failure or on cancellation; workers stop claiming tasks
+    private let stopped = Atomic<Bool>(false)
+
+    init(gguf: GGUF, tensorIndices: [Int], options: GGUF.BatchLoadOptions) {
+        var slots = [Slot]()
+        var tasks = [WorkItem]()
+        for (slot, tensorIndex) in tensorIndices.enumerated() {
+            let count = Int(gguf.tensorInfos.elementCounts[tensorIndex])
+            let blockSize = gguf.tensorInfos.dataTypes[tensorIndex].blockSize
+            // A trailing partial block can only be decoded with the rest of the tensor
+            let step =
+                count % blockSize == 0
+                ? max(1, options.taskSize / blockSize) * blockSize
+                : max(1, count)
+            let ranges = stride(from: 0, to: max(count, 1), by: step).map {
+                $0..<min(count, $0 + step)
+            }
+            slots.append(Slot(tensorIndex: tensorIndex, count: count, taskCount: ranges.count))
+            tasks += ranges.map { WorkItem(slot: slot, elements: $0) }
+        }
+        let workerCount = max(1, min(options.maxConcurrency, tasks.count))
+        self.gguf = gguf
+        self.slots = slots
+        self.queues = (0..<workerCount).map { worker in
+            WorkQueue(Array(tasks[worker...].striding(by: workerCount)))
+        }
+    }
+
+    var error: (any Error)? {
+        failure.withLock { $0 }
+    }
+
+    /// Skips the tasks not yet started
+    func cancel() {
+        stopped.store(true, ordering: .relaxed)
+    }
+
+    /// Runs every task, calling `deliver` with each tensor as its last task finishes
+    func run(fileData: Data, deliver: (GGUF.TensorValues) throws -> Void) {
+        DispatchQueue.concurrentPerform(iterations: queues.count) { worker in
+            while !stopped.load(ordering: .relaxed), let task = nextTask(for: worker) {
+                do {
+                    try execute(task, fileData: fileData)
+                    let slot = slots[task.slot]
+                    if slot.remaining.subtract(1, ordering: .acquiringAndReleasing).newValue == 0
+                    {
+                        try deliver(slot.take())
+                    }
+                } catch {
+                    failure.withLock { $0 = $0 ?? error }
+                    stopped.store(true, ordering: .relaxed)
+                }
+            }
+        }
+    }
+
+    /// The worker's own next task, or one stolen from the other queues
+    private func nextTask(for worker: Int) -> WorkItem? {
+        if let task = queues[worker].popFront() {
+            return task
+        }
+        for offset in 1..<queues.count {
+            if let task = queues[(worker + offset) % queues.count].popBack() {
+                return task
+            }
+        }
+        return nil
+    }
+
+    private func execute(_ task: WorkItem, fileData: Data) throws {
+        let slot = slots[task.slot]
+        let tensorIndex = slot.tensorIndex
+        let type = gguf.tensorInfos.dataTypes[tensorIndex]
+        let byteRange = gguf.tensorInfos.byteRange(at: tensorIndex)
+        // Tasks start on block boundaries; only the last one may end inside a block
+        let blockBytes = { (element: Int) in element / type.blockSize * type.bytesPerBlock }
+        let start = byteRange.lowerBound + blockBytes(task.elements.lowerBound)
+        let end =
+            task.elements.upperBound == slot.count
+            ? byteRange.upperBound
+            : byteRange.lowerBound + blockBytes(task.elements.upperBound)
+        try GGUF.convert(
+            fileData[start..<end], type: type, into: slot.values.slice(task.elements),
+            parallelism: .serial)
+    }
+}
+
+/// Hands finished tensors from the workers of one load to a stream's consumer
+private final class Delivery: Sendable {
+    typealias Consumer = CheckedContinuation<GGUF.TensorValues?, any Error>
+
+    private struct State {
+        /// Finished tensors not yet taken, in completion order
+        var ready: [GGUF.TensorValues] = []
+        /// Consumer suspended in `next()` while `ready` is empty
+        var consumer: Consumer?
+        var end: Result<Void, any Error>?
+        var isCancelled = false
+    }
+
+    private let loader: BatchLoader
+    private let state = Mutex(State())
+    /// Free places in `ready`
+    private let space: DispatchSemaphore
+
+    init(loader: BatchLoader, capacity: Int) {
+        self.loader = loader
+        self.space = DispatchSemaphore(value: max(1, capacity))
+    }
+
+    /// Queues `values` for the consumer, blocking the worker while the queue is full
+    func put(_ values: GGUF.TensorValues) {
+        space.wait()
+        let (consumer, isQueued) = state.withLock { state -> (Consumer?, Bool) in
+            if state.isCancelled {
+                return (nil, false)
+            }
+            if let consumer = state.consumer {
+                state.consumer = nil
+                return (consumer, false)
+            }
+            state.ready.append(values)
+            return (nil, true)
+        }
+        // The place stays taken only while the tensor waits. After cancellation this wakes the
+        // next blocked worker, which drops its tensor in turn.
+        if !isQueued {
+            space.signal()
+        }
+        consumer?.resume(returning: values)
+    }
+
+    /// Ends the stream once the queued tensors are taken
+    func finish(throwing error: (any Error)?) {
+        let consumer = state.withLock { state in
+            state.end = error.map { .failure($0) } ?? .success(())
+            defer { state.consumer = nil }
+            return state.consumer
+        }
+        if let error {
+            consumer?.resume(throwing: error)
+        } else {
+            consumer?.resume(returning: nil)
+        }
+    }
+
+    /// Stops the load, drops the queued tensors and releases the blocked workers
+    func cancel() {
+        loader.cancel()
+        let (consumer, dropped) = state.withLock { state in
+            defer {
+                state.isCancelled = true
+                state.ready.removeAll()
+                state.consumer = nil
+            }
+            return (state.consumer, state.isCancelled ? 0 : state.ready.count)
+        }
+        // Frees the dropped tensors' places, and one more to wake a blocked worker
+        for _ in 0...dropped {
+            space.signal()
+        }
+        consumer?.resume(returning: nil)
+    }
+
+    /// The next finished tensor, or nil after the last one or on cancellation
+    func next() async throws -> GGUF.TensorValues? {
+        try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { continuation in
+                let result = state.withLock { state -> Result<GGUF.TensorValues?, any Error>? in
+                    if state.isCancelled {
+                        return .success(nil)
+                    }
+                    if !state.ready.isEmpty {
+                        return .success(state.ready.removeFirst())
+                    }
+                    if let end = state.end {
+                        return end.map { nil }
+                    }
+                    state.consumer = continuation
+                    return nil
+                }
+                if case .success(.some) = result {
+                    space.signal()
+                }
+                if let result {
+                    continuation.resume(with: result)
+                }
+            }
+        } onCancel: {
+            cancel()
+        }
+    }
+}
+
+/// Cancels the load when the stream is released, e.g. after iteration ends early
+private final class DeliveryOwner: Sendable {
+    let delivery: Delivery
+
+    init(_ delivery: Delivery) {
+        self.delivery = delivery
+    }
+
+    deinit {
+        delivery.cancel()
+    }
+}
+
+extension ArraySlice {
+    /// Every `step`-th element, starting with the first
+    fileprivate func striding(by step: Int) -> [Element] {
+        stride(from: startIndex, to: endIndex, by: step).map { self[$0] }
+    }
+}
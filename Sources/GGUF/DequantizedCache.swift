@@ -0,0 +1,386 @@
+import Foundation
+import Quants
+
+#if canImport(Darwin)
+import Darwin
+#elseif canImport(Glibc)
+import Glibc
+#endif
+
+extension GGUF {
+    /// Sidecar file of dequantized tensors, memory-mapped on later loads.
+    ///
+    /// Dequantizing a model produces the same values on every start. The cache stores them
+    /// once, each tensor aligned to 64 bytes, so a warm start maps the file and hands out
+    /// views into the mapping: no allocation and no decoding.
+    ///
+    /// The file starts with a 64-byte header and an index with one entry per tensor: the
+    /// tensor's offset in the data section, its element count and where its values start.
+    /// The header records a hash of the GGUF's header, metadata and tensor infos plus the
+    /// file size. A cache whose hash, size or tensor offsets disagree with the model is
+    /// stale. Weights rewritten in place with the same header and layout are not detected.
+    public struct DequantizedCache: Sendable {
+        /// Encoding of the cached values
+        public enum Precision: UInt32, Sendable, CaseIterable {
+            case f32 = 0
+            case f16 = 1
+            case bf16 = 2
+
+            /// Bytes per value
+            public var byteWidth: Int {
+                self == .f32 ? 4 : 2
+            }
+        }
+
+        public let precision: Precision
+        /// Tensor infos of the model the cache was opened for
+        public let tensorInfos: TensorTable
+        private let file: MappedFile
+        /// Offset of each tensor's values in the file; nil if the tensor is not cached
+        private let valueOffsets: [Int?]
+
+        /// Maps the cache at `url` if it was built for this model
+        /// - Parameters:
+        ///   - url: Location of the cache file
+        ///   - gguf: Model the cache belongs to
+        ///   - fileData: The complete GGUF file data, used to fingerprint the model
+        /// - Returns: nil if the file is missing, truncated or was built for another model
+        /// - Throws: Error if the file exists but cannot be mapped
+        public init?(contentsOf url: URL, for gguf: GGUF, fileData: Data) throws {
+            guard FileManager.default.fileExists(atPath: url.path) else {
+                return nil
+            }
+            let file = try MappedFile(contentsOf: url)
+            let data = file.data
+            let tensorCount = gguf.tensorInfos.count
+            guard data.count >= Layout.headerSize + tensorCount * Layout.entrySize else {
+                return nil
+            }
+            func load<T: FixedWidthInteger>(_ offset: Int, as type: T.Type = UInt64.self) -> T {
+                data.withUnsafeBytes {
+                    T(littleEndian: $0.loadUnaligned(fromByteOffset: offset, as: T.self))
+                }
+            }
+            guard load(0, as: UInt32.self) == Layout.magic,
+                load(4, as: UInt32.self) == Layout.version,
+                let precision = Precision(rawValue: load(8, as: UInt32.self)),
+                load(16) == Self.fingerprint(of: gguf, fileData: fileData),
+                load(24) == UInt64(fileData.count),
+                load(32) == UInt64(tensorCount)
+            else {
+                return nil
+            }
+
+            var valueOffsets = [Int?](repeating: nil, count: tensorCount)
+            for index in 0..<tensorCount {
+                let entry = Layout.headerSize + index * Layout.entrySize
+                guard load(entry) == gguf.tensorInfos.offsets[index] else {
+                    return nil
+                }
+                let valueOffset = load(entry + 16)
+                guard valueOffset != Layout.absent else {
+                    continue
+                }
+                let count = Int(gguf.tensorInfos.elementCounts[index])
+                guard load(entry + 8) == UInt64(count),
+                    let start = Int(exactly: valueOffset),
+                    start % Layout.alignment == 0,
+                    start <= data.count - count * precision.byteWidth
+                else {
+                    return nil
+                }
+                valueOffsets[index] = start
+            }
+            self.precision = precision
+            self.tensorInfos = gguf.tensorInfos
+            self.file = file
+            self.valueOffsets = valueOffsets
+        }
+
+        /// Maps the cache at `url`, building it first if it is missing or stale
+        /// - Parameters:
+        ///   - url: Location of the cache file
+        ///   - gguf: Model to cache
+        ///   - fileData: The complete GGUF file data
+        ///   - precision: Encoding used when the cache is (re)built. An existing cache of
+        ///     another precision is rebuilt.
+        ///   - parallelism: How to split dequantization of each tensor across threads
+        /// - Throws: `fileWriteFailed` if the cache cannot be written, `staleCache` if another
+        ///   process replaces it before it is mapped, or an error if it cannot be mapped
+        public static func open(
+            at url: URL,
+            for gguf: GGUF,
+            fileData: Data,
+            precision: Precision = .f32,
+            parallelism: Parallelism = .serial
+        ) throws -> DequantizedCache {
+            if let cache = try DequantizedCache(contentsOf: url, for: gguf, fileData: fileData),
+                cache.precision == precision
+            {
+                return cache
+            }
+            try build(
+                for: gguf, fileData: fileData, at: url, precision: precision,
+                parallelism: parallelism)
+            guard let cache = try DequantizedCache(contentsOf: url, for: gguf, fileData: fileData),
+                cache.precision == precision
+            else {
+                // Replaced by a cache for another model or precision between the build and
+                // the load
+                throw Error.staleCache
+            }
+            return cache
+        }
+
+        /// Dequantizes every tensor of `gguf` into a new cache file at `url`.
+        ///
+        /// Tensors are written one at a time, so memory use is bounded by the largest
+        /// tensor. The file is written next to `url` and renamed into place, so readers never
+        /// map a partial cache. Tensors whose type cannot be converted are left out.
+        /// - Parameters:
+        ///   - gguf: Model to cache
+        ///   - fileData: The complete GGUF file data
+        ///   - url: Location of the cache file; replaced if it exists
+        ///   - precision: Encoding of the cached values
+        ///   - parallelism: How to split dequantization of each tensor across threads
+        /// - Throws: `fileWriteFailed` if the file cannot be created, written or renamed into
+        ///   place
+        public static func build(
+            for gguf: GGUF,
+            fileData: Data,
+            at url: URL,
+            precision: Precision = .f32,
+            parallelism: Parallelism = .serial
+        ) throws {
+            let tensorCount = gguf.tensorInfos.count
+            let temporaryURL = url.deletingLastPathComponent()
+                .appendingPathComponent(".\(url.lastPathComponent).\(UUID().uuidString)")
+            let descriptor = createFile(atPath: temporaryURL.path)
+            guard descriptor >= 0 else {
+                throw Error.fileWriteFailed(errno: errno)
+            }
+            var renamed = false
+            defer {
+                if !renamed {
+                    try? FileManager.default.removeItem(at: temporaryURL)
+                }
+            }
+            defer { close(descriptor) }
+
+            var position = (Layout.headerSize + tensorCount * Layout.entrySize)
+                .aligned(to: Layout.alignment)
+            var index = [UInt8]()
+            index.reserveCapacity(tensorCount * Layout.entrySize)
+            for tensorIndex in 0..<tensorCount {
+                let count = Int(gguf.tensorInfos.elementCounts[tensorIndex])
+                index.appendLittleEndian(gguf.tensorInfos.offsets[tensorIndex])
+                index.appendLittleEndian(UInt64(count))
+                guard
+                    let values = try? encodedValues(
+                        of: gguf, at: tensorIndex, from: fileData, precision: precision,
+                        parallelism: parallelism)
+                else {
+                    index.appendLittleEndian(Layout.absent)
+                    continue
+                }
+                index.appendLittleEndian(UInt64(position))
+                let padding = (position + values.count).aligned(to: Layout.alignment)
+                    - (position + values.count)
+                try write(values + Data(count: padding), to: descriptor, at: position)
+                position += values.count + padding
+            }
+
+            var header = [UInt8]()
+            header.appendLittleEndian(Layout.magic)
+            header.appendLittleEndian(Layout.version)
+            header.appendLittleEndian(precision.rawValue)
+            header.appendLittleEndian(UInt32(0))
+            header.appendLittleEndian(fingerprint(of: gguf, fileData: fileData))
+            header.appendLittleEndian(UInt64(fileData.count))
+            header.appendLittleEndian(UInt64(tensorCount))
+            header += [UInt8](repeating: 0, count: Layout.headerSize - header.count)
+            try write(Data(header + index), to: descriptor, at: 0)
+            guard fsync(descriptor) == 0 else {
+                throw Error.fileWriteFailed(errno: errno)
+            }
+
+            guard rename(temporaryURL.path, url.path) == 0 else {
+                throw Error.fileWriteFailed(errno: errno)
+            }
+            renamed = true
+        }
+
+        /// Cached values of a tensor, or nil if the tensor is not in the cache
+        public func tensor(at tensorIndex: Int) -> CachedTensor? {
+            guard let start = valueOffsets[tensorIndex] else {
+                return nil
+            }
+            let count = Int(tensorInfos.elementCounts[tensorIndex])
+            let end = start + count * precision.byteWidth
+            return CachedTensor(precision: precision, bytes: file.data[start..<end])
+        }
+
+        /// Cached values of the tensor called `name`, or nil if there is no such cached tensor
+        public func tensor(_ name: String) -> CachedTensor? {
+            tensorInfos.index(named: name).flatMap(tensor(at:))
+        }
+
+        // MARK: - Helpers
+
+        private enum Layout {
+            static let magic: UInt32 = 0x4344_4747  // "GGDC"
+            static let version: UInt32 = 1
+            static let headerSize = 64
+            /// Source offset, element count and value offset
+            static let entrySize = 24
+            static let alignment = 64
+            /// Value offset of a tensor that is not cached
+            static let absent = UInt64.max
+        }
+
+        /// FNV-1a over everything before the tensor data: header, metadata and tensor infos
+        static func fingerprint(of gguf: GGUF, fileData: Data) -> UInt64 {
+            let prefix = fileData.prefix(gguf.tensorDataOffset)
+            return prefix.withUnsafeBytes { bytes in
+                var hash: UInt64 = 0xcbf2_9ce4_8422_2325
+                for byte in bytes {
+                    hash = (hash ^ UInt64(byte)) &* 0x100_0000_01b3
+                }
+                return hash
+            }
+        }
+
+        /// Writes all of `data` at `offset`, retrying short and interrupted writes
+        private static func write(_ data: Data, to fileDescriptor: Int32, at offset: Int) throws {
+            try data.withUnsafeBytes { buffer in
+                var total = 0
+                while total < buffer.count {
+                    let result = pwrite(
+                        fileDescriptor,
+                        buffer.baseAddress! + total,
+                        buffer.count - total,
+                        off_t(offset + total)
+                    )
+                    if result < 0 {
+                        if errno == EINTR {
+                            continue
+                        }
+                        throw Error.fileWriteFailed(errno: errno)
+                    }
+                    total += result
+                }
+            }
+        }
+
+        private static func encodedValues(
+            of gguf: GGUF,
+            at tensorIndex: Int,
+            from fileData: Data,
+            precision: Precision,
+            parallelism: Parallelism
+        ) throws -> Data {
+            switch precision {
+            case .f32:
+                let values = try gguf.tensorFloatArray(
+                    at: tensorIndex, from: fileData, parallelism: parallelism)
+                return values.withUnsafeBytes { Data($0) }
+            case .f16:
+                return try gguf.tensorHalfData(
+                    at: tensorIndex, from: fileData, as: .f16, parallelism: parallelism)
+            case .bf16:
+                return try gguf.tensorHalfData(
+                    at: tensorIndex, from: fileData, as: .bf16, parallelism: parallelism)
+            }
+        }
+    }
+
+    /// Values of one tensor inside a mapped `DequantizedCache`. Copies share the mapping;
+    /// it stays mapped while any view is alive.
+    public struct CachedTensor: RandomAccessCollection, Sendable {
+        public let precision: DequantizedCache.Precision
+        /// Encoded values, 64-byte aligned
+        public let bytes: Data
+
+        public var startIndex: Int { 0 }
+        public var endIndex: Int { bytes.count / precision.byteWidth }
+
+        public subscript(position: Int) -> Float {
+            precondition(indices.contains(position), "Index out of range")
+            return bytes.withUnsafeBytes { raw in
+                let offset = position * precision.byteWidth
+                switch precision {
+                case .f32:
+                    return raw.load(fromByteOffset: offset, as: Float.self)
+                case .f16:
+                    let bits = raw.load(fromByteOffset: offset, as: UInt16.self)
+                    return Float(Float16(bitPattern: bits))
+                case .bf16:
+                    let bits = raw.load(fromByteOffset: offset, as: UInt16.self)
+                    return Float(bitPattern: UInt32(bits) << 16)
+                }
+            }
+        }
+
+        /// The values as f32: copied out of the mapping when cached as f32, widened otherwise
+        public func floatArray(parallelism: Parallelism = .serial) -> [Float] {
+            switch precision {
+            case .f32:
+                withUnsafeBufferPointer { Array($0) }
+            case .f16:
+                Dequantize.convert(bytes, from: .f16, elementCount: count, parallelism: parallelism)
+            case .bf16:
+                Dequantize.convert(
+                    bytes, from: .bf16, elementCount: count, parallelism: parallelism)
+            }
+        }
+
+        /// Calls `body` with the values in place
+        /// - Precondition: `precision` is `.f32`
+        public func withUnsafeBufferPointer<R>(
+            _ body: (UnsafeBufferPointer<Float>) throws -> R
+        ) rethrows -> R {
+            precondition(precision == .f32, "Cached values are \(precision), not f32")
+            return try bytes.withUnsafeBytes { try body($0.assumingMemoryBound(to: Float.self)) }
+        }
+
+        /// Calls `body` with the 16-bit patterns in place
+        /// - Precondition: `precision` is `.f16` or `.bf16`
+        public func withUnsafeHalfBufferPointer<R>(
+            _ body: (UnsafeBufferPointer<UInt16>) throws -> R
+        ) rethrows -> R {
+            precondition(precision != .f32, "Cached values are f32")
+            return try bytes.withUnsafeBytes { try body($0.assumingMemoryBound(to: UInt16.self)) }
+        }
+    }
+}
+
+extension GGUF {
+    /// Extract tensor data as a Float array, read from `cache` when it holds the tensor and
+    /// dequantized from `fileData` otherwise. Cached tensors are copied (f32) or widened
+    /// (f16, bf16), never decoded, so they carry the cache's precision; `cache.tensor(at:)`
+    /// gives the values without copying.
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - cache: Cache opened for this model
+    ///   - parallelism: How to split the work across threads
+    /// - Returns: Array of Float values
+    /// - Throws: Error if the tensor is not cached and its type is not supported for conversion
+    public func tensorFloatArray(
+        at tensorIndex: Int,
+        from fileData: Data,
+        cache: DequantizedCache,
+        parallelism: Parallelism = .serial
+    ) throws -> [Float] {
+        guard let cached = cache.tensor(at: tensorIndex) else {
+            return try tensorFloatArray(at: tensorIndex, from: fileData, parallelism: parallelism)
+        }
+        return cached.floatArray(parallelism: parallelism)
+    }
+}
+
+/// Creates a new file for writing and returns its descriptor, or -1 with `errno` set. Inside
+/// `DequantizedCache`, `open` names the static method rather than the system call.
+private func createFile(atPath path: String) -> Int32 {
+    open(path, O_WRONLY | O_CREAT | O_EXCL, 0o644)
+}
@@ -10,3 +10,11 @@ extension String {
         self = try String(parsingUTF8: &input, count: lengthInt)
     }
 }
+
+extension [UInt8] {
+    /// Appends a GGUF string: UInt64 length + UTF-8 data (no null terminator)
+    mutating func appendGGUFString(_ string: String) {
+        appendLittleEndian(UInt64(string.utf8.count))
+        append(contentsOf: string.utf8)
+    }
+}
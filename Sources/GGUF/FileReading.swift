@@ -0,0 +1,172 @@
+import BinaryParsing
+import Foundation
+
+#if canImport(Darwin)
+import Darwin
+#elseif canImport(Glibc)
+import Glibc
+#endif
+
+extension GGUF {
+    /// Parses the header, metadata and tensor infos of the file at `path` without mapping it.
+    ///
+    /// The file is read with `pread` from the start, in reads that double from
+    /// `initialReadSize` while the parser runs out of input before `tensorDataOffset`, so the
+    /// cost is bounded by the metadata size rather than the model size: at most twice the
+    /// header region, or `initialReadSize` if that is larger. Tensor data is never mapped;
+    /// only the tail of the last read may reach into it. Fetch payloads afterwards with
+    /// `tensorData(at:fileDescriptor:)`. Any other parse error, such as a bad magic number,
+    /// is thrown as soon as it is found.
+    /// - Parameters:
+    ///   - path: GGUF file to read
+    ///   - metadataDecoding: How metadata arrays are decoded
+    ///   - initialReadSize: Size of the first read; enough for most models' metadata
+    /// - Throws: Error if the file cannot be read or is not a valid GGUF file
+    public init(
+        contentsOfFile path: String,
+        metadataDecoding: MetadataDecoding = .eager,
+        initialReadSize: Int = 1 << 18
+    ) throws {
+        let handle = try FileHandle(forReadingFrom: URL(fileURLWithPath: path))
+        defer { try? handle.close() }
+        try self.init(
+            fileDescriptor: handle.fileDescriptor,
+            metadataDecoding: metadataDecoding,
+            initialReadSize: initialReadSize
+        )
+    }
+
+    /// Parses the header region of an open file with positional reads; see
+    /// `init(contentsOfFile:metadataDecoding:initialReadSize:)`. The descriptor's offset is
+    /// not changed and it is not closed.
+    public init(
+        fileDescriptor: Int32,
+        metadataDecoding: MetadataDecoding = .eager,
+        initialReadSize: Int = 1 << 18
+    ) throws {
+        self = try Self.parsingPrefix(
+            metadataDecoding: metadataDecoding,
+            initialReadSize: initialReadSize
+        ) { buffer, offset in
+            try Self.read(fileDescriptor, into: buffer, at: offset)
+        }
+    }
+
+    /// Position of a tensor's payload in the file
+    public func tensorByteRange(at tensorIndex: Int) -> Range<Int> {
+        tensorInfos.byteRange(at: tensorIndex)
+    }
+
+    /// Reads exactly the payload of one tensor from an open file
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileDescriptor: Descriptor of the file this GGUF was parsed from
+    /// - Returns: Raw bytes of the tensor data
+    /// - Throws: Error if the read fails or the file ends early
+    public func tensorData(at tensorIndex: Int, fileDescriptor: Int32) throws -> Data {
+        var data = Data(count: tensorInfos.sizesInBytes[tensorIndex])
+        try data.withUnsafeMutableBytes { buffer in
+            try readTensorData(at: tensorIndex, fileDescriptor: fileDescriptor, into: buffer)
+        }
+        return data
+    }
+
+    public func tensorData(_ tensorName: String, fileDescriptor: Int32) throws -> Data? {
+        guard let tensorIndex = tensorInfos.index(named: tensorName) else {
+            return nil
+        }
+        return try tensorData(at: tensorIndex, fileDescriptor: fileDescriptor)
+    }
+
+    /// Reads the payload of one tensor into a caller-owned buffer without allocating
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileDescriptor: Descriptor of the file this GGUF was parsed from
+    ///   - output: Destination; must hold exactly `sizeInBytes` bytes
+    /// - Throws: Error if the buffer size does not match, the read fails or the file ends early
+    public func readTensorData(
+        at tensorIndex: Int,
+        fileDescriptor: Int32,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        let range = tensorByteRange(at: tensorIndex)
+        guard output.count == range.count else {
+            throw Error.invalidOutputBufferSize(range.count)
+        }
+        let bytesRead = try Self.read(fileDescriptor, into: output, at: range.lowerBound)
+        guard bytesRead == range.count else {
+            throw Error.unexpectedEndOfFile(
+                expected: range.upperBound,
+                actual: range.lowerBound + bytesRead
+            )
+        }
+    }
+
+    // MARK: - Helpers
+
+    /// Parses the header region from growing reads of a file's start
+    /// - Parameter read: Fills a buffer from a file offset; returns fewer bytes than requested
+    ///   only at the end of the file
+    static func parsingPrefix(
+        metadataDecoding: MetadataDecoding,
+        initialReadSize: Int,
+        read: (UnsafeMutableRawBufferPointer, Int) throws -> Int
+    ) throws -> GGUF {
+        var prefix = Data()
+        var readSize = max(initialReadSize, 64)
+        while true {
+            let start = prefix.count
+            prefix.count = readSize
+            let bytesRead = try prefix.withUnsafeMutableBytes { buffer in
+                try read(UnsafeMutableRawBufferPointer(rebasing: buffer[start...]), start)
+            }
+            prefix.count = start + bytesRead
+            let reachedEndOfFile = prefix.count < readSize
+            do {
+                return try GGUF(parsing: prefix, metadataDecoding: metadataDecoding)
+            } catch where !reachedEndOfFile && isInsufficientData(error) {
+                readSize *= 2
+            }
+        }
+    }
+
+    /// Whether parsing failed only because the input ended early
+    static func isInsufficientData(_ error: any Swift.Error) -> Bool {
+        if let error = error as? ParsingError {
+            return error.status == .insufficientData
+        }
+        if case .insufficientData? = error as? Error {
+            return true
+        }
+        return false
+    }
+
+    /// Fills `buffer` from `offset` with `pread`, retrying short reads; returns fewer bytes
+    /// than requested only at the end of the file
+    static func read(
+        _ fileDescriptor: Int32,
+        into buffer: UnsafeMutableRawBufferPointer,
+        at offset: Int
+    ) throws -> Int {
+        var total = 0
+        while total < buffer.count {
+            let result = pread(
+                fileDescriptor,
+                buffer.baseAddress! + total,
+                buffer.count - total,
+                off_t(offset + total)
+            )
+            if result < 0 {
+                if errno == EINTR {
+                    continue
+                }
+                throw Error.fileReadFailed(errno: errno)
+            }
+            if result == 0 {
+                break
+            }
+            total += result
+        }
+        return total
+    }
+}
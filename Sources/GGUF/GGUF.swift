@@ -5,8 +5,7 @@ import Quants
 public struct GGUF: Sendable {
     public let header: Header
     public let metadata: [MetadataKeyValue]
-    public let tensorInfos: [TensorInfo]
-    public let tensorNameToIndex: [String: Int]
+    public let tensorInfos: TensorTable
     public let metadataKeyToValue: [String: MetadataValue]
     public let tensorDataOffset: Int
     public let alignment: Int
@@ -14,21 +13,58 @@ public struct GGUF: Sendable {
     public init(
         header: Header,
         metadata: [MetadataKeyValue],
-        tensorInfos: [TensorInfo],
-        tensorNameToIndex: [String: Int],
+        tensorInfos: TensorTable,
         metadataKeyToValue: [String: MetadataValue],
         tensorDataOffset: Int,
         alignment: Int
     ) {
+        var tensorInfos = tensorInfos
+        tensorInfos.setDataOffset(tensorDataOffset)
         self.header = header
         self.metadata = metadata
         self.tensorInfos = tensorInfos
-        self.tensorNameToIndex = tensorNameToIndex
         self.metadataKeyToValue = metadataKeyToValue
         self.tensorDataOffset = tensorDataOffset
         self.alignment = alignment
     }
 
+    /// - Precondition: `tensorNameToIndex` maps every tensor's name to its index
+    @available(*, deprecated, message: "Pass a TensorTable, which indexes names itself")
+    public init(
+        header: Header,
+        metadata: [MetadataKeyValue],
+        tensorInfos: [TensorInfo],
+        tensorNameToIndex: [String: Int],
+        metadataKeyToValue: [String: MetadataValue],
+        tensorDataOffset: Int,
+        alignment: Int
+    ) {
+        precondition(
+            tensorNameToIndex.count == tensorInfos.count
+                && tensorNameToIndex.allSatisfy { name, index in
+                    tensorInfos.indices.contains(index) && tensorInfos[index].name == name
+                },
+            "tensorNameToIndex does not match tensorInfos"
+        )
+        self.init(
+            header: header,
+            metadata: metadata,
+            tensorInfos: TensorTable(tensorInfos),
+            metadataKeyToValue: metadataKeyToValue,
+            tensorDataOffset: tensorDataOffset,
+            alignment: alignment
+        )
+    }
+
+    /// Index of every tensor by name, built on each access
+    @available(
+        *, deprecated,
+        message: "Builds a dictionary on every access; use tensorInfos.index(named:)"
+    )
+    public var tensorNameToIndex: [String: Int] {
+        Dictionary(uniqueKeysWithValues: tensorInfos.indices.map { (tensorInfos.name(at: $0), $0) })
+    }
+
     /// Convenience accessor for metadata by key
     public func metadataValue(forKey key: String) -> GGUF.MetadataValue? {
         metadataKeyToValue[key]
@@ -40,19 +76,62 @@ public struct GGUF: Sendable {
     ///   - fileData: The complete GGUF file data
     /// - Returns: Raw bytes of the tensor data
     public func tensorData(at tensorIndex: Int, from fileData: Data) -> Data {
-        let info = tensorInfos[tensorIndex]
-        let startOffset = tensorDataOffset + Int(info.offset)
-        let endOffset = startOffset + info.sizeInBytes
-        return fileData[startOffset..<endOffset]
+        fileData[tensorInfos.byteRange(at: tensorIndex)]
     }
 
     public func tensorData(_ tensorName: String, from fileData: Data) -> Data? {
-        guard let tensorIndex = tensorNameToIndex[tensorName] else {
+        guard let tensorIndex = tensorInfos.index(named: tensorName) else {
             return nil
         }
         return tensorData(at: tensorIndex, from: fileData)
     }
 
+    /// Calls `body` with the values of an F32 tensor read in place, without copying.
+    ///
+    /// The buffer points into `fileData` and is only valid inside `body`. Tensor data is
+    /// aligned within the file, so the values are copied only when `fileData` itself starts
+    /// at an address that is not a multiple of 4.
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - body: Receives the tensor's values
+    /// - Throws: `unsupportedTensorTypeForConversion` if the tensor is not F32, otherwise
+    ///   any error thrown by `body`
+    public func withF32Values<R>(
+        ofTensorAt tensorIndex: Int,
+        from fileData: Data,
+        _ body: (UnsafeBufferPointer<Float>) throws -> R
+    ) throws -> R {
+        let type = tensorInfos.dataTypes[tensorIndex]
+        guard type == .f32 else {
+            throw Error.unsupportedTensorTypeForConversion(type)
+        }
+        let count = Int(tensorInfos.elementCounts[tensorIndex])
+        return try tensorData(at: tensorIndex, from: fileData).withUnsafeBytes { bytes in
+            try Self.withF32Values(in: bytes, count: count, body)
+        }
+    }
+
+    /// Calls `body` with the first `count` f32 values of `bytes`, copying them only when
+    /// `bytes` starts at an address that is not a multiple of 4
+    static func withF32Values<R>(
+        in bytes: UnsafeRawBufferPointer,
+        count: Int,
+        _ body: (UnsafeBufferPointer<Float>) throws -> R
+    ) rethrows -> R {
+        let bytes = UnsafeRawBufferPointer(rebasing: bytes[..<(count * 4)])
+        guard let base = bytes.baseAddress,
+            Int(bitPattern: base) % MemoryLayout<Float>.alignment != 0
+        else {
+            return try body(bytes.assumingMemoryBound(to: Float.self))
+        }
+        let copy = [Float](unsafeUninitializedCapacity: count) { buffer, initializedCount in
+            UnsafeMutableRawBufferPointer(buffer).copyMemory(from: bytes)
+            initializedCount = count
+        }
+        return try copy.withUnsafeBufferPointer(body)
+    }
+
     /// Extract tensor data as a Float array, dequantizing if necessary
     /// - Parameters:
     ///   - tensorIndex: Index of the tensor in tensorInfos array
@@ -60,67 +139,353 @@ public struct GGUF: Sendable {
     /// - Returns: Array of Float values
     /// - Throws: Error if the tensor type is not supported for conversion
     public func tensorFloatArray(at tensorIndex: Int, from fileData: Data) throws -> [Float] {
-        let info = tensorInfos[tensorIndex]
-        let data = tensorData(at: tensorIndex, from: fileData)
-        let elementCount = Int(info.elementCount)
-
-        switch info.dataType {
-        case .f64:
-            return data.toArray(of: Double.self, Float.init)
-        case .f32:
-            return data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-                let inputBuffer = ptr.assumingMemoryBound(to: Float.self)
-                return Array(inputBuffer)
+        try tensorFloatArray(at: tensorIndex, from: fileData, parallelism: .serial)
+    }
+
+    /// Extract tensor data as a Float array, dequantizing quantized tensors in parallel
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - parallelism: How to split dequantization across threads; the output is identical
+    ///     to the serial path
+    /// - Returns: Array of Float values
+    /// - Throws: Error if the tensor type is not supported for conversion
+    public func tensorFloatArray(
+        at tensorIndex: Int,
+        from fileData: Data,
+        parallelism: Parallelism
+    ) throws -> [Float] {
+        let profiler = LoadProfiler.current
+        let mark = profiler?.mark()
+        let elementCount = Int(tensorInfos.elementCounts[tensorIndex])
+        let values = try [Float](unsafeUninitializedCapacity: elementCount) {
+            buffer, initializedCount in
+            try dequantizeTensor(
+                at: tensorIndex,
+                from: fileData,
+                into: UnsafeMutableBufferPointer(rebasing: buffer[..<elementCount]),
+                parallelism: parallelism
+            )
+            initializedCount = elementCount
+        }
+        if let profiler, let mark {
+            profiler.recordTensorLoad(
+                since: mark, index: tensorIndex, name: tensorInfos.name(at: tensorIndex),
+                type: tensorInfos.dataTypes[tensorIndex], elementCount: elementCount,
+                bytesIn: tensorInfos.sizesInBytes[tensorIndex])
+        }
+        return values
+    }
+
+    /// Dequantize a whole tensor into a caller-owned buffer without allocating
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - output: Destination buffer; must hold exactly `elementCount` values
+    ///   - parallelism: How to split dequantization across threads
+    /// - Throws: Error if the tensor type is not supported for conversion or the buffer size
+    ///   does not match
+    public func dequantizeTensor(
+        at tensorIndex: Int,
+        from fileData: Data,
+        into output: UnsafeMutableBufferPointer<Float>,
+        parallelism: Parallelism = .serial
+    ) throws {
+        let elementCount = Int(tensorInfos.elementCounts[tensorIndex])
+        guard output.count == elementCount else {
+            throw Error.invalidOutputBufferSize(elementCount)
+        }
+        try Self.convert(
+            tensorData(at: tensorIndex, from: fileData),
+            type: tensorInfos.dataTypes[tensorIndex],
+            into: output,
+            parallelism: parallelism
+        )
+    }
+
+    /// Dequantize a range of rows into a caller-owned buffer, touching only the blocks of
+    /// those rows. A row spans the first (innermost) dimension, e.g. one token embedding.
+    /// - Parameters:
+    ///   - rows: Rows to decode, in `0..<rowCount`
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - output: Destination buffer; must hold exactly `rows.count * rowLength` values
+    ///   - parallelism: How to split dequantization across threads
+    /// - Throws: Error if the range is out of bounds, rows do not start on block boundaries,
+    ///   the tensor type is not supported for conversion or the buffer size does not match
+    public func dequantizeRows(
+        _ rows: Range<Int>,
+        ofTensorAt tensorIndex: Int,
+        from fileData: Data,
+        into output: UnsafeMutableBufferPointer<Float>,
+        parallelism: Parallelism = .serial
+    ) throws {
+        let dataType = tensorInfos.dataTypes[tensorIndex]
+        let rowLength = tensorInfos.rowLength(at: tensorIndex)
+        guard rowLength % dataType.blockSize == 0 else {
+            throw Error.unalignedTensorRows(tensorInfos.name(at: tensorIndex))
+        }
+        guard rows.lowerBound >= 0, rows.upperBound <= tensorInfos.rowCount(at: tensorIndex) else {
+            throw Error.invalidRowRange(rows)
+        }
+        guard output.count == rows.count * rowLength else {
+            throw Error.invalidOutputBufferSize(rows.count * rowLength)
+        }
+        let rowSizeInBytes = dataType.sizeInBytes(elementCount: UInt64(rowLength))
+        let startOffset =
+            tensorInfos.byteRange(at: tensorIndex).lowerBound + rows.lowerBound * rowSizeInBytes
+        let endOffset = startOffset + rows.count * rowSizeInBytes
+        try Self.convert(
+            fileData[startOffset..<endOffset],
+            type: dataType,
+            into: output,
+            parallelism: parallelism
+        )
+    }
+
+    /// Extract a range of rows as a Float array, dequantizing only the blocks they cover
+    /// - Parameters:
+    ///   - rows: Rows to decode, in `0..<rowCount`
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    /// - Returns: Array of `rows.count * rowLength` Float values
+    /// - Throws: Error if the range is invalid or the tensor type is not supported
+    public func tensorRowsFloatArray(
+        _ rows: Range<Int>,
+        ofTensorAt tensorIndex: Int,
+        from fileData: Data
+    ) throws -> [Float] {
+        let elementCount = rows.count * tensorInfos.rowLength(at: tensorIndex)
+        return try [Float](unsafeUninitializedCapacity: elementCount) { buffer, initializedCount in
+            try dequantizeRows(
+                rows,
+                ofTensorAt: tensorIndex,
+                from: fileData,
+                into: UnsafeMutableBufferPointer(rebasing: buffer[..<elementCount])
+            )
+            initializedCount = elementCount
+        }
+    }
+
+    /// Multiply a block-quantized 2D tensor by a vector straight from the file data, without
+    /// dequantizing the weights. Each row of the tensor produces one output value.
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - vector: Activations; must hold exactly `rowLength` values
+    ///   - fileData: The complete GGUF file data
+    ///   - activations: Whether to dot against f32 or 8-bit quantized activations
+    ///   - parallelism: How to split the rows across threads
+    /// - Returns: Array of `rowCount` Float values
+    /// - Throws: Error if the tensor is not block-quantized, its rows do not start on block
+    ///   boundaries or the vector length does not match
+    public func multiply(
+        tensorAt tensorIndex: Int,
+        by vector: [Float],
+        from fileData: Data,
+        activations: ActivationPrecision = .f32,
+        parallelism: Parallelism = .serial
+    ) throws -> [Float] {
+        let dataType = tensorInfos.dataTypes[tensorIndex]
+        let rowLength = tensorInfos.rowLength(at: tensorIndex)
+        guard let format = dataType.blockFormat else {
+            throw Error.unsupportedTensorTypeForConversion(dataType)
+        }
+        guard rowLength % format.blockSize == 0 else {
+            throw Error.unalignedTensorRows(tensorInfos.name(at: tensorIndex))
+        }
+        guard vector.count == rowLength else {
+            throw Error.invalidVectorLength(rowLength)
+        }
+        return MatVec.multiply(
+            tensorData(at: tensorIndex, from: fileData),
+            format: format,
+            rows: tensorInfos.rowCount(at: tensorIndex),
+            by: vector,
+            activations: activations,
+            parallelism: parallelism
+        )
+    }
+
+    /// Extract tensor data as 16-bit floats, dequantizing straight to the half encoding
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - half: Encoding of the output
+    ///   - parallelism: How to split dequantization across threads
+    /// - Returns: Bit patterns of the values, rounded to nearest even
+    /// - Throws: Error if the tensor type is not supported for conversion
+    public func tensorHalfArray(
+        at tensorIndex: Int,
+        from fileData: Data,
+        as half: HalfFormat,
+        parallelism: Parallelism = .serial
+    ) throws -> [UInt16] {
+        let elementCount = Int(tensorInfos.elementCounts[tensorIndex])
+        return try [UInt16](unsafeUninitializedCapacity: elementCount) {
+            buffer, initializedCount in
+            try dequantizeTensor(
+                at: tensorIndex,
+                from: fileData,
+                into: UnsafeMutableBufferPointer(rebasing: buffer[..<elementCount]),
+                as: half,
+                parallelism: parallelism
+            )
+            initializedCount = elementCount
+        }
+    }
+
+    public func tensorHalfArray(
+        _ tensorName: String,
+        from fileData: Data,
+        as half: HalfFormat,
+        parallelism: Parallelism = .serial
+    ) throws -> [UInt16]? {
+        guard let tensorIndex = tensorInfos.index(named: tensorName) else {
+            return nil
+        }
+        return try tensorHalfArray(
+            at: tensorIndex, from: fileData, as: half, parallelism: parallelism)
+    }
+
+    /// Tensor bytes in the given 16-bit encoding. A tensor already stored in that encoding is
+    /// returned as a slice of `fileData` without copying.
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - half: Encoding of the output
+    ///   - parallelism: How to split dequantization across threads
+    /// - Returns: `elementCount * 2` bytes of little-endian 16-bit floats
+    /// - Throws: Error if the tensor type is not supported for conversion
+    public func tensorHalfData(
+        at tensorIndex: Int,
+        from fileData: Data,
+        as half: HalfFormat,
+        parallelism: Parallelism = .serial
+    ) throws -> Data {
+        if tensorInfos.dataTypes[tensorIndex].halfFormat == half {
+            return tensorData(at: tensorIndex, from: fileData)
+        }
+        var data = Data(count: Int(tensorInfos.elementCounts[tensorIndex]) * 2)
+        try data.withUnsafeMutableBytes { bytes in
+            try dequantizeTensor(
+                at: tensorIndex,
+                from: fileData,
+                into: bytes.bindMemory(to: UInt16.self),
+                as: half,
+                parallelism: parallelism
+            )
+        }
+        return data
+    }
+
+    /// Dequantize a whole tensor to 16-bit floats in a caller-owned buffer
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - output: Destination buffer; must hold exactly `elementCount` values
+    ///   - half: Encoding of the output
+    ///   - parallelism: How to split dequantization across threads
+    /// - Throws: Error if the tensor type is not supported for conversion or the buffer size
+    ///   does not match
+    public func dequantizeTensor(
+        at tensorIndex: Int,
+        from fileData: Data,
+        into output: UnsafeMutableBufferPointer<UInt16>,
+        as half: HalfFormat,
+        parallelism: Parallelism = .serial
+    ) throws {
+        let elementCount = Int(tensorInfos.elementCounts[tensorIndex])
+        guard output.count == elementCount else {
+            throw Error.invalidOutputBufferSize(elementCount)
+        }
+        try Self.convert(
+            tensorData(at: tensorIndex, from: fileData),
+            type: tensorInfos.dataTypes[tensorIndex],
+            into: output,
+            as: half,
+            parallelism: parallelism
+        )
+    }
+
+    /// Converts raw tensor bytes of the given type into 16-bit floats
+    private static func convert(
+        _ data: Data,
+        type: TensorType,
+        into output: UnsafeMutableBufferPointer<UInt16>,
+        as half: HalfFormat,
+        parallelism: Parallelism
+    ) throws {
+        try data.withUnsafeBytes { (input: UnsafeRawBufferPointer) in
+            if let source = type.halfFormat {
+                Dequantize.convert(
+                    input, from: source, into: output, as: half, parallelism: parallelism)
+            } else if type == .f32 {
+                withF32Values(in: input, count: output.count) { values in
+                    Dequantize.narrow(values, into: output, as: half, parallelism: parallelism)
+                }
+            } else if let format = type.blockFormat {
+                Dequantize.dequantize(
+                    input, into: output, format: format, as: half, parallelism: parallelism)
+            } else {
+                // No direct kernel (f64 and integer tensors): widen to f32 first
+                let values = try [Float](unsafeUninitializedCapacity: output.count) {
+                    buffer, initializedCount in
+                    try convert(
+                        data,
+                        type: type,
+                        into: UnsafeMutableBufferPointer(rebasing: buffer[..<output.count]),
+                        parallelism: parallelism
+                    )
+                    initializedCount = output.count
+                }
+                values.withUnsafeBufferPointer { values in
+                    Dequantize.narrow(values, into: output, as: half, parallelism: parallelism)
+                }
+            }
+        }
+    }
+
+    /// Converts raw tensor bytes of the given type into `output`
+    static func convert(
+        _ data: Data,
+        type: TensorType,
+        into output: UnsafeMutableBufferPointer<Float>,
+        parallelism: Parallelism
+    ) throws {
+        try data.withUnsafeBytes { (input: UnsafeRawBufferPointer) in
+            if type == .f32 {
+                UnsafeMutableRawBufferPointer(output).copyMemory(
+                    from: UnsafeRawBufferPointer(rebasing: input[..<(output.count * 4)]))
+            } else if let source = type.elementFormat {
+                Dequantize.convert(input, from: source, into: output, parallelism: parallelism)
+            } else if let format = type.blockFormat {
+                Dequantize.dequantize(input, into: output, format: format, parallelism: parallelism)
+            } else {
+                throw Error.unsupportedTensorTypeForConversion(type)
             }
-        case .f16:
-            return data.toArray(of: Float16.self, Float.init)
-        case .i8:
-            return data.toArray(of: Int8.self, Float.init)
-        case .i16:
-            return data.toArray(of: Int16.self, Float.init)
-        case .i32:
-            return data.toArray(of: Int32.self, Float.init)
-        case .i64:
-            return data.toArray(of: Int64.self, Float.init)
-        case .q4_0:
-            return Dequantize.Q4_0(data, elementCount: elementCount)
-        case .q4_1:
-            return Dequantize.Q4_1(data, elementCount: elementCount)
-        case .q5_0:
-            return Dequantize.Q5_0(data, elementCount: elementCount)
-        case .q5_1:
-            return Dequantize.Q5_1(data, elementCount: elementCount)
-        case .q8_0:
-            return Dequantize.Q8_0(data, elementCount: elementCount)
-        case .q2_K:
-            return Dequantize.Q2_K(data, elementCount: elementCount)
-        case .q3_K:
-            return Dequantize.Q3_K(data, elementCount: elementCount)
-        case .q4_K:
-            return Dequantize.Q4_K(data, elementCount: elementCount)
-        case .q5_K:
-            return Dequantize.Q5_K(data, elementCount: elementCount)
-        case .q6_K:
-            return Dequantize.Q6_K(data, elementCount: elementCount)
-        case .q8_K:
-            return Dequantize.Q8_K(data, elementCount: elementCount)
-        case .iq4_NL:
-            return Dequantize.IQ4_NL(data, elementCount: elementCount)
-        case .q8_1, .bf16, .iq2_XXS, .iq2_XS, .iq3_XXS, .iq1_S, .iq3_S, .iq2_S, .iq4_XS,
-            .iq1_M, .tq1_0, .tq2_0, .mxfp4:
-            throw Error.unsupportedTensorTypeForConversion(info.dataType)
         }
     }
 
     public func tensorFloatArray(_ tensorName: String, from fileData: Data) throws -> [Float]? {
-        guard let tensorIndex = tensorNameToIndex[tensorName] else {
+        guard let tensorIndex = tensorInfos.index(named: tensorName) else {
             return nil
         }
         return try tensorFloatArray(at: tensorIndex, from: fileData)
     }
 
+    public func tensorFloatArray(
+        _ tensorName: String,
+        from fileData: Data,
+        parallelism: Parallelism
+    ) throws -> [Float]? {
+        guard let tensorIndex = tensorInfos.index(named: tensorName) else {
+            return nil
+        }
+        return try tensorFloatArray(at: tensorIndex, from: fileData, parallelism: parallelism)
+    }
+
     /// Extract alignment from metadata (general.alignment key)
-    private static func extractAlignment(from metadataKeyToValue: [String: MetadataValue]) -> Int {
+    static func extractAlignment(from metadataKeyToValue: [String: MetadataValue]) -> Int {
         switch metadataKeyToValue["general.alignment"] {
         case .uint32(let alignment):
             return Int(alignment)
@@ -132,20 +497,46 @@ public struct GGUF: Sendable {
 
 extension GGUF: ExpressibleByParsing {
     public init(parsing input: inout ParserSpan) throws {
+        try self.init(parsing: &input, decoding: .eager, source: nil)
+    }
+
+    /// Parses `data`, choosing how metadata arrays are decoded. With `.lazy`, arrays such as
+    /// `tokenizer.ggml.tokens` keep referencing `data` (zero-copy, also for mapped files) and
+    /// decode elements on access. With `.packedNumericArrays`, numeric arrays such as
+    /// `tokenizer.ggml.scores` are copied packed while strings are decoded as usual.
+    public init(parsing data: Data, metadataDecoding: MetadataDecoding) throws {
+        switch metadataDecoding {
+        case .eager:
+            try self.init(parsing: data)
+        case .lazy, .packedNumericArrays:
+            self = try data.withParserSpan { span in
+                try GGUF(parsing: &span, decoding: metadataDecoding, source: data)
+            }
+        }
+    }
+
+    private init(
+        parsing input: inout ParserSpan,
+        decoding: MetadataDecoding,
+        source: Data?
+    ) throws {
+        let profiler = LoadProfiler.current
+        let start = profiler?.now()
         let startCount = input.count
         let header = try Header(parsing: &input)
+        let headerEnd = profiler?.now()
         guard let metadataCount = Int(exactly: header.metadataKeyValueCount) else {
             throw Error.invalidMetadataCount(header.metadataKeyValueCount)
         }
         let metadata = try Array(parsing: &input, count: metadataCount) { span in
-            try MetadataKeyValue(parsing: &span)
+            try MetadataKeyValue(parsing: &span, decoding: decoding, source: source)
         }
         guard let tensorCount = Int(exactly: header.tensorCount) else {
             throw Error.invalidTensorCount(header.tensorCount)
         }
-        let tensorInfos = try Array(parsing: &input, count: tensorCount) { span in
-            try TensorInfo(parsing: &span)
-        }
+        let metadataEnd = profiler?.now()
+        let tensorInfos = try TensorTable(parsing: &input, count: tensorCount)
+        let tensorInfosEnd = profiler?.now()
         let metadataKeyToValue = Dictionary(
             uniqueKeysWithValues: metadata.map { ($0.key, $0.value) })
         let alignment = Self.extractAlignment(from: metadataKeyToValue)
@@ -165,12 +556,16 @@ extension GGUF: ExpressibleByParsing {
         } else {
             alignedOffset = currentOffset
         }
+        if let profiler, let start, let headerEnd, let metadataEnd, let tensorInfosEnd {
+            profiler.recordParse(
+                start: start, headerEnd: headerEnd, metadataEnd: metadataEnd,
+                tensorInfosEnd: tensorInfosEnd, end: .now, metadataCount: metadataCount,
+                tensorCount: tensorCount)
+        }
         self.init(
             header: header,
             metadata: metadata,
             tensorInfos: tensorInfos,
-            tensorNameToIndex: Dictionary(
-                uniqueKeysWithValues: tensorInfos.enumerated().map { ($0.element.name, $0.offset) }),
             metadataKeyToValue: metadataKeyToValue,
             tensorDataOffset: alignedOffset,
             alignment: alignment
@@ -36,3 +36,13 @@ extension GGUF.Header: ExpressibleByParsing {
         self.metadataKeyValueCount = try UInt64(parsingLittleEndian: &input)
     }
 }
+
+extension GGUF.Header {
+    /// Appends the 24-byte header in the layout `init(parsing:)` reads
+    func serialize(into output: inout [UInt8]) {
+        output.appendBigEndian(magic)
+        output.appendLittleEndian(version)
+        output.appendLittleEndian(tensorCount)
+        output.appendLittleEndian(metadataKeyValueCount)
+    }
+}
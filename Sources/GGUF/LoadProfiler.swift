@@ -0,0 +1,394 @@
+import Foundation
+import Synchronization
+
+#if canImport(Darwin)
+import Darwin
+#elseif canImport(Glibc)
+import Glibc
+#endif
+
+extension GGUF {
+    /// Opt-in timings of `init(parsing:)` and `tensorFloatArray` calls.
+    ///
+    /// While a profiler is started, every parse records the time spent in the header,
+    /// metadata, tensor infos and alignment padding, and every `tensorFloatArray` call
+    /// records its tensor, byte counts, wall time and page faults. Loads are also summed
+    /// per tensor type. Results export as a JSON summary or as Chrome trace events for
+    /// `chrome://tracing` and Perfetto.
+    ///
+    /// Only one profiler is active at a time and it sees calls from every thread. When none
+    /// is active the hooks cost one atomic load.
+    public final class LoadProfiler: Sendable {
+        /// Phases of one `init(parsing:)` call
+        public struct ParseTiming: Sendable, Hashable {
+            /// Start of the parse, relative to the profiler's start
+            public let start: Duration
+            public let header: Duration
+            /// Key-value pairs, including eager array decoding
+            public let metadata: Duration
+            public let tensorInfos: Duration
+            /// Alignment lookup and padding check
+            public let padding: Duration
+            public let metadataCount: Int
+            public let tensorCount: Int
+            let thread: Int
+
+            public var total: Duration {
+                header + metadata + tensorInfos + padding
+            }
+        }
+
+        /// One `tensorFloatArray` call
+        public struct TensorLoad: Sendable, Hashable {
+            /// Index of the tensor in tensorInfos array
+            public let index: Int
+            public let name: String
+            public let type: TensorType
+            public let elementCount: Int
+            /// Encoded payload bytes read
+            public let bytesIn: Int
+            /// Float bytes written
+            public let bytesOut: Int
+            /// Start of the call, relative to the profiler's start
+            public let start: Duration
+            public let duration: Duration
+            /// Minor and major page faults of the whole process during the call
+            public let pageFaults: Int
+            let thread: Int
+        }
+
+        /// Totals of the loads of one tensor type
+        public struct TypeCounters: Sendable, Hashable {
+            public var loads = 0
+            public var elements = 0
+            public var bytesIn = 0
+            public var bytesOut = 0
+            public var duration = Duration.zero
+            public var pageFaults = 0
+        }
+
+        private struct State {
+            var parses: [ParseTiming] = []
+            var tensorLoads: [TensorLoad] = []
+            var countersByType: [TensorType: TypeCounters] = [:]
+            /// Small trace ids for the threads seen so far
+            var threads: [UInt: Int] = [:]
+
+            mutating func traceThread(_ thread: UInt) -> Int {
+                if let id = threads[thread] {
+                    return id
+                }
+                threads[thread] = threads.count + 1
+                return threads.count
+            }
+        }
+
+        private let origin = ContinuousClock.now
+        private let state = Mutex(State())
+
+        public init() {}
+
+        /// Makes this the active profiler, replacing any other
+        public func start() {
+            Self.active.withLock { $0 = self }
+            Self.isActive.store(true, ordering: .releasing)
+        }
+
+        /// Stops recording if this is the active profiler
+        public func stop() {
+            Self.active.withLock { active in
+                guard active === self else {
+                    return
+                }
+                active = nil
+                Self.isActive.store(false, ordering: .releasing)
+            }
+        }
+
+        /// Runs `body` with this profiler active
+        public func profile<R>(_ body: () throws -> R) rethrows -> R {
+            start()
+            defer { stop() }
+            return try body()
+        }
+
+        public var parses: [ParseTiming] {
+            state.withLock { $0.parses }
+        }
+
+        public var tensorLoads: [TensorLoad] {
+            state.withLock { $0.tensorLoads }
+        }
+
+        public var countersByType: [TensorType: TypeCounters] {
+            state.withLock { $0.countersByType }
+        }
+
+        /// Drops everything recorded so far
+        public func reset() {
+            state.withLock { $0 = State() }
+        }
+
+        /// Summary with every parse, per-type totals and every load, times in microseconds
+        public func jsonReport() throws -> Data {
+            let state = state.withLock { $0 }
+            let report = Report(
+                parses: state.parses.map(Report.Parse.init),
+                types: state.countersByType
+                    .sorted { $0.key.rawValue < $1.key.rawValue }
+                    .map(Report.TypeTotals.init),
+                tensorLoads: state.tensorLoads.map(Report.Load.init)
+            )
+            let encoder = JSONEncoder()
+            encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+            return try encoder.encode(report)
+        }
+
+        /// Chrome trace-event JSON: one complete event per parse phase and per load
+        public func traceEvents() throws -> Data {
+            let state = state.withLock { $0 }
+            var events = [TraceEvent]()
+            for parse in state.parses {
+                var start = parse.start
+                events.append(
+                    TraceEvent(
+                        name: "parse", category: "parse", start: start, duration: parse.total,
+                        thread: parse.thread,
+                        arguments: [
+                            "metadataCount": "\(parse.metadataCount)",
+                            "tensorCount": "\(parse.tensorCount)",
+                        ]))
+                let phases = [
+                    ("header", parse.header), ("metadata", parse.metadata),
+                    ("tensorInfos", parse.tensorInfos), ("padding", parse.padding),
+                ]
+                for (name, duration) in phases {
+                    events.append(
+                        TraceEvent(
+                            name: name, category: "parse", start: start, duration: duration,
+                            thread: parse.thread, arguments: [:]))
+                    start += duration
+                }
+            }
+            for load in state.tensorLoads {
+                events.append(
+                    TraceEvent(
+                        name: load.name, category: "\(load.type)", start: load.start,
+                        duration: load.duration, thread: load.thread,
+                        arguments: [
+                            "elements": "\(load.elementCount)",
+                            "bytesIn": "\(load.bytesIn)",
+                            "bytesOut": "\(load.bytesOut)",
+                            "pageFaults": "\(load.pageFaults)",
+                        ]))
+            }
+            let encoder = JSONEncoder()
+            encoder.outputFormatting = .sortedKeys
+            return try encoder.encode(["traceEvents": events])
+        }
+
+        // MARK: - Hooks
+
+        private static let isActive = Atomic<Bool>(false)
+        private static let active = Mutex<LoadProfiler?>(nil)
+
+        /// The active profiler, or nil when profiling is off
+        static var current: LoadProfiler? {
+            guard isActive.load(ordering: .acquiring) else {
+                return nil
+            }
+            return active.withLock { $0 }
+        }
+
+        /// Clock reading and fault count at the start of a measured call
+        struct Mark {
+            let instant: ContinuousClock.Instant
+            let pageFaults: Int
+        }
+
+        func now() -> ContinuousClock.Instant {
+            .now
+        }
+
+        func mark() -> Mark {
+            Mark(instant: .now, pageFaults: Self.pageFaults())
+        }
+
+        /// Records a parse from the instants at which each phase ended
+        func recordParse(
+            start: ContinuousClock.Instant,
+            headerEnd: ContinuousClock.Instant,
+            metadataEnd: ContinuousClock.Instant,
+            tensorInfosEnd: ContinuousClock.Instant,
+            end: ContinuousClock.Instant,
+            metadataCount: Int,
+            tensorCount: Int
+        ) {
+            let thread = Self.threadID()
+            state.withLock { state in
+                state.parses.append(
+                    ParseTiming(
+                        start: start - origin,
+                        header: headerEnd - start,
+                        metadata: metadataEnd - headerEnd,
+                        tensorInfos: tensorInfosEnd - metadataEnd,
+                        padding: end - tensorInfosEnd,
+                        metadataCount: metadataCount,
+                        tensorCount: tensorCount,
+                        thread: state.traceThread(thread)))
+            }
+        }
+
+        /// Records a `tensorFloatArray` call that began at `mark`
+        func recordTensorLoad(
+            since mark: Mark, index: Int, name: String, type: TensorType, elementCount: Int,
+            bytesIn: Int
+        ) {
+            let duration = ContinuousClock.now - mark.instant
+            let pageFaults = Self.pageFaults() - mark.pageFaults
+            let thread = Self.threadID()
+            state.withLock { state in
+                let load = TensorLoad(
+                    index: index, name: name, type: type, elementCount: elementCount,
+                    bytesIn: bytesIn, bytesOut: elementCount * MemoryLayout<Float>.size,
+                    start: mark.instant - origin, duration: duration, pageFaults: pageFaults,
+                    thread: state.traceThread(thread))
+                state.tensorLoads.append(load)
+                state.countersByType[type, default: TypeCounters()].add(load)
+            }
+        }
+
+        private static func pageFaults() -> Int {
+            var usage = rusage()
+            guard getrusage(RUSAGE_SELF, &usage) == 0 else {
+                return 0
+            }
+            return Int(usage.ru_minflt) + Int(usage.ru_majflt)
+        }
+
+        private static func threadID() -> UInt {
+            #if canImport(Darwin)
+            UInt(bitPattern: pthread_self())
+            #else
+            UInt(pthread_self())
+            #endif
+        }
+    }
+}
+
+extension GGUF.LoadProfiler.TypeCounters {
+    fileprivate mutating func add(_ load: GGUF.LoadProfiler.TensorLoad) {
+        loads += 1
+        elements += load.elementCount
+        bytesIn += load.bytesIn
+        bytesOut += load.bytesOut
+        duration += load.duration
+        pageFaults += load.pageFaults
+    }
+}
+
+// MARK: - Report encoding
+
+extension Duration {
+    fileprivate var microseconds: Double {
+        Double(components.seconds) * 1e6 + Double(components.attoseconds) * 1e-12
+    }
+}
+
+private struct Report: Encodable {
+    struct Parse: Encodable {
+        let startMicroseconds: Double
+        let headerMicroseconds: Double
+        let metadataMicroseconds: Double
+        let tensorInfosMicroseconds: Double
+        let paddingMicroseconds: Double
+        let totalMicroseconds: Double
+        let metadataCount: Int
+        let tensorCount: Int
+
+        init(_ parse: GGUF.LoadProfiler.ParseTiming) {
+            startMicroseconds = parse.start.microseconds
+            headerMicroseconds = parse.header.microseconds
+            metadataMicroseconds = parse.metadata.microseconds
+            tensorInfosMicroseconds = parse.tensorInfos.microseconds
+            paddingMicroseconds = parse.padding.microseconds
+            totalMicroseconds = parse.total.microseconds
+            metadataCount = parse.metadataCount
+            tensorCount = parse.tensorCount
+        }
+    }
+
+    struct TypeTotals: Encodable {
+        let type: String
+        let loads: Int
+        let elements: Int
+        let bytesIn: Int
+        let bytesOut: Int
+        let microseconds: Double
+        let pageFaults: Int
+
+        init(_ entry: (key: GGUF.TensorType, value: GGUF.LoadProfiler.TypeCounters)) {
+            type = "\(entry.key)"
+            loads = entry.value.loads
+            elements = entry.value.elements
+            bytesIn = entry.value.bytesIn
+            bytesOut = entry.value.bytesOut
+            microseconds = entry.value.duration.microseconds
+            pageFaults = entry.value.pageFaults
+        }
+    }
+
+    struct Load: Encodable {
+        let index: Int
+        let name: String
+        let type: String
+        let elements: Int
+        let bytesIn: Int
+        let bytesOut: Int
+        let startMicroseconds: Double
+        let microseconds: Double
+        let pageFaults: Int
+
+        init(_ load: GGUF.LoadProfiler.TensorLoad) {
+            index = load.index
+            name = load.name
+            type = "\(load.type)"
+            elements = load.elementCount
+            bytesIn = load.bytesIn
+            bytesOut = load.bytesOut
+            startMicroseconds = load.start.microseconds
+            microseconds = load.duration.microseconds
+            pageFaults = load.pageFaults
+        }
+    }
+
+    let parses: [Parse]
+    let types: [TypeTotals]
+    let tensorLoads: [Load]
+}
+
+/// Complete ("X") event of the Chrome trace-event format
+private struct TraceEvent: Encodable {
+    let name: String
+    let category: String
+    let start: Duration
+    let duration: Duration
+    let thread: Int
+    let arguments: [String: String]
+
+    enum CodingKeys: String, CodingKey {
+        case name, cat, ph, ts, dur, pid, tid, args
+    }
+
+    func encode(to encoder: any Encoder) throws {
+        var container = encoder.container(keyedBy: CodingKeys.self)
+        try container.encode(name, forKey: .name)
+        try container.encode(category, forKey: .cat)
+        try container.encode("X", forKey: .ph)
+        try container.encode(start.microseconds, forKey: .ts)
+        try container.encode(duration.microseconds, forKey: .dur)
+        try container.encode(1, forKey: .pid)
+        try container.encode(thread, forKey: .tid)
+        try container.encode(arguments, forKey: .args)
+    }
+}
@@ -0,0 +1,319 @@
+import Foundation
+
+extension GGUF {
+    /// How `GGUF(parsing:metadataDecoding:)` decodes metadata arrays
+    public enum MetadataDecoding: Sendable {
+        /// Every array element becomes a `MetadataValue` while parsing
+        case eager
+        /// Arrays stay in their encoded form inside the file data and decode elements on
+        /// access; scalars are still decoded up front
+        case lazy
+        /// Arrays of fixed-width values, such as `tokenizer.ggml.scores`, are copied out of the
+        /// file data in their encoded form with one copy each and read through
+        /// `arrayValues(as:)`. String and nested arrays are decoded as with `.eager`, so the
+        /// result does not keep the file data alive.
+        case packedNumericArrays
+    }
+
+    /// A metadata array kept in its encoded on-disk form. Elements are decoded on access from
+    /// a slice of the file data, so a 256k-entry tokenizer vocabulary costs one offset table
+    /// instead of 256k `String` allocations.
+    public struct MetadataArray: Sendable, Hashable, RandomAccessCollection {
+        /// Type of every element
+        public let elementType: ValueType
+        /// Number of elements
+        public let count: Int
+        /// Encoded elements, without the type and count prefix
+        public let bytes: Data
+        /// Start of each element in `bytes`; empty when elements have a fixed width
+        private let elementOffsets: [Int]
+
+        public var startIndex: Int { 0 }
+        public var endIndex: Int { count }
+
+        public subscript(position: Int) -> MetadataValue {
+            precondition(position >= 0 && position < count, "Index out of range")
+            let offset =
+                elementOffsets.isEmpty
+                ? position * elementType.fixedWidth! : elementOffsets[position]
+            if elementType == .array {
+                // Nested arrays stay lazy, viewing a slice of the same bytes
+                let (rawType, nestedCount) = bytes.withUnsafeBytes { raw in
+                    (
+                        raw.loadLittleEndian(fromByteOffset: offset, as: UInt32.self),
+                        Int(raw.loadLittleEndian(fromByteOffset: offset + 4, as: UInt64.self))
+                    )
+                }
+                // Validated together with the enclosing array
+                return .lazyArray(
+                    try! MetadataArray(
+                        elementType: ValueType(rawValue: rawType)!,
+                        count: nestedCount,
+                        encodedIn: bytes.dropFirst(offset + 12)
+                    ))
+            }
+            return bytes.withUnsafeBytes { raw in
+                Self.decodeScalar(elementType, at: offset, in: raw)
+            }
+        }
+
+        /// Elements as a typed Swift array, or nil if `T` does not match `elementType`.
+        /// Elements are stored little-endian, so on little-endian hosts this is one bulk copy.
+        public func values<T: MetadataScalar>(as type: T.Type = T.self) -> [T]? {
+            guard elementType == T.metadataValueType else {
+                return nil
+            }
+            #if _endian(little)
+            return [T](unsafeUninitializedCapacity: count) { buffer, initializedCount in
+                bytes.withUnsafeBytes { raw in
+                    UnsafeMutableRawBufferPointer(buffer).copyMemory(from: raw)
+                }
+                initializedCount = count
+            }
+            #else
+            return map { T(metadataValue: $0)! }
+            #endif
+        }
+
+        /// Validates `count` encoded elements at the start of `data` and keeps a slice of them.
+        /// Strings are checked for valid UTF-8 here, so a file that eager parsing rejects is
+        /// rejected lazily too.
+        /// - Throws: Error if the elements run past the end of `data` or a string is not valid
+        ///   UTF-8
+        init(elementType: ValueType, count: Int, encodedIn data: Data) throws {
+            var offsets: [Int] = []
+            let byteCount = try data.withUnsafeBytes { raw in
+                if let width = elementType.fixedWidth {
+                    let (size, overflow) = count.multipliedReportingOverflow(by: width)
+                    guard !overflow else {
+                        throw Error.invalidArrayLength(UInt64(count))
+                    }
+                    guard size <= raw.count else {
+                        throw Error.insufficientData
+                    }
+                    return size
+                }
+                offsets.reserveCapacity(count)
+                var offset = 0
+                for _ in 0..<count {
+                    offsets.append(offset)
+                    offset += try Self.encodedSize(of: elementType, at: offset, in: raw)
+                }
+                return offset
+            }
+            self.elementType = elementType
+            self.count = count
+            self.bytes = data.prefix(byteCount)
+            self.elementOffsets = offsets
+        }
+
+        // MARK: - Helpers
+
+        /// Size of one encoded value of `type` at `offset`
+        private static func encodedSize(
+            of type: ValueType,
+            at offset: Int,
+            in raw: UnsafeRawBufferPointer
+        ) throws -> Int {
+            if let width = type.fixedWidth {
+                guard offset + width <= raw.count else {
+                    throw Error.insufficientData
+                }
+                return width
+            }
+            switch type {
+            case .string:
+                let length = try readLength(at: offset, in: raw)
+                guard length <= raw.count - offset - 8 else {
+                    throw Error.insufficientData
+                }
+                let utf8 = UnsafeRawBufferPointer(
+                    rebasing: raw[(offset + 8)..<(offset + 8 + length)])
+                guard utf8.isValidUTF8 else {
+                    throw Error.invalidUTF8String
+                }
+                return 8 + length
+            default:
+                guard offset + 12 <= raw.count else {
+                    throw Error.insufficientData
+                }
+                let rawType = raw.loadLittleEndian(fromByteOffset: offset, as: UInt32.self)
+                guard let nestedType = ValueType(rawValue: rawType) else {
+                    throw Error.invalidValueType(rawType)
+                }
+                let nestedCount = try readLength(at: offset + 4, in: raw)
+                var size = 12
+                if let width = nestedType.fixedWidth {
+                    let (contents, overflow) = nestedCount.multipliedReportingOverflow(by: width)
+                    guard !overflow else {
+                        throw Error.invalidArrayLength(UInt64(nestedCount))
+                    }
+                    guard contents <= raw.count - offset - size else {
+                        throw Error.insufficientData
+                    }
+                    return size + contents
+                }
+                for _ in 0..<nestedCount {
+                    size += try encodedSize(of: nestedType, at: offset + size, in: raw)
+                }
+                return size
+            }
+        }
+
+        private static func readLength(
+            at offset: Int,
+            in raw: UnsafeRawBufferPointer
+        ) throws -> Int {
+            guard offset + 8 <= raw.count else {
+                throw Error.insufficientData
+            }
+            let length = raw.loadLittleEndian(fromByteOffset: offset, as: UInt64.self)
+            guard let lengthInt = Int(exactly: length) else {
+                throw Error.invalidArrayLength(length)
+            }
+            return lengthInt
+        }
+
+        /// Decodes one non-array element that `init` already validated
+        private static func decodeScalar(
+            _ type: ValueType,
+            at offset: Int,
+            in raw: UnsafeRawBufferPointer
+        ) -> MetadataValue {
+            func load<T: FixedWidthInteger>(_: T.Type) -> T {
+                raw.loadLittleEndian(fromByteOffset: offset, as: T.self)
+            }
+            switch type {
+            case .uint8: return .uint8(load(UInt8.self))
+            case .int8: return .int8(load(Int8.self))
+            case .uint16: return .uint16(load(UInt16.self))
+            case .int16: return .int16(load(Int16.self))
+            case .uint32: return .uint32(load(UInt32.self))
+            case .int32: return .int32(load(Int32.self))
+            case .float32: return .float32(Float(bitPattern: load(UInt32.self)))
+            case .bool: return .bool(load(UInt8.self) != 0)
+            case .uint64: return .uint64(load(UInt64.self))
+            case .int64: return .int64(load(Int64.self))
+            case .float64: return .float64(Double(bitPattern: load(UInt64.self)))
+            case .string:
+                let length = Int(load(UInt64.self))
+                let utf8 = UnsafeRawBufferPointer(
+                    rebasing: raw[(offset + 8)..<(offset + 8 + length)])
+                // Validated by `init`, so no bytes are replaced
+                return .string(String(decoding: utf8, as: UTF8.self))
+            case .array:
+                preconditionFailure("Nested arrays are decoded by the subscript")
+            }
+        }
+    }
+}
+
+extension GGUF {
+    /// Numeric types that metadata arrays can be read into in bulk
+    public protocol MetadataScalar: Sendable {
+        /// Metadata type whose encoding matches the in-memory little-endian layout
+        static var metadataValueType: ValueType { get }
+        /// Extracts the value if `metadataValue` holds this type
+        init?(metadataValue: MetadataValue)
+    }
+}
+
+extension UInt8: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .uint8 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .uint8(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension Int8: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .int8 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .int8(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension UInt16: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .uint16 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .uint16(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension Int16: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .int16 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .int16(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension UInt32: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .uint32 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .uint32(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension Int32: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .int32 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .int32(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension UInt64: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .uint64 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .uint64(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension Int64: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .int64 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .int64(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension Float: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .float32 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .float32(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension Double: GGUF.MetadataScalar {
+    public static var metadataValueType: GGUF.ValueType { .float64 }
+    public init?(metadataValue: GGUF.MetadataValue) {
+        guard case .float64(let value) = metadataValue else { return nil }
+        self = value
+    }
+}
+
+extension GGUF.ValueType {
+    /// Encoded size of one value, or nil for strings and arrays
+    var fixedWidth: Int? {
+        switch self {
+        case .uint8, .int8, .bool: 1
+        case .uint16, .int16: 2
+        case .uint32, .int32, .float32: 4
+        case .uint64, .int64, .float64: 8
+        case .string, .array: nil
+        }
+    }
+}
+
+extension UnsafeRawBufferPointer {
+    /// Reads a possibly unaligned little-endian integer
+    func loadLittleEndian<T: FixedWidthInteger>(fromByteOffset offset: Int, as type: T.Type) -> T {
+        T(littleEndian: loadUnaligned(fromByteOffset: offset, as: T.self))
+    }
+}
@@ -1,4 +1,5 @@
 import BinaryParsing
+import Foundation
 
 extension GGUF {
     public struct MetadataKeyValue: Sendable {
@@ -20,9 +21,18 @@ extension GGUF {
 
 extension GGUF.MetadataKeyValue: ExpressibleByParsing {
     public init(parsing input: inout ParserSpan) throws {
+        try self.init(parsing: &input, decoding: .eager, source: nil)
+    }
+
+    init(
+        parsing input: inout ParserSpan,
+        decoding: GGUF.MetadataDecoding,
+        source: Data?
+    ) throws {
         let key = try String(parsingGGUFString: &input)
         let valueType = try GGUF.ValueType(parsing: &input)
-        let value = try GGUF.MetadataValue(parsing: &input, type: valueType)
+        let value = try GGUF.MetadataValue(
+            parsing: &input, type: valueType, decoding: decoding, source: source)
         self.init(
             key: key,
             value: value,
@@ -30,3 +40,16 @@ extension GGUF.MetadataKeyValue: ExpressibleByParsing {
         )
     }
 }
+
+extension GGUF.MetadataKeyValue {
+    /// Appends the key, value type and value in the layout `init(parsing:)` reads
+    /// - Throws: Error if `valueType` does not describe `value`
+    func serialize(into output: inout [UInt8]) throws {
+        guard value.valueType == valueType else {
+            throw GGUF.Error.metadataTypeMismatch(key)
+        }
+        output.appendGGUFString(key)
+        output.appendLittleEndian(valueType.rawValue)
+        try value.serialize(into: &output, key: key)
+    }
+}
@@ -1,4 +1,5 @@
 import BinaryParsing
+import Foundation
 
 /// Metadata value with type-specific data
 extension GGUF {
@@ -16,11 +17,27 @@ extension GGUF {
         case bool(Bool)
         case string(String)
         case array(GGUF.ValueType, [GGUF.MetadataValue])
+        /// Array kept in its encoded form, produced by `.lazy` and `.packedNumericArrays`
+        /// decoding. Elements decode on access.
+        case lazyArray(GGUF.MetadataArray)
     }
 }
 
 extension GGUF.MetadataValue {
     init(parsing input: inout ParserSpan, type: GGUF.ValueType) throws {
+        try self.init(parsing: &input, type: type, decoding: .eager, source: nil)
+    }
+
+    /// - Parameters:
+    ///   - decoding: How arrays are stored; anything but `.eager` needs `source`
+    ///   - source: Data that `input` is a suffix of. Lazy arrays view its bytes, packed arrays
+    ///     copy them.
+    init(
+        parsing input: inout ParserSpan,
+        type: GGUF.ValueType,
+        decoding: GGUF.MetadataDecoding,
+        source: Data?
+    ) throws {
         switch type {
         case .uint8:
             self = .uint8(try UInt8(parsing: &input))
@@ -48,8 +65,34 @@ extension GGUF.MetadataValue {
             guard let count = Int(exactly: arrayLength) else {
                 throw GGUF.Error.invalidArrayLength(arrayLength)
             }
+            switch (decoding, source) {
+            case (.lazy, let source?):
+                let array = try GGUF.MetadataArray(
+                    elementType: arrayType,
+                    count: count,
+                    encodedIn: source.suffix(input.count)
+                )
+                try input.seek(toRelativeOffset: array.bytes.count)
+                self = .lazyArray(array)
+                return
+            case (.packedNumericArrays, let source?) where arrayType.fixedWidth != nil:
+                let view = try GGUF.MetadataArray(
+                    elementType: arrayType,
+                    count: count,
+                    encodedIn: source.suffix(input.count)
+                )
+                try input.seek(toRelativeOffset: view.bytes.count)
+                // Owns its bytes, so the file data can be released after parsing
+                self = .lazyArray(
+                    try GGUF.MetadataArray(
+                        elementType: arrayType, count: count, encodedIn: Data(view.bytes)))
+                return
+            default:
+                break
+            }
             let values = try Array(parsing: &input, count: count) { span in
-                try GGUF.MetadataValue(parsing: &span, type: arrayType)
+                try GGUF.MetadataValue(
+                    parsing: &span, type: arrayType, decoding: decoding, source: source)
             }
             self = .array(arrayType, values)
         case .uint64:
@@ -76,9 +119,87 @@ extension GGUF.MetadataValue: CustomStringConvertible {
         case .bool(let v): "\(v) (bool)"
         case .string(let v): "\"\(v)\""
         case .array(let type, let values): "[\(values.count) x \(type)]"
+        case .lazyArray(let array): "[\(array.count) x \(array.elementType)]"
         case .uint64(let v): "\(v) (uint64)"
         case .int64(let v): "\(v) (int64)"
         case .float64(let v): "\(v) (float64)"
         }
     }
 }
+
+extension GGUF.MetadataValue {
+    /// Type tag that precedes this value in a file
+    public var valueType: GGUF.ValueType {
+        switch self {
+        case .uint8: .uint8
+        case .int8: .int8
+        case .uint16: .uint16
+        case .int16: .int16
+        case .uint32: .uint32
+        case .int32: .int32
+        case .float32: .float32
+        case .bool: .bool
+        case .string: .string
+        case .array, .lazyArray: .array
+        case .uint64: .uint64
+        case .int64: .int64
+        case .float64: .float64
+        }
+    }
+
+    /// Elements of an eager or lazy array, decoded; nil for scalars
+    public var arrayElements: [GGUF.MetadataValue]? {
+        switch self {
+        case .array(_, let values): values
+        case .lazyArray(let array): Array(array)
+        default: nil
+        }
+    }
+
+    /// Elements of a numeric array as a typed Swift array, or nil if this is not an array of
+    /// `T`. Lazily parsed and packed arrays are copied in bulk.
+    public func arrayValues<T: GGUF.MetadataScalar>(as type: T.Type = T.self) -> [T]? {
+        switch self {
+        case .array(let elementType, let values) where elementType == T.metadataValueType:
+            let typed = values.compactMap(T.init(metadataValue:))
+            return typed.count == values.count ? typed : nil
+        case .lazyArray(let array):
+            return array.values(as: T.self)
+        default:
+            return nil
+        }
+    }
+
+    /// Appends the value without its type tag, mirroring `init(parsing:type:)`
+    /// - Throws: Error if an array element does not match the array's element type
+    func serialize(into output: inout [UInt8], key: String) throws {
+        switch self {
+        case .uint8(let v): output.appendLittleEndian(v)
+        case .int8(let v): output.appendLittleEndian(v)
+        case .uint16(let v): output.appendLittleEndian(v)
+        case .int16(let v): output.appendLittleEndian(v)
+        case .uint32(let v): output.appendLittleEndian(v)
+        case .int32(let v): output.appendLittleEndian(v)
+        case .float32(let v): output.appendLittleEndian(v.bitPattern)
+        case .bool(let v): output.appendLittleEndian(UInt8(v ? 1 : 0))
+        case .string(let v): output.appendGGUFString(v)
+        case .array(let type, let values):
+            output.appendLittleEndian(type.rawValue)
+            output.appendLittleEndian(UInt64(values.count))
+            for element in values {
+                guard element.valueType == type else {
+                    throw GGUF.Error.metadataTypeMismatch(key)
+                }
+                try element.serialize(into: &output, key: key)
+            }
+        case .lazyArray(let array):
+            // Still in the encoded layout, so the bytes are copied as they are
+            output.appendLittleEndian(array.elementType.rawValue)
+            output.appendLittleEndian(UInt64(array.count))
+            output.append(contentsOf: array.bytes)
+        case .uint64(let v): output.appendLittleEndian(v)
+        case .int64(let v): output.appendLittleEndian(v)
+        case .float64(let v): output.appendLittleEndian(v.bitPattern)
+        }
+    }
+}
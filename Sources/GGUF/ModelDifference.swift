@@ -0,0 +1,176 @@
+import Foundation
+import Quants
+
+extension GGUF {
+    /// How one tensor differs between two models
+    public struct TensorDifference: Sendable, Hashable {
+        /// Index of the tensor in this model's tensorInfos array
+        public let index: Int
+        /// Index of the tensor in the other model's tensorInfos array
+        public let otherIndex: Int
+        public let name: String
+        public let type: TensorType
+        public let otherType: TensorType
+        /// Error metrics of the other model's values against this model's
+        public let difference: Difference
+        /// Whether the other model stores different bytes or a different type
+        public let isChanged: Bool
+    }
+
+    /// How two models differ, tensor by tensor
+    public struct ModelDifference: Sendable {
+        /// Tensors both models have with the same dimensions, in this model's order
+        public let tensors: [TensorDifference]
+        /// Names of the tensors only the other model has, in its order
+        public let added: [String]
+        /// Names of the tensors only this model has, in its order
+        public let removed: [String]
+        /// Names of the tensors both models have with different dimensions
+        public let reshaped: [String]
+        /// All compared values merged, as if the tensors were one run
+        public let total: Difference
+
+        /// Compared tensors whose bytes or type differ
+        public var changed: [TensorDifference] {
+            tensors.filter(\.isChanged)
+        }
+    }
+
+    /// Compares every tensor of this model with the tensor of the same name in `other`.
+    ///
+    /// Tensors of the same type are compared a 256-value tile at a time: tiles with equal bytes
+    /// are skipped without decoding, so a fine-tune that touched a few layers costs little more
+    /// than a memory compare. Differing tiles of quantized, f16, bf16 and f32 tensors are
+    /// decoded on the stack and measured straight away, in constant memory. Integer and f64
+    /// tensors, which have no fused kernel, are converted to temporary f32 arrays when their
+    /// bytes differ.
+    /// - Parameters:
+    ///   - other: The model to compare with, e.g. a fine-tune of this one
+    ///   - fileData: This model's complete GGUF file data
+    ///   - otherFileData: The other model's complete GGUF file data
+    ///   - parallelism: How to split the work on each tensor across threads
+    /// - Returns: Per-tensor metrics, plus the tensors only one model has or whose shapes differ
+    /// - Throws: Error if a tensor type is not supported for conversion
+    public func difference(
+        to other: GGUF,
+        fileData: Data,
+        otherFileData: Data,
+        parallelism: Parallelism = .automatic
+    ) throws -> ModelDifference {
+        var tensors = [TensorDifference]()
+        var removed = [String]()
+        var reshaped = [String]()
+        var total = Difference()
+        for index in tensorInfos.indices {
+            let name = tensorInfos.name(at: index)
+            guard let otherIndex = other.tensorInfos.index(named: name) else {
+                removed.append(name)
+                continue
+            }
+            let dimensions = tensorInfos.dimensions(at: index)
+            guard dimensions == other.tensorInfos.dimensions(at: otherIndex) else {
+                reshaped.append(name)
+                continue
+            }
+            let tensor = try difference(
+                at: index, from: fileData, to: other, at: otherIndex, from: otherFileData,
+                parallelism: parallelism)
+            tensors.append(tensor)
+            total.merge(tensor.difference)
+        }
+        let added = other.tensorInfos.indices
+            .map { other.tensorInfos.name(at: $0) }
+            .filter { tensorInfos.index(named: $0) == nil }
+        return ModelDifference(
+            tensors: tensors, added: added, removed: removed, reshaped: reshaped, total: total)
+    }
+
+    /// Writes the tensors of `other` that differ from this model's as a new GGUF file.
+    ///
+    /// The output holds the changed, added and reshaped tensors of `other`, copied without
+    /// decoding in `other`'s order, together with `other`'s metadata. Applying it means
+    /// loading each tensor from the delta when present and from this model otherwise.
+    /// - Parameters:
+    ///   - other: The model whose changes to extract
+    ///   - fileData: This model's complete GGUF file data
+    ///   - otherFileData: The other model's complete GGUF file data
+    ///   - url: Output file; replaced if it exists
+    ///   - metadata: Metadata entries added to the output, replacing `other`'s entries with
+    ///     the same key
+    ///   - parallelism: How to split the comparison of each tensor across threads
+    /// - Returns: The comparison the delta was extracted from
+    /// - Throws: Error if a tensor type is not supported for conversion or the file cannot be
+    ///   written
+    @discardableResult
+    public func writeDelta(
+        of other: GGUF,
+        fileData: Data,
+        otherFileData: Data,
+        to url: URL,
+        metadata: [MetadataKeyValue] = [],
+        parallelism: Parallelism = .automatic
+    ) throws -> ModelDifference {
+        let difference = try difference(
+            to: other, fileData: fileData, otherFileData: otherFileData,
+            parallelism: parallelism)
+        let unchanged = Set(difference.tensors.filter { !$0.isChanged }.map(\.otherIndex))
+        let replaced = Set(metadata.map(\.key))
+        var writer = try Writer(
+            metadata: other.metadata.filter { !replaced.contains($0.key) } + metadata)
+        for index in other.tensorInfos.indices where !unchanged.contains(index) {
+            let info = other.tensorInfos[index]
+            try writer.addTensor(
+                name: info.name, dimensions: info.dimensions, dataType: info.dataType,
+                source: .data(other.tensorData(at: index, from: otherFileData)))
+        }
+        try writer.write(to: url)
+        return difference
+    }
+
+    // MARK: - Helpers
+
+    /// Compares the tensor at `index` with the tensor of `other` at `otherIndex`, which has the
+    /// same dimensions
+    private func difference(
+        at index: Int,
+        from fileData: Data,
+        to other: GGUF,
+        at otherIndex: Int,
+        from otherFileData: Data,
+        parallelism: Parallelism
+    ) throws -> TensorDifference {
+        let type = tensorInfos.dataTypes[index]
+        let otherType = other.tensorInfos.dataTypes[otherIndex]
+        let elementCount = Int(tensorInfos.elementCounts[index])
+        let data = tensorData(at: index, from: fileData)
+        let otherData = other.tensorData(at: otherIndex, from: otherFileData)
+        let tensor = { (difference: Difference, isChanged: Bool) in
+            TensorDifference(
+                index: index, otherIndex: otherIndex, name: tensorInfos.name(at: index),
+                type: type, otherType: otherType, difference: difference, isChanged: isChanged)
+        }
+
+        if let layout = Self.valueLayout(of: type),
+            let otherLayout = Self.valueLayout(of: otherType)
+        {
+            let difference = Difference(
+                data, layout: layout, otherData, layout: otherLayout,
+                elementCount: elementCount, parallelism: parallelism)
+            return tensor(difference, type != otherType || !difference.isIdentical)
+        }
+        if type == otherType && data == otherData {
+            return tensor(Difference(identicalCount: elementCount), false)
+        }
+        let values = try tensorFloatArray(at: index, from: fileData, parallelism: parallelism)
+        let otherValues = try other.tensorFloatArray(
+            at: otherIndex, from: otherFileData, parallelism: parallelism)
+        let difference = values.withUnsafeBytes { a in
+            otherValues.withUnsafeBytes { b in
+                Difference(
+                    a, layout: .f32, b, layout: .f32, elementCount: elementCount,
+                    parallelism: parallelism)
+            }
+        }
+        return tensor(difference, true)
+    }
+}
@@ -0,0 +1,207 @@
+import Dispatch
+import Foundation
+import Quants
+
+#if canImport(Darwin)
+import Darwin
+#elseif canImport(Glibc)
+import Glibc
+#endif
+
+extension GGUF {
+    /// A file mapped read-only into memory.
+    ///
+    /// Unlike `Data(contentsOf:options:)`, the mapping is guaranteed to be backed by the file,
+    /// so ranges can be released with `MADV_DONTNEED` and faulted back in from disk later.
+    public struct MappedFile: Sendable {
+        /// Contents of the file; unmapped when the last copy is released
+        public let data: Data
+
+        /// Maps the file at `url`
+        /// - Throws: Error if the file cannot be opened or mapped
+        public init(contentsOf url: URL) throws {
+            let fileDescriptor = open(url.path, O_RDONLY)
+            guard fileDescriptor >= 0 else {
+                throw Error.fileReadFailed(errno: errno)
+            }
+            defer { close(fileDescriptor) }
+            var status = stat()
+            guard fstat(fileDescriptor, &status) == 0 else {
+                throw Error.fileReadFailed(errno: errno)
+            }
+            let size = Int(status.st_size)
+            guard size > 0 else {
+                data = Data()
+                return
+            }
+            guard let base = mmap(nil, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0),
+                base != UnsafeMutableRawPointer(bitPattern: -1)
+            else {
+                throw Error.fileReadFailed(errno: errno)
+            }
+            data = Data(
+                bytesNoCopy: base,
+                count: size,
+                deallocator: .custom { pointer, count in _ = munmap(pointer, count) }
+            )
+        }
+
+        /// Hints the kernel about the pages holding `range`
+        /// - Parameters:
+        ///   - range: Byte range of the file
+        ///   - advice: `MADV_WILLNEED` widens the range to whole pages; `MADV_DONTNEED` shrinks
+        ///     it so pages shared with neighbouring bytes stay resident
+        func advise(_ range: Range<Int>, _ advice: Int32) {
+            let pageSize = Int(getpagesize())
+            var start = range.lowerBound / pageSize * pageSize
+            var end = (range.upperBound + pageSize - 1) / pageSize * pageSize
+            if advice == MADV_DONTNEED {
+                start = (range.lowerBound + pageSize - 1) / pageSize * pageSize
+                end = range.upperBound / pageSize * pageSize
+            }
+            let length = min(end, data.count) - start
+            guard length > 0 else {
+                return
+            }
+            data.withUnsafeBytes { bytes in
+                let address = UnsafeMutableRawPointer(mutating: bytes.baseAddress! + start)
+                _ = madvise(address, length, advice)
+            }
+        }
+    }
+
+    /// Tuning for `forEachTensorFloatArray(in:options:_:)`
+    public struct PrefetchOptions: Sendable {
+        /// Number of tensors past the one being dequantized whose pages are requested ahead
+        public var lookahead: Int
+        /// Bytes of dequantized output held by workers at once. A tensor larger than this
+        /// still loads, but alone.
+        public var maxInFlightBytes: Int
+        /// Whether the pages of a tensor are released after its values are handed over, so
+        /// resident memory stays flat across the load
+        public var releaseConsumedPages: Bool
+        /// Maximum number of tensors dequantized at the same time
+        public var maxConcurrency: Int
+
+        public init(
+            lookahead: Int = 4,
+            maxInFlightBytes: Int = 1 << 30,
+            releaseConsumedPages: Bool = false,
+            maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount
+        ) {
+            self.lookahead = lookahead
+            self.maxInFlightBytes = maxInFlightBytes
+            self.releaseConsumedPages = releaseConsumedPages
+            self.maxConcurrency = maxConcurrency
+        }
+    }
+
+    /// Dequantizes every tensor of a mapped file, overlapping page-in with dequantization.
+    ///
+    /// Tensors are claimed in file-offset order. Claiming a tensor asks the kernel to read
+    /// ahead the next `lookahead` tensors with `MADV_WILLNEED`, so workers rarely stall on
+    /// page faults and load time approaches the larger of I/O and compute time.
+    /// - Parameters:
+    ///   - file: Mapping of the file this GGUF was parsed from
+    ///   - options: Read-ahead distance, memory bound and concurrency
+    ///   - body: Receives each tensor's index and values. Called concurrently from worker
+    ///     threads and not in any particular order.
+    /// - Throws: The first error thrown by a conversion or by `body`; tensors not yet claimed
+    ///   are skipped
+    public func forEachTensorFloatArray(
+        in file: MappedFile,
+        options: PrefetchOptions = PrefetchOptions(),
+        _ body: @Sendable (_ tensorIndex: Int, _ values: [Float]) throws -> Void
+    ) throws {
+        let order = tensorInfos.indices.sorted { tensorInfos.offsets[$0] < tensorInfos.offsets[$1] }
+        let pipeline = PrefetchPipeline(order: order, options: options)
+        let workerCount = max(1, min(options.maxConcurrency, order.count))
+        DispatchQueue.concurrentPerform(iterations: workerCount) { _ in
+            while let claim = pipeline.claim(outputBytes: { outputBytes(at: $0) }) {
+                for index in claim.prefetch {
+                    file.advise(tensorByteRange(at: index), MADV_WILLNEED)
+                }
+                do {
+                    try body(claim.index, try tensorFloatArray(at: claim.index, from: file.data))
+                    if options.releaseConsumedPages {
+                        file.advise(tensorByteRange(at: claim.index), MADV_DONTNEED)
+                    }
+                    pipeline.finish(outputBytes: claim.outputBytes, error: nil)
+                } catch {
+                    pipeline.finish(outputBytes: claim.outputBytes, error: error)
+                }
+            }
+        }
+        if let error = pipeline.error {
+            throw error
+        }
+    }
+
+    private func outputBytes(at tensorIndex: Int) -> Int {
+        Int(tensorInfos.elementCounts[tensorIndex]) * MemoryLayout<Float>.stride
+    }
+}
+
+/// Shared cursor and memory accounting of `forEachTensorFloatArray(in:options:_:)`
+private final class PrefetchPipeline: @unchecked Sendable {
+    struct Claim {
+        let index: Int
+        let outputBytes: Int
+        /// Tensors to request from disk now
+        let prefetch: ArraySlice<Int>
+    }
+
+    private let order: [Int]
+    private let options: GGUF.PrefetchOptions
+    /// Guards every property below
+    private let condition = NSCondition()
+    private var next = 0
+    private var prefetchedThrough = 0
+    private var inFlightBytes = 0
+    private(set) var error: (any Error)?
+
+    init(order: [Int], options: GGUF.PrefetchOptions) {
+        self.order = order
+        self.options = options
+    }
+
+    /// Takes the next tensor in file order, waiting until its output fits in the memory bound;
+    /// nil once every tensor is claimed or a worker failed
+    func claim(outputBytes: (Int) -> Int) -> Claim? {
+        condition.lock()
+        defer { condition.unlock() }
+        guard error == nil, next < order.count else {
+            return nil
+        }
+        let position = next
+        next += 1
+        let index = order[position]
+        let bytes = outputBytes(index)
+        while error == nil, inFlightBytes > 0, inFlightBytes + bytes > options.maxInFlightBytes {
+            condition.wait()
+        }
+        guard error == nil else {
+            return nil
+        }
+        inFlightBytes += bytes
+        let prefetchEnd = min(order.count, position + 1 + max(0, options.lookahead))
+        let prefetchStart = min(prefetchedThrough, prefetchEnd)
+        prefetchedThrough = max(prefetchedThrough, prefetchEnd)
+        return Claim(
+            index: index,
+            outputBytes: bytes,
+            prefetch: order[prefetchStart..<prefetchEnd]
+        )
+    }
+
+    /// Returns a claimed tensor's memory, recording the first failure
+    func finish(outputBytes: Int, error: (any Error)?) {
+        condition.lock()
+        defer { condition.unlock() }
+        inFlightBytes -= outputBytes
+        if self.error == nil {
+            self.error = error
+        }
+        condition.broadcast()
+    }
+}
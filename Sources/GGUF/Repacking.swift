@@ -0,0 +1,141 @@
+import Foundation
+import Quants
+
+extension GGUF {
+    /// Directory of repacked tensors of one model, for
+    /// `repackedTensor(at:from:interleave:cache:)`.
+    ///
+    /// Cache files are keyed like `DequantizedCache`: a hash of the model's header, metadata
+    /// and tensor infos plus the file size, together with the tensor's offset, type and
+    /// dimensions. The model hash is computed once here, so looking a tensor up costs no more
+    /// than opening its file. Models sharing a directory, e.g. fine-tunes of one base, differ
+    /// in their headers and never pick up each other's blocks. Weights rewritten in place with
+    /// the same header and layout are not detected.
+    public struct RepackCache: Sendable {
+        /// Existing directory holding the cache files
+        public let directory: URL
+        let fingerprint: UInt64
+        let fileSize: Int
+
+        /// - Parameters:
+        ///   - directory: Existing directory holding the cache files
+        ///   - gguf: Model whose tensors are cached
+        ///   - fileData: The complete GGUF file data, used to fingerprint the model
+        public init(directory: URL, for gguf: GGUF, fileData: Data) {
+            self.directory = directory
+            self.fingerprint = DequantizedCache.fingerprint(of: gguf, fileData: fileData)
+            self.fileSize = fileData.count
+        }
+    }
+
+    /// Repacks a Q4_0, Q8_0 or Q4_K matrix into the interleaved layout of `RepackedMatrix`.
+    ///
+    /// With a cache, the repacked blocks are written to its directory on first use and mapped
+    /// back on later calls, so the shuffle is paid once per model.
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - interleave: Rows per group, 4 or 8
+    ///   - cache: Cache opened for this model, or nil to skip the disk cache
+    /// - Returns: The repacked matrix with `rowCount` rows of `rowLength` elements
+    /// - Throws: Error if the tensor type has no interleaved layout or its rows do not start on
+    ///   block boundaries. Failing to write the cache is not an error.
+    public func repackedTensor(
+        at tensorIndex: Int,
+        from fileData: Data,
+        interleave: Int = RepackedMatrix.preferredInterleave(),
+        cache: RepackCache? = nil
+    ) throws -> RepackedMatrix {
+        let dataType = tensorInfos.dataTypes[tensorIndex]
+        let rows = tensorInfos.rowCount(at: tensorIndex)
+        let columns = tensorInfos.rowLength(at: tensorIndex)
+        guard let format = dataType.blockFormat, RepackedMatrix.canRepack(format) else {
+            throw Error.unsupportedTensorTypeForConversion(dataType)
+        }
+        guard columns % format.blockSize == 0 else {
+            throw Error.unalignedTensorRows(tensorInfos.name(at: tensorIndex))
+        }
+        let payload = tensorData(at: tensorIndex, from: fileData)
+        var cacheFile: (url: URL, tag: UInt64)?
+        if let cache {
+            precondition(cache.fileSize == fileData.count, "Cache was opened for another model")
+            let tag = Self.repackCacheTag(
+                cache: cache, offset: tensorInfos.offsets[tensorIndex], type: dataType,
+                dimensions: tensorInfos.dimensions(at: tensorIndex))
+            let url = cache.directory.appendingPathComponent(
+                Self.repackCacheFileName(
+                    name: tensorInfos.name(at: tensorIndex), format: format,
+                    interleave: interleave, tag: tag))
+            if let cached = RepackedMatrix(contentsOf: url, tag: tag), cached.format == format,
+                cached.interleave == interleave, cached.rows == rows, cached.columns == columns
+            {
+                return cached
+            }
+            cacheFile = (url, tag)
+        }
+        let matrix = RepackedMatrix(
+            payload,
+            format: format,
+            rows: rows,
+            columns: columns,
+            interleave: interleave
+        )
+        if let cacheFile {
+            try? matrix.write(to: cacheFile.url, tag: cacheFile.tag)
+        }
+        return matrix
+    }
+
+    /// File name of a repacked tensor. Bytes of the name other than ASCII letters, digits,
+    /// `_`, `-` and `.` are percent-encoded, `%` included, so distinct names never share a file.
+    static func repackCacheFileName(
+        name: String,
+        format: BlockFormat,
+        interleave: Int,
+        tag: UInt64
+    ) -> String {
+        var safeName = ""
+        for byte in name.utf8 {
+            switch byte {
+            case UInt8(ascii: "a")...UInt8(ascii: "z"), UInt8(ascii: "A")...UInt8(ascii: "Z"),
+                UInt8(ascii: "0")...UInt8(ascii: "9"), UInt8(ascii: "_"), UInt8(ascii: "-"),
+                UInt8(ascii: "."):
+                safeName.unicodeScalars.append(Unicode.Scalar(byte))
+            default:
+                safeName += "%" + String(byte, radix: 16, uppercase: true).leftPadded(to: 2)
+            }
+        }
+        let hexTag = String(tag, radix: 16).leftPadded(to: 16)
+        return "\(safeName).\(format)x\(interleave).\(hexTag).repack"
+    }
+
+    /// FNV-1a over the model fingerprint and file size, then the tensor's offset, type and
+    /// dimensions
+    static func repackCacheTag(
+        cache: RepackCache,
+        offset: UInt64,
+        type: TensorType,
+        dimensions: some Collection<UInt64>
+    ) -> UInt64 {
+        var key = [UInt8]()
+        key.appendLittleEndian(cache.fingerprint)
+        key.appendLittleEndian(UInt64(cache.fileSize))
+        key.appendLittleEndian(offset)
+        key.appendLittleEndian(type.rawValue)
+        for dimension in dimensions {
+            key.appendLittleEndian(dimension)
+        }
+        var hash: UInt64 = 0xcbf2_9ce4_8422_2325
+        for byte in key {
+            hash = (hash ^ UInt64(byte)) &* 0x100_0000_01b3
+        }
+        return hash
+    }
+}
+
+extension String {
+    /// The string with leading zeros added up to `length` characters
+    fileprivate func leftPadded(to length: Int) -> String {
+        String(repeating: "0", count: max(0, length - count)) + self
+    }
+}
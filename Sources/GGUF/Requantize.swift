@@ -0,0 +1,264 @@
+import Dispatch
+import Foundation
+import Quants
+
+extension GGUF {
+    /// Target type for the tensors whose names match a pattern
+    public struct RequantizationRule: Sendable, Hashable {
+        /// Tensor name pattern; `*` matches any run of characters, as in
+        /// `TensorTable.indices(matching:)`
+        public var pattern: String
+        /// Type to write, or nil to keep the tensor's type
+        public var type: TensorType?
+
+        public init(_ pattern: String, _ type: TensorType?) {
+            self.pattern = pattern
+            self.type = type
+        }
+    }
+
+    /// Tuning for `requantize(from:to:options:)`
+    public struct RequantizationOptions: Sendable {
+        /// Type of the tensors no rule matches, or nil to keep their types
+        public var defaultType: TensorType?
+        /// Per-pattern targets; the first matching rule wins
+        public var rules: [RequantizationRule]
+        /// Metadata entries added to the output, replacing source entries with the same key
+        public var metadata: [MetadataKeyValue]
+        /// Elements converted per step. Two steps are held at once, so peak memory is about
+        /// `8 * chunkSize` bytes of floats plus the encoded output, whatever the model size.
+        public var chunkSize: Int
+        /// How to split each step across threads
+        public var parallelism: Parallelism
+
+        public init(
+            defaultType: TensorType?,
+            rules: [RequantizationRule] = [],
+            metadata: [MetadataKeyValue] = [],
+            chunkSize: Int = 1 << 22,
+            parallelism: Parallelism = .automatic
+        ) {
+            self.defaultType = defaultType
+            self.rules = rules
+            self.metadata = metadata
+            self.chunkSize = max(1, chunkSize)
+            self.parallelism = parallelism
+        }
+
+        /// Converts everything to `type` except norms and the output projection, which keep
+        /// their (usually higher) precision
+        public static func preservingSensitiveTensors(as type: TensorType) -> Self {
+            RequantizationOptions(
+                defaultType: type,
+                rules: [
+                    RequantizationRule("*norm*", nil),
+                    RequantizationRule("output.weight", nil),
+                ])
+        }
+    }
+
+    /// Source and output type of one tensor of a requantization
+    public struct RequantizedTensor: Sendable, Hashable {
+        /// Index of the tensor in tensorInfos array
+        public let index: Int
+        public let name: String
+        public let sourceType: TensorType
+        public let type: TensorType
+    }
+
+    /// Output type of every tensor under `options`, without converting anything.
+    ///
+    /// A tensor keeps its type when its row length is not a multiple of the block size of its
+    /// type or of the target, since blocks never span rows.
+    /// - Throws: `unsupportedTensorTypeForConversion` if a rule or the default names a type
+    ///   that cannot be written
+    public func requantizationPlan(
+        options: RequantizationOptions
+    ) throws -> [RequantizedTensor] {
+        var targets = [TensorType?](repeating: options.defaultType, count: tensorInfos.count)
+        var matched = [Bool](repeating: false, count: tensorInfos.count)
+        for rule in options.rules {
+            for index in tensorInfos.indices(matching: rule.pattern) where !matched[index] {
+                matched[index] = true
+                targets[index] = rule.type
+            }
+        }
+        return try tensorInfos.indices.map { index in
+            let info = tensorInfos[index]
+            var type = targets[index] ?? info.dataType
+            if type != info.dataType {
+                guard Self.canRequantize(to: type) else {
+                    throw Error.unsupportedTensorTypeForConversion(type)
+                }
+                if info.rowLength % type.blockSize != 0
+                    || info.rowLength % info.dataType.blockSize != 0
+                {
+                    type = info.dataType
+                }
+            }
+            return RequantizedTensor(
+                index: index, name: info.name, sourceType: info.dataType, type: type)
+        }
+    }
+
+    /// Converts tensors to other types and writes the result as a new GGUF file.
+    ///
+    /// Tensors are streamed into the output one chunk at a time: while one chunk of
+    /// `options.chunkSize` elements is written, the next is dequantized and requantized on
+    /// `options.parallelism` threads. Tensors that keep their type are copied without
+    /// decoding. Metadata, tensor order, dimensions and alignment are those of the source,
+    /// except that `general.file_type` is dropped when any tensor changes type: it names the
+    /// source's quantization mix, which the output no longer has. Pass it in
+    /// `options.metadata` to describe the output's mix.
+    /// - Parameters:
+    ///   - fileData: The complete GGUF file data
+    ///   - url: Output file; replaced if it exists
+    ///   - options: Type rules, chunk size and parallelism
+    /// - Returns: The type of every tensor written
+    /// - Throws: Error if a rule names a type that cannot be written, a tensor cannot be
+    ///   converted or the file cannot be written
+    @discardableResult
+    public func requantize(
+        from fileData: Data,
+        to url: URL,
+        options: RequantizationOptions
+    ) throws -> [RequantizedTensor] {
+        let plan = try requantizationPlan(options: options)
+        var replaced = Set(options.metadata.map(\.key))
+        if plan.contains(where: { $0.type != $0.sourceType }) {
+            replaced.insert("general.file_type")
+        }
+        var writer = try Writer(
+            metadata: metadata.filter { !replaced.contains($0.key) } + options.metadata)
+        for tensor in plan {
+            let source: TensorSource
+            if tensor.type == tensor.sourceType {
+                source = .data(tensorData(at: tensor.index, from: fileData))
+            } else {
+                source = .stream { emit in
+                    try self.requantizedChunks(
+                        of: tensor, from: fileData, options: options, emit)
+                }
+            }
+            try writer.addTensor(
+                name: tensor.name, dimensions: Array(tensorInfos.dimensions(at: tensor.index)),
+                dataType: tensor.type,
+                source: source)
+        }
+        try writer.write(to: url)
+        return plan
+    }
+
+    // MARK: - Helpers
+
+    /// Whether `requantize` can encode values as `type`
+    private static func canRequantize(to type: TensorType) -> Bool {
+        switch type {
+        case .f32, .f16, .bf16: true
+        default: type.blockFormat?.isQuantizable ?? false
+        }
+    }
+
+    /// Converts one tensor chunk by chunk, converting the next chunk on a background queue
+    /// while `emit` writes the current one
+    private func requantizedChunks(
+        of tensor: RequantizedTensor,
+        from fileData: Data,
+        options: RequantizationOptions,
+        _ emit: (UnsafeRawBufferPointer) throws -> Void
+    ) throws {
+        let elementCount = Int(tensorInfos.elementCounts[tensor.index])
+        // Chunks start on block boundaries of both types; every block size divides 256
+        let step = max(256, options.chunkSize / 256 * 256)
+        let chunks = stride(from: 0, to: elementCount, by: step).map {
+            $0..<min(elementCount, $0 + step)
+        }
+        let buffers = (0..<2).map { _ in
+            ChunkBuffer(
+                elementCount: min(step, elementCount),
+                byteCount: tensor.type.sizeInBytes(elementCount: UInt64(min(step, elementCount))))
+        }
+        let group = DispatchGroup()
+        let convert = { (chunk: Int) in
+            let buffer = buffers[chunk % 2]
+            DispatchQueue.global().async(group: group) {
+                do {
+                    buffer.byteCount = try self.encode(
+                        tensor, elements: chunks[chunk], from: fileData, into: buffer,
+                        parallelism: options.parallelism)
+                } catch {
+                    buffer.error = error
+                }
+            }
+        }
+        if !chunks.isEmpty {
+            convert(0)
+        }
+        for chunk in chunks.indices {
+            group.wait()
+            let buffer = buffers[chunk % 2]
+            if let error = buffer.error {
+                throw error
+            }
+            if chunk + 1 < chunks.count {
+                convert(chunk + 1)
+            }
+            try emit(UnsafeRawBufferPointer(rebasing: buffer.bytes[..<buffer.byteCount]))
+        }
+    }
+
+    /// Converts `elements` of a tensor into `buffer` and returns the encoded byte count
+    private func encode(
+        _ tensor: RequantizedTensor,
+        elements: Range<Int>,
+        from fileData: Data,
+        into buffer: ChunkBuffer,
+        parallelism: Parallelism
+    ) throws -> Int {
+        let sourceType = tensor.sourceType
+        let byteRange = tensorInfos.byteRange(at: tensor.index)
+        let blockBytes = { (element: Int) in
+            element / sourceType.blockSize * sourceType.bytesPerBlock
+        }
+        let start = byteRange.lowerBound + blockBytes(elements.lowerBound)
+        let end = byteRange.lowerBound + blockBytes(elements.upperBound)
+        let values = UnsafeMutableBufferPointer(rebasing: buffer.values[..<elements.count])
+        try Self.convert(
+            fileData[start..<end], type: sourceType, into: values, parallelism: parallelism)
+
+        let byteCount = tensor.type.sizeInBytes(elementCount: UInt64(elements.count))
+        let output = UnsafeMutableRawBufferPointer(rebasing: buffer.bytes[..<byteCount])
+        switch tensor.type {
+        case .f32:
+            output.copyMemory(from: UnsafeRawBufferPointer(values))
+        case .f16, .bf16:
+            Dequantize.narrow(
+                UnsafeBufferPointer(values), into: output.bindMemory(to: UInt16.self),
+                as: tensor.type.halfFormat!, parallelism: parallelism)
+        default:
+            Quantize.quantize(
+                UnsafeBufferPointer(values), into: output, format: tensor.type.blockFormat!,
+                parallelism: parallelism)
+        }
+        return byteCount
+    }
+}
+
+/// Floats and encoded bytes of one chunk. Each buffer is used by one thread at a time: the
+/// converting queue until the dispatch group is waited on, then the writer.
+private final class ChunkBuffer: @unchecked Sendable {
+    let values: UnsafeMutableBufferPointer<Float>
+    let bytes: UnsafeMutableRawBufferPointer
+    var byteCount = 0
+    var error: (any Error)?
+
+    init(elementCount: Int, byteCount: Int) {
+        values = .allocate(capacity: elementCount)
+        bytes = .allocate(byteCount: byteCount, alignment: 64)
+    }
+
+    deinit {
+        values.deallocate()
+        bytes.deallocate()
+    }
+}
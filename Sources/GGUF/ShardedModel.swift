@@ -0,0 +1,176 @@
+import Foundation
+import Quants
+
+extension GGUF {
+    /// A model split across `<prefix>-00001-of-0000N.gguf` files, as written by
+    /// `llama-gguf-split`, behind a single tensor index.
+    ///
+    /// Siblings are found from the `split.no` and `split.count` metadata of the opened shard,
+    /// then mapped and parsed concurrently. A file without `split.*` metadata loads as a
+    /// model with one shard.
+    public struct ShardedModel: Sendable {
+        /// One file of the model
+        public struct Shard: Sendable {
+            public let url: URL
+            public let gguf: GGUF
+            /// Contents of the file, memory-mapped when possible
+            public let fileData: Data
+        }
+
+        /// Where a tensor lives
+        public struct TensorLocation: Sendable {
+            /// Index into `shards`
+            public let shardIndex: Int
+            /// Index into the shard's `tensorInfos`
+            public let tensorIndex: Int
+            /// Offset of the payload within the shard file
+            public let fileOffset: Int
+            public let info: TensorInfo
+        }
+
+        /// Shards ordered by `split.no`
+        public let shards: [Shard]
+        public let tensorLocations: [String: TensorLocation]
+
+        /// Loads the model that `url` belongs to; any shard of it may be passed
+        /// - Parameters:
+        ///   - url: One of the shard files
+        ///   - metadataDecoding: How metadata arrays are decoded
+        ///   - maxConcurrency: Maximum number of shards parsed at the same time
+        /// - Throws: Error if a shard is missing or malformed, shards disagree on the split
+        ///   layout, or a tensor name appears twice
+        public init(
+            contentsOf url: URL,
+            metadataDecoding: MetadataDecoding = .eager,
+            maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount
+        ) throws {
+            let first = try Self.loadShard(url, metadataDecoding: metadataDecoding)
+            let (splitIndex, splitCount) = try Self.splitPosition(of: first.gguf, url: url)
+            let urls = try Self.shardURLs(for: url, splitIndex: splitIndex, splitCount: splitCount)
+
+            var results = [Result<Shard, any Swift.Error>?](repeating: nil, count: splitCount)
+            results[splitIndex] = .success(first)
+            results.withUnsafeMutableBufferPointer { results in
+                let parallelism = Parallelism(maxConcurrency: maxConcurrency, minimumChunkSize: 1)
+                // Every chunk writes only its own slots
+                parallelism.forEachChunk(blockCount: splitCount, blockSize: 1) { indices in
+                    for index in indices where index != splitIndex {
+                        results[index] = Result {
+                            try Self.loadShard(urls[index], metadataDecoding: metadataDecoding)
+                        }
+                    }
+                }
+            }
+            let shards = try results.map { try $0!.get() }
+
+            var tensorLocations: [String: TensorLocation] = [:]
+            for (shardIndex, shard) in shards.enumerated() {
+                let position = try Self.splitPosition(of: shard.gguf, url: shard.url)
+                guard position == (shardIndex, splitCount) else {
+                    throw Error.invalidSplit(shard.url.lastPathComponent)
+                }
+                for (tensorIndex, info) in shard.gguf.tensorInfos.enumerated() {
+                    let location = TensorLocation(
+                        shardIndex: shardIndex,
+                        tensorIndex: tensorIndex,
+                        fileOffset: shard.gguf.tensorDataOffset + Int(info.offset),
+                        info: info
+                    )
+                    guard tensorLocations.updateValue(location, forKey: info.name) == nil else {
+                        throw Error.duplicateTensorName(info.name)
+                    }
+                }
+            }
+            let tensorCount = first.gguf.metadataValue(forKey: "split.tensors.count")
+            if case .int32(let count) = tensorCount, Int(count) != tensorLocations.count {
+                throw Error.invalidSplit(url.lastPathComponent)
+            }
+            self.shards = shards
+            self.tensorLocations = tensorLocations
+        }
+
+        /// Metadata of the first shard, which holds the model's key-value pairs
+        public func metadataValue(forKey key: String) -> MetadataValue? {
+            shards[0].gguf.metadataValue(forKey: key)
+        }
+
+        /// Raw bytes of a tensor, from the shard that holds it
+        public func tensorData(_ tensorName: String) -> Data? {
+            guard let location = tensorLocations[tensorName] else {
+                return nil
+            }
+            let shard = shards[location.shardIndex]
+            return shard.gguf.tensorData(at: location.tensorIndex, from: shard.fileData)
+        }
+
+        /// Extract tensor data as a Float array, dequantizing if necessary
+        /// - Parameters:
+        ///   - tensorName: Name of the tensor in any shard
+        ///   - parallelism: How to split dequantization across threads
+        /// - Returns: Array of Float values, or nil if no shard has the tensor
+        /// - Throws: Error if the tensor type is not supported for conversion
+        public func tensorFloatArray(
+            _ tensorName: String,
+            parallelism: Parallelism = .serial
+        ) throws -> [Float]? {
+            guard let location = tensorLocations[tensorName] else {
+                return nil
+            }
+            let shard = shards[location.shardIndex]
+            return try shard.gguf.tensorFloatArray(
+                at: location.tensorIndex,
+                from: shard.fileData,
+                parallelism: parallelism
+            )
+        }
+
+        // MARK: - Helpers
+
+        private static func loadShard(
+            _ url: URL,
+            metadataDecoding: MetadataDecoding
+        ) throws -> Shard {
+            let fileData = try Data(contentsOf: url, options: .mappedIfSafe)
+            let gguf = try GGUF(parsing: fileData, metadataDecoding: metadataDecoding)
+            return Shard(url: url, gguf: gguf, fileData: fileData)
+        }
+
+        /// Zero-based `split.no` and `split.count`; (0, 1) for unsplit files
+        private static func splitPosition(of gguf: GGUF, url: URL) throws -> (Int, Int) {
+            let index = gguf.metadataValue(forKey: "split.no")
+            switch (index, gguf.metadataValue(forKey: "split.count")) {
+            case (nil, nil):
+                return (0, 1)
+            case (.uint16(let index), .uint16(let count)) where index < count:
+                return (Int(index), Int(count))
+            default:
+                throw Error.invalidSplit(url.lastPathComponent)
+            }
+        }
+
+        /// Sibling paths following the `<prefix>-%05d-of-%05d.gguf` naming of llama.cpp
+        private static func shardURLs(
+            for url: URL,
+            splitIndex: Int,
+            splitCount: Int
+        ) throws -> [URL] {
+            guard splitCount > 1 else {
+                return [url]
+            }
+            let name = url.lastPathComponent
+            let suffix = shardSuffix(splitIndex, of: splitCount)
+            guard name.hasSuffix(suffix) else {
+                throw Error.invalidSplit(name)
+            }
+            let prefix = name.dropLast(suffix.count)
+            let directory = url.deletingLastPathComponent()
+            return (0..<splitCount).map { index in
+                directory.appendingPathComponent(prefix + shardSuffix(index, of: splitCount))
+            }
+        }
+
+        private static func shardSuffix(_ index: Int, of count: Int) -> String {
+            String(format: "-%05d-of-%05d.gguf", index + 1, count)
+        }
+    }
+}
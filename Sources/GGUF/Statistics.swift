@@ -0,0 +1,142 @@
+import Foundation
+import Quants
+
+extension GGUF {
+    /// Statistics of one tensor
+    public struct TensorStatistics: Sendable, Hashable {
+        /// Index of the tensor in tensorInfos array
+        public let index: Int
+        public let name: String
+        public let statistics: Statistics
+        /// Value distribution, if bins were requested
+        public let histogram: Histogram?
+    }
+
+    /// Statistics of every tensor of a model
+    public struct ModelStatistics: Sendable {
+        /// One entry per summarized tensor, in tensorInfos order
+        public let tensors: [TensorStatistics]
+        /// All summarized values merged, as if the tensors were one run
+        public let total: Statistics
+    }
+
+    /// Summarizes a tensor without materializing its values.
+    ///
+    /// Quantized, f16, bf16 and f32 tensors are decoded a tile at a time and folded into the
+    /// summary straight away. Integer and f64 tensors, which have no fused kernel, are
+    /// converted to a temporary f32 array first.
+    /// - Parameters:
+    ///   - tensorIndex: Index of the tensor in tensorInfos array
+    ///   - fileData: The complete GGUF file data
+    ///   - histogramBins: Number of histogram bins; nil skips the histogram
+    ///   - histogramRange: Range covered by the bins. When nil, the range is the tensor's
+    ///     `min...max`, which takes a second pass over the data.
+    ///   - parallelism: How to split the work across threads
+    /// - Returns: The tensor's statistics
+    /// - Throws: Error if the tensor type is not supported for conversion
+    public func statistics(
+        at tensorIndex: Int,
+        from fileData: Data,
+        histogramBins: Int? = nil,
+        histogramRange: ClosedRange<Float>? = nil,
+        parallelism: Parallelism = .automatic
+    ) throws -> TensorStatistics {
+        let elementCount = Int(tensorInfos.elementCounts[tensorIndex])
+        let summarize = { (input: UnsafeRawBufferPointer, layout: ValueLayout) in
+            let statistics = Statistics(
+                input, layout: layout, elementCount: elementCount, parallelism: parallelism)
+            var histogram: Histogram?
+            if let histogramBins {
+                let range = histogramRange ?? Self.valueRange(of: statistics)
+                var bins = Histogram(
+                    lowerBound: range.lowerBound, upperBound: range.upperBound,
+                    binCount: histogramBins)
+                bins.add(
+                    input, layout: layout, elementCount: elementCount, parallelism: parallelism)
+                histogram = bins
+            }
+            return TensorStatistics(
+                index: tensorIndex, name: tensorInfos.name(at: tensorIndex),
+                statistics: statistics, histogram: histogram)
+        }
+
+        let type = tensorInfos.dataTypes[tensorIndex]
+        if type == .f32 {
+            return try withF32Values(ofTensorAt: tensorIndex, from: fileData) {
+                summarize(UnsafeRawBufferPointer($0), .f32)
+            }
+        }
+        if let layout = Self.valueLayout(of: type) {
+            return tensorData(at: tensorIndex, from: fileData).withUnsafeBytes {
+                summarize($0, layout)
+            }
+        }
+        let values = try tensorFloatArray(
+            at: tensorIndex, from: fileData, parallelism: parallelism)
+        return values.withUnsafeBytes { summarize($0, .f32) }
+    }
+
+    /// Summarizes the tensor called `name`, or returns nil if there is no such tensor
+    public func statistics(
+        _ tensorName: String,
+        from fileData: Data,
+        histogramBins: Int? = nil,
+        histogramRange: ClosedRange<Float>? = nil,
+        parallelism: Parallelism = .automatic
+    ) throws -> TensorStatistics? {
+        guard let tensorIndex = tensorInfos.index(named: tensorName) else {
+            return nil
+        }
+        return try statistics(
+            at: tensorIndex, from: fileData, histogramBins: histogramBins,
+            histogramRange: histogramRange, parallelism: parallelism)
+    }
+
+    /// Summarizes every tensor and the model as a whole
+    /// - Parameters:
+    ///   - fileData: The complete GGUF file data
+    ///   - histogramBins: Number of bins of each tensor's histogram; nil skips histograms
+    ///   - parallelism: How to split the work on each tensor across threads
+    /// - Returns: Per-tensor statistics and their merged total. Tensors whose type cannot be
+    ///   converted are left out.
+    public func modelStatistics(
+        from fileData: Data,
+        histogramBins: Int? = nil,
+        parallelism: Parallelism = .automatic
+    ) -> ModelStatistics {
+        var tensors = [TensorStatistics]()
+        var total = Statistics()
+        for index in tensorInfos.indices {
+            guard
+                let tensor = try? statistics(
+                    at: index, from: fileData, histogramBins: histogramBins,
+                    parallelism: parallelism)
+            else {
+                continue
+            }
+            tensors.append(tensor)
+            total.merge(tensor.statistics)
+        }
+        return ModelStatistics(tensors: tensors, total: total)
+    }
+
+    // MARK: - Helpers
+
+    /// Layout with a fused decode-and-summarize path, or nil for integer and f64 types
+    static func valueLayout(of type: TensorType) -> ValueLayout? {
+        if type == .f32 {
+            return .f32
+        }
+        if let half = type.halfFormat {
+            return .half(half)
+        }
+        return type.blockFormat.map(ValueLayout.blocks)
+    }
+
+    /// `min...max` of the finite values summarized by `statistics`, or 0...0 if there are none
+    private static func valueRange(of statistics: Statistics) -> ClosedRange<Float> {
+        let lower = statistics.min.isFinite ? statistics.min : -Float.greatestFiniteMagnitude
+        let upper = statistics.max.isFinite ? statistics.max : Float.greatestFiniteMagnitude
+        return statistics.count > 0 && lower <= upper ? lower...upper : 0...0
+    }
+}
@@ -0,0 +1,222 @@
+import Dispatch
+import Foundation
+import Quants
+import Synchronization
+
+extension GGUF {
+    /// Dequantized tensors of one file, kept in memory up to a byte budget.
+    ///
+    /// The least recently used tensors are evicted first. Lookups are thread-safe, and
+    /// concurrent requests for a tensor that is still being dequantized wait for that work
+    /// instead of repeating it. Returned arrays share storage with the cached copy.
+    public final class TensorCache: Sendable {
+        /// Counters for sizing the budget
+        public struct Statistics: Sendable, Equatable {
+            /// Lookups served from the cache, including ones that joined an in-flight load
+            public var hits = 0
+            /// Lookups that dequantized the tensor
+            public var misses = 0
+            /// Tensors dropped to stay within the budget
+            public var evictions = 0
+            /// Number of cached tensors
+            public var entryCount = 0
+            /// Bytes held by cached tensors
+            public var byteCount = 0
+        }
+
+        public let gguf: GGUF
+        public let fileData: Data
+        /// Maximum number of bytes of dequantized values kept at once
+        public let byteBudget: Int
+        /// How cache misses split dequantization across threads
+        public let parallelism: Parallelism
+
+        private let state: Mutex<State>
+
+        /// - Parameters:
+        ///   - gguf: Parsed file
+        ///   - fileData: Contents of the file
+        ///   - byteBudget: Maximum number of bytes of dequantized values kept at once;
+        ///     tensors larger than this are returned but never cached
+        ///   - parallelism: How cache misses split dequantization across threads
+        public init(
+            gguf: GGUF,
+            fileData: Data,
+            byteBudget: Int,
+            parallelism: Parallelism = .serial
+        ) {
+            precondition(byteBudget >= 0, "Byte budget must not be negative")
+            self.gguf = gguf
+            self.fileData = fileData
+            self.byteBudget = byteBudget
+            self.parallelism = parallelism
+            self.state = Mutex(State(tensorCount: gguf.tensorInfos.count))
+        }
+
+        /// Current counters
+        public var statistics: Statistics {
+            state.withLock { $0.statistics }
+        }
+
+        /// Tensor values as Float, dequantized on first use
+        /// - Parameter tensorIndex: Index of the tensor in `gguf.tensorInfos`
+        /// - Returns: Array of Float values
+        /// - Throws: Error if the tensor type is not supported for conversion
+        public func tensorFloatArray(at tensorIndex: Int) throws -> [Float] {
+            let lookup = state.withLock { (state: inout State) -> Lookup in
+                if let values = state.values[tensorIndex] {
+                    state.statistics.hits += 1
+                    state.touch(tensorIndex)
+                    return .cached(values)
+                }
+                if let load = state.inFlight[tensorIndex] {
+                    state.statistics.hits += 1
+                    return .waiting(load)
+                }
+                state.statistics.misses += 1
+                let load = Load()
+                state.inFlight[tensorIndex] = load
+                return .loading(load)
+            }
+
+            switch lookup {
+            case .cached(let values):
+                return values
+            case .waiting(let load):
+                load.done.wait()
+                return try load.result!.get()
+            case .loading(let load):
+                let result = Result {
+                    try gguf.tensorFloatArray(
+                        at: tensorIndex, from: fileData, parallelism: parallelism)
+                }
+                load.result = result
+                state.withLock { state in
+                    state.inFlight[tensorIndex] = nil
+                    if case .success(let values) = result {
+                        state.insert(values, at: tensorIndex, byteBudget: byteBudget)
+                    }
+                }
+                load.done.leave()
+                return try result.get()
+            }
+        }
+
+        /// Tensor values as Float, dequantized on first use
+        /// - Parameter tensorName: Name of the tensor
+        /// - Returns: Array of Float values, or nil if the file has no such tensor
+        /// - Throws: Error if the tensor type is not supported for conversion
+        public func tensorFloatArray(_ tensorName: String) throws -> [Float]? {
+            guard let tensorIndex = gguf.tensorInfos.index(named: tensorName) else {
+                return nil
+            }
+            return try tensorFloatArray(at: tensorIndex)
+        }
+
+        /// Drops every cached tensor; counters other than the sizes are kept
+        public func removeAll() {
+            state.withLock { state in
+                while state.oldest != State.none {
+                    state.remove(state.oldest)
+                }
+            }
+        }
+    }
+}
+
+extension GGUF.TensorCache {
+    /// Dequantization in progress; waiters block on `done` and then read `result`
+    private final class Load: @unchecked Sendable {
+        let done = DispatchGroup()
+        /// Written once by the loading thread before `done` is left
+        var result: Result<[Float], any Error>?
+
+        init() {
+            done.enter()
+        }
+    }
+
+    private enum Lookup {
+        case cached([Float])
+        case waiting(Load)
+        case loading(Load)
+    }
+
+    /// Cached tensors threaded on a doubly linked recency list indexed by tensor index
+    private struct State {
+        static let none = -1
+
+        var values: [[Float]?]
+        var newer: [Int]
+        var older: [Int]
+        var newest = Self.none
+        var oldest = Self.none
+        var inFlight: [Int: Load] = [:]
+        var statistics = Statistics()
+
+        init(tensorCount: Int) {
+            values = Array(repeating: nil, count: tensorCount)
+            newer = Array(repeating: Self.none, count: tensorCount)
+            older = Array(repeating: Self.none, count: tensorCount)
+        }
+
+        /// Marks a cached tensor as the most recently used
+        mutating func touch(_ index: Int) {
+            guard index != newest else {
+                return
+            }
+            unlink(index)
+            link(index)
+        }
+
+        /// Caches `values`, evicting the least recently used tensors to make room
+        mutating func insert(_ values: [Float], at index: Int, byteBudget: Int) {
+            let byteCount = values.count * MemoryLayout<Float>.stride
+            guard self.values[index] == nil, byteCount <= byteBudget else {
+                return
+            }
+            while statistics.byteCount + byteCount > byteBudget {
+                remove(oldest)
+                statistics.evictions += 1
+            }
+            self.values[index] = values
+            statistics.entryCount += 1
+            statistics.byteCount += byteCount
+            link(index)
+        }
+
+        mutating func remove(_ index: Int) {
+            unlink(index)
+            statistics.entryCount -= 1
+            statistics.byteCount -= values[index]!.count * MemoryLayout<Float>.stride
+            values[index] = nil
+        }
+
+        /// Inserts `index` at the newest end of the list
+        private mutating func link(_ index: Int) {
+            older[index] = newest
+            newer[index] = Self.none
+            if newest != Self.none {
+                newer[newest] = index
+            } else {
+                oldest = index
+            }
+            newest = index
+        }
+
+        private mutating func unlink(_ index: Int) {
+            if older[index] != Self.none {
+                newer[older[index]] = newer[index]
+            } else {
+                oldest = newer[index]
+            }
+            if newer[index] != Self.none {
+                older[newer[index]] = older[index]
+            } else {
+                newest = older[index]
+            }
+            older[index] = Self.none
+            newer[index] = Self.none
+        }
+    }
+}
@@ -7,17 +7,29 @@ extension GGUF {
         public let dimensions: [UInt64]
         public let dataType: GGUF.TensorType
         public let offset: UInt64
-
         /// Total number of elements in the tensor
-        public var elementCount: UInt64 {
-            dimensions.reduce(1, *)
-        }
+        public let elementCount: UInt64
 
         /// Size of this tensor's data in bytes
         public var sizeInBytes: Int {
             dataType.sizeInBytes(elementCount: elementCount)
         }
 
+        /// Number of elements in one row (the first, innermost dimension)
+        public var rowLength: Int {
+            Int(dimensions.first ?? 1)
+        }
+
+        /// Number of rows, i.e. the product of all dimensions except the first
+        public var rowCount: Int {
+            rowLength == 0 ? 0 : Int(elementCount) / rowLength
+        }
+
+        /// Size of one row's data in bytes
+        public var rowSizeInBytes: Int {
+            dataType.sizeInBytes(elementCount: UInt64(rowLength))
+        }
+
         public init(
             name: String,
             dimensionCount: UInt32,
@@ -30,6 +42,7 @@ extension GGUF {
             self.dimensions = dimensions
             self.dataType = dataType
             self.offset = offset
+            self.elementCount = dimensions.reduce(1, *)
         }
     }
 }
@@ -49,5 +62,19 @@ extension GGUF.TensorInfo: ExpressibleByParsing {
         }
         self.dataType = try GGUF.TensorType(parsing: &input)
         self.offset = try UInt64(parsingLittleEndian: &input)
+        self.elementCount = dimensions.reduce(1, *)
+    }
+}
+
+extension GGUF.TensorInfo {
+    /// Appends the tensor info in the layout `init(parsing:)` reads
+    func serialize(into output: inout [UInt8]) {
+        output.appendGGUFString(name)
+        output.appendLittleEndian(dimensionCount)
+        for dimension in dimensions {
+            output.appendLittleEndian(dimension)
+        }
+        output.appendLittleEndian(dataType.rawValue)
+        output.appendLittleEndian(offset)
     }
 }
@@ -0,0 +1,361 @@
+import BinaryParsing
+
+extension GGUF {
+    /// Tensor infos of a file, stored column by column.
+    ///
+    /// Names live in one byte arena and dimensions in one flat array, so parsing a file with
+    /// tens of thousands of tensors allocates a handful of buffers instead of two per tensor.
+    /// Element counts, byte sizes and file offsets are computed once. Subscripting
+    /// materializes a `TensorInfo`; the per-column accessors do not allocate.
+    ///
+    /// Names are indexed three times: a hash table answers exact lookups, a name-sorted
+    /// permutation answers prefix and wildcard queries such as `blk.17.*`, and a permutation
+    /// sorted by reversed name answers queries such as `*_exps.weight`, neither scanning every
+    /// tensor.
+    public struct TensorTable: Sendable, RandomAccessCollection {
+        public typealias Index = Int
+
+        /// Name bytes of every tensor, back to back
+        private var nameBytes: [UInt8] = []
+        /// End of each name in `nameBytes`; a name starts where the previous one ends
+        private var nameEnds: [Int32] = []
+        /// Dimensions of every tensor, back to back
+        private var dimensionValues: [UInt64] = []
+        /// End of each tensor's dimensions in `dimensionValues`
+        private var dimensionEnds: [Int32] = []
+        /// Open-addressing hash table of tensor indices keyed by name; -1 marks a free slot
+        private var slots: [Int32] = []
+        /// Tensor indices ordered by name bytes
+        private var sortedIndices: [Int32] = []
+        /// Tensor indices ordered by name bytes read from the end
+        private var reverseSortedIndices: [Int32] = []
+
+        public private(set) var dataTypes: [TensorType] = []
+        /// Offsets of the payloads relative to the start of the data section
+        public private(set) var offsets: [UInt64] = []
+        public private(set) var elementCounts: [UInt64] = []
+        public private(set) var sizesInBytes: [Int] = []
+        /// Offsets of the payloads from the start of the file
+        public private(set) var fileOffsets: [Int] = []
+
+        public var startIndex: Int { 0 }
+        public var endIndex: Int { nameEnds.count }
+
+        /// Builds the table from materialized infos, e.g. ones collected by a writer
+        /// - Precondition: Tensor names are unique
+        public init(_ infos: some Sequence<TensorInfo>, dataOffset: Int = 0) {
+            for info in infos {
+                append(
+                    name: info.name.utf8,
+                    dimensions: info.dimensions,
+                    dataType: info.dataType,
+                    offset: info.offset
+                )
+            }
+            do {
+                try buildIndex()
+            } catch {
+                preconditionFailure("\(error)")
+            }
+            setDataOffset(dataOffset)
+        }
+
+        /// Parses `count` tensor infos in the layout `TensorInfo(parsing:)` reads
+        init(parsing input: inout ParserSpan, count: Int) throws {
+            nameEnds.reserveCapacity(count)
+            dimensionEnds.reserveCapacity(count)
+            dataTypes.reserveCapacity(count)
+            offsets.reserveCapacity(count)
+            elementCounts.reserveCapacity(count)
+            sizesInBytes.reserveCapacity(count)
+            dimensionValues.reserveCapacity(count * 2)
+            nameBytes.reserveCapacity(count * 24)
+            for _ in 0..<count {
+                try appendParsing(&input)
+            }
+            try buildIndex()
+        }
+
+        public subscript(position: Int) -> TensorInfo {
+            let dimensions = Array(dimensions(at: position))
+            return TensorInfo(
+                name: name(at: position),
+                dimensionCount: UInt32(dimensions.count),
+                dimensions: dimensions,
+                dataType: dataTypes[position],
+                offset: offsets[position]
+            )
+        }
+
+        // MARK: - Columns
+
+        public func name(at index: Int) -> String {
+            String(decoding: nameBytes[nameRange(at: index)], as: UTF8.self)
+        }
+
+        public func dimensions(at index: Int) -> ArraySlice<UInt64> {
+            let start = index == 0 ? 0 : Int(dimensionEnds[index - 1])
+            return dimensionValues[start..<Int(dimensionEnds[index])]
+        }
+
+        /// Position of a tensor's payload in the file
+        public func byteRange(at index: Int) -> Range<Int> {
+            fileOffsets[index]..<(fileOffsets[index] + sizesInBytes[index])
+        }
+
+        /// Number of elements in one row (the first, innermost dimension)
+        public func rowLength(at index: Int) -> Int {
+            Int(dimensions(at: index).first ?? 1)
+        }
+
+        /// Number of rows, i.e. the product of all dimensions except the first
+        public func rowCount(at index: Int) -> Int {
+            let rowLength = rowLength(at: index)
+            return rowLength == 0 ? 0 : Int(elementCounts[index]) / rowLength
+        }
+
+        // MARK: - Lookup
+
+        /// Index of the tensor called `name`, or nil if there is none
+        public func index(named name: String) -> Int? {
+            var name = name
+            return name.withUTF8 { name in
+                guard !slots.isEmpty else {
+                    return nil
+                }
+                let mask = slots.count - 1
+                var slot = Self.hash(name) & mask
+                while slots[slot] >= 0 {
+                    let index = Int(slots[slot])
+                    if nameBytes[nameRange(at: index)].elementsEqual(name) {
+                        return index
+                    }
+                    slot = (slot + 1) & mask
+                }
+                return nil
+            }
+        }
+
+        /// Indices of the tensors whose names start with `prefix`, in ascending order
+        public func indices(withPrefix prefix: String) -> [Int] {
+            let range = sortedRange(withPrefix: Array(prefix.utf8))
+            return sortedIndices[range].map(Int.init).sorted()
+        }
+
+        /// Indices of the tensors whose names match `pattern`, in ascending order. `*` matches
+        /// any run of bytes, dots included; every other byte matches itself.
+        ///
+        /// The literal prefix before the first `*` and the literal suffix after the last one
+        /// narrow the search through the sorted name indices, whichever leaves fewer names.
+        /// Only a pattern that starts and ends with `*`, such as `*.ffn_*`, checks every name.
+        public func indices(matching pattern: String) -> [Int] {
+            let pattern = Array(pattern.utf8)
+            let star = UInt8(ascii: "*")
+            let literalPrefix = pattern.prefix { $0 != star }
+            let literalSuffix = pattern.reversed().prefix { $0 != star }
+            let candidates: ArraySlice<Int32>
+            let byPrefix = sortedRange(withPrefix: Array(literalPrefix))
+            if literalPrefix.count < pattern.count, !literalSuffix.isEmpty {
+                let bySuffix = reverseSortedRange(withSuffix: Array(literalSuffix))
+                candidates =
+                    bySuffix.count < byPrefix.count
+                    ? reverseSortedIndices[bySuffix] : sortedIndices[byPrefix]
+            } else {
+                candidates = sortedIndices[byPrefix]
+            }
+            return candidates.lazy.map(Int.init).filter { index in
+                Self.glob(pattern[...], matches: nameBytes[nameRange(at: index)])
+            }.sorted()
+        }
+
+        /// Indices of the tensors of repeating block `block` (names starting `blk.<block>.`)
+        public func indices(inBlock block: Int) -> [Int] {
+            indices(withPrefix: "blk.\(block).")
+        }
+
+        // MARK: - Building
+
+        private mutating func appendParsing(_ input: inout ParserSpan) throws {
+            let length = try UInt64(parsingLittleEndian: &input)
+            guard let length = Int(exactly: length) else {
+                throw Error.invalidStringCount(length)
+            }
+            guard length <= Constants.maxTensorNameBytes else {
+                let name = try [UInt8](parsing: &input, byteCount: length)
+                throw Error.invalidTensorName(String(decoding: name, as: UTF8.self))
+            }
+            let start = nameBytes.count
+            for _ in 0..<length {
+                nameBytes.append(try UInt8(parsing: &input))
+            }
+            let name = nameBytes[start...]
+            guard name.isValidUTF8 else {
+                throw Error.invalidTensorName(String(decoding: name, as: UTF8.self))
+            }
+            nameEnds.append(Int32(nameBytes.count))
+
+            let dimensionCount = try UInt32(parsingLittleEndian: &input)
+            guard let dimensionCountInt = Int(exactly: dimensionCount) else {
+                throw Error.invalidTensorDimensionCount(dimensionCount)
+            }
+            guard dimensionCountInt <= input.count / 8 else {
+                throw Error.insufficientData
+            }
+            var elementCount: UInt64 = 1
+            for _ in 0..<dimensionCountInt {
+                let dimension = try UInt64(parsingLittleEndian: &input)
+                dimensionValues.append(dimension)
+                let (product, overflow) = elementCount.multipliedReportingOverflow(by: dimension)
+                guard !overflow, product <= Int.max else {
+                    throw Error.invalidTensorDimensionCount(dimensionCount)
+                }
+                elementCount = product
+            }
+            dimensionEnds.append(Int32(dimensionValues.count))
+            let dataType = try TensorType(parsing: &input)
+            // Keeps `sizeInBytes` from overflowing on hostile dimensions
+            let maximumCount = (Int.max - dataType.blockSize) / max(1, dataType.bytesPerBlock)
+            guard elementCount <= UInt64(maximumCount) else {
+                throw Error.invalidTensorDimensionCount(dimensionCount)
+            }
+            dataTypes.append(dataType)
+            offsets.append(try UInt64(parsingLittleEndian: &input))
+            elementCounts.append(elementCount)
+            sizesInBytes.append(dataType.sizeInBytes(elementCount: elementCount))
+        }
+
+        private mutating func append(
+            name: String.UTF8View,
+            dimensions: [UInt64],
+            dataType: TensorType,
+            offset: UInt64
+        ) {
+            nameBytes.append(contentsOf: name)
+            nameEnds.append(Int32(nameBytes.count))
+            dimensionValues.append(contentsOf: dimensions)
+            dimensionEnds.append(Int32(dimensionValues.count))
+            let elementCount = dimensions.reduce(1, *)
+            dataTypes.append(dataType)
+            offsets.append(offset)
+            elementCounts.append(elementCount)
+            sizesInBytes.append(dataType.sizeInBytes(elementCount: elementCount))
+        }
+
+        /// Fills the hash table and the sorted permutation
+        /// - Throws: `duplicateTensorName` if two tensors share a name
+        private mutating func buildIndex() throws {
+            var capacity = 1
+            while capacity < count * 2 {
+                capacity <<= 1
+            }
+            slots = Array(repeating: -1, count: count == 0 ? 0 : capacity)
+            let mask = capacity - 1
+            for index in 0..<count {
+                let name = nameBytes[nameRange(at: index)]
+                var slot = name.withContiguousStorageIfAvailable(Self.hash)! & mask
+                while slots[slot] >= 0 {
+                    if nameBytes[nameRange(at: Int(slots[slot]))].elementsEqual(name) {
+                        throw Error.duplicateTensorName(self.name(at: index))
+                    }
+                    slot = (slot + 1) & mask
+                }
+                slots[slot] = Int32(index)
+            }
+            sortedIndices = (0..<Int32(count)).sorted { lhs, rhs in
+                nameBytes[nameRange(at: Int(lhs))].lexicographicallyPrecedes(
+                    nameBytes[nameRange(at: Int(rhs))])
+            }
+            reverseSortedIndices = (0..<Int32(count)).sorted { lhs, rhs in
+                nameBytes[nameRange(at: Int(lhs))].reversed().lexicographicallyPrecedes(
+                    nameBytes[nameRange(at: Int(rhs))].reversed())
+            }
+        }
+
+        /// Resolves `offsets` against the start of the data section. Offsets past `Int.max`
+        /// are clamped; `GGUF.verify(fileData:)` reports them as out of bounds.
+        mutating func setDataOffset(_ dataOffset: Int) {
+            fileOffsets = offsets.map { dataOffset + min(Int(clamping: $0), Int.max - dataOffset) }
+        }
+
+        // MARK: - Helpers
+
+        private func nameRange(at index: Int) -> Range<Int> {
+            (index == 0 ? 0 : Int(nameEnds[index - 1]))..<Int(nameEnds[index])
+        }
+
+        /// Positions in `sortedIndices` of the names starting with `prefix`
+        private func sortedRange(withPrefix prefix: [UInt8]) -> Range<Int> {
+            range(in: sortedIndices, startingWith: prefix) { $0 }
+        }
+
+        /// Positions in `reverseSortedIndices` of the names ending with the reversed bytes of
+        /// `reversedSuffix`
+        private func reverseSortedRange(withSuffix reversedSuffix: [UInt8]) -> Range<Int> {
+            range(in: reverseSortedIndices, startingWith: reversedSuffix) { $0.reversed() }
+        }
+
+        /// Positions in `order`, which is sorted by `key` of the names, of the names whose key
+        /// starts with `prefix`
+        private func range<Key: Sequence<UInt8>>(
+            in order: [Int32],
+            startingWith prefix: [UInt8],
+            key: (ArraySlice<UInt8>) -> Key
+        ) -> Range<Int> {
+            var low = 0
+            var high = order.count
+            while low < high {
+                let middle = (low + high) / 2
+                if key(nameBytes[nameRange(at: Int(order[middle]))]).lexicographicallyPrecedes(
+                    prefix)
+                {
+                    low = middle + 1
+                } else {
+                    high = middle
+                }
+            }
+            var end = low
+            while end < order.count,
+                key(nameBytes[nameRange(at: Int(order[end]))]).starts(with: prefix)
+            {
+                end += 1
+            }
+            return low..<end
+        }
+
+        /// FNV-1a
+        private static func hash(_ bytes: UnsafeBufferPointer<UInt8>) -> Int {
+            var hash: UInt64 = 0xcbf2_9ce4_8422_2325
+            for byte in bytes {
+                hash = (hash ^ UInt64(byte)) &* 0x100_0000_01b3
+            }
+            return Int(truncatingIfNeeded: hash)
+        }
+
+        /// Wildcard match where `*` matches any run of bytes
+        private static func glob(_ pattern: ArraySlice<UInt8>, matches name: ArraySlice<UInt8>)
+            -> Bool
+        {
+            let star = UInt8(ascii: "*")
+            var p = pattern.startIndex
+            var n = name.startIndex
+            // Last `*` seen and the name position it is currently assumed to extend to
+            var backtrack: (pattern: Int, name: Int)?
+            while n < name.endIndex {
+                if p < pattern.endIndex, pattern[p] == star {
+                    backtrack = (p, n)
+                    p += 1
+                } else if p < pattern.endIndex, pattern[p] == name[n] {
+                    p += 1
+                    n += 1
+                } else if let star = backtrack {
+                    p = star.pattern + 1
+                    n = star.name + 1
+                    backtrack = (star.pattern, star.name + 1)
+                } else {
+                    return false
+                }
+            }
+            return pattern[p...].allSatisfy { $0 == star }
+        }
+    }
+}
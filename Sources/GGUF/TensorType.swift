@@ -1,4 +1,5 @@
 import BinaryParsing
+import Quants
 
 extension GGUF {
     public enum TensorType: UInt32, Sendable {
@@ -88,9 +89,9 @@ extension GGUF.TensorType: CustomStringConvertible {
     /// Block size for quantized types (number of elements per block)
     public var blockSize: Int {
         switch self {
-        case .q4_0, .q4_1, .q5_0, .q5_1, .q8_0, .q8_1: 32
+        case .q4_0, .q4_1, .q5_0, .q5_1, .q8_0, .q8_1, .iq4_NL: 32
         case .q2_K, .q3_K, .q4_K, .q5_K, .q6_K, .q8_K: 256
-        case .iq2_XXS, .iq2_XS, .iq3_XXS, .iq1_S, .iq4_NL, .iq3_S, .iq2_S, .iq4_XS, .iq1_M: 256
+        case .iq2_XXS, .iq2_XS, .iq3_XXS, .iq1_S, .iq3_S, .iq2_S, .iq4_XS, .iq1_M: 256
         case .tq1_0, .tq2_0: 256
         case .mxfp4: 32
         default: 1  // Non-quantized types
@@ -113,6 +114,7 @@ extension GGUF.TensorType: CustomStringConvertible {
         case .q5_1: 24  // 32 elements in 24 bytes (4 + 4 + 16)
         case .q8_0: 34  // 32 elements in 34 bytes (2 + 32)
         case .q8_1: 36  // 32 elements in 36 bytes (4 + 4 + 32)
+        case .iq4_NL: 18  // 32 elements in 18 bytes (2 + 16)
 
         // K-quantizations (256 elements per block)
         case .q2_K: 82  // 256 elements in 82 bytes
@@ -127,18 +129,71 @@ extension GGUF.TensorType: CustomStringConvertible {
         case .iq2_XS: 74
         case .iq3_XXS: 98
         case .iq1_S: 50
-        case .iq4_NL: 130
         case .iq3_S: 110
         case .iq2_S: 82
         case .iq4_XS: 136
         case .iq1_M: 56
 
         // Ternary quantizations
-        case .tq1_0: 34
-        case .tq2_0: 68
+        case .tq1_0: 54  // 256 elements in 54 bytes (48 + 4 + 2)
+        case .tq2_0: 66  // 256 elements in 66 bytes (64 + 2)
 
-        // Mixed precision
-        case .mxfp4: 20
+        // Microscaling
+        case .mxfp4: 17  // 32 elements in 17 bytes (1 + 16)
+        }
+    }
+
+    /// Block format used by the `Quants` kernels, or nil if this type has no dequantization kernel
+    public var blockFormat: BlockFormat? {
+        switch self {
+        case .q4_0: .q4_0
+        case .q4_1: .q4_1
+        case .q5_0: .q5_0
+        case .q5_1: .q5_1
+        case .q8_0: .q8_0
+        case .q2_K: .q2_K
+        case .q3_K: .q3_K
+        case .q4_K: .q4_K
+        case .q5_K: .q5_K
+        case .q6_K: .q6_K
+        case .q8_K: .q8_K
+        case .q8_1: .q8_1
+        case .iq2_XXS: .iq2_XXS
+        case .iq2_XS: .iq2_XS
+        case .iq2_S: .iq2_S
+        case .iq3_XXS: .iq3_XXS
+        case .iq3_S: .iq3_S
+        case .iq1_S: .iq1_S
+        case .iq1_M: .iq1_M
+        case .iq4_NL: .iq4_NL
+        case .iq4_XS: .iq4_XS
+        case .tq1_0: .tq1_0
+        case .tq2_0: .tq2_0
+        case .mxfp4: .mxfp4
+        default: nil
+        }
+    }
+
+    /// 16-bit float encoding of this type, or nil if it is not a half precision type
+    public var halfFormat: HalfFormat? {
+        switch self {
+        case .f16: .f16
+        case .bf16: .bf16
+        default: nil
+        }
+    }
+
+    /// Plain element encoding of this type, or nil for f32 and block types
+    public var elementFormat: ElementFormat? {
+        switch self {
+        case .f16: .f16
+        case .bf16: .bf16
+        case .f64: .f64
+        case .i8: .i8
+        case .i16: .i16
+        case .i32: .i32
+        case .i64: .i64
+        default: nil
         }
     }
 
@@ -10,10 +10,30 @@ extension GGUF {
         case invalidTensorCount(UInt64)
         case invalidTensorDimensionCount(UInt32)
         case invalidArrayLength(UInt64)
+        /// A string in a lazily decoded metadata array is not valid UTF-8
+        case invalidUTF8String
+        /// The input ends before the value being parsed, e.g. a partial header region
+        case insufficientData
         case invalidMagicNumber(UInt32)
         case invalidAlignmentPadding
         case notSupportedVersion(UInt32)
         case unsupportedTensorTypeForConversion(TensorType)
+        case unalignedTensorRows(String)
+        case invalidRowRange(Range<Int>)
+        case invalidOutputBufferSize(Int)
+        case invalidVectorLength(Int)
+        case invalidAlignment(Int)
+        case duplicateMetadataKey(String)
+        case duplicateTensorName(String)
+        case metadataTypeMismatch(String)
+        case tensorPayloadSizeMismatch(String, expected: Int, actual: Int)
+        case fileReadFailed(errno: Int32)
+        /// Creating, writing or renaming an output file failed, e.g. on a full disk
+        case fileWriteFailed(errno: Int32)
+        /// A cache file was replaced by one for another model or precision while in use
+        case staleCache
+        case unexpectedEndOfFile(expected: Int, actual: Int)
+        case invalidSplit(String)
     }
 }
 
@@ -25,11 +45,44 @@ extension GGUF {
     }
 }
 
-extension Data {
-    func toArray<T>(of type: T.Type, _ fn: (T) -> Float) -> [Float] {
-        withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            let inputBuffer = ptr.bindMemory(to: T.self)
-            return inputBuffer.map { fn($0) }
+extension [UInt8] {
+    /// Appends `value` in little-endian byte order
+    mutating func appendLittleEndian<T: FixedWidthInteger>(_ value: T) {
+        Swift.withUnsafeBytes(of: value.littleEndian) { append(contentsOf: $0) }
+    }
+
+    /// Appends `value` in big-endian byte order
+    mutating func appendBigEndian<T: FixedWidthInteger>(_ value: T) {
+        Swift.withUnsafeBytes(of: value.bigEndian) { append(contentsOf: $0) }
+    }
+
+    /// Appends `count` zero bytes
+    mutating func appendZeros(count: Int) {
+        append(contentsOf: repeatElement(0, count: count))
+    }
+}
+
+extension Sequence<UInt8> {
+    /// Whether the bytes are well-formed UTF-8
+    var isValidUTF8: Bool {
+        var iterator = makeIterator()
+        var decoder = UTF8()
+        while true {
+            switch decoder.decode(&iterator) {
+            case .scalarValue:
+                continue
+            case .emptyInput:
+                return true
+            case .error:
+                return false
+            }
         }
     }
 }
+
+extension Int {
+    /// Rounds up to the next multiple of `alignment`
+    func aligned(to alignment: Int) -> Int {
+        (self + alignment - 1) / alignment * alignment
+    }
+}
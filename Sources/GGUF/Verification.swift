@@ -0,0 +1,205 @@
+import Dispatch
+import Foundation
+import Quants
+
+extension GGUF {
+    /// Problems `verify(fileData:)` can find in a tensor
+    public struct TensorIssues: OptionSet, Sendable, Hashable {
+        public let rawValue: UInt8
+
+        public init(rawValue: UInt8) {
+            self.rawValue = rawValue
+        }
+
+        /// The payload ends past the end of the file
+        public static let outOfBounds = TensorIssues(rawValue: 1 << 0)
+        /// The offset is not a multiple of the file's alignment
+        public static let misaligned = TensorIssues(rawValue: 1 << 1)
+        /// The payload shares bytes with another tensor's payload
+        public static let overlapping = TensorIssues(rawValue: 1 << 2)
+        /// A block scale or an f16/bf16/f32 value is NaN or infinite
+        public static let nonFinite = TensorIssues(rawValue: 1 << 3)
+    }
+
+    /// Result of verifying one tensor
+    public struct TensorVerification: Sendable, Hashable {
+        /// Index of the tensor in tensorInfos array
+        public let index: Int
+        public let name: String
+        public var issues: TensorIssues = []
+        /// Number of NaN or infinite scale fields (quantized tensors) or values (f16, bf16 and
+        /// f32 tensors). Tensors with layout issues are not scanned.
+        public var nonFiniteCount = 0
+        /// Index of a tensor whose payload overlaps this one, if any
+        public var overlappingIndex: Int?
+
+        public var isValid: Bool { issues.isEmpty }
+    }
+
+    /// Per-tensor results of `verify(fileData:)`
+    public struct VerificationReport: Sendable {
+        /// One entry per tensor, in tensorInfos order
+        public let tensors: [TensorVerification]
+
+        /// Whether every tensor passed
+        public var isValid: Bool {
+            tensors.allSatisfy(\.isValid)
+        }
+
+        /// Tensors with at least one issue
+        public var failures: [TensorVerification] {
+            tensors.filter { !$0.isValid }
+        }
+    }
+
+    /// Checks that the tensor layout is safe to read and, optionally, that the data holds no
+    /// NaN or infinite values.
+    ///
+    /// `init(parsing:)` only validates the header and metadata. A file from an untrusted
+    /// source can still describe tensors past the end of the file, overlapping each other or
+    /// off the alignment grid, and `tensorData(at:from:)` traps on the first of those. Run
+    /// this before reading tensors of such a file.
+    ///
+    /// The layout check sorts the tensors by offset, so it runs in O(n log n) for n tensors.
+    /// The value scan reads the scale fields of quantized blocks (`d`, `dmin`, ...) and every
+    /// value of f16, bf16 and f32 tensors with the SIMD kernels of `NonFinite`. Large
+    /// tensors are split into chunks; small ones are scanned concurrently.
+    /// - Parameters:
+    ///   - fileData: The complete GGUF file data
+    ///   - scanValues: Whether to scan scales and float payloads after the layout check
+    ///   - parallelism: How to split the scan across threads
+    ///   - simdLevel: Kernels to use
+    /// - Returns: One result per tensor
+    public func verify(
+        fileData: Data,
+        scanValues: Bool = true,
+        parallelism: Parallelism = .automatic,
+        simdLevel: SIMDLevel = .best
+    ) -> VerificationReport {
+        var results = tensorInfos.indices.map {
+            TensorVerification(index: $0, name: tensorInfos.name(at: $0))
+        }
+        verifyLayout(fileSize: fileData.count, into: &results)
+        if scanValues {
+            scanNonFinite(
+                fileData: fileData, into: &results, parallelism: parallelism,
+                simdLevel: simdLevel)
+        }
+        return VerificationReport(tensors: results)
+    }
+
+    // MARK: - Helpers
+
+    /// Flags out-of-bounds, misaligned and overlapping payloads
+    private func verifyLayout(fileSize: Int, into results: inout [TensorVerification]) {
+        let dataSize = UInt64(max(0, fileSize - tensorDataOffset))
+        let alignment = UInt64(max(1, self.alignment))
+        for index in tensorInfos.indices {
+            let offset = tensorInfos.offsets[index]
+            let size = UInt64(tensorInfos.sizesInBytes[index])
+            if offset > dataSize || size > dataSize - offset {
+                results[index].issues.insert(.outOfBounds)
+            }
+            if offset % alignment != 0 {
+                results[index].issues.insert(.misaligned)
+            }
+        }
+
+        // After sorting by offset a payload can only overlap the ones that start before the
+        // furthest end seen so far
+        let order = tensorInfos.indices.sorted {
+            tensorInfos.offsets[$0] < tensorInfos.offsets[$1]
+        }
+        var furthest: (end: UInt64, index: Int)?
+        for index in order {
+            let offset = tensorInfos.offsets[index]
+            let size = UInt64(tensorInfos.sizesInBytes[index])
+            let (end, overflow) = offset.addingReportingOverflow(size)
+            let clampedEnd = overflow ? UInt64.max : end
+            if size > 0, let previous = furthest, offset < previous.end {
+                results[index].issues.insert(.overlapping)
+                results[index].overlappingIndex = previous.index
+                if !results[previous.index].issues.contains(.overlapping) {
+                    results[previous.index].issues.insert(.overlapping)
+                    results[previous.index].overlappingIndex = index
+                }
+            }
+            if size > 0, clampedEnd > furthest?.end ?? 0 {
+                furthest = (clampedEnd, index)
+            }
+        }
+    }
+
+    /// Counts non-finite scales or values of every tensor whose layout is valid
+    private func scanNonFinite(
+        fileData: Data,
+        into results: inout [TensorVerification],
+        parallelism: Parallelism,
+        simdLevel: SIMDLevel
+    ) {
+        let scannable = tensorInfos.indices.filter { index in
+            results[index].isValid && Self.scanEncoding(of: tensorInfos.dataTypes[index]) != nil
+        }
+        // Tensors too small to split are scanned side by side instead
+        let isLarge = { (index: Int) in
+            Int(self.tensorInfos.elementCounts[index]) >= 2 * parallelism.minimumChunkSize
+        }
+        let large = scannable.filter(isLarge)
+        let small = scannable.filter { !isLarge($0) }
+
+        var counts = [Int](repeating: 0, count: tensorInfos.count)
+        fileData.withUnsafeBytes { bytes in
+            let scan = { (index: Int, parallelism: Parallelism) -> Int in
+                let range = tensorInfos.byteRange(at: index)
+                let payload = UnsafeRawBufferPointer(rebasing: bytes[range])
+                switch Self.scanEncoding(of: tensorInfos.dataTypes[index]) {
+                case .scales(let format):
+                    return NonFinite.countScales(
+                        in: payload, format: format, parallelism: parallelism,
+                        simdLevel: simdLevel)
+                case .values(let encoding):
+                    return NonFinite.count(
+                        in: payload, encoding: encoding, parallelism: parallelism,
+                        simdLevel: simdLevel)
+                case nil:
+                    return 0
+                }
+            }
+            for index in large {
+                counts[index] = scan(index, parallelism)
+            }
+            counts.withUnsafeMutableBufferPointer { counts in
+                let workers = min(parallelism.maxConcurrency, small.count)
+                guard workers > 0 else {
+                    return
+                }
+                DispatchQueue.concurrentPerform(iterations: workers) { worker in
+                    // Each worker writes only the slots of its own tensors
+                    for position in stride(from: worker, to: small.count, by: workers) {
+                        counts[small[position]] = scan(small[position], .serial)
+                    }
+                }
+            }
+        }
+
+        for index in scannable where counts[index] > 0 {
+            results[index].issues.insert(.nonFinite)
+            results[index].nonFiniteCount = counts[index]
+        }
+    }
+
+    private enum ScanEncoding {
+        case scales(BlockFormat)
+        case values(NonFinite.Encoding)
+    }
+
+    /// What to scan in a tensor of `type`, or nil for integer and unsupported types
+    private static func scanEncoding(of type: TensorType) -> ScanEncoding? {
+        switch type {
+        case .f32: .values(.f32)
+        case .f16: .values(.f16)
+        case .bf16: .values(.bf16)
+        default: type.blockFormat.map(ScanEncoding.scales)
+        }
+    }
+}
@@ -0,0 +1,274 @@
+import Foundation
+
+extension GGUF {
+    /// Where a tensor's payload bytes come from when a file is written
+    public enum TensorSource: Sendable {
+        /// Bytes already in memory (or memory-mapped)
+        case data(Data)
+        /// `sizeInBytes` bytes of another file starting at `offset`, read in large chunks
+        case file(URL, offset: Int)
+        /// Bytes produced on demand; the closure passes every chunk to `emit` in order
+        case stream(@Sendable (_ emit: (UnsafeRawBufferPointer) throws -> Void) throws -> Void)
+    }
+
+    /// Serializes a GGUF file using the same layout rules the parser enforces.
+    ///
+    /// Tensor payloads are only read while the file is being written, and are streamed
+    /// through a fixed-size buffer, so the whole model never has to be in memory.
+    /// Parsing the output with `GGUF(parsing:)` gives back `layout`.
+    public struct Writer: Sendable {
+        public private(set) var metadata: [MetadataKeyValue]
+        public private(set) var tensorInfos: [TensorInfo] = []
+        /// Tensor alignment, taken from `general.alignment` like the parser does
+        public let alignment: Int
+        private var sources: [TensorSource] = []
+        private let metadataBytes: [UInt8]
+        private var tensorNames: Set<String> = []
+        private var tensorDataSize = 0
+
+        /// - Parameter metadata: Key-value pairs written in order. Set `general.alignment`
+        ///   (uint32) to use an alignment other than 32.
+        /// - Throws: Error if a key repeats, a value does not match its type, or the alignment
+        ///   is not positive
+        public init(metadata: [MetadataKeyValue] = []) throws {
+            var keys: Set<String> = []
+            var metadataBytes: [UInt8] = []
+            for entry in metadata {
+                guard keys.insert(entry.key).inserted else {
+                    throw Error.duplicateMetadataKey(entry.key)
+                }
+                // Metadata is small next to the tensors, so it is serialized (and validated) once
+                try entry.serialize(into: &metadataBytes)
+            }
+            let alignment = GGUF.extractAlignment(
+                from: Dictionary(uniqueKeysWithValues: metadata.map { ($0.key, $0.value) }))
+            guard alignment > 0 else {
+                throw Error.invalidAlignment(alignment)
+            }
+            self.metadata = metadata
+            self.metadataBytes = metadataBytes
+            self.alignment = alignment
+        }
+
+        /// Appends a tensor. Its offset is the next aligned position in the data section.
+        /// - Parameters:
+        ///   - name: Unique tensor name, at most 64 bytes of UTF-8
+        ///   - dimensions: Dimensions, innermost first
+        ///   - dataType: Element type of the payload
+        ///   - source: Where to read the `sizeInBytes` payload bytes from
+        /// - Throws: Error if the name is too long or already used
+        public mutating func addTensor(
+            name: String,
+            dimensions: [UInt64],
+            dataType: TensorType,
+            source: TensorSource
+        ) throws {
+            guard name.utf8.count <= Constants.maxTensorNameBytes else {
+                throw Error.invalidTensorName(name)
+            }
+            guard tensorNames.insert(name).inserted else {
+                throw Error.duplicateTensorName(name)
+            }
+            let info = TensorInfo(
+                name: name,
+                dimensionCount: UInt32(dimensions.count),
+                dimensions: dimensions,
+                dataType: dataType,
+                offset: UInt64(tensorDataSize)
+            )
+            tensorInfos.append(info)
+            sources.append(source)
+            tensorDataSize = (tensorDataSize + info.sizeInBytes).aligned(to: alignment)
+        }
+
+        /// The structure `GGUF(parsing:)` returns for the written file
+        public var layout: GGUF {
+            let metadataKeyToValue = Dictionary(
+                uniqueKeysWithValues: metadata.map { ($0.key, $0.value) })
+            return GGUF(
+                header: header,
+                metadata: metadata,
+                tensorInfos: TensorTable(tensorInfos),
+                metadataKeyToValue: metadataKeyToValue,
+                tensorDataOffset: tensorDataOffset,
+                alignment: alignment
+            )
+        }
+
+        /// Total size of the written file in bytes
+        public var fileSize: Int {
+            tensorDataOffset + tensorDataSize
+        }
+
+        /// Offset of the data section, i.e. the aligned size of everything before it
+        public var tensorDataOffset: Int {
+            let prefixSize =
+                24 + metadataBytes.count
+                + tensorInfos.reduce(0) { size, info in
+                    size + 8 + info.name.utf8.count + 4 + 8 * info.dimensions.count + 4 + 8
+                }
+            return prefixSize.aligned(to: alignment)
+        }
+
+        /// Writes the file to `url`, replacing any existing file
+        /// - Parameters:
+        ///   - url: Destination file
+        ///   - bufferSize: Size of the sequential writes issued to the file
+        public func write(to url: URL, bufferSize: Int = 1 << 22) throws {
+            FileManager.default.createFile(atPath: url.path, contents: nil)
+            let handle = try FileHandle(forWritingTo: url)
+            defer { try? handle.close() }
+            try handle.truncate(atOffset: 0)
+            try write(to: handle, bufferSize: bufferSize)
+        }
+
+        /// Writes the file at the current position of `handle`
+        /// - Parameters:
+        ///   - handle: Destination, open for writing
+        ///   - bufferSize: Size of the sequential writes issued to the handle
+        public func write(to handle: FileHandle, bufferSize: Int = 1 << 22) throws {
+            var sink = OutputSink(capacity: bufferSize) { bytes in
+                guard let base = bytes.baseAddress else {
+                    return
+                }
+                let data = Data(
+                    bytesNoCopy: UnsafeMutableRawPointer(mutating: base),
+                    count: bytes.count,
+                    deallocator: .none
+                )
+                try handle.write(contentsOf: data)
+            }
+            try write(to: &sink)
+        }
+
+        /// Serializes the whole file into memory; meant for small files and tests
+        public func serializedData() throws -> Data {
+            var data = Data(capacity: fileSize)
+            var sink = OutputSink(capacity: 1 << 16) { data.append(contentsOf: $0) }
+            try write(to: &sink)
+            return data
+        }
+
+        // MARK: - Helpers
+
+        private var header: Header {
+            Header(
+                magic: Constants.headerMagic,
+                version: 3,
+                tensorCount: UInt64(tensorInfos.count),
+                metadataKeyValueCount: UInt64(metadata.count)
+            )
+        }
+
+        /// Header, metadata, tensor infos and the zero padding up to the data section
+        private func serializedPrefix() -> [UInt8] {
+            var output: [UInt8] = []
+            output.reserveCapacity(tensorDataOffset)
+            header.serialize(into: &output)
+            output += metadataBytes
+            for info in tensorInfos {
+                info.serialize(into: &output)
+            }
+            output.appendZeros(count: output.count.aligned(to: alignment) - output.count)
+            return output
+        }
+
+        private func write(to sink: inout OutputSink) throws {
+            try sink.write(serializedPrefix())
+            var position = 0
+            for (info, source) in zip(tensorInfos, sources) {
+                try sink.writeZeros(count: Int(info.offset) - position)
+                let written = try Self.copy(source, byteCount: info.sizeInBytes, into: &sink)
+                guard written == info.sizeInBytes else {
+                    throw Error.tensorPayloadSizeMismatch(
+                        info.name,
+                        expected: info.sizeInBytes,
+                        actual: written
+                    )
+                }
+                position = Int(info.offset) + written
+            }
+            try sink.writeZeros(count: tensorDataSize - position)
+            try sink.flush()
+        }
+
+        /// Copies a payload into `sink` and returns the number of bytes it produced. File
+        /// sources stop at `byteCount`; the other sources are copied whole and checked after.
+        private static func copy(
+            _ source: TensorSource,
+            byteCount: Int,
+            into sink: inout OutputSink
+        ) throws -> Int {
+            switch source {
+            case .data(let data):
+                try data.withUnsafeBytes { try sink.write($0) }
+                return data.count
+            case .file(let url, let offset):
+                let handle = try FileHandle(forReadingFrom: url)
+                defer { try? handle.close() }
+                try handle.seek(toOffset: UInt64(offset))
+                var copied = 0
+                while copied < byteCount {
+                    let chunk = min(sink.capacity, byteCount - copied)
+                    guard let data = try handle.read(upToCount: chunk), !data.isEmpty else {
+                        break
+                    }
+                    try data.withUnsafeBytes { try sink.write($0) }
+                    copied += data.count
+                }
+                return copied
+            case .stream(let produce):
+                var copied = 0
+                try produce { bytes in
+                    try sink.write(bytes)
+                    copied += bytes.count
+                }
+                return copied
+            }
+        }
+    }
+}
+
+/// Coalesces small writes into `capacity`-sized chunks; writes at least that large bypass the
+/// buffer and go straight to `flushBytes`
+struct OutputSink {
+    let capacity: Int
+    private var buffer: [UInt8] = []
+    private let flushBytes: (UnsafeRawBufferPointer) throws -> Void
+
+    init(capacity: Int, flushBytes: @escaping (UnsafeRawBufferPointer) throws -> Void) {
+        self.capacity = max(1, capacity)
+        self.flushBytes = flushBytes
+        buffer.reserveCapacity(self.capacity)
+    }
+
+    mutating func write(_ bytes: UnsafeRawBufferPointer) throws {
+        if buffer.count + bytes.count > capacity {
+            try flush()
+        }
+        if bytes.count >= capacity {
+            try flushBytes(bytes)
+        } else {
+            buffer.append(contentsOf: bytes)
+        }
+    }
+
+    mutating func write(_ bytes: [UInt8]) throws {
+        try bytes.withUnsafeBytes { try write($0) }
+    }
+
+    mutating func writeZeros(count: Int) throws {
+        guard count > 0 else {
+            return
+        }
+        try write([UInt8](repeating: 0, count: count))
+    }
+
+    mutating func flush() throws {
+        guard !buffer.isEmpty else {
+            return
+        }
+        try buffer.withUnsafeBytes { try flushBytes($0) }
+        buffer.removeAll(keepingCapacity: true)
+    }
+}
@@ -0,0 +1,208 @@
+import GGMLQuants
+
+/// Block-quantized layouts supported by the `Quants` kernels
+public enum BlockFormat: Sendable, CaseIterable {
+    case q4_0
+    case q4_1
+    case q5_0
+    case q5_1
+    case q8_0
+    case q2_K
+    case q3_K
+    case q4_K
+    case q5_K
+    case q6_K
+    case q8_K
+    case iq4_NL
+    case q8_1
+    case iq2_XXS
+    case iq2_XS
+    case iq2_S
+    case iq3_XXS
+    case iq3_S
+    case iq1_S
+    case iq1_M
+    case iq4_XS
+    case tq1_0
+    case tq2_0
+    case mxfp4
+
+    /// Number of elements per block
+    public var blockSize: Int {
+        switch self {
+        case .q4_0, .q4_1, .q5_0, .q5_1, .q8_0, .q8_1, .iq4_NL, .mxfp4: 32
+        case .q2_K, .q3_K, .q4_K, .q5_K, .q6_K, .q8_K: 256
+        case .iq2_XXS, .iq2_XS, .iq2_S, .iq3_XXS, .iq3_S, .iq1_S, .iq1_M, .iq4_XS: 256
+        case .tq1_0, .tq2_0: 256
+        }
+    }
+
+    /// Number of bytes per block
+    public var bytesPerBlock: Int {
+        switch self {
+        case .q4_0: MemoryLayout<block_q4_0>.size
+        case .q4_1: MemoryLayout<block_q4_1>.size
+        case .q5_0: MemoryLayout<block_q5_0>.size
+        case .q5_1: MemoryLayout<block_q5_1>.size
+        case .q8_0: MemoryLayout<block_q8_0>.size
+        case .q2_K: MemoryLayout<block_q2_K>.size
+        case .q3_K: MemoryLayout<block_q3_K>.size
+        case .q4_K: MemoryLayout<block_q4_K>.size
+        case .q5_K: MemoryLayout<block_q5_K>.size
+        case .q6_K: MemoryLayout<block_q6_K>.size
+        case .q8_K: MemoryLayout<block_q8_K>.size
+        case .iq4_NL: MemoryLayout<block_iq4_nl>.size
+        case .q8_1: MemoryLayout<block_q8_1>.size
+        case .iq2_XXS: MemoryLayout<block_iq2_xxs>.size
+        case .iq2_XS: MemoryLayout<block_iq2_xs>.size
+        case .iq2_S: MemoryLayout<block_iq2_s>.size
+        case .iq3_XXS: MemoryLayout<block_iq3_xxs>.size
+        case .iq3_S: MemoryLayout<block_iq3_s>.size
+        case .iq1_S: MemoryLayout<block_iq1_s>.size
+        case .iq1_M: MemoryLayout<block_iq1_m>.size
+        case .iq4_XS: MemoryLayout<block_iq4_xs>.size
+        case .tq1_0: MemoryLayout<block_tq1_0>.size
+        case .tq2_0: MemoryLayout<block_tq2_0>.size
+        case .mxfp4: MemoryLayout<block_mxfp4>.size
+        }
+    }
+
+    /// Dequantization kernel for this format at the given SIMD level
+    func dequantizeKernel(_ simdLevel: SIMDLevel) -> ggml_dequantize_row_t {
+        let kernels = simdLevel.dequantizeKernels.pointee
+        let kernel =
+            switch self {
+            case .q4_0: kernels.q4_0
+            case .q4_1: kernels.q4_1
+            case .q5_0: kernels.q5_0
+            case .q5_1: kernels.q5_1
+            case .q8_0: kernels.q8_0
+            case .q2_K: kernels.q2_K
+            case .q3_K: kernels.q3_K
+            case .q4_K: kernels.q4_K
+            case .q5_K: kernels.q5_K
+            case .q6_K: kernels.q6_K
+            case .q8_K: kernels.q8_K
+            case .iq4_NL: kernels.iq4_nl
+            case .q8_1: kernels.q8_1
+            case .iq2_XXS: kernels.iq2_xxs
+            case .iq2_XS: kernels.iq2_xs
+            case .iq2_S: kernels.iq2_s
+            case .iq3_XXS: kernels.iq3_xxs
+            case .iq3_S: kernels.iq3_s
+            case .iq1_S: kernels.iq1_s
+            case .iq1_M: kernels.iq1_m
+            case .iq4_XS: kernels.iq4_xs
+            case .tq1_0: kernels.tq1_0
+            case .tq2_0: kernels.tq2_0
+            case .mxfp4: kernels.mxfp4
+            }
+        return kernel!
+    }
+
+    /// Whether `Quantize` can produce this format. The IQ, ternary and MXFP4 layouts are
+    /// dequantize-only.
+    public var isQuantizable: Bool {
+        quantizeKernel(.scalar) != nil
+    }
+
+    /// Quantization kernel for this format at the given SIMD level, or nil if it is not
+    /// quantizable
+    func quantizeKernel(_ simdLevel: SIMDLevel) -> ggml_quantize_row_t? {
+        let kernels = simdLevel.quantizeKernels.pointee
+        return
+            switch self {
+            case .q4_0: kernels.q4_0
+            case .q4_1: kernels.q4_1
+            case .q5_0: kernels.q5_0
+            case .q5_1: kernels.q5_1
+            case .q8_0: kernels.q8_0
+            case .q2_K: kernels.q2_K
+            case .q3_K: kernels.q3_K
+            case .q4_K: kernels.q4_K
+            case .q5_K: kernels.q5_K
+            case .q6_K: kernels.q6_K
+            case .q8_K: kernels.q8_K
+            case .iq4_NL: kernels.iq4_nl
+            case .q8_1: kernels.q8_1
+            case .iq2_XXS, .iq2_XS, .iq2_S, .iq3_XXS, .iq3_S, .iq1_S, .iq1_M, .iq4_XS: nil
+            case .tq1_0, .tq2_0, .mxfp4: nil
+            }
+    }
+
+    /// 8-bit layout activations are quantized to for the integer dot products, or nil if the
+    /// format has no integer dot product and always dots against f32 activations
+    var activationLayout: ActivationLayout? {
+        switch self {
+        case .q4_0, .q5_0, .q8_0, .iq4_NL: .q8_0
+        case .q4_1, .q5_1: .q8_1
+        case .q2_K, .q3_K, .q4_K, .q5_K, .q6_K, .q8_K: .q8_K
+        case .q8_1, .iq2_XXS, .iq2_XS, .iq2_S, .iq3_XXS, .iq3_S, .iq1_S, .iq1_M, .iq4_XS: nil
+        case .tq1_0, .tq2_0, .mxfp4: nil
+        }
+    }
+
+    /// Integer dot product kernel for this format at the given SIMD level, or nil if the
+    /// format has no `activationLayout`
+    func vecDotKernel(_ simdLevel: SIMDLevel) -> ggml_vec_dot_t? {
+        let kernels = simdLevel.vecDotKernels.pointee
+        return
+            switch self {
+            case .q4_0: kernels.q4_0_q8_0
+            case .q4_1: kernels.q4_1_q8_1
+            case .q5_0: kernels.q5_0_q8_0
+            case .q5_1: kernels.q5_1_q8_1
+            case .q8_0: kernels.q8_0_q8_0
+            case .q2_K: kernels.q2_K_q8_K
+            case .q3_K: kernels.q3_K_q8_K
+            case .q4_K: kernels.q4_K_q8_K
+            case .q5_K: kernels.q5_K_q8_K
+            case .q6_K: kernels.q6_K_q8_K
+            case .q8_K: kernels.q8_K_q8_K
+            case .iq4_NL: kernels.iq4_nl_q8_0
+            case .q8_1, .iq2_XXS, .iq2_XS, .iq2_S, .iq3_XXS, .iq3_S, .iq1_S, .iq1_M, .iq4_XS: nil
+            case .tq1_0, .tq2_0, .mxfp4: nil
+            }
+    }
+}
+
+/// 8-bit block layouts used for quantized activations
+enum ActivationLayout: Sendable {
+    case q8_0
+    case q8_1
+    case q8_K
+
+    /// Number of elements per block
+    var blockSize: Int {
+        switch self {
+        case .q8_0, .q8_1: 32
+        case .q8_K: 256
+        }
+    }
+
+    /// Number of bytes per block
+    var bytesPerBlock: Int {
+        switch self {
+        case .q8_0: MemoryLayout<block_q8_0>.size
+        case .q8_1: MemoryLayout<block_q8_1>.size
+        case .q8_K: MemoryLayout<block_q8_K>.size
+        }
+    }
+
+    /// Quantizes `count` floats from `input` into blocks at `output`
+    func quantize(
+        _ input: UnsafePointer<Float>,
+        into output: UnsafeMutableRawPointer,
+        count: Int,
+        simdLevel: SIMDLevel
+    ) {
+        let kernels = simdLevel.quantizeKernels.pointee
+        let kernel =
+            switch self {
+            case .q8_0: kernels.q8_0
+            case .q8_1: kernels.q8_1
+            case .q8_K: kernels.q8_K
+            }
+        kernel!(input, output, Int64(count))
+    }
+}
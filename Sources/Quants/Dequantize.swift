@@ -6,144 +6,331 @@ public enum Dequantize {
     // MARK: - Q4_0
 
     public static func Q4_0(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q4_0.self)
-                dequantize_row_q4_0(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q4_0(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q4_0(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q4_0, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q4_1
 
     public static func Q4_1(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q4_1.self)
-                dequantize_row_q4_1(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q4_1(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q4_1(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q4_1, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q5_0
 
     public static func Q5_0(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q5_0.self)
-                dequantize_row_q5_0(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q5_0(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q5_0(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q5_0, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q5_1
 
     public static func Q5_1(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q5_1.self)
-                dequantize_row_q5_1(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q5_1(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q5_1(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q5_1, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q8_0
 
     public static func Q8_0(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q8_0.self)
-                dequantize_row_q8_0(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q8_0(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q8_0(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q8_0, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - Q8_1
+
+    public static func Q8_1(_ data: Data, elementCount: Int) -> [Float] {
+        Q8_1(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q8_1(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q8_1, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q2_K
 
     public static func Q2_K(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q2_K.self)
-                dequantize_row_q2_K(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q2_K(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q2_K(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q2_K, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q3_K
 
     public static func Q3_K(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q3_K.self)
-                dequantize_row_q3_K(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q3_K(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q3_K(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q3_K, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q4_K
 
     public static func Q4_K(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q4_K.self)
-                dequantize_row_q4_K(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q4_K(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q4_K(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q4_K, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q5_K
 
     public static func Q5_K(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q5_K.self)
-                dequantize_row_q5_K(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q5_K(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q5_K(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q5_K, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q6_K
 
     public static func Q6_K(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q6_K.self)
-                dequantize_row_q6_K(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q6_K(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q6_K(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q6_K, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - Q8_K
 
     public static func Q8_K(_ data: Data, elementCount: Int) -> [Float] {
-        data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
-            [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_q8_K.self)
-                dequantize_row_q8_K(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
-                finalCount = elementCount
-            }
-        }
+        Q8_K(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func Q8_K(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .q8_K, elementCount: elementCount, simdLevel: simdLevel)
     }
 
     // MARK: - IQ4_NL
 
     public static func IQ4_NL(_ data: Data, elementCount: Int) -> [Float] {
+        IQ4_NL(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func IQ4_NL(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .iq4_NL, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - IQ4_XS
+
+    public static func IQ4_XS(_ data: Data, elementCount: Int) -> [Float] {
+        IQ4_XS(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func IQ4_XS(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .iq4_XS, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - IQ3_XXS
+
+    public static func IQ3_XXS(_ data: Data, elementCount: Int) -> [Float] {
+        IQ3_XXS(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func IQ3_XXS(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .iq3_XXS, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - IQ3_S
+
+    public static func IQ3_S(_ data: Data, elementCount: Int) -> [Float] {
+        IQ3_S(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func IQ3_S(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .iq3_S, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - IQ2_XXS
+
+    public static func IQ2_XXS(_ data: Data, elementCount: Int) -> [Float] {
+        IQ2_XXS(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func IQ2_XXS(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .iq2_XXS, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - IQ2_XS
+
+    public static func IQ2_XS(_ data: Data, elementCount: Int) -> [Float] {
+        IQ2_XS(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func IQ2_XS(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .iq2_XS, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - IQ2_S
+
+    public static func IQ2_S(_ data: Data, elementCount: Int) -> [Float] {
+        IQ2_S(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func IQ2_S(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .iq2_S, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - IQ1_S
+
+    public static func IQ1_S(_ data: Data, elementCount: Int) -> [Float] {
+        IQ1_S(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func IQ1_S(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .iq1_S, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - IQ1_M
+
+    public static func IQ1_M(_ data: Data, elementCount: Int) -> [Float] {
+        IQ1_M(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func IQ1_M(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .iq1_M, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - TQ1_0
+
+    public static func TQ1_0(_ data: Data, elementCount: Int) -> [Float] {
+        TQ1_0(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func TQ1_0(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .tq1_0, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - TQ2_0
+
+    public static func TQ2_0(_ data: Data, elementCount: Int) -> [Float] {
+        TQ2_0(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func TQ2_0(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .tq2_0, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - MXFP4
+
+    public static func MXFP4(_ data: Data, elementCount: Int) -> [Float] {
+        MXFP4(data, elementCount: elementCount, simdLevel: .best)
+    }
+
+    public static func MXFP4(_ data: Data, elementCount: Int, simdLevel: SIMDLevel) -> [Float] {
+        dequantize(data, format: .mxfp4, elementCount: elementCount, simdLevel: simdLevel)
+    }
+
+    // MARK: - Generic
+
+    /// Dequantizes `data` holding `elementCount` elements of the given block format
+    /// - Parameters:
+    ///   - data: Raw block data; must hold at least `elementCount / blockSize` blocks
+    ///   - format: Block layout of `data`
+    ///   - elementCount: Number of elements to decode; must be a multiple of the block size
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    /// - Returns: Array of Float values
+    public static func dequantize(
+        _ data: Data,
+        format: BlockFormat,
+        elementCount: Int,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> [Float] {
         data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) in
             [Float](unsafeUninitializedCapacity: elementCount) { outputBuffer, finalCount in
-                let inputPtr = ptr.baseAddress?.assumingMemoryBound(to: block_iq4_nl.self)
-                dequantize_row_iq4_nl(inputPtr, outputBuffer.baseAddress, Int64(elementCount))
+                // Checks that every element is covered by a whole block of `data`
+                dequantize(
+                    ptr,
+                    into: UnsafeMutableBufferPointer(rebasing: outputBuffer[..<elementCount]),
+                    format: format,
+                    parallelism: parallelism,
+                    simdLevel: simdLevel
+                )
                 finalCount = elementCount
             }
         }
     }
+
+    /// Dequantizes raw block data into a caller-owned buffer without allocating
+    /// - Parameters:
+    ///   - input: Raw block data; must hold at least `output.count / blockSize` blocks
+    ///   - output: Destination buffer; its count must be a multiple of the block size
+    ///   - format: Block layout of `input`
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public static func dequantize(
+        _ input: UnsafeRawBufferPointer,
+        into output: UnsafeMutableBufferPointer<Float>,
+        format: BlockFormat,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        precondition(
+            output.count % format.blockSize == 0,
+            "Output count \(output.count) is not a multiple of the \(format) block size"
+        )
+        precondition(
+            input.count >= output.count / format.blockSize * format.bytesPerBlock,
+            "Input holds fewer than \(output.count) \(format) elements"
+        )
+        run(
+            format: format,
+            input: input,
+            output: output,
+            elementCount: output.count,
+            parallelism: parallelism,
+            simdLevel: simdLevel
+        )
+    }
+
+    // MARK: - Helpers
+
+    /// Runs the row kernel chunk by chunk, each chunk writing its own slice of `output`
+    private static func run(
+        format: BlockFormat,
+        input: UnsafeRawBufferPointer,
+        output: UnsafeMutableBufferPointer<Float>,
+        elementCount: Int,
+        parallelism: Parallelism,
+        simdLevel: SIMDLevel
+    ) {
+        guard let inputBase = input.baseAddress, let outputBase = output.baseAddress else {
+            return
+        }
+        let kernel = format.dequantizeKernel(simdLevel)
+        let blockSize = format.blockSize
+        let bytesPerBlock = format.bytesPerBlock
+        let blockCount = elementCount / blockSize
+        parallelism.forEachChunk(blockCount: blockCount, blockSize: blockSize) { blocks in
+            kernel(
+                inputBase + blocks.lowerBound * bytesPerBlock,
+                outputBase + blocks.lowerBound * blockSize,
+                Int64(blocks.count * blockSize)
+            )
+        }
+    }
 }
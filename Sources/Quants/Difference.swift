@@ -0,0 +1,169 @@
+import Foundation
+import GGMLQuants
+import Synchronization
+
+/// Error metrics between two runs of values, e.g. a tensor of a base model and the same tensor
+/// of a fine-tune.
+///
+/// The runs are compared a tile of 256 values (`comparisonTileSize`) at a time. When both use
+/// the same encoding, tiles whose bytes are equal are skipped without decoding; only the
+/// others are decoded and measured. Runs in different encodings are measured in full. As with
+/// `Statistics`, every SIMD level returns the same bits.
+public struct Difference: Sendable, Hashable {
+    /// Number of values in each compared tile, one K-quant super-block
+    public static let comparisonTileSize = 256
+
+    /// Number of values in the runs
+    public private(set) var count: Int
+    /// Number of values decoded and measured; the rest sit in tiles with equal bytes
+    public private(set) var measuredCount: Int
+    /// Number of tiles decoded and measured
+    public private(set) var measuredTileCount: Int
+    /// Largest |a - b| over the measured values, ignoring NaNs
+    public private(set) var maxAbsoluteError: Float
+    /// Sum of (a - b)^2 over the measured values
+    public private(set) var sumOfSquaredErrors: Double
+    /// Sum of a * b over the measured values
+    public private(set) var dotProduct: Double
+    /// Sum of a^2 over the measured values
+    public private(set) var sumOfSquaresA: Double
+    /// Sum of b^2 over the measured values
+    public private(set) var sumOfSquaresB: Double
+
+    /// Whether every tile was skipped as byte-identical
+    public var isIdentical: Bool {
+        measuredCount == 0
+    }
+
+    /// Root mean squared error over all values; skipped tiles contribute zero error
+    public var rootMeanSquaredError: Double {
+        count > 0 ? (sumOfSquaredErrors / Double(count)).squareRoot() : 0
+    }
+
+    /// Cosine similarity of the measured values; 1 when nothing was measured or both sides
+    /// are zero, 0 when only one side is
+    public var cosineSimilarity: Double {
+        let norms = (sumOfSquaresA * sumOfSquaresB).squareRoot()
+        if norms > 0 {
+            return dotProduct / norms
+        }
+        return sumOfSquaresA == sumOfSquaresB ? 1 : 0
+    }
+
+    /// Difference of two empty runs
+    public init() {
+        self.init(ggml_diff(), count: 0, tiles: 0)
+    }
+
+    /// Difference of two byte-identical runs of `count` values
+    public init(identicalCount count: Int) {
+        self.init(ggml_diff(), count: count, tiles: 0)
+    }
+
+    init(_ diff: ggml_diff, count: Int, tiles: Int) {
+        self.count = count
+        measuredCount = Int(diff.count)
+        measuredTileCount = tiles
+        maxAbsoluteError = diff.max_abs
+        sumOfSquaredErrors = diff.sumsq_diff
+        dotProduct = diff.dot
+        sumOfSquaresA = diff.sumsq_a
+        sumOfSquaresB = diff.sumsq_b
+    }
+
+    var cValue: ggml_diff {
+        ggml_diff(
+            count: Int64(measuredCount), sumsq_diff: sumOfSquaredErrors, dot: dotProduct,
+            sumsq_a: sumOfSquaresA, sumsq_b: sumOfSquaresB, max_abs: maxAbsoluteError)
+    }
+
+    /// Folds `other` in, as if its runs had been appended
+    public mutating func merge(_ other: Difference) {
+        var diff = cValue
+        var otherDiff = other.cValue
+        ggml_diff_merge(&diff, &otherDiff)
+        self = Difference(
+            diff, count: count + other.count,
+            tiles: measuredTileCount + other.measuredTileCount)
+    }
+
+    /// Compares `elementCount` values of `a` with those of `b`
+    /// - Parameters:
+    ///   - a: Encoded values; must hold at least `elementCount` of them
+    ///   - layoutA: Encoding of `a`
+    ///   - b: Encoded values; must hold at least `elementCount` of them
+    ///   - layoutB: Encoding of `b`
+    ///   - elementCount: Number of values; a multiple of both block sizes
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public init(
+        _ a: UnsafeRawBufferPointer,
+        layout layoutA: ValueLayout,
+        _ b: UnsafeRawBufferPointer,
+        layout layoutB: ValueLayout,
+        elementCount: Int,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        for (input, layout) in [(a, layoutA), (b, layoutB)] {
+            precondition(
+                elementCount % layout.blockSize == 0,
+                "Element count \(elementCount) is not a multiple of the block size \(layout)")
+            precondition(
+                input.count >= elementCount / layout.blockSize * layout.bytesPerBlock,
+                "Input holds fewer than \(elementCount) values")
+        }
+        guard let baseA = a.baseAddress, let baseB = b.baseAddress, elementCount > 0 else {
+            self.init(identicalCount: elementCount)
+            return
+        }
+        let kernel = simdLevel.statsKernels.pointee.diff!
+        let decodeA = layoutA.decodeKernel(simdLevel)
+        let decodeB = layoutB.decodeKernel(simdLevel)
+        let sameEncoding: Int32 = layoutA == layoutB ? 1 : 0
+        let tileSize = Self.comparisonTileSize
+        let tileCount = (elementCount + tileSize - 1) / tileSize
+        let address = { (base: UnsafeRawPointer, layout: ValueLayout, element: Int) in
+            base + element / layout.blockSize * layout.bytesPerBlock
+        }
+        let partials = Mutex<[(Int, ggml_diff, Int)]>([])
+        parallelism.forEachChunk(blockCount: tileCount, blockSize: tileSize) { tiles in
+            let start = tiles.lowerBound * tileSize
+            let end = min(elementCount, tiles.upperBound * tileSize)
+            var diff = ggml_diff()
+            let measured = ggml_dequantize_row_diff(
+                decodeA, Int64(layoutA.blockSize), layoutA.bytesPerBlock,
+                address(baseA, layoutA, start),
+                decodeB, Int64(layoutB.blockSize), layoutB.bytesPerBlock,
+                address(baseB, layoutB, start),
+                sameEncoding, kernel, Int64(end - start), &diff)
+            partials.withLock { $0.append((start, diff, Int(measured))) }
+        }
+        // Merging in element order keeps the result independent of thread scheduling
+        var total = Difference()
+        for (_, diff, tiles) in partials.withLock({ $0 }).sorted(by: { $0.0 < $1.0 }) {
+            total.merge(Difference(diff, count: 0, tiles: tiles))
+        }
+        total.count = elementCount
+        self = total
+    }
+
+    /// Compares `elementCount` values of `a` with those of `b`
+    public init(
+        _ a: Data,
+        layout layoutA: ValueLayout,
+        _ b: Data,
+        layout layoutB: ValueLayout,
+        elementCount: Int,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        self = a.withUnsafeBytes { a in
+            b.withUnsafeBytes { b in
+                Difference(
+                    a, layout: layoutA, b, layout: layoutB, elementCount: elementCount,
+                    parallelism: parallelism, simdLevel: simdLevel)
+            }
+        }
+    }
+}
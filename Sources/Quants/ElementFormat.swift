@@ -0,0 +1,119 @@
+import Foundation
+import GGMLQuants
+
+/// Plain (non-block) element encodings that widen to f32
+public enum ElementFormat: Sendable, CaseIterable {
+    /// IEEE 754 binary16
+    case f16
+    /// bfloat16, the upper half of an f32
+    case bf16
+    case f64
+    case i8
+    case i16
+    case i32
+    case i64
+
+    /// Number of bytes per element
+    public var bytesPerElement: Int {
+        switch self {
+        case .i8: 1
+        case .f16, .bf16, .i16: 2
+        case .i32: 4
+        case .f64, .i64: 8
+        }
+    }
+
+    /// Kernel widening this encoding to f32, shaped like a row dequantizer
+    func widenKernel(_ simdLevel: SIMDLevel) -> ggml_dequantize_row_t {
+        let kernels = simdLevel.convertKernels.pointee
+        let kernel =
+            switch self {
+            case .f16: kernels.fp16
+            case .bf16: kernels.bf16
+            case .f64: kernels.f64
+            case .i8: kernels.i8
+            case .i16: kernels.i16
+            case .i32: kernels.i32
+            case .i64: kernels.i64
+            }
+        return kernel!
+    }
+}
+
+extension HalfFormat {
+    /// The same encoding as an element format
+    var elementFormat: ElementFormat {
+        switch self {
+        case .f16: .f16
+        case .bf16: .bf16
+        }
+    }
+}
+
+extension Dequantize {
+
+    // MARK: - Plain element types
+
+    /// Converts plain elements to f32: 16-bit floats widen exactly, f64 and integers round to
+    /// nearest even like `Float.init`
+    /// - Parameters:
+    ///   - data: Elements in the `source` encoding
+    ///   - source: Encoding of `data`
+    ///   - elementCount: Number of elements to convert
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    /// - Returns: Array of Float values
+    public static func convert(
+        _ data: Data,
+        from source: ElementFormat,
+        elementCount: Int,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> [Float] {
+        data.withUnsafeBytes { input in
+            [Float](unsafeUninitializedCapacity: elementCount) { output, initializedCount in
+                convert(
+                    input,
+                    from: source,
+                    into: UnsafeMutableBufferPointer(rebasing: output[..<elementCount]),
+                    parallelism: parallelism,
+                    simdLevel: simdLevel
+                )
+                initializedCount = elementCount
+            }
+        }
+    }
+
+    /// Converts plain elements to f32 into a caller-owned buffer without allocating
+    /// - Parameters:
+    ///   - input: Elements in the `source` encoding at any alignment; must hold at least
+    ///     `output.count` of them
+    ///   - source: Encoding of `input`
+    ///   - output: Destination buffer
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public static func convert(
+        _ input: UnsafeRawBufferPointer,
+        from source: ElementFormat,
+        into output: UnsafeMutableBufferPointer<Float>,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        let width = source.bytesPerElement
+        precondition(
+            input.count >= output.count * width,
+            "Input holds fewer than \(output.count) \(source) elements"
+        )
+        guard let inputBase = input.baseAddress, let outputBase = output.baseAddress else {
+            return
+        }
+        let kernel = source.widenKernel(simdLevel)
+        parallelism.forEachChunk(blockCount: output.count, blockSize: 1) { elements in
+            kernel(
+                inputBase + elements.lowerBound * width,
+                outputBase + elements.lowerBound,
+                Int64(elements.count)
+            )
+        }
+    }
+}
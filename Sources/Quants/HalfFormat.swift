@@ -0,0 +1,221 @@
+import Foundation
+import GGMLQuants
+
+/// 16-bit float encodings the dequantizers can write directly
+public enum HalfFormat: Sendable, CaseIterable {
+    /// IEEE 754 binary16
+    case f16
+    /// bfloat16, the upper half of an f32
+    case bf16
+
+    /// f32 narrowing kernel for this encoding at the given SIMD level
+    func narrowKernel(_ simdLevel: SIMDLevel) -> ggml_from_float_t {
+        let kernels = simdLevel.halfKernels.pointee
+        let kernel =
+            switch self {
+            case .f16: kernels.fp16
+            case .bf16: kernels.bf16
+            }
+        return kernel!
+    }
+
+    /// Kernel widening this encoding to f32 at the given SIMD level, shaped like a row
+    /// dequantizer
+    func widenKernel(_ simdLevel: SIMDLevel) -> ggml_dequantize_row_t {
+        elementFormat.widenKernel(simdLevel)
+    }
+}
+
+extension Dequantize {
+
+    // MARK: - Half precision output
+
+    /// Dequantizes `data` straight to 16-bit floats, at half the memory of `[Float]`
+    /// - Parameters:
+    ///   - data: Raw block data
+    ///   - format: Block layout of `data`
+    ///   - elementCount: Number of elements to decode
+    ///   - half: Encoding of the output
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    /// - Returns: Bit patterns of the 16-bit values, rounded to nearest even
+    public static func dequantize(
+        _ data: Data,
+        format: BlockFormat,
+        elementCount: Int,
+        as half: HalfFormat,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> [UInt16] {
+        data.withUnsafeBytes { input in
+            [UInt16](unsafeUninitializedCapacity: elementCount) { output, initializedCount in
+                dequantize(
+                    input,
+                    into: UnsafeMutableBufferPointer(rebasing: output[..<elementCount]),
+                    format: format,
+                    as: half,
+                    parallelism: parallelism,
+                    simdLevel: simdLevel
+                )
+                initializedCount = elementCount
+            }
+        }
+    }
+
+    /// Dequantizes raw block data to 16-bit floats in a caller-owned buffer. Blocks are decoded
+    /// one tile at a time into a stack buffer, so no f32 copy of the tensor is ever made.
+    /// - Parameters:
+    ///   - input: Raw block data; must hold at least `output.count / blockSize` blocks
+    ///   - output: Destination buffer; its count must be a multiple of the block size
+    ///   - format: Block layout of `input`
+    ///   - half: Encoding of the output
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public static func dequantize(
+        _ input: UnsafeRawBufferPointer,
+        into output: UnsafeMutableBufferPointer<UInt16>,
+        format: BlockFormat,
+        as half: HalfFormat,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        precondition(
+            output.count % format.blockSize == 0,
+            "Output count \(output.count) is not a multiple of the \(format) block size"
+        )
+        precondition(
+            input.count >= output.count / format.blockSize * format.bytesPerBlock,
+            "Input holds fewer than \(output.count) \(format) elements"
+        )
+        runHalf(
+            decode: format.dequantizeKernel(simdLevel),
+            blockSize: format.blockSize,
+            bytesPerBlock: format.bytesPerBlock,
+            input: input,
+            output: output,
+            half: half,
+            parallelism: parallelism,
+            simdLevel: simdLevel
+        )
+    }
+
+    /// Re-encodes 16-bit floats, e.g. bf16 weights for an f16 consumer
+    /// - Parameters:
+    ///   - input: Values in the `source` encoding; must hold at least `output.count` of them
+    ///   - source: Encoding of `input`
+    ///   - output: Destination buffer
+    ///   - half: Encoding of the output
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public static func convert(
+        _ input: UnsafeRawBufferPointer,
+        from source: HalfFormat,
+        into output: UnsafeMutableBufferPointer<UInt16>,
+        as half: HalfFormat,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        precondition(
+            input.count >= output.count * 2,
+            "Input holds fewer than \(output.count) values"
+        )
+        if source == half {
+            UnsafeMutableRawBufferPointer(output).copyMemory(
+                from: UnsafeRawBufferPointer(rebasing: input[..<(output.count * 2)]))
+            return
+        }
+        runHalf(
+            decode: source.widenKernel(simdLevel),
+            blockSize: 1,
+            bytesPerBlock: 2,
+            input: input,
+            output: output,
+            half: half,
+            parallelism: parallelism,
+            simdLevel: simdLevel
+        )
+    }
+
+    /// Narrows f32 values to 16-bit floats, rounding to nearest even
+    /// - Parameters:
+    ///   - input: Values to narrow; must hold at least `output.count` of them
+    ///   - output: Destination buffer
+    ///   - half: Encoding of the output
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public static func narrow(
+        _ input: UnsafeBufferPointer<Float>,
+        into output: UnsafeMutableBufferPointer<UInt16>,
+        as half: HalfFormat,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        precondition(input.count >= output.count, "Input holds fewer than \(output.count) values")
+        guard let inputBase = input.baseAddress, let outputBase = output.baseAddress else {
+            return
+        }
+        let kernel = half.narrowKernel(simdLevel)
+        parallelism.forEachChunk(blockCount: output.count, blockSize: 1) { elements in
+            kernel(
+                inputBase + elements.lowerBound,
+                outputBase + elements.lowerBound,
+                Int64(elements.count)
+            )
+        }
+    }
+
+    /// Widens 16-bit floats to f32; exact for both encodings
+    /// - Parameters:
+    ///   - input: Values in the `source` encoding; must hold at least `output.count` of them
+    ///   - source: Encoding of `input`
+    ///   - output: Destination buffer
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public static func widen(
+        _ input: UnsafeRawBufferPointer,
+        from source: HalfFormat,
+        into output: UnsafeMutableBufferPointer<Float>,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        convert(
+            input,
+            from: source.elementFormat,
+            into: output,
+            parallelism: parallelism,
+            simdLevel: simdLevel
+        )
+    }
+
+    // MARK: - Helpers
+
+    /// Runs the tiled decode-and-narrow kernel chunk by chunk, each chunk writing its own
+    /// slice of `output`
+    private static func runHalf(
+        decode: ggml_dequantize_row_t,
+        blockSize: Int,
+        bytesPerBlock: Int,
+        input: UnsafeRawBufferPointer,
+        output: UnsafeMutableBufferPointer<UInt16>,
+        half: HalfFormat,
+        parallelism: Parallelism,
+        simdLevel: SIMDLevel
+    ) {
+        guard let inputBase = input.baseAddress, let outputBase = output.baseAddress else {
+            return
+        }
+        let narrow = half.narrowKernel(simdLevel)
+        let blockCount = output.count / blockSize
+        parallelism.forEachChunk(blockCount: blockCount, blockSize: blockSize) { blocks in
+            ggml_dequantize_row_half(
+                decode,
+                narrow,
+                Int64(blockSize),
+                bytesPerBlock,
+                inputBase + blocks.lowerBound * bytesPerBlock,
+                outputBase + blocks.lowerBound * blockSize,
+                Int64(blocks.count * blockSize)
+            )
+        }
+    }
+}
@@ -0,0 +1,244 @@
+import Foundation
+import GGMLQuants
+
+/// Precision of the activation vector in fused dot products
+public enum ActivationPrecision: Sendable {
+    /// Activations stay f32; each weight tile is decoded on the stack and dotted right away
+    case f32
+    /// Activations are quantized once to the 8-bit layout paired with the weight format and
+    /// the dot products run on integers. Faster, at the cost of a small quantization error.
+    case q8
+}
+
+/// Activations quantized once and reused for every row of a matrix-vector product
+public struct QuantizedActivations: Sendable {
+    /// Weight format these activations pair with
+    public let weightFormat: BlockFormat
+    /// Number of activations
+    public let count: Int
+    let storage: [UInt8]
+
+    /// Quantizes `values` to the 8-bit layout paired with `weightFormat`
+    /// - Parameters:
+    ///   - values: Activations; the count must be a multiple of the weight block size
+    ///   - weightFormat: Format of the rows these activations will be dotted with; must have
+    ///     an integer dot product
+    ///   - simdLevel: Kernels to use
+    public init(
+        _ values: UnsafeBufferPointer<Float>,
+        for weightFormat: BlockFormat,
+        simdLevel: SIMDLevel = .best
+    ) {
+        precondition(
+            values.count % weightFormat.blockSize == 0,
+            "Activation count \(values.count) is not a multiple of the \(weightFormat) block size"
+        )
+        guard let layout = weightFormat.activationLayout else {
+            preconditionFailure("\(weightFormat) has no integer dot product")
+        }
+        let byteCount = values.count / layout.blockSize * layout.bytesPerBlock
+        self.weightFormat = weightFormat
+        self.count = values.count
+        self.storage = [UInt8](unsafeUninitializedCapacity: byteCount) { buffer, initializedCount in
+            if let input = values.baseAddress, let output = buffer.baseAddress {
+                layout.quantize(input, into: output, count: values.count, simdLevel: simdLevel)
+            }
+            initializedCount = byteCount
+        }
+    }
+
+    public init(_ values: [Float], for weightFormat: BlockFormat, simdLevel: SIMDLevel = .best) {
+        self = values.withUnsafeBufferPointer {
+            QuantizedActivations($0, for: weightFormat, simdLevel: simdLevel)
+        }
+    }
+}
+
+/// Dot products and matrix-vector products that read block-quantized weights directly,
+/// without materializing them as floats
+public enum MatVec {
+
+    /// Dot product of one quantized row with f32 activations
+    /// - Parameters:
+    ///   - row: Raw block data holding `vector.count` elements
+    ///   - format: Block layout of `row`
+    ///   - vector: Activations; the count must be a multiple of the block size
+    ///   - simdLevel: Kernels to use
+    public static func dot(
+        _ row: UnsafeRawBufferPointer,
+        format: BlockFormat,
+        _ vector: UnsafeBufferPointer<Float>,
+        simdLevel: SIMDLevel = .best
+    ) -> Float {
+        checkRows(row, format: format, columns: vector.count)
+        guard let rowBase = row.baseAddress, let vectorBase = vector.baseAddress else {
+            return 0
+        }
+        return ggml_vec_dot_dequantized_f32(
+            format.dequantizeKernel(simdLevel),
+            simdLevel.vecDotKernels.pointee.f32,
+            Int64(format.blockSize),
+            format.bytesPerBlock,
+            rowBase,
+            vectorBase,
+            Int64(vector.count)
+        )
+    }
+
+    /// Dot product of one quantized row with quantized activations
+    /// - Parameters:
+    ///   - row: Raw block data holding `activations.count` elements
+    ///   - format: Block layout of `row`; must match `activations.weightFormat`'s pairing
+    ///   - activations: Activations quantized for `format`
+    ///   - simdLevel: Kernels to use
+    public static func dot(
+        _ row: UnsafeRawBufferPointer,
+        format: BlockFormat,
+        _ activations: QuantizedActivations,
+        simdLevel: SIMDLevel = .best
+    ) -> Float {
+        precondition(
+            activations.weightFormat.activationLayout == format.activationLayout,
+            "Activations quantized for \(activations.weightFormat) cannot pair with \(format)"
+        )
+        checkRows(row, format: format, columns: activations.count)
+        let kernel = format.vecDotKernel(simdLevel)!
+        return activations.storage.withUnsafeBytes { quantized in
+            guard let rowBase = row.baseAddress, let quantizedBase = quantized.baseAddress else {
+                return 0
+            }
+            return kernel(rowBase, quantizedBase, Int64(activations.count))
+        }
+    }
+
+    /// Computes `output = W * vector` for a row-major quantized matrix `W` with `output.count`
+    /// rows of `vector.count` elements. Rows are split across threads; each row writes only
+    /// its own output element.
+    /// - Parameters:
+    ///   - matrix: Raw block data of `W`
+    ///   - format: Block layout of `matrix`
+    ///   - vector: Activations; the count must be a multiple of the block size
+    ///   - output: Destination buffer, one value per row
+    ///   - activations: Whether to dot against f32 or 8-bit quantized activations; formats
+    ///     without an integer dot product always use f32
+    ///   - parallelism: How to split the rows across threads
+    ///   - simdLevel: Kernels to use
+    public static func multiply(
+        _ matrix: UnsafeRawBufferPointer,
+        format: BlockFormat,
+        by vector: UnsafeBufferPointer<Float>,
+        into output: UnsafeMutableBufferPointer<Float>,
+        activations: ActivationPrecision = .f32,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        let columns = vector.count
+        let rowSizeInBytes = checkRows(matrix, format: format, columns: columns, rows: output.count)
+        guard let outputBase = output.baseAddress else {
+            return
+        }
+        guard columns > 0, let matrixBase = matrix.baseAddress,
+            let vectorBase = vector.baseAddress
+        else {
+            output.update(repeating: 0)
+            return
+        }
+        switch format.activationLayout == nil ? .f32 : activations {
+        case .f32:
+            let dequantize = format.dequantizeKernel(simdLevel)
+            let dot = simdLevel.vecDotKernels.pointee.f32
+            let blockSize = Int64(format.blockSize)
+            let bytesPerBlock = format.bytesPerBlock
+            parallelism.forEachChunk(blockCount: output.count, blockSize: columns) { rows in
+                for row in rows {
+                    outputBase[row] = ggml_vec_dot_dequantized_f32(
+                        dequantize,
+                        dot,
+                        blockSize,
+                        bytesPerBlock,
+                        matrixBase + row * rowSizeInBytes,
+                        vectorBase,
+                        Int64(columns)
+                    )
+                }
+            }
+        case .q8:
+            let quantized = QuantizedActivations(vector, for: format, simdLevel: simdLevel)
+            let kernel = format.vecDotKernel(simdLevel)!
+            quantized.storage.withUnsafeBytes { quantizedBytes in
+                guard let quantizedBase = quantizedBytes.baseAddress else {
+                    return
+                }
+                parallelism.forEachChunk(blockCount: output.count, blockSize: columns) { rows in
+                    for row in rows {
+                        outputBase[row] = kernel(
+                            matrixBase + row * rowSizeInBytes,
+                            quantizedBase,
+                            Int64(columns)
+                        )
+                    }
+                }
+            }
+        }
+    }
+
+    /// Computes `W * vector` for a row-major quantized matrix `W` with `rows` rows of
+    /// `vector.count` elements
+    /// - Parameters:
+    ///   - matrix: Raw block data of `W`
+    ///   - format: Block layout of `matrix`
+    ///   - rows: Number of rows in `W`
+    ///   - vector: Activations; the count must be a multiple of the block size
+    ///   - activations: Whether to dot against f32 or 8-bit quantized activations
+    ///   - parallelism: How to split the rows across threads
+    ///   - simdLevel: Kernels to use
+    /// - Returns: One value per row
+    public static func multiply(
+        _ matrix: Data,
+        format: BlockFormat,
+        rows: Int,
+        by vector: [Float],
+        activations: ActivationPrecision = .f32,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> [Float] {
+        matrix.withUnsafeBytes { (matrixBytes: UnsafeRawBufferPointer) in
+            vector.withUnsafeBufferPointer { vectorBuffer in
+                [Float](unsafeUninitializedCapacity: rows) { outputBuffer, initializedCount in
+                    multiply(
+                        matrixBytes,
+                        format: format,
+                        by: vectorBuffer,
+                        into: UnsafeMutableBufferPointer(rebasing: outputBuffer[..<rows]),
+                        activations: activations,
+                        parallelism: parallelism,
+                        simdLevel: simdLevel
+                    )
+                    initializedCount = rows
+                }
+            }
+        }
+    }
+
+    // MARK: - Helpers
+
+    /// Validates that `data` holds `rows` rows of `columns` elements and returns the row size
+    @discardableResult
+    private static func checkRows(
+        _ data: UnsafeRawBufferPointer,
+        format: BlockFormat,
+        columns: Int,
+        rows: Int = 1
+    ) -> Int {
+        precondition(
+            columns % format.blockSize == 0,
+            "Row length \(columns) is not a multiple of the \(format) block size"
+        )
+        let rowSizeInBytes = columns / format.blockSize * format.bytesPerBlock
+        precondition(
+            data.count >= rows * rowSizeInBytes,
+            "Input holds fewer than \(rows) rows of \(columns) \(format) elements"
+        )
+        return rowSizeInBytes
+    }
+}
@@ -0,0 +1,171 @@
+import Foundation
+import GGMLQuants
+import Synchronization
+
+/// Counts NaN and infinite values in float payloads and in the scales of quantized blocks.
+///
+/// Values are classified on their exponent bits, so the scans never decode to f32 and
+/// accept data at any alignment.
+public enum NonFinite {
+    /// Float encodings of a payload or scale field
+    public enum Encoding: Sendable, CaseIterable {
+        case f16
+        case bf16
+        case f32
+
+        /// Bytes per value
+        public var byteWidth: Int {
+            self == .f32 ? 4 : 2
+        }
+
+        /// Scan kernel for this encoding at the given SIMD level
+        func kernel(_ simdLevel: SIMDLevel) -> ggml_count_nonfinite_t {
+            let kernels = simdLevel.finiteKernels.pointee
+            let kernel =
+                switch self {
+                case .f16: kernels.fp16
+                case .bf16: kernels.bf16
+                case .f32: kernels.f32
+                }
+            return kernel!
+        }
+    }
+
+    /// Number of NaN and infinite values in a contiguous float payload
+    /// - Parameters:
+    ///   - data: Values, `byteWidth` bytes each; trailing bytes of a partial value are ignored
+    ///   - encoding: Encoding of the values
+    ///   - parallelism: How to split the scan across threads
+    ///   - simdLevel: Kernels to use
+    public static func count(
+        in data: UnsafeRawBufferPointer,
+        encoding: Encoding,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> Int {
+        scan(
+            data,
+            count: data.count / encoding.byteWidth,
+            field: (0, encoding),
+            stride: encoding.byteWidth,
+            parallelism: parallelism,
+            simdLevel: simdLevel
+        )
+    }
+
+    /// Number of NaN and infinite scale fields (`d`, `dmin`, `m`, ...) in quantized blocks.
+    ///
+    /// Formats without a float scale field (IQ1_M spreads its scale over the sub-block
+    /// scales, MXFP4 stores a power-of-two exponent) always return 0.
+    /// - Parameters:
+    ///   - data: Raw block data; trailing bytes of a partial block are ignored
+    ///   - format: Block layout of `data`
+    ///   - parallelism: How to split the scan across threads
+    ///   - simdLevel: Kernels to use
+    public static func countScales(
+        in data: UnsafeRawBufferPointer,
+        format: BlockFormat,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> Int {
+        let blockCount = data.count / format.bytesPerBlock
+        var total = 0
+        for field in format.scaleFields {
+            total += scan(
+                data,
+                count: blockCount,
+                field: field,
+                stride: format.bytesPerBlock,
+                blockSize: format.blockSize,
+                parallelism: parallelism,
+                simdLevel: simdLevel
+            )
+        }
+        return total
+    }
+
+    /// Number of NaN and infinite values in a contiguous float payload
+    public static func count(
+        in data: Data,
+        encoding: Encoding,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> Int {
+        data.withUnsafeBytes { bytes in
+            count(in: bytes, encoding: encoding, parallelism: parallelism, simdLevel: simdLevel)
+        }
+    }
+
+    /// Number of NaN and infinite scale fields in quantized blocks
+    public static func countScales(
+        in data: Data,
+        format: BlockFormat,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> Int {
+        data.withUnsafeBytes { bytes in
+            countScales(in: bytes, format: format, parallelism: parallelism, simdLevel: simdLevel)
+        }
+    }
+
+    // MARK: - Helpers
+
+    /// Scans `count` values at `field.offset + i * stride`, summing the chunk counts
+    private static func scan(
+        _ data: UnsafeRawBufferPointer,
+        count: Int,
+        field: (offset: Int, encoding: Encoding),
+        stride: Int,
+        blockSize: Int = 1,
+        parallelism: Parallelism,
+        simdLevel: SIMDLevel
+    ) -> Int {
+        guard let base = data.baseAddress, count > 0 else {
+            return 0
+        }
+        let kernel = field.encoding.kernel(simdLevel)
+        let total = Atomic<Int>(0)
+        parallelism.forEachChunk(blockCount: count, blockSize: blockSize) { range in
+            let found = kernel(
+                base + field.offset + range.lowerBound * stride,
+                Int64(range.count),
+                stride
+            )
+            total.add(Int(found), ordering: .relaxed)
+        }
+        return total.load(ordering: .relaxed)
+    }
+}
+
+extension BlockFormat {
+    /// Byte offsets and encodings of the float scale fields of one block
+    var scaleFields: [(offset: Int, encoding: NonFinite.Encoding)] {
+        switch self {
+        case .q4_0, .q5_0, .q8_0, .iq4_NL:
+            [(0, .f16)]
+        case .q4_1, .q5_1, .q8_1:
+            [(0, .f16), (2, .f16)]
+        case .iq2_XXS, .iq2_XS, .iq2_S, .iq3_XXS, .iq3_S, .iq1_S, .iq4_XS:
+            [(0, .f16)]
+        case .q2_K:
+            [
+                (MemoryLayout<block_q2_K>.offset(of: \.d)!, .f16),
+                (MemoryLayout<block_q2_K>.offset(of: \.dmin)!, .f16),
+            ]
+        case .q3_K:
+            [(MemoryLayout<block_q3_K>.offset(of: \.d)!, .f16)]
+        case .q4_K, .q5_K:
+            [(0, .f16), (2, .f16)]
+        case .q6_K:
+            [(MemoryLayout<block_q6_K>.offset(of: \.d)!, .f16)]
+        case .q8_K:
+            [(0, .f32)]
+        case .tq1_0:
+            [(MemoryLayout<block_tq1_0>.offset(of: \.d)!, .f16)]
+        case .tq2_0:
+            [(MemoryLayout<block_tq2_0>.offset(of: \.d)!, .f16)]
+        case .iq1_M, .mxfp4:
+            []
+        }
+    }
+}
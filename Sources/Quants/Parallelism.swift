@@ -0,0 +1,54 @@
+import Dispatch
+import Foundation
+
+/// Controls how dequantization work is split across threads.
+///
+/// Work is always split on block boundaries and every chunk writes only its own slice of the
+/// output, so results are identical to the serial path regardless of the settings.
+public struct Parallelism: Sendable, Hashable {
+    /// Maximum number of chunks processed concurrently
+    public var maxConcurrency: Int
+    /// Minimum number of elements per chunk; smaller inputs are processed serially
+    public var minimumChunkSize: Int
+
+    public init(
+        maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount,
+        minimumChunkSize: Int = 1 << 16
+    ) {
+        self.maxConcurrency = max(1, maxConcurrency)
+        self.minimumChunkSize = max(1, minimumChunkSize)
+    }
+
+    /// Runs everything on the calling thread
+    public static let serial = Parallelism(maxConcurrency: 1)
+
+    /// Uses every active processor with the default chunk size
+    public static var automatic: Parallelism {
+        Parallelism()
+    }
+
+    /// Number of chunks to split `blockCount` blocks of `blockSize` elements into
+    func chunkCount(blockCount: Int, blockSize: Int) -> Int {
+        let minimumBlocks = max(1, (minimumChunkSize + blockSize - 1) / blockSize)
+        return max(1, min(maxConcurrency, blockCount / minimumBlocks))
+    }
+
+    /// Splits `0..<blockCount` into contiguous ranges and calls `body` for each, concurrently
+    /// when more than one chunk is needed
+    package func forEachChunk(
+        blockCount: Int,
+        blockSize: Int,
+        _ body: (Range<Int>) -> Void
+    ) {
+        let chunks = chunkCount(blockCount: blockCount, blockSize: blockSize)
+        guard chunks > 1 else {
+            body(0..<blockCount)
+            return
+        }
+        DispatchQueue.concurrentPerform(iterations: chunks) { chunk in
+            let lowerBound = blockCount * chunk / chunks
+            let upperBound = blockCount * (chunk + 1) / chunks
+            body(lowerBound..<upperBound)
+        }
+    }
+}
@@ -0,0 +1,77 @@
+import Foundation
+import GGMLQuants
+
+/// Converts f32 values into block-quantized layouts, the inverse of `Dequantize`
+public enum Quantize {
+
+    /// Quantizes `values` into blocks of the given format
+    /// - Parameters:
+    ///   - values: Input values; the count must be a multiple of the block size and every
+    ///     value must be finite
+    ///   - format: Block layout to produce; must be `isQuantizable`
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    /// - Returns: Raw block data, `values.count / blockSize * bytesPerBlock` bytes
+    public static func quantize(
+        _ values: [Float],
+        format: BlockFormat,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> Data {
+        var data = Data(count: values.count / format.blockSize * format.bytesPerBlock)
+        values.withUnsafeBufferPointer { input in
+            data.withUnsafeMutableBytes { output in
+                quantize(
+                    input,
+                    into: output,
+                    format: format,
+                    parallelism: parallelism,
+                    simdLevel: simdLevel
+                )
+            }
+        }
+        return data
+    }
+
+    /// Quantizes values into a caller-owned buffer without allocating
+    /// - Parameters:
+    ///   - input: Input values; the count must be a multiple of the block size
+    ///   - output: Destination for the raw blocks; must hold at least
+    ///     `input.count / blockSize` blocks
+    ///   - format: Block layout to produce; must be `isQuantizable`
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public static func quantize(
+        _ input: UnsafeBufferPointer<Float>,
+        into output: UnsafeMutableRawBufferPointer,
+        format: BlockFormat,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        precondition(
+            input.count % format.blockSize == 0,
+            "Input count \(input.count) is not a multiple of the \(format) block size"
+        )
+        let blockSize = format.blockSize
+        let bytesPerBlock = format.bytesPerBlock
+        let blockCount = input.count / blockSize
+        precondition(
+            output.count >= blockCount * bytesPerBlock,
+            "Output holds fewer than \(input.count) \(format) elements"
+        )
+        guard let inputBase = input.baseAddress, let outputBase = output.baseAddress else {
+            return
+        }
+        guard let kernel = format.quantizeKernel(simdLevel) else {
+            preconditionFailure("\(format) cannot be quantized")
+        }
+        // Blocks are quantized independently, so chunks never share an output byte
+        parallelism.forEachChunk(blockCount: blockCount, blockSize: blockSize) { blocks in
+            kernel(
+                inputBase + blocks.lowerBound * blockSize,
+                outputBase + blocks.lowerBound * bytesPerBlock,
+                Int64(blocks.count * blockSize)
+            )
+        }
+    }
+}
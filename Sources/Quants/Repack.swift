@@ -0,0 +1,385 @@
+import Foundation
+import GGMLQuants
+
+/// A block-quantized matrix whose rows are stored in groups of `interleave`, with the blocks
+/// at the same column of every row in a group next to each other.
+///
+/// In the file layout each row's blocks are contiguous, so a matrix-vector product streams
+/// the activations once per row. Interleaving lets one vector load cover one chunk of every
+/// row in a group, so the kernels stream the activations once per group and produce
+/// `interleave` outputs per pass. Repacking is a single copy, done once at load time; the
+/// result can be written to disk with `write(to:tag:)` and mapped back on later runs.
+///
+/// Q4_0, Q8_0 and Q4_K can be repacked. Rows past the last full group stay in the file
+/// layout. Products use activations quantized to the paired 8-bit layout, like
+/// `MatVec.multiply` with `.q8`, and the interleaved kernels match the scalar reference bit
+/// for bit at every SIMD level.
+public struct RepackedMatrix: Sendable {
+    /// Block layout of the original rows
+    public let format: BlockFormat
+    /// Number of rows per group, 4 or 8
+    public let interleave: Int
+    public let rows: Int
+    /// Number of elements per row
+    public let columns: Int
+    /// Row groups, followed by the trailing `rows % interleave` rows in the file layout
+    let storage: Data
+
+    /// Whether `format` has an interleaved layout
+    public static func canRepack(_ format: BlockFormat) -> Bool {
+        switch format {
+        case .q4_0, .q8_0, .q4_K: true
+        default: false
+        }
+    }
+
+    /// Interleave whose kernels are vectorized at `simdLevel`: eight rows fill the 32-bit
+    /// lanes of an AVX2 register, four those of a NEON register
+    public static func preferredInterleave(for simdLevel: SIMDLevel = .best) -> Int {
+        switch simdLevel {
+        case .avx2, .avx512: 8
+        case .scalar, .neon: 4
+        }
+    }
+
+    /// Repacks a row-major quantized matrix
+    /// - Parameters:
+    ///   - matrix: Raw block data holding `rows` rows of `columns` elements
+    ///   - format: Block layout of `matrix`; must satisfy `canRepack`
+    ///   - rows: Number of rows
+    ///   - columns: Number of elements per row; must be a multiple of the block size
+    ///   - interleave: Rows per group, 4 or 8
+    public init(
+        _ matrix: UnsafeRawBufferPointer,
+        format: BlockFormat,
+        rows: Int,
+        columns: Int,
+        interleave: Int = RepackedMatrix.preferredInterleave()
+    ) {
+        precondition(Self.canRepack(format), "\(format) has no interleaved layout")
+        precondition(interleave == 4 || interleave == 8, "Interleave must be 4 or 8")
+        precondition(
+            columns % format.blockSize == 0,
+            "Row length \(columns) is not a multiple of the \(format) block size"
+        )
+        let rowSizeInBytes = columns / format.blockSize * format.bytesPerBlock
+        precondition(
+            matrix.count >= rows * rowSizeInBytes,
+            "Input holds fewer than \(rows) rows of \(columns) \(format) elements"
+        )
+        self.format = format
+        self.interleave = interleave
+        self.rows = rows
+        self.columns = columns
+
+        let groupedRows = rows / interleave * interleave
+        let groupBytes = groupedRows / interleave * Self.groupSizeInBytes(
+            format: format, interleave: interleave, columns: columns)
+        let tailBytes = (rows - groupedRows) * rowSizeInBytes
+        var storage = Data(count: groupBytes + tailBytes)
+        storage.withUnsafeMutableBytes { output in
+            guard let source = matrix.baseAddress, let destination = output.baseAddress else {
+                return
+            }
+            let n = Int32(interleave)
+            switch format {
+            case .q4_0:
+                ggml_repack_q4_0(
+                    source.assumingMemoryBound(to: block_q4_0.self), destination, n,
+                    Int64(groupedRows), Int64(columns))
+            case .q8_0:
+                ggml_repack_q8_0(
+                    source.assumingMemoryBound(to: block_q8_0.self), destination, n,
+                    Int64(groupedRows), Int64(columns))
+            case .q4_K:
+                ggml_repack_q4_K(
+                    source.assumingMemoryBound(to: block_q4_K.self), destination, n,
+                    Int64(groupedRows), Int64(columns))
+            default:
+                preconditionFailure("\(format) has no interleaved layout")
+            }
+            (destination + groupBytes).copyMemory(
+                from: source + groupedRows * rowSizeInBytes, byteCount: tailBytes)
+        }
+        self.storage = storage
+    }
+
+    public init(
+        _ matrix: Data,
+        format: BlockFormat,
+        rows: Int,
+        columns: Int,
+        interleave: Int = RepackedMatrix.preferredInterleave()
+    ) {
+        self = matrix.withUnsafeBytes {
+            RepackedMatrix(
+                $0, format: format, rows: rows, columns: columns, interleave: interleave)
+        }
+    }
+
+    /// Computes `output = W * vector`. Row groups are split across threads; every group
+    /// writes only its own outputs.
+    /// - Parameters:
+    ///   - vector: Activations; must hold `columns` values
+    ///   - output: Destination buffer; must hold `rows` values
+    ///   - parallelism: How to split the row groups across threads
+    ///   - simdLevel: Kernels to use
+    public func multiply(
+        by vector: UnsafeBufferPointer<Float>,
+        into output: UnsafeMutableBufferPointer<Float>,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        precondition(vector.count == columns, "Vector length must be \(columns)")
+        precondition(output.count == rows, "Output length must be \(rows)")
+        guard let outputBase = output.baseAddress else {
+            return
+        }
+        guard columns > 0 else {
+            output.update(repeating: 0)
+            return
+        }
+        let quantized = QuantizedActivations(vector, for: format, simdLevel: simdLevel)
+        let gemv = gemvKernel(simdLevel)
+        let dot = format.vecDotKernel(simdLevel)!
+        let groupCount = rows / interleave
+        let groupSize = groupSizeInBytes
+        let rowSize = rowSizeInBytes
+        storage.withUnsafeBytes { storageBytes in
+            quantized.storage.withUnsafeBytes { quantizedBytes in
+                guard let base = storageBytes.baseAddress,
+                    let activations = quantizedBytes.baseAddress
+                else {
+                    return
+                }
+                parallelism.forEachChunk(
+                    blockCount: groupCount,
+                    blockSize: columns * interleave
+                ) { groups in
+                    for group in groups {
+                        gemv(
+                            base + group * groupSize,
+                            activations,
+                            outputBase + group * interleave,
+                            Int64(columns)
+                        )
+                    }
+                }
+                let tail = base + groupCount * groupSize
+                for row in (groupCount * interleave)..<rows {
+                    let offset = (row - groupCount * interleave) * rowSize
+                    outputBase[row] = dot(tail + offset, activations, Int64(columns))
+                }
+            }
+        }
+    }
+
+    /// Computes `W * vector`
+    /// - Parameters:
+    ///   - vector: Activations; must hold `columns` values
+    ///   - parallelism: How to split the row groups across threads
+    ///   - simdLevel: Kernels to use
+    /// - Returns: One value per row
+    public func multiply(
+        by vector: [Float],
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) -> [Float] {
+        vector.withUnsafeBufferPointer { vectorBuffer in
+            [Float](unsafeUninitializedCapacity: rows) { outputBuffer, initializedCount in
+                multiply(
+                    by: vectorBuffer,
+                    into: UnsafeMutableBufferPointer(rebasing: outputBuffer[..<rows]),
+                    parallelism: parallelism,
+                    simdLevel: simdLevel
+                )
+                initializedCount = rows
+            }
+        }
+    }
+
+    /// Decodes the matrix to row-major floats, identical to dequantizing the original rows
+    public func dequantized(simdLevel: SIMDLevel = .best) -> [Float] {
+        let count = rows * columns
+        let groupCount = rows / interleave
+        return [Float](unsafeUninitializedCapacity: count) { buffer, initializedCount in
+            storage.withUnsafeBytes { storageBytes in
+                guard let base = storageBytes.baseAddress, let output = buffer.baseAddress else {
+                    return
+                }
+                for group in 0..<groupCount {
+                    dequantizeGroup(
+                        base + group * groupSizeInBytes,
+                        into: output + group * interleave * columns
+                    )
+                }
+                let tailRows = rows - groupCount * interleave
+                if tailRows > 0 {
+                    format.dequantizeKernel(simdLevel)(
+                        base + groupCount * groupSizeInBytes,
+                        output + groupCount * interleave * columns,
+                        Int64(tailRows * columns)
+                    )
+                }
+            }
+            initializedCount = count
+        }
+    }
+
+    // MARK: - Serialization
+
+    /// Serialized form: a 32-byte little-endian header followed by the repacked blocks
+    /// - Parameter tag: Caller-defined value identifying the source tensor, checked on load
+    public func serializedData(tag: UInt64 = 0) -> Data {
+        var header = [UInt8]()
+        header.reserveCapacity(Self.headerSize)
+        func append<T: FixedWidthInteger>(_ value: T) {
+            withUnsafeBytes(of: value.littleEndian) { header.append(contentsOf: $0) }
+        }
+        append(Self.magic)
+        append(Self.version)
+        append(Self.formatCode(format)!)
+        append(UInt8(interleave))
+        append(UInt64(rows))
+        append(UInt64(columns))
+        append(tag)
+        return Data(header) + storage
+    }
+
+    /// Restores a matrix written by `serializedData(tag:)`. The blocks are not copied, so a
+    /// memory-mapped `data` stays mapped.
+    /// - Returns: nil if `data` is not a repacked matrix of this version, was written with
+    ///   another tag, or is truncated
+    public init?(serializedData data: Data, tag: UInt64 = 0) {
+        guard data.count >= Self.headerSize else {
+            return nil
+        }
+        let start = data.startIndex
+        func load<T: FixedWidthInteger>(_ offset: Int, as type: T.Type) -> T {
+            var value = T.zero
+            withUnsafeMutableBytes(of: &value) { bytes in
+                data.copyBytes(to: bytes, from: (start + offset)..<(start + offset + bytes.count))
+            }
+            return T(littleEndian: value)
+        }
+        guard load(0, as: UInt32.self) == Self.magic,
+            load(4, as: UInt16.self) == Self.version,
+            let format = Self.format(forCode: load(6, as: UInt8.self)),
+            let rows = Int(exactly: load(8, as: UInt64.self)),
+            let columns = Int(exactly: load(16, as: UInt64.self)),
+            load(24, as: UInt64.self) == tag
+        else {
+            return nil
+        }
+        let interleave = Int(load(7, as: UInt8.self))
+        guard interleave == 4 || interleave == 8, columns % format.blockSize == 0 else {
+            return nil
+        }
+        let groupBytes = Self.groupSizeInBytes(
+            format: format, interleave: interleave, columns: columns)
+        let rowBytes = columns / format.blockSize * format.bytesPerBlock
+        let (groupTotal, overflow) = (rows / interleave).multipliedReportingOverflow(
+            by: groupBytes)
+        guard !overflow,
+            data.count - Self.headerSize == groupTotal + rows % interleave * rowBytes
+        else {
+            return nil
+        }
+        self.format = format
+        self.interleave = interleave
+        self.rows = rows
+        self.columns = columns
+        self.storage = data[(start + Self.headerSize)...]
+    }
+
+    /// Writes `serializedData(tag:)` to `url`, replacing any existing file atomically
+    public func write(to url: URL, tag: UInt64 = 0) throws {
+        try serializedData(tag: tag).write(to: url, options: .atomic)
+    }
+
+    /// Maps a matrix written by `write(to:tag:)`
+    /// - Returns: nil if the file is missing or does not hold a matrix with this tag
+    public init?(contentsOf url: URL, tag: UInt64 = 0) {
+        guard let data = try? Data(contentsOf: url, options: .alwaysMapped) else {
+            return nil
+        }
+        self.init(serializedData: data, tag: tag)
+    }
+
+    // MARK: - Helpers
+
+    private static let magic: UInt32 = 0x4B50_5251  // "QRPK"
+    private static let version: UInt16 = 1
+    private static let headerSize = 32
+
+    private static func formatCode(_ format: BlockFormat) -> UInt8? {
+        switch format {
+        case .q4_0: 0
+        case .q8_0: 1
+        case .q4_K: 2
+        default: nil
+        }
+    }
+
+    private static func format(forCode code: UInt8) -> BlockFormat? {
+        switch code {
+        case 0: .q4_0
+        case 1: .q8_0
+        case 2: .q4_K
+        default: nil
+        }
+    }
+
+    /// Bytes of one group of `interleave` rows of `columns` elements
+    private static func groupSizeInBytes(format: BlockFormat, interleave: Int, columns: Int)
+        -> Int
+    {
+        let blockSize =
+            switch (format, interleave) {
+            case (.q4_0, 4): MemoryLayout<block_q4_0x4>.size
+            case (.q4_0, _): MemoryLayout<block_q4_0x8>.size
+            case (.q8_0, 4): MemoryLayout<block_q8_0x4>.size
+            case (.q8_0, _): MemoryLayout<block_q8_0x8>.size
+            case (.q4_K, 4): MemoryLayout<block_q4_Kx4>.size
+            case (.q4_K, _): MemoryLayout<block_q4_Kx8>.size
+            default: preconditionFailure("\(format) has no interleaved layout")
+            }
+        return columns / format.blockSize * blockSize
+    }
+
+    private var groupSizeInBytes: Int {
+        Self.groupSizeInBytes(format: format, interleave: interleave, columns: columns)
+    }
+
+    private var rowSizeInBytes: Int {
+        columns / format.blockSize * format.bytesPerBlock
+    }
+
+    private func gemvKernel(_ simdLevel: SIMDLevel) -> ggml_gemv_t {
+        let kernels = simdLevel.gemvKernels.pointee
+        let kernel =
+            switch (format, interleave) {
+            case (.q4_0, 4): kernels.q4_0x4_q8_0
+            case (.q4_0, _): kernels.q4_0x8_q8_0
+            case (.q8_0, 4): kernels.q8_0x4_q8_0
+            case (.q8_0, _): kernels.q8_0x8_q8_0
+            case (.q4_K, 4): kernels.q4_Kx4_q8_K
+            case (.q4_K, _): kernels.q4_Kx8_q8_K
+            default: preconditionFailure("\(format) has no interleaved layout")
+            }
+        return kernel!
+    }
+
+    private func dequantizeGroup(
+        _ group: UnsafeRawPointer,
+        into output: UnsafeMutablePointer<Float>
+    ) {
+        let n = Int32(interleave)
+        switch format {
+        case .q4_0: ggml_dequantize_repacked_q4_0(group, output, n, Int64(columns))
+        case .q8_0: ggml_dequantize_repacked_q8_0(group, output, n, Int64(columns))
+        case .q4_K: ggml_dequantize_repacked_q4_K(group, output, n, Int64(columns))
+        default: preconditionFailure("\(format) has no interleaved layout")
+        }
+    }
+}
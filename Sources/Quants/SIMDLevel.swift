@@ -0,0 +1,91 @@
+import GGMLQuants
+
+/// Instruction set used by the dequantization, quantization and dot product kernels
+public enum SIMDLevel: Int, Sendable, CaseIterable {
+    case scalar = 0
+    case neon = 1
+    case avx2 = 2
+    case avx512 = 3
+
+    /// Widest level supported by both the build and the host CPU
+    public static var best: SIMDLevel {
+        SIMDLevel(ggml_simd_level_best())
+    }
+
+    /// Whether kernels for this level can run on the host CPU
+    public var isAvailable: Bool {
+        ggml_simd_level_available(cValue)
+    }
+
+    var cValue: ggml_simd_level {
+        ggml_simd_level(UInt32(rawValue))
+    }
+
+    init(_ level: ggml_simd_level) {
+        self = SIMDLevel(rawValue: Int(level.rawValue)) ?? .scalar
+    }
+
+    /// Kernel table for this level
+    var dequantizeKernels: UnsafePointer<ggml_dequantize_kernels> {
+        guard let kernels = ggml_get_dequantize_kernels(cValue) else {
+            preconditionFailure("SIMD level \(self) is not available on this CPU")
+        }
+        return kernels
+    }
+
+    /// Dot product kernel table for this level
+    var vecDotKernels: UnsafePointer<ggml_vec_dot_kernels> {
+        guard let kernels = ggml_get_vec_dot_kernels(cValue) else {
+            preconditionFailure("SIMD level \(self) is not available on this CPU")
+        }
+        return kernels
+    }
+
+    /// Interleaved dot product kernel table for this level
+    var gemvKernels: UnsafePointer<ggml_gemv_kernels> {
+        guard let kernels = ggml_get_gemv_kernels(cValue) else {
+            preconditionFailure("SIMD level \(self) is not available on this CPU")
+        }
+        return kernels
+    }
+
+    /// Quantization kernel table for this level
+    var quantizeKernels: UnsafePointer<ggml_quantize_kernels> {
+        guard let kernels = ggml_get_quantize_kernels(cValue) else {
+            preconditionFailure("SIMD level \(self) is not available on this CPU")
+        }
+        return kernels
+    }
+
+    /// Half precision conversion kernel table for this level
+    var halfKernels: UnsafePointer<ggml_half_kernels> {
+        guard let kernels = ggml_get_half_kernels(cValue) else {
+            preconditionFailure("SIMD level \(self) is not available on this CPU")
+        }
+        return kernels
+    }
+
+    /// Element conversion kernel table for this level
+    var convertKernels: UnsafePointer<ggml_convert_kernels> {
+        guard let kernels = ggml_get_convert_kernels(cValue) else {
+            preconditionFailure("SIMD level \(self) is not available on this CPU")
+        }
+        return kernels
+    }
+
+    /// Non-finite scan kernel table for this level
+    var finiteKernels: UnsafePointer<ggml_finite_kernels> {
+        guard let kernels = ggml_get_finite_kernels(cValue) else {
+            preconditionFailure("SIMD level \(self) is not available on this CPU")
+        }
+        return kernels
+    }
+
+    /// Statistics kernel table for this level
+    var statsKernels: UnsafePointer<ggml_stats_kernels> {
+        guard let kernels = ggml_get_stats_kernels(cValue) else {
+            preconditionFailure("SIMD level \(self) is not available on this CPU")
+        }
+        return kernels
+    }
+}
@@ -0,0 +1,273 @@
+import Foundation
+import GGMLQuants
+import Synchronization
+
+/// Encoding of the values summarized by `Statistics` and `Histogram`
+public enum ValueLayout: Sendable, Hashable {
+    /// 32-bit floats; the data must be 4-byte aligned
+    case f32
+    /// 16-bit floats
+    case half(HalfFormat)
+    /// Quantized blocks, decoded one tile at a time
+    case blocks(BlockFormat)
+
+    /// Number of elements per block
+    var blockSize: Int {
+        switch self {
+        case .f32, .half: 1
+        case .blocks(let format): format.blockSize
+        }
+    }
+
+    /// Number of bytes per block
+    var bytesPerBlock: Int {
+        switch self {
+        case .f32: 4
+        case .half: 2
+        case .blocks(let format): format.bytesPerBlock
+        }
+    }
+
+    /// Row decoder feeding the tiled drivers, or nil for f32 values read in place
+    func decodeKernel(_ simdLevel: SIMDLevel) -> ggml_dequantize_row_t? {
+        switch self {
+        case .f32: nil
+        case .half(let half): half.widenKernel(simdLevel)
+        case .blocks(let format): format.dequantizeKernel(simdLevel)
+        }
+    }
+}
+
+/// Extremes, moments and L2 norm of a run of values, accumulated in one streaming pass.
+///
+/// Values are decoded a QK_K tile at a time into a stack buffer and folded into the summary
+/// straight away, so quantized tensors are summarized without materializing `[Float]`. Tiles
+/// are summarized in f32 and combined in double with Chan's parallel update, which keeps the
+/// variance accurate for large tensors and lets summaries of separate chunks, tensors or
+/// files be merged. Every SIMD level returns the same bits; different `Parallelism` settings
+/// may differ in the last bits because chunk boundaries move.
+public struct Statistics: Sendable, Hashable {
+    /// Number of values
+    public private(set) var count: Int
+    /// Smallest value, ignoring NaNs; +inf when empty
+    public private(set) var min: Float
+    /// Largest value, ignoring NaNs; -inf when empty
+    public private(set) var max: Float
+    public private(set) var mean: Double
+    /// Sum of squared deviations from the mean
+    public private(set) var sumOfSquaredDeviations: Double
+    public private(set) var sumOfSquares: Double
+
+    /// Population variance
+    public var variance: Double {
+        count > 0 ? sumOfSquaredDeviations / Double(count) : 0
+    }
+
+    public var standardDeviation: Double {
+        variance.squareRoot()
+    }
+
+    public var l2Norm: Double {
+        sumOfSquares.squareRoot()
+    }
+
+    /// Summary of no values
+    public init() {
+        var stats = ggml_stats()
+        ggml_stats_init(&stats)
+        self.init(stats)
+    }
+
+    init(_ stats: ggml_stats) {
+        count = Int(stats.count)
+        min = stats.min
+        max = stats.max
+        mean = stats.mean
+        sumOfSquaredDeviations = stats.m2
+        sumOfSquares = stats.sumsq
+    }
+
+    var cValue: ggml_stats {
+        ggml_stats(
+            count: Int64(count), mean: mean, m2: sumOfSquaredDeviations, sumsq: sumOfSquares,
+            min: min, max: max)
+    }
+
+    /// Folds `other` in, as if its values had been appended
+    public mutating func merge(_ other: Statistics) {
+        var stats = cValue
+        var other = other.cValue
+        ggml_stats_merge(&stats, &other)
+        self = Statistics(stats)
+    }
+
+    /// Summarizes `elementCount` values
+    /// - Parameters:
+    ///   - input: Encoded values; must hold at least `elementCount` of them
+    ///   - layout: Encoding of `input`
+    ///   - elementCount: Number of values; a multiple of the block size for `.blocks`
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public init(
+        _ input: UnsafeRawBufferPointer,
+        layout: ValueLayout,
+        elementCount: Int,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        let kernel = simdLevel.statsKernels.pointee.stats!
+        let decode = layout.decodeKernel(simdLevel)
+        let partials = Mutex<[(Int, ggml_stats)]>([])
+        forEachTile(input, layout: layout, elementCount: elementCount, parallelism) {
+            elements, base in
+            var stats = ggml_stats()
+            ggml_stats_init(&stats)
+            if let decode {
+                ggml_dequantize_row_stats(
+                    decode, kernel, Int64(layout.blockSize), layout.bytesPerBlock, base,
+                    Int64(elements.count), &stats)
+            } else {
+                kernel(base.assumingMemoryBound(to: Float.self), Int64(elements.count), &stats)
+            }
+            partials.withLock { $0.append((elements.lowerBound, stats)) }
+        }
+        // Merging in element order keeps the result independent of thread scheduling
+        var total = Statistics()
+        for (_, stats) in partials.withLock({ $0 }).sorted(by: { $0.0 < $1.0 }) {
+            total.merge(Statistics(stats))
+        }
+        self = total
+    }
+
+    /// Summarizes `elementCount` values
+    public init(
+        _ input: Data,
+        layout: ValueLayout,
+        elementCount: Int,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        self = input.withUnsafeBytes { input in
+            Statistics(
+                input, layout: layout, elementCount: elementCount, parallelism: parallelism,
+                simdLevel: simdLevel)
+        }
+    }
+}
+
+/// Value counts in equal-width bins over a fixed range.
+///
+/// Values below the range land in the first bin and values above it in the last; NaNs are
+/// not counted. Like `Statistics`, blocks are decoded a tile at a time.
+public struct Histogram: Sendable, Hashable {
+    public let lowerBound: Float
+    public let upperBound: Float
+    /// Number of values per bin
+    public private(set) var counts: [Int]
+
+    /// An empty histogram
+    /// - Precondition: `binCount` is in 1...2^24 and the bounds are finite and ordered
+    public init(lowerBound: Float, upperBound: Float, binCount: Int) {
+        precondition(binCount > 0 && binCount <= 1 << 24, "Bin count \(binCount) out of range")
+        precondition(
+            lowerBound.isFinite && upperBound.isFinite && lowerBound <= upperBound,
+            "Invalid histogram range \(lowerBound)...\(upperBound)")
+        self.lowerBound = lowerBound
+        self.upperBound = upperBound
+        self.counts = Array(repeating: 0, count: binCount)
+    }
+
+    /// Width of one bin
+    public var binWidth: Float {
+        (upperBound - lowerBound) / Float(counts.count)
+    }
+
+    /// Bins per unit; 0 for an empty range, which puts every value in the first bin
+    var scale: Float {
+        upperBound > lowerBound ? Float(counts.count) / (upperBound - lowerBound) : 0
+    }
+
+    /// Counts `elementCount` more values
+    /// - Parameters:
+    ///   - input: Encoded values; must hold at least `elementCount` of them
+    ///   - layout: Encoding of `input`
+    ///   - elementCount: Number of values; a multiple of the block size for `.blocks`
+    ///   - parallelism: How to split the work across threads
+    ///   - simdLevel: Kernels to use
+    public mutating func add(
+        _ input: UnsafeRawBufferPointer,
+        layout: ValueLayout,
+        elementCount: Int,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        let kernel = simdLevel.statsKernels.pointee.histogram!
+        let decode = layout.decodeKernel(simdLevel)
+        let (lowerBound, scale, binCount) = (self.lowerBound, self.scale, counts.count)
+        let total = Mutex(counts)
+        forEachTile(input, layout: layout, elementCount: elementCount, parallelism) {
+            elements, base in
+            var local = [Int64](repeating: 0, count: binCount)
+            local.withUnsafeMutableBufferPointer { local in
+                if let decode {
+                    ggml_dequantize_row_histogram(
+                        decode, kernel, Int64(layout.blockSize), layout.bytesPerBlock, base,
+                        Int64(elements.count), lowerBound, scale, Int64(binCount),
+                        local.baseAddress)
+                } else {
+                    kernel(
+                        base.assumingMemoryBound(to: Float.self), Int64(elements.count),
+                        lowerBound, scale, Int64(binCount), local.baseAddress)
+                }
+            }
+            total.withLock { counts in
+                for bin in 0..<binCount {
+                    counts[bin] += Int(local[bin])
+                }
+            }
+        }
+        counts = total.withLock { $0 }
+    }
+
+    /// Counts `elementCount` more values
+    public mutating func add(
+        _ input: Data,
+        layout: ValueLayout,
+        elementCount: Int,
+        parallelism: Parallelism = .serial,
+        simdLevel: SIMDLevel = .best
+    ) {
+        input.withUnsafeBytes { input in
+            add(
+                input, layout: layout, elementCount: elementCount, parallelism: parallelism,
+                simdLevel: simdLevel)
+        }
+    }
+}
+
+/// Splits `elementCount` values into block-aligned chunks and calls `body` with each chunk's
+/// element range and the address of its first block
+private func forEachTile(
+    _ input: UnsafeRawBufferPointer,
+    layout: ValueLayout,
+    elementCount: Int,
+    _ parallelism: Parallelism,
+    _ body: (Range<Int>, UnsafeRawPointer) -> Void
+) {
+    let blockSize = layout.blockSize
+    precondition(
+        elementCount % blockSize == 0,
+        "Element count \(elementCount) is not a multiple of the block size \(blockSize)")
+    let blockCount = elementCount / blockSize
+    precondition(
+        input.count >= blockCount * layout.bytesPerBlock,
+        "Input holds fewer than \(elementCount) values")
+    guard let base = input.baseAddress, blockCount > 0 else {
+        return
+    }
+    parallelism.forEachChunk(blockCount: blockCount, blockSize: blockSize) { blocks in
+        body(
+            (blocks.lowerBound * blockSize)..<(blocks.upperBound * blockSize),
+            base + blocks.lowerBound * layout.bytesPerBlock)
+    }
+}
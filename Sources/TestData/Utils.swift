@@ -447,3 +447,451 @@ public let quantizedValuesByName: [(name: String, values: [Float])] = [
         ]
     ),
 ]
+
+/// First 32 values of the fixtures that only the dequantization tests use
+public let dequantizedValuesByName: [(name: String, values: [Float])] = [
+    (
+        name: "Q8_1",
+        values: [
+            -0.2930374,
+            0.13233948,
+            0.31666946,
+            -0.35448074,
+            -0.45373535,
+            -0.2410469,
+            0.576622,
+            0.46791458,
+            -0.16069794,
+            -0.5246315,
+            -0.49154663,
+            -0.39229202,
+            -0.10870743,
+            0.1890564,
+            0.07562256,
+            0.45373535,
+            -0.59552765,
+            0.21268845,
+            0.12288666,
+            -0.19850922,
+            -0.08980179,
+            0.44900894,
+            0.34975433,
+            -0.06616974,
+            0.25049973,
+            -0.4301033,
+            0.45373535,
+            -0.08507538,
+            -0.42065048,
+            -0.59080124,
+            0.03781128,
+            -0.16542435,
+        ]
+    ),
+    (
+        name: "IQ2_XXS",
+        values: [
+            -0.23162842,
+            0.23162842,
+            -1.2450027,
+            -0.23162842,
+            -0.7238388,
+            -0.23162842,
+            0.23162842,
+            -0.7238388,
+            -0.23162842,
+            0.23162842,
+            1.2450027,
+            0.7238388,
+            0.23162842,
+            -0.23162842,
+            0.23162842,
+            0.7238388,
+            -1.2450027,
+            0.7238388,
+            -0.23162842,
+            0.7238388,
+            -0.7238388,
+            0.7238388,
+            -0.23162842,
+            0.23162842,
+            -0.23162842,
+            0.23162842,
+            -0.7238388,
+            0.23162842,
+            1.2450027,
+            0.23162842,
+            0.23162842,
+            0.7238388,
+        ]
+    ),
+    (
+        name: "IQ2_XS",
+        values: [
+            1.2832642,
+            -0.41064453,
+            0.41064453,
+            -2.2072144,
+            -1.2832642,
+            -0.41064453,
+            0.41064453,
+            0.41064453,
+            -2.2072144,
+            1.2832642,
+            -0.41064453,
+            2.2072144,
+            -0.41064453,
+            2.2072144,
+            1.2832642,
+            -0.41064453,
+            0.68499756,
+            0.68499756,
+            0.1274414,
+            -0.3982544,
+            0.68499756,
+            0.1274414,
+            -0.68499756,
+            0.3982544,
+            0.68499756,
+            0.1274414,
+            -0.1274414,
+            0.3982544,
+            0.68499756,
+            0.3982544,
+            0.1274414,
+            -0.1274414,
+        ]
+    ),
+    (
+        name: "IQ2_S",
+        values: [
+            -0.4764557,
+            0.4764557,
+            -1.488924,
+            0.4764557,
+            0.4764557,
+            -1.488924,
+            -1.488924,
+            -1.488924,
+            2.5609493,
+            -1.488924,
+            1.488924,
+            -1.488924,
+            2.5609493,
+            0.4764557,
+            -2.5609493,
+            1.488924,
+            3.1755772,
+            1.8462658,
+            -0.59080505,
+            1.8462658,
+            1.8462658,
+            1.8462658,
+            0.59080505,
+            0.59080505,
+            -1.8462658,
+            -1.8462658,
+            0.59080505,
+            0.59080505,
+            3.1755772,
+            1.8462658,
+            1.8462658,
+            0.59080505,
+        ]
+    ),
+    (
+        name: "IQ3_XXS",
+        values: [
+            -2.0747948,
+            -0.9370041,
+            -1.2047195,
+            -0.13385773,
+            -0.13385773,
+            -0.9370041,
+            0.9370041,
+            1.7401505,
+            -0.40157318,
+            -0.66928864,
+            0.13385773,
+            0.40157318,
+            0.13385773,
+            -2.0747948,
+            -0.40157318,
+            0.66928864,
+            -0.9370041,
+            -1.2047195,
+            1.472435,
+            -1.2047195,
+            1.2047195,
+            -0.9370041,
+            -0.13385773,
+            -0.40157318,
+            2.0747948,
+            -1.472435,
+            -1.2047195,
+            0.13385773,
+            -1.2047195,
+            -1.7401505,
+            1.2047195,
+            1.2047195,
+        ]
+    ),
+    (
+        name: "IQ3_S",
+        values: [
+            -0.68348694,
+            0.68348694,
+            1.5948029,
+            -1.1391449,
+            -3.4174347,
+            0.22782898,
+            1.5948029,
+            0.68348694,
+            1.5948029,
+            -0.68348694,
+            -0.22782898,
+            -1.5948029,
+            2.0504608,
+            -0.22782898,
+            2.0504608,
+            -2.5061188,
+            1.1391449,
+            2.0504608,
+            1.1391449,
+            2.9617767,
+            1.1391449,
+            1.1391449,
+            0.22782898,
+            2.5061188,
+            -0.68348694,
+            1.5948029,
+            1.5948029,
+            -0.22782898,
+            -1.1391449,
+            -1.1391449,
+            -1.5948029,
+            -0.22782898,
+        ]
+    ),
+    (
+        name: "IQ1_S",
+        values: [
+            -0.10007858,
+            -0.0111198425,
+            -0.0111198425,
+            0.0778389,
+            -0.10007858,
+            -0.10007858,
+            -0.0111198425,
+            0.0778389,
+            -0.10007858,
+            -0.0111198425,
+            -0.10007858,
+            -0.10007858,
+            -0.10007858,
+            0.0778389,
+            -0.0111198425,
+            -0.0111198425,
+            0.0778389,
+            0.0778389,
+            -0.10007858,
+            -0.0111198425,
+            0.0778389,
+            -0.0111198425,
+            -0.0111198425,
+            -0.10007858,
+            -0.10007858,
+            -0.0111198425,
+            0.0778389,
+            -0.10007858,
+            -0.0111198425,
+            -0.10007858,
+            -0.0111198425,
+            -0.10007858,
+        ]
+    ),
+    (
+        name: "IQ1_M",
+        values: [
+            -0.060060024,
+            -0.060060024,
+            0.046713352,
+            -0.006673336,
+            0.046713352,
+            -0.006673336,
+            0.046713352,
+            -0.060060024,
+            0.046713352,
+            -0.006673336,
+            -0.060060024,
+            -0.060060024,
+            0.046713352,
+            -0.006673336,
+            -0.006673336,
+            -0.060060024,
+            0.006673336,
+            0.006673336,
+            0.0007414818,
+            -0.0051903725,
+            0.0007414818,
+            -0.0051903725,
+            -0.0051903725,
+            0.0007414818,
+            -0.0007414818,
+            -0.0007414818,
+            -0.0007414818,
+            0.0051903725,
+            -0.0007414818,
+            0.0051903725,
+            -0.0007414818,
+            -0.0007414818,
+        ]
+    ),
+    (
+        name: "IQ4_XS",
+        values: [
+            3.1262207,
+            9.138184,
+            -19.959717,
+            21.402588,
+            6.011963,
+            21.402588,
+            21.402588,
+            27.174072,
+            12.745361,
+            27.174072,
+            16.593018,
+            0.24047852,
+            -2.4047852,
+            -2.4047852,
+            0.24047852,
+            -2.4047852,
+            -25.009766,
+            12.745361,
+            -11.783447,
+            3.1262207,
+            27.174072,
+            0.24047852,
+            -19.959717,
+            16.593018,
+            21.402588,
+            6.011963,
+            -11.783447,
+            16.593018,
+            -8.416748,
+            12.745361,
+            -30.540771,
+            -15.6311035,
+        ]
+    ),
+    (
+        name: "TQ1_0",
+        values: [
+            -0.018081665,
+            0.018081665,
+            0.0,
+            -0.018081665,
+            -0.018081665,
+            -0.018081665,
+            0.018081665,
+            0.0,
+            -0.018081665,
+            -0.018081665,
+            0.0,
+            0.0,
+            0.018081665,
+            0.0,
+            -0.018081665,
+            0.0,
+            0.018081665,
+            -0.018081665,
+            0.0,
+            0.0,
+            0.0,
+            -0.018081665,
+            0.0,
+            0.0,
+            0.0,
+            0.0,
+            -0.018081665,
+            0.018081665,
+            0.018081665,
+            -0.018081665,
+            0.018081665,
+            0.0,
+        ]
+    ),
+    (
+        name: "TQ2_0",
+        values: [
+            0.0,
+            0.0,
+            0.0029449463,
+            -0.0029449463,
+            0.0,
+            -0.0029449463,
+            -0.0029449463,
+            0.0,
+            -0.0029449463,
+            0.0,
+            0.0029449463,
+            0.0029449463,
+            0.0029449463,
+            -0.0029449463,
+            -0.0029449463,
+            -0.0029449463,
+            -0.0029449463,
+            0.0,
+            0.0,
+            0.0,
+            0.0029449463,
+            -0.0029449463,
+            0.0029449463,
+            0.0029449463,
+            0.0029449463,
+            -0.0029449463,
+            0.0029449463,
+            0.0,
+            0.0,
+            0.0,
+            -0.0029449463,
+            -0.0029449463,
+        ]
+    ),
+    (
+        name: "MXFP4",
+        values: [
+            1.0,
+            0.0,
+            -6.0,
+            1.0,
+            6.0,
+            2.0,
+            1.0,
+            0.0,
+            -6.0,
+            -4.0,
+            -1.0,
+            1.5,
+            6.0,
+            -6.0,
+            1.0,
+            2.0,
+            -4.0,
+            6.0,
+            1.5,
+            0.5,
+            1.5,
+            -1.5,
+            4.0,
+            0.0,
+            -1.0,
+            4.0,
+            -3.0,
+            -4.0,
+            -4.0,
+            2.0,
+            0.0,
+            1.0,
+        ]
+    ),
+]
@@ -0,0 +1,113 @@
+import Foundation
+import Quants
+import Synchronization
+import Testing
+
+@testable import GGUF
+
+@Suite struct BatchLoaderTests {
+    /// Tensors of very different sizes: a large Q4_K matrix, a Q8_0 matrix, small f16/f32
+    /// vectors and an i8 vector
+    func makeFile() throws -> (GGUF, Data) {
+        try makeGGUFFile(tensors: [
+            .q4_K("token_embd.weight"),
+            .q8_0("blk.0.attn_q.weight", rows: 8),
+            TestTensor(
+                "blk.0.attn_norm.weight", (0..<48).map { Float16(Float($0) - 24) }, type: .f16),
+            TestTensor("output_norm.weight", (0..<100).map(Float.init), type: .f32),
+            TestTensor("ids", (0..<77).map { UInt8($0) }, type: .i8),
+        ])
+    }
+
+    @Test(arguments: [1, 3, 8])
+    func `every tensor should match tensorFloatArray`(_ maxConcurrency: Int) throws {
+        let (gguf, fileData) = try makeFile()
+        let loaded = Mutex<[Int: [Float]]>([:])
+        // Small tasks split the matrices across every worker
+        let options = GGUF.BatchLoadOptions(maxConcurrency: maxConcurrency, taskSize: 4096)
+        try gguf.loadTensors(.all, from: fileData, options: options) { values in
+            let array = Array(values)
+            loaded.withLock { $0[values.tensorIndex] = array }
+        }
+        let results = loaded.withLock { $0 }
+        #expect(results.count == gguf.tensorInfos.count)
+        for index in gguf.tensorInfos.indices {
+            #expect(results[index] == (try gguf.tensorFloatArray(at: index, from: fileData)))
+        }
+    }
+
+    @Test func `selections should pick tensors by name, index or predicate`() throws {
+        let (gguf, fileData) = try makeFile()
+        let byName = try gguf.tensorIndices(
+            of: .names(["output_norm.weight", "token_embd.weight", "output_norm.weight"]))
+        #expect(byName == [3, 0])
+        #expect(try gguf.tensorIndices(of: .indices([4, 1, 4])) == [4, 1])
+        let norms = try gguf.tensorIndices(of: .matching { $0.name.hasSuffix("norm.weight") })
+        #expect(norms == [2, 3])
+        #expect(throws: GGUF.Error.self) {
+            try gguf.loadTensors(.names(["missing"]), from: fileData) { _ in }
+        }
+    }
+
+    @Test func `errors from the callback should stop the load`() throws {
+        struct Stop: Swift.Error {}
+        let (gguf, fileData) = try makeFile()
+        let delivered = Atomic<Int>(0)
+        #expect(throws: Stop.self) {
+            try gguf.loadTensors(
+                .all, from: fileData, options: GGUF.BatchLoadOptions(maxConcurrency: 1)
+            ) { _ in
+                delivered.add(1, ordering: .relaxed)
+                throw Stop()
+            }
+        }
+        #expect(delivered.load(ordering: .relaxed) == 1)
+    }
+
+    @Test func `tensors should stream as they complete`() async throws {
+        let (gguf, fileData) = try makeFile()
+        var indices = [Int]()
+        for try await values in try gguf.tensorValues(.indices([0, 2]), from: fileData) {
+            indices.append(values.tensorIndex)
+            let expected = try gguf.tensorFloatArray(at: values.tensorIndex, from: fileData)
+            values.withUnsafeBufferPointer { #expect(Array($0) == expected) }
+        }
+        #expect(indices.sorted() == [0, 2])
+    }
+
+    @Test func `a slow consumer should get every tensor once`() async throws {
+        let (gguf, fileData) = try makeFile()
+        // Workers finish tensors faster than they are taken and wait for room
+        let options = GGUF.BatchLoadOptions(maxConcurrency: 2, taskSize: 4096)
+        var indices = [Int]()
+        for try await values in try gguf.tensorValues(.all, from: fileData, options: options) {
+            try await Task.sleep(for: .milliseconds(20))
+            indices.append(values.tensorIndex)
+            let expected = try gguf.tensorFloatArray(at: values.tensorIndex, from: fileData)
+            values.withUnsafeBufferPointer { #expect(Array($0) == expected) }
+        }
+        #expect(indices.sorted() == Array(gguf.tensorInfos.indices))
+    }
+
+    @Test func `ending iteration early should release blocked workers`() async throws {
+        let (gguf, fileData) = try makeFile()
+        let options = GGUF.BatchLoadOptions(maxConcurrency: 1, taskSize: 256)
+        for _ in 0..<10 {
+            for try await _ in try gguf.tensorValues(.all, from: fileData, options: options) {
+                break
+            }
+        }
+        // A cancelled consumer ends the stream instead of waiting forever
+        let task = Task {
+            var count = 0
+            for try await _ in try gguf.tensorValues(.all, from: fileData, options: options) {
+                count += 1
+                try await Task.sleep(for: .seconds(10))
+            }
+            return count
+        }
+        try await Task.sleep(for: .milliseconds(50))
+        task.cancel()
+        #expect(await (try? task.value) == nil)
+    }
+}
@@ -1,4 +1,5 @@
 import Foundation
+import Quants
 import TestData
 import Testing
 
@@ -25,3 +26,208 @@ func `float array should be present for different tensor data types`(_ resource:
         )
     )
 }
+
+@Test(arguments: ["Q4_0", "Q4_K", "Q6_K"])
+func `parallel float array should match serial float array`(_ resource: String) throws {
+    let payload = try #require(testData(named: resource, withExtension: "bin"))
+    let type = try #require(
+        [GGUF.TensorType.q4_0, .q4_K, .q6_K].first { $0.description == resource })
+    let fileData = makeGGUFFile(dimensions: [256, 2048], type: type, payload: payload)
+    let gguf = try GGUF(parsing: fileData)
+
+    let serial = try gguf.tensorFloatArray(at: 0, from: fileData)
+    let parallel = try gguf.tensorFloatArray(
+        at: 0,
+        from: fileData,
+        parallelism: Parallelism(maxConcurrency: 5, minimumChunkSize: 256)
+    )
+    #expect(serial.count == 2048 * 256)
+    #expect(parallel.map(\.bitPattern) == serial.map(\.bitPattern))
+}
+
+@Test(arguments: ["Q4_0", "Q4_K", "Q6_K"])
+func `row range should match the corresponding slice of the full tensor`(
+    _ resource: String
+) throws {
+    let payload = try #require(testData(named: resource, withExtension: "bin"))
+    let type = try #require(
+        [GGUF.TensorType.q4_0, .q4_K, .q6_K].first { $0.description == resource })
+    let fileData = makeGGUFFile(dimensions: [512, 1024], type: type, payload: payload)
+    let gguf = try GGUF(parsing: fileData)
+    let full = try gguf.tensorFloatArray(at: 0, from: fileData)
+
+    #expect(gguf.tensorInfos[0].rowLength == 512)
+    #expect(gguf.tensorInfos[0].rowCount == 1024)
+    for rows in [0..<1, 17..<18, 100..<356, 1023..<1024] {
+        let slice = try gguf.tensorRowsFloatArray(rows, ofTensorAt: 0, from: fileData)
+        #expect(slice == Array(full[(rows.lowerBound * 512)..<(rows.upperBound * 512)]))
+    }
+}
+
+@Test func `dequantizing into a buffer should match the float array`() throws {
+    let fileData = try #require(testData(named: "small", withExtension: "gguf"))
+    let gguf = try GGUF(parsing: fileData)
+
+    for (index, info) in gguf.tensorInfos.enumerated() {
+        var buffer = [Float](repeating: .nan, count: Int(info.elementCount))
+        try buffer.withUnsafeMutableBufferPointer { output in
+            try gguf.dequantizeTensor(at: index, from: fileData, into: output)
+        }
+        #expect(buffer == (try gguf.tensorFloatArray(at: index, from: fileData)))
+    }
+}
+
+@Test func `invalid row ranges and buffer sizes should throw`() throws {
+    let payload = try #require(testData(named: "Q4_0", withExtension: "bin"))
+    let fileData = makeGGUFFile(dimensions: [512, 1024], type: .q4_0, payload: payload)
+    let gguf = try GGUF(parsing: fileData)
+    var buffer = [Float](repeating: 0, count: 512)
+
+    try buffer.withUnsafeMutableBufferPointer { output in
+        #expect(throws: GGUF.Error.self) {
+            try gguf.dequantizeRows(1024..<1025, ofTensorAt: 0, from: fileData, into: output)
+        }
+        #expect(throws: GGUF.Error.self) {
+            try gguf.dequantizeRows(0..<2, ofTensorAt: 0, from: fileData, into: output)
+        }
+        #expect(throws: GGUF.Error.self) {
+            try gguf.dequantizeTensor(at: 0, from: fileData, into: output)
+        }
+    }
+}
+
+@Test func `tensor matvec should match dequantize then dot`() throws {
+    let payload = try #require(testData(named: "Q4_K", withExtension: "bin"))
+    let fileData = makeGGUFFile(dimensions: [512, 1024], type: .q4_K, payload: payload)
+    let gguf = try GGUF(parsing: fileData)
+    let weights = try gguf.tensorFloatArray(at: 0, from: fileData)
+    let vector = (0..<512).map { Float($0 % 7) - 3 }
+
+    let result = try gguf.multiply(tensorAt: 0, by: vector, from: fileData)
+    #expect(result.count == 1024)
+    for row in [0, 511, 1023] {
+        let expected = zip(weights[(row * 512)..<((row + 1) * 512)], vector)
+            .reduce(0.0) { $0 + Double($1.0) * Double($1.1) }
+        #expect(abs(Double(result[row]) - expected) < 1e-3)
+    }
+    #expect(throws: GGUF.Error.self) {
+        try gguf.multiply(tensorAt: 0, by: Array(vector[..<256]), from: fileData)
+    }
+}
+
+@Test(arguments: ["F32", "F64", "F16", "I8", "I16", "I32", "I64"])
+func `half array should hold the narrowed values`(_ resource: String) throws {
+    let fileData = try #require(testData(named: resource, withExtension: "gguf"))
+    let gguf = try GGUF(parsing: fileData)
+    let expected = (1...32).map { Float($0 % 2 == 0 ? -$0 : $0) }
+
+    for half in HalfFormat.allCases {
+        let values = try gguf.tensorHalfArray(at: 0, from: fileData, as: half)
+        var narrowed = [UInt16](repeating: 0, count: expected.count)
+        expected.withUnsafeBufferPointer { input in
+            narrowed.withUnsafeMutableBufferPointer { output in
+                Dequantize.narrow(input, into: output, as: half)
+            }
+        }
+        #expect(values == narrowed, "\(resource) to \(half)")
+    }
+}
+
+@Test func `half tensors should pass through without conversion`() throws {
+    let values = (0..<64).map { Float($0) - 20.5 }
+    var bf16 = Data(count: values.count * 2)
+    values.withUnsafeBufferPointer { input in
+        bf16.withUnsafeMutableBytes { output in
+            Dequantize.narrow(input, into: output.bindMemory(to: UInt16.self), as: .bf16)
+        }
+    }
+    let fileData = makeGGUFFile(dimensions: [64], type: .bf16, payload: bf16)
+    let gguf = try GGUF(parsing: fileData)
+
+    #expect(try gguf.tensorHalfData(at: 0, from: fileData, as: .bf16) == bf16)
+    #expect(try gguf.tensorFloatArray(at: 0, from: fileData) == values)
+    let f16 = try gguf.tensorHalfData(at: 0, from: fileData, as: .f16)
+    let roundTrip = makeGGUFFile(dimensions: [64], type: .f16, payload: f16)
+    #expect(try GGUF(parsing: roundTrip).tensorFloatArray(at: 0, from: roundTrip) == values)
+}
+
+@Test func `large integer tensors should convert in parallel like Float.init`() throws {
+    let values = (0..<100_000).map { Int32(truncatingIfNeeded: $0 &* 2_654_435_761) }
+    let payload = values.withUnsafeBytes { Data($0) }
+    let fileData = makeGGUFFile(dimensions: [1000, 100], type: .i32, payload: payload)
+    let gguf = try GGUF(parsing: fileData)
+
+    let converted = try gguf.tensorFloatArray(
+        at: 0, from: fileData, parallelism: Parallelism(maxConcurrency: 4, minimumChunkSize: 1))
+    #expect(converted == values.map(Float.init))
+}
+
+@Test func `f32 values should be viewed in place`() throws {
+    let fileData = try #require(testData(named: "F32", withExtension: "gguf"))
+    let gguf = try GGUF(parsing: fileData)
+    let expected = try gguf.tensorFloatArray(at: 0, from: fileData)
+
+    let range = gguf.tensorInfos.byteRange(at: 0)
+    try fileData.withUnsafeBytes { file in
+        try gguf.withF32Values(ofTensorAt: 0, from: fileData) { values in
+            #expect(Array(values) == expected)
+            #expect(UnsafeRawPointer(values.baseAddress) == file.baseAddress! + range.lowerBound)
+        }
+    }
+    let f16 = try #require(testData(named: "F16", withExtension: "gguf"))
+    #expect(throws: GGUF.Error.self) {
+        try GGUF(parsing: f16).withF32Values(ofTensorAt: 0, from: f16) { _ in }
+    }
+}
+
+@Test func `f32 tensors should narrow to half from data at an odd address`() throws {
+    let fileData = try #require(testData(named: "F32", withExtension: "gguf"))
+    let gguf = try GGUF(parsing: fileData)
+    let expected = try gguf.tensorHalfArray(at: 0, from: fileData, as: .f16)
+
+    try withMisalignedCopy(of: fileData) { misaligned in
+        #expect(try gguf.tensorHalfArray(at: 0, from: misaligned, as: .f16) == expected)
+    }
+}
+
+@Test(arguments: ["Q4_0", "Q4_K", "Q6_K"])
+func `quantized tensors should dequantize straight to half`(_ resource: String) throws {
+    let payload = try #require(testData(named: resource, withExtension: "bin"))
+    let type = try #require(
+        [GGUF.TensorType.q4_0, .q4_K, .q6_K].first { $0.description == resource })
+    let fileData = makeGGUFFile(dimensions: [256, 2048], type: type, payload: payload)
+    let gguf = try GGUF(parsing: fileData)
+    let format = try #require(type.blockFormat)
+
+    let half = try gguf.tensorHalfArray(
+        at: 0, from: fileData, as: .f16, parallelism: .automatic)
+    let expected = Dequantize.dequantize(
+        payload, format: format, elementCount: 256 * 2048, as: .f16)
+    #expect(half == expected)
+}
+
+@Test func `tensor type sizes should match the block formats`() {
+    for type in (0...UInt32(64)).compactMap(GGUF.TensorType.init(rawValue:)) {
+        guard let format = type.blockFormat else {
+            continue
+        }
+        #expect(type.blockSize == format.blockSize, "\(type)")
+        #expect(type.bytesPerBlock == format.bytesPerBlock, "\(type)")
+    }
+}
+
+@Test(arguments: dequantizedValuesByName.map(\.name))
+func `dequantize-only tensor types should convert to floats`(_ resource: String) throws {
+    let payload = try #require(testData(named: resource, withExtension: "bin"))
+    let type = try #require(
+        (0...UInt32(64)).compactMap(GGUF.TensorType.init(rawValue:)).first {
+            $0.description == resource
+        })
+    let format = try #require(type.blockFormat)
+    let fileData = makeGGUFFile(dimensions: [256, 2048], type: type, payload: payload)
+    let gguf = try GGUF(parsing: fileData)
+
+    let values = try gguf.tensorFloatArray(at: 0, from: fileData, parallelism: .automatic)
+    let expected = Dequantize.dequantize(payload, format: format, elementCount: 256 * 2048)
+    #expect(values.map(\.bitPattern) == expected.map(\.bitPattern))
+}
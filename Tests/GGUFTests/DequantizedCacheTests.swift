@@ -0,0 +1,124 @@
+import Foundation
+import Quants
+import Testing
+
+@testable import GGUF
+
+@Suite struct DequantizedCacheTests {
+    /// A Q4_K matrix of 16 rows and an f32 vector whose size is not a multiple of 64 bytes
+    func makeFile() throws -> (GGUF, Data) {
+        try makeGGUFFile(tensors: [
+            .q4_K("blk.0.ffn_up.weight", rows: 16),
+            TestTensor("bias", (0..<33).map(Float.init), type: .f32),
+        ])
+    }
+
+    func temporaryURL() -> URL {
+        FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString + ".dqc")
+    }
+
+    @Test func `cached tensors should match tensorFloatArray`() throws {
+        let (gguf, fileData) = try makeFile()
+        let url = temporaryURL()
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        #expect(try GGUF.DequantizedCache(contentsOf: url, for: gguf, fileData: fileData) == nil)
+        _ = try GGUF.DequantizedCache.open(at: url, for: gguf, fileData: fileData)
+        let cache = try #require(
+            try GGUF.DequantizedCache(contentsOf: url, for: gguf, fileData: fileData))
+        #expect(cache.precision == .f32)
+        for index in 0..<gguf.tensorInfos.count {
+            let expected = try gguf.tensorFloatArray(at: index, from: fileData)
+            let cached = try #require(cache.tensor(at: index))
+            #expect(Array(cached) == expected)
+            cached.withUnsafeBufferPointer { values in
+                #expect(Int(bitPattern: values.baseAddress) % 64 == 0)
+                #expect(Array(values) == expected)
+            }
+        }
+        #expect(cache.tensor("bias")?.count == 33)
+        #expect(cache.tensor("missing") == nil)
+    }
+
+    @Test func `half precision caches should match tensorHalfArray`() throws {
+        let (gguf, fileData) = try makeFile()
+        let url = temporaryURL()
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        for half in [HalfFormat.f16, .bf16] {
+            let precision: GGUF.DequantizedCache.Precision = half == .f16 ? .f16 : .bf16
+            let cache = try GGUF.DequantizedCache.open(
+                at: url, for: gguf, fileData: fileData, precision: precision)
+            #expect(cache.precision == precision)
+            let expected = try gguf.tensorHalfArray(at: 0, from: fileData, as: half)
+            let cached = try #require(cache.tensor(at: 0))
+            cached.withUnsafeHalfBufferPointer { #expect(Array($0) == expected) }
+            #expect(cached.count == expected.count)
+        }
+    }
+
+    @Test(arguments: GGUF.DequantizedCache.Precision.allCases)
+    func `tensorFloatArray should be served from the cache`(
+        _ precision: GGUF.DequantizedCache.Precision
+    ) throws {
+        let (gguf, fileData) = try makeFile()
+        let url = temporaryURL()
+        defer { try? FileManager.default.removeItem(at: url) }
+        let cache = try GGUF.DequantizedCache.open(
+            at: url, for: gguf, fileData: fileData, precision: precision)
+
+        for index in gguf.tensorInfos.indices {
+            let values = try gguf.tensorFloatArray(at: index, from: fileData, cache: cache)
+            #expect(values == Array(try #require(cache.tensor(at: index))))
+            let expected = try gguf.tensorFloatArray(at: index, from: fileData)
+            switch precision {
+            case .f32:
+                #expect(values == expected)
+            case .f16, .bf16:
+                let half: HalfFormat = precision == .f16 ? .f16 : .bf16
+                let bits = try gguf.tensorHalfArray(at: index, from: fileData, as: half)
+                let widened = Dequantize.convert(
+                    bits.withUnsafeBytes { Data($0) }, from: precision == .f16 ? .f16 : .bf16,
+                    elementCount: bits.count)
+                #expect(values == widened)
+            }
+        }
+    }
+
+    @Test func `caches built for another model should be stale`() throws {
+        let (gguf, fileData) = try makeFile()
+        let url = temporaryURL()
+        defer { try? FileManager.default.removeItem(at: url) }
+        try GGUF.DequantizedCache.build(for: gguf, fileData: fileData, at: url)
+
+        // Same layout, different weights and a different name: the header hash differs
+        var writer = try GGUF.Writer()
+        let bias = [Float](repeating: 1, count: 33).withUnsafeBytes { Data($0) }
+        try writer.addTensor(name: "other", dimensions: [33], dataType: .f32, source: .data(bias))
+        let otherData = try writer.serializedData()
+        let other = try GGUF(parsing: otherData)
+        #expect(try GGUF.DequantizedCache(contentsOf: url, for: other, fileData: otherData) == nil)
+
+        let rebuilt = try GGUF.DequantizedCache.open(at: url, for: other, fileData: otherData)
+        #expect(rebuilt.tensor("other").map(Array.init) == [Float](repeating: 1, count: 33))
+        #expect(try GGUF.DequantizedCache(contentsOf: url, for: gguf, fileData: fileData) == nil)
+
+        // A truncated cache is a miss as well
+        let truncated = try Data(contentsOf: url).prefix(80)
+        try truncated.write(to: url)
+        #expect(try GGUF.DequantizedCache(contentsOf: url, for: other, fileData: otherData) == nil)
+    }
+
+    @Test func `failing to write the cache should be a write error`() throws {
+        let (gguf, fileData) = try makeFile()
+        let url = temporaryURL().appendingPathComponent("missing").appendingPathComponent("cache")
+        let error = #expect(throws: GGUF.Error.self) {
+            try GGUF.DequantizedCache.build(for: gguf, fileData: fileData, at: url)
+        }
+        guard case .fileWriteFailed(let code) = error else {
+            Issue.record("Expected fileWriteFailed, got \(String(describing: error))")
+            return
+        }
+        #expect(code == ENOENT)
+    }
+}
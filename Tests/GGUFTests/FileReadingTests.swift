@@ -0,0 +1,125 @@
+import Foundation
+import Testing
+
+@testable import GGUF
+
+@Suite struct FileReadingTests {
+    func withTemporaryFile<T>(_ data: Data, _ body: (String) throws -> T) throws -> T {
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString + ".gguf")
+        try data.write(to: url)
+        defer { try? FileManager.default.removeItem(at: url) }
+        return try body(url.path)
+    }
+
+    func makeFile() throws -> Data {
+        try makeGGUFFile(
+            metadata: [
+                .init(key: "general.name", value: .string("pread"), valueType: .string),
+                .init(
+                    key: "tokenizer.ggml.tokens",
+                    value: .array(.string, (0..<500).map { .string("token \($0)") }),
+                    valueType: .array
+                ),
+            ],
+            tensors: [
+                .q4_K("weight"), TestTensor("bias", [Float](repeating: 0, count: 8), type: .f32),
+            ]
+        ).data
+    }
+
+    @Test(arguments: [64, 1000, 1 << 18])
+    func `reading the header region should match parsing the whole file`(
+        _ initialReadSize: Int
+    ) throws {
+        let data = try makeFile()
+        let expected = try GGUF(parsing: data)
+        let gguf = try withTemporaryFile(data) { path in
+            try GGUF(contentsOfFile: path, initialReadSize: initialReadSize)
+        }
+        #expect(gguf.metadata.map(\.key) == expected.metadata.map(\.key))
+        #expect(gguf.metadata.map(\.value) == expected.metadata.map(\.value))
+        #expect(gguf.tensorInfos.map(\.name) == expected.tensorInfos.map(\.name))
+        #expect(gguf.tensorInfos.map(\.offset) == expected.tensorInfos.map(\.offset))
+        #expect(gguf.tensorDataOffset == expected.tensorDataOffset)
+    }
+
+    @Test func `tensor payloads should be read by exact range`() throws {
+        let data = try makeFile()
+        try withTemporaryFile(data) { path in
+            let handle = try #require(FileHandle(forReadingAtPath: path))
+            defer { try? handle.close() }
+            let gguf = try GGUF(
+                fileDescriptor: handle.fileDescriptor,
+                metadataDecoding: .lazy,
+                initialReadSize: 100
+            )
+            for index in gguf.tensorInfos.indices {
+                let payload = try gguf.tensorData(at: index, fileDescriptor: handle.fileDescriptor)
+                #expect(payload == gguf.tensorData(at: index, from: data))
+                #expect(payload.count == gguf.tensorByteRange(at: index).count)
+            }
+            #expect(try gguf.tensorData("missing", fileDescriptor: handle.fileDescriptor) == nil)
+        }
+    }
+
+    @Test func `truncated files should throw`() throws {
+        let data = try makeFile()
+        let gguf = try GGUF(parsing: data)
+        try withTemporaryFile(data.prefix(gguf.tensorDataOffset / 2)) { path in
+            #expect(throws: (any Error).self) {
+                try GGUF(contentsOfFile: path, initialReadSize: 64)
+            }
+        }
+        // The header region is intact but the last payload is cut short
+        try withTemporaryFile(data.prefix(data.count - 4)) { path in
+            let handle = try #require(FileHandle(forReadingAtPath: path))
+            defer { try? handle.close() }
+            let truncated = try GGUF(fileDescriptor: handle.fileDescriptor)
+            #expect(throws: GGUF.Error.self) {
+                try truncated.tensorData("bias", fileDescriptor: handle.fileDescriptor)
+            }
+        }
+    }
+
+    /// Parses `data` as if it were a file, recording the range of every read
+    func parsePrefix(
+        of data: Data,
+        initialReadSize: Int
+    ) -> (result: Result<GGUF, any Error>, reads: [Range<Int>]) {
+        var reads: [Range<Int>] = []
+        let result = Result {
+            try GGUF.parsingPrefix(
+                metadataDecoding: .eager, initialReadSize: initialReadSize
+            ) { buffer, offset in
+                let range = offset..<max(offset, min(data.count, offset + buffer.count))
+                _ = data.copyBytes(to: buffer, from: range)
+                reads.append(range)
+                return range.count
+            }
+        }
+        return (result, reads)
+    }
+
+    @Test func `reads should stop at twice the header region`() throws {
+        let data = try makeFile()
+        let expected = try GGUF(parsing: data)
+        let (result, reads) = parsePrefix(of: data, initialReadSize: 64)
+        #expect(try result.get().tensorDataOffset == expected.tensorDataOffset)
+        #expect(reads.count > 1)
+        #expect(try #require(reads.last).upperBound < 2 * expected.tensorDataOffset)
+    }
+
+    @Test(arguments: [
+        (0, UInt8(0x00)),  // magic number
+        (4, 0x09),  // version
+        (24 + 8 + "general.name".utf8.count, 0x7F),  // value type of the first entry
+    ])
+    func `invalid headers should fail after the first read`(_ offset: Int, _ byte: UInt8) throws {
+        var data = try makeFile()
+        data[offset] = byte
+        let (result, reads) = parsePrefix(of: data, initialReadSize: 64)
+        #expect(throws: GGUF.Error.self) { try result.get() }
+        #expect(reads == [0..<64])
+    }
+}
@@ -0,0 +1,134 @@
+import Foundation
+import Testing
+
+@testable import GGUF
+
+@Suite struct LazyMetadataTests {
+    static let tokens = (0..<1000).map { "tok_\($0)_é" }
+    static let metadata: [GGUF.MetadataKeyValue] = [
+        .init(key: "general.name", value: .string("lazy"), valueType: .string),
+        .init(
+            key: "tokenizer.ggml.tokens",
+            value: .array(.string, tokens.map { .string($0) }),
+            valueType: .array
+        ),
+        .init(
+            key: "tokenizer.ggml.scores",
+            value: .array(.float32, (0..<1000).map { .float32(Float($0) / 8) }),
+            valueType: .array
+        ),
+        .init(
+            key: "test.nested",
+            value: .array(
+                .array,
+                [
+                    .array(.int16, [.int16(-1), .int16(2)]),
+                    .array(.string, [.string("x"), .string("")]),
+                    .array(.uint8, []),
+                ]),
+            valueType: .array
+        ),
+        .init(key: "test.empty", value: .array(.string, []), valueType: .array),
+    ]
+
+    /// Replaces lazy arrays, including nested ones, with their eager form
+    func decoded(_ value: GGUF.MetadataValue) -> GGUF.MetadataValue {
+        guard case .lazyArray(let array) = value else {
+            return value
+        }
+        return .array(array.elementType, array.map(decoded))
+    }
+
+    func makeFile() throws -> Data {
+        var writer = try GGUF.Writer(metadata: Self.metadata)
+        try writer.addTensor(
+            name: "t", dimensions: [4], dataType: .f32, source: .data(Data(count: 16)))
+        return try writer.serializedData()
+    }
+
+    @Test func `lazy arrays should decode to the eager values`() throws {
+        let data = try makeFile()
+        let eager = try GGUF(parsing: data, metadataDecoding: .eager)
+        let lazy = try GGUF(parsing: data, metadataDecoding: .lazy)
+
+        #expect(lazy.metadata.map(\.key) == eager.metadata.map(\.key))
+        #expect(lazy.metadata.map { decoded($0.value) } == eager.metadata.map(\.value))
+        #expect(lazy.tensorDataOffset == eager.tensorDataOffset)
+        #expect(lazy.tensorInfos.map(\.offset) == eager.tensorInfos.map(\.offset))
+        #expect(lazy.metadataValue(forKey: "general.name") == .string("lazy"))
+    }
+
+    @Test func `packed decoding should pack only fixed-width arrays`() throws {
+        let data = try makeFile()
+        let eager = try GGUF(parsing: data)
+        let packed = try GGUF(parsing: data, metadataDecoding: .packedNumericArrays)
+        #expect(zip(packed.metadata, eager.metadata).allSatisfy { isClose($0.value, $1.value) })
+
+        #expect(
+            packed.metadataValue(forKey: "tokenizer.ggml.tokens")
+                == eager.metadataValue(forKey: "tokenizer.ggml.tokens"))
+        let scores = try #require(packed.metadataValue(forKey: "tokenizer.ggml.scores"))
+        guard case .lazyArray(let array) = scores else {
+            Issue.record("float32 array was decoded element by element")
+            return
+        }
+        #expect(array.values(as: Float.self) == (0..<1000).map { Float($0) / 8 })
+        // Copied out of the file data rather than viewing it
+        let fileBytes = data.withUnsafeBytes { $0.baseAddress! }
+        let arrayBytes = array.bytes.withUnsafeBytes { $0.baseAddress! }
+        #expect(arrayBytes < fileBytes || arrayBytes >= fileBytes + data.count)
+    }
+
+    @Test func `lazy arrays should support random access by key`() throws {
+        let data = try makeFile()
+        let gguf = try GGUF(parsing: data, metadataDecoding: .lazy)
+
+        guard case .lazyArray(let tokens) = gguf.metadataValue(forKey: "tokenizer.ggml.tokens")
+        else {
+            Issue.record("tokens were decoded eagerly")
+            return
+        }
+        #expect(tokens.elementType == .string)
+        #expect(tokens.count == 1000)
+        #expect(tokens[0] == .string(Self.tokens[0]))
+        #expect(tokens[999] == .string(Self.tokens[999]))
+        #expect(tokens[517] == .string(Self.tokens[517]))
+
+        let scores = gguf.metadataValue(forKey: "tokenizer.ggml.scores")
+        #expect(scores?.arrayElements?[40] == .float32(5))
+        #expect(scores?.arrayValues(as: Float.self) == (0..<1000).map { Float($0) / 8 })
+        #expect(gguf.metadataValue(forKey: "test.empty")?.arrayElements == [])
+    }
+
+    @Test func `lazy arrays should be written back unchanged`() throws {
+        let data = try makeFile()
+        let lazy = try GGUF(parsing: data, metadataDecoding: .lazy)
+        var writer = try GGUF.Writer(metadata: lazy.metadata)
+        try writer.addTensor(
+            name: "t", dimensions: [4], dataType: .f32, source: .data(Data(count: 16)))
+        #expect(try writer.serializedData() == data)
+    }
+
+    @Test func `truncated arrays should throw`() throws {
+        let data = try makeFile()
+        let gguf = try GGUF(parsing: data)
+        // Cut inside the token array
+        let truncated = data.prefix(gguf.tensorDataOffset / 2)
+        #expect(throws: (any Error).self) {
+            try GGUF(parsing: truncated, metadataDecoding: .lazy)
+        }
+    }
+
+    @Test func `invalid UTF-8 should be rejected in both decoding modes`() throws {
+        var data = try makeFile()
+        // "é" in the first token becomes a lone continuation byte
+        let range = try #require(data.firstRange(of: Data("tok_0_é".utf8)))
+        data[range.upperBound - 2] = 0x80
+        #expect(throws: (any Error).self) {
+            try GGUF(parsing: data)
+        }
+        #expect(throws: GGUF.Error.self) {
+            try GGUF(parsing: data, metadataDecoding: .lazy)
+        }
+    }
+}
@@ -0,0 +1,78 @@
+import Foundation
+import Quants
+import Testing
+
+@testable import GGUF
+
+// Serialized because each test installs its own process-wide profiler
+@Suite(.serialized) struct LoadProfilerTests {
+    /// A Q4_K matrix and an f32 vector with names no other test uses, since the active
+    /// profiler also sees calls from tests running in parallel
+    func makeFile() throws -> Data {
+        try makeGGUFFile(
+            metadata: [.init(key: "general.name", value: .string("profiled"), valueType: .string)],
+            tensors: [
+                .q4_K("profiled.ffn_up.weight", rows: 16),
+                TestTensor("profiled.bias", (0..<64).map(Float.init), type: .f32),
+            ]
+        ).data
+    }
+
+    @Test func `loads and parses should be recorded while profiling`() throws {
+        let fileData = try makeFile()
+        let profiler = GGUF.LoadProfiler()
+        let gguf = try profiler.profile {
+            let gguf = try GGUF(parsing: fileData, metadataDecoding: .lazy)
+            for index in gguf.tensorInfos.indices {
+                _ = try gguf.tensorFloatArray(at: index, from: fileData, parallelism: .automatic)
+            }
+            return gguf
+        }
+
+        let parse = try #require(
+            profiler.parses.first { $0.metadataCount == 1 && $0.tensorCount == 2 })
+        #expect(parse.total > .zero)
+        #expect(parse.total == parse.header + parse.metadata + parse.tensorInfos + parse.padding)
+
+        let loads = profiler.tensorLoads.filter { $0.name.hasPrefix("profiled.") }
+        #expect(loads.map(\.name) == ["profiled.ffn_up.weight", "profiled.bias"])
+        #expect(loads.map(\.type) == [.q4_K, .f32])
+        #expect(loads[0].elementCount == 4096 * 16)
+        #expect(loads[0].bytesIn == gguf.tensorInfos.sizesInBytes[0])
+        #expect(loads[0].bytesOut == 4096 * 16 * 4)
+        #expect(loads[1].bytesIn == 256)
+
+        let counters = try #require(profiler.countersByType[.q4_K])
+        #expect(counters.loads >= 1)
+        #expect(counters.elements >= 4096 * 16)
+
+        // Stopped profilers record nothing
+        _ = try gguf.tensorFloatArray(at: 1, from: fileData)
+        #expect(profiler.tensorLoads.filter { $0.name.hasPrefix("profiled.") }.count == 2)
+    }
+
+    @Test func `reports should be valid JSON`() throws {
+        let fileData = try makeFile()
+        let profiler = GGUF.LoadProfiler()
+        try profiler.profile {
+            let gguf = try GGUF(parsing: fileData)
+            _ = try gguf.tensorFloatArray("profiled.bias", from: fileData)
+        }
+
+        let report = try #require(
+            try JSONSerialization.jsonObject(with: profiler.jsonReport()) as? [String: Any])
+        #expect((report["parses"] as? [Any])?.isEmpty == false)
+        let types = try #require(report["types"] as? [[String: Any]])
+        #expect(types.contains { $0["type"] as? String == "F32" })
+
+        let trace = try #require(
+            try JSONSerialization.jsonObject(with: profiler.traceEvents()) as? [String: Any])
+        let events = try #require(trace["traceEvents"] as? [[String: Any]])
+        #expect(events.contains { $0["name"] as? String == "metadata" })
+        #expect(events.allSatisfy { $0["ph"] as? String == "X" })
+        #expect(events.contains { $0["name"] as? String == "profiled.bias" })
+
+        profiler.reset()
+        #expect(profiler.tensorLoads.isEmpty)
+    }
+}
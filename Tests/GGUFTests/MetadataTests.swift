@@ -96,6 +96,40 @@ import Testing
         let value = try GGUF.MetadataValue(parsing: &span, type: .array)
 
         #expect(value == .array(.uint32, [.uint32(10), .uint32(20), .uint32(30)]))
+        #expect(value.arrayValues(as: UInt32.self) == [10, 20, 30])
+        #expect(value.arrayValues(as: Int32.self) == nil)
+        #expect(span.count == 0)
+    }
+
+    @available(macOS 26.0, iOS 26.0, watchOS 26.0, tvOS 26.0, *)
+    @Test func `lazily parsed numeric arrays should be stored packed`() throws {
+        let scores: [Float] = (0..<1000).map { Float($0) * -0.5 }
+        var data: [UInt8] = []
+        data += littleEndianBytes(GGUF.ValueType.float32.rawValue)
+        data += littleEndianBytes(UInt64(scores.count))
+        for score in scores {
+            data += littleEndianBytes(score.bitPattern)
+        }
+
+        var span = ParserSpan(data.span.bytes)
+        let value = try GGUF.MetadataValue(
+            parsing: &span, type: .array, decoding: .lazy, source: Data(data))
+        #expect(span.count == 0)
+
+        guard case .lazyArray(let array) = value else {
+            Issue.record("float32 array was decoded element by element")
+            return
+        }
+        #expect(array.bytes.count == scores.count * 4)
+        #expect(array.values(as: Float.self) == scores)
+        #expect(array[3] == .float32(-1.5))
+        #expect(value.arrayValues(as: Double.self) == nil)
+        // Eager parsing keeps the element-wise form, read through the same accessor
+        var eagerSpan = ParserSpan(data.span.bytes)
+        let eager = try GGUF.MetadataValue(parsing: &eagerSpan, type: .array)
+        #expect(eager == .array(.float32, scores.map(GGUF.MetadataValue.float32)))
+        #expect(eager.arrayValues(as: Float.self) == scores)
+        #expect(isClose(eager, value))
     }
 
     @available(macOS 26.0, iOS 26.0, watchOS 26.0, tvOS 26.0, *)
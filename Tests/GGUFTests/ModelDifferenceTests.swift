@@ -0,0 +1,101 @@
+import Foundation
+import Quants
+import Testing
+
+@testable import GGUF
+
+@Suite struct ModelDifferenceTests {
+    /// A base model and a fine-tune with one changed Q8_0 block, a retyped norm, a new tensor,
+    /// a dropped one and a reshaped one
+    func makeFiles() throws -> (base: (GGUF, Data), tuned: (GGUF, Data)) {
+        let q8 = try TestTensor.q8_0("blk.0.attn_q.weight", rows: 8)
+        var tunedQ8 = q8
+        tunedQ8.payload[tunedQ8.payload.startIndex + 5 * 34 + 10] ^= 0x21
+        let halves = TestTensor(
+            "blk.0.ffn_up.weight", (0..<(1024 * 4)).map { Float16(sin(Float($0) * 0.01)) },
+            type: .f16, dimensions: [1024, 4])
+        let norm = (0..<4096).map { 1 + Float($0 % 7) * 0.01 }
+        let ids = (0..<64).map(Int32.init)
+
+        func file(tuned: Bool) throws -> (GGUF, Data) {
+            try makeGGUFFile(
+                metadata: [
+                    .init(
+                        key: "general.name", value: .string(tuned ? "tuned" : "base"),
+                        valueType: .string)
+                ],
+                tensors: [
+                    tuned ? tunedQ8 : q8,
+                    halves,
+                    tuned
+                        ? TestTensor("blk.0.attn_norm.weight", norm.map(Float16.init), type: .f16)
+                        : TestTensor("blk.0.attn_norm.weight", norm, type: .f32),
+                    TestTensor("ids", ids, type: .i32, dimensions: tuned ? [32, 2] : [64]),
+                    TestTensor(
+                        tuned ? "lora.scale" : "rope_freqs", Array(norm.prefix(32)), type: .f32),
+                ])
+        }
+        return (try file(tuned: false), try file(tuned: true))
+    }
+
+    @Test func `tensors should be matched by name and compared tile by tile`() throws {
+        let ((base, baseData), (tuned, tunedData)) = try makeFiles()
+        let difference = try base.difference(
+            to: tuned, fileData: baseData, otherFileData: tunedData,
+            parallelism: Parallelism(maxConcurrency: 4, minimumChunkSize: 256))
+
+        #expect(difference.added == ["lora.scale"])
+        #expect(difference.removed == ["rope_freqs"])
+        #expect(difference.reshaped == ["ids"])
+        #expect(difference.tensors.map(\.name) == [
+            "blk.0.attn_q.weight", "blk.0.ffn_up.weight", "blk.0.attn_norm.weight",
+        ])
+        #expect(difference.changed.map(\.name) == ["blk.0.attn_q.weight", "blk.0.attn_norm.weight"])
+
+        let q8 = difference.tensors[0].difference
+        #expect(q8.measuredTileCount == 1)
+        #expect(q8.measuredCount == Difference.comparisonTileSize)
+        let values = try base.tensorFloatArray(at: 0, from: baseData)
+        let tunedValues = try tuned.tensorFloatArray(at: 0, from: tunedData)
+        let maxError = zip(values, tunedValues).map { abs($0 - $1) }.max()
+        #expect(q8.maxAbsoluteError == maxError)
+        #expect(q8.maxAbsoluteError > 0)
+        #expect(q8.cosineSimilarity < 1)
+
+        #expect(difference.tensors[1].difference.isIdentical)
+        // Different types are decoded and measured in full
+        let norm = difference.tensors[2]
+        #expect(norm.type == .f32 && norm.otherType == .f16)
+        #expect(norm.difference.measuredCount == 4096)
+        #expect(norm.difference.maxAbsoluteError < 1e-3)
+        #expect(difference.total.count == 8 * 4096 + 4 * 1024 + 4096)
+    }
+
+    @Test func `delta should hold only the changed and added tensors`() throws {
+        let ((base, baseData), (tuned, tunedData)) = try makeFiles()
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent("\(UUID().uuidString).gguf")
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        try base.writeDelta(
+            of: tuned, fileData: baseData, otherFileData: tunedData, to: url,
+            metadata: [.init(key: "delta.base", value: .string("base"), valueType: .string)])
+        let deltaData = try Data(contentsOf: url)
+        let delta = try GGUF(parsing: deltaData)
+        #expect(delta.metadataValue(forKey: "general.name") == .string("tuned"))
+        #expect(delta.metadataValue(forKey: "delta.base") == .string("base"))
+        let names = ["blk.0.attn_q.weight", "blk.0.attn_norm.weight", "ids", "lora.scale"]
+        #expect(delta.tensorInfos.map(\.name) == names)
+        for (index, name) in names.enumerated() {
+            let tunedIndex = try #require(tuned.tensorInfos.index(named: name))
+            #expect(delta.tensorInfos[index].dimensions == tuned.tensorInfos[tunedIndex].dimensions)
+            #expect(
+                delta.tensorData(at: index, from: deltaData)
+                    == tuned.tensorData(at: tunedIndex, from: tunedData))
+        }
+
+        // A model compared with itself yields an empty delta
+        let same = try tuned.difference(to: tuned, fileData: tunedData, otherFileData: tunedData)
+        #expect(same.changed.isEmpty && same.total.isIdentical)
+    }
+}
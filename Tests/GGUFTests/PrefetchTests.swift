@@ -0,0 +1,77 @@
+import Foundation
+import Synchronization
+import TestData
+import Testing
+
+@testable import GGUF
+
+@Suite struct PrefetchTests {
+    /// Q4_K, Q6_K and Q8_0 weights of 512 KiB elements each, plus a small f32 bias
+    func withMappedFile(_ body: (GGUF, GGUF.MappedFile) throws -> Void) throws {
+        var writer = try GGUF.Writer()
+        for (name, type) in [("Q4_K", GGUF.TensorType.q4_K), ("Q6_K", .q6_K), ("Q8_0", .q8_0)] {
+            let payload = try #require(testData(named: name, withExtension: "bin"))
+            try writer.addTensor(
+                name: name, dimensions: [256, 2048], dataType: type, source: .data(payload))
+        }
+        let bias = (0..<100).map(Float.init).withUnsafeBytes { Data($0) }
+        try writer.addTensor(name: "bias", dimensions: [100], dataType: .f32, source: .data(bias))
+
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString + ".gguf")
+        try writer.write(to: url)
+        defer { try? FileManager.default.removeItem(at: url) }
+        let file = try GGUF.MappedFile(contentsOf: url)
+        try body(try GGUF(parsing: file.data), file)
+    }
+
+    @Test func `pipeline should deliver every tensor once`() throws {
+        try withMappedFile { gguf, file in
+            let results = Mutex([Int: [Float]]())
+            let options = GGUF.PrefetchOptions(lookahead: 2, releaseConsumedPages: true)
+            try gguf.forEachTensorFloatArray(in: file, options: options) { index, values in
+                results.withLock { #expect($0.updateValue(values, forKey: index) == nil) }
+            }
+
+            let delivered = results.withLock { $0 }
+            #expect(delivered.count == gguf.tensorInfos.count)
+            for (index, values) in delivered {
+                #expect(values == (try gguf.tensorFloatArray(at: index, from: file.data)))
+            }
+        }
+    }
+
+    @Test func `in-flight output should stay within the memory bound`() throws {
+        try withMappedFile { gguf, file in
+            let tensorBytes = 256 * 2048 * 4
+            let inFlight = Mutex((current: 0, peak: 0))
+            let options = GGUF.PrefetchOptions(
+                maxInFlightBytes: tensorBytes + 400, maxConcurrency: 4)
+            try gguf.forEachTensorFloatArray(in: file, options: options) { _, values in
+                let bytes = values.count * 4
+                inFlight.withLock {
+                    $0.current += bytes
+                    $0.peak = max($0.peak, $0.current)
+                }
+                Thread.sleep(forTimeInterval: 0.01)
+                inFlight.withLock { $0.current -= bytes }
+            }
+            #expect(inFlight.withLock { $0.peak } <= tensorBytes + 400)
+        }
+    }
+
+    @Test func `errors thrown by the body should stop the pipeline`() throws {
+        struct Stop: Error {}
+        try withMappedFile { gguf, file in
+            let options = GGUF.PrefetchOptions(maxConcurrency: 1)
+            let calls = Mutex(0)
+            #expect(throws: Stop.self) {
+                try gguf.forEachTensorFloatArray(in: file, options: options) { _, _ in
+                    calls.withLock { $0 += 1 }
+                    throw Stop()
+                }
+            }
+            #expect(calls.withLock { $0 } == 1)
+        }
+    }
+}
@@ -0,0 +1,89 @@
+import Foundation
+import Quants
+import Testing
+
+@testable import GGUF
+
+@Suite struct RepackingTests {
+    /// A Q4_K matrix of 128 rows of 4096 elements and a small f32 bias
+    func makeFile() throws -> (GGUF, Data) {
+        try makeGGUFFile(tensors: [
+            .q4_K("blk.0.ffn_up.weight"),
+            TestTensor("bias", (0..<32).map(Float.init), type: .f32),
+        ])
+    }
+
+    @Test func `repacked tensors should be cached on disk`() throws {
+        let (gguf, fileData) = try makeFile()
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let cache = GGUF.RepackCache(directory: directory, for: gguf, fileData: fileData)
+
+        let built = try gguf.repackedTensor(at: 0, from: fileData, interleave: 4, cache: cache)
+        let files = try FileManager.default.contentsOfDirectory(atPath: directory.path)
+        let tag = GGUF.repackCacheTag(
+            cache: cache, offset: gguf.tensorInfos.offsets[0], type: .q4_K,
+            dimensions: gguf.tensorInfos.dimensions(at: 0))
+        #expect(files.count == 1)
+        #expect(files.first?.hasPrefix("blk.0.ffn_up.weight.q4_Kx4.") == true)
+        #expect(files.first?.hasSuffix("\(String(tag, radix: 16)).repack") == true)
+
+        let cached = try gguf.repackedTensor(at: 0, from: fileData, interleave: 4, cache: cache)
+        #expect(cached.rows == 128)
+        #expect(cached.columns == 4096)
+        let vector = (0..<4096).map { Float(($0 % 17) - 8) * 0.125 }
+        #expect(cached.multiply(by: vector) == built.multiply(by: vector))
+        #expect(cached.dequantized() == (try gguf.tensorFloatArray(at: 0, from: fileData)))
+
+        // Another interleave is a separate cache entry
+        _ = try gguf.repackedTensor(at: 0, from: fileData, interleave: 8, cache: cache)
+        #expect(try FileManager.default.contentsOfDirectory(atPath: directory.path).count == 2)
+    }
+
+    @Test func `tensors without an interleaved layout should throw`() throws {
+        let (gguf, fileData) = try makeFile()
+        #expect(throws: GGUF.Error.self) {
+            _ = try gguf.repackedTensor(at: 1, from: fileData)
+        }
+    }
+
+    @Test func `models with different headers should not share a cache`() throws {
+        let (gguf, fileData) = try makeFile()
+        // Same layout and tensor names, different metadata and a changed middle block
+        var tuned = try TestTensor.q4_K("blk.0.ffn_up.weight")
+        // A quant byte of the middle Q4_K block, after its 16 bytes of scales
+        tuned.payload[tuned.payload.startIndex + 64 * 144 + 16 + 10] ^= 0x33
+        let (tunedModel, tunedData) = try makeGGUFFile(
+            metadata: [.init(key: "general.name", value: .string("tuned"), valueType: .string)],
+            tensors: [tuned, TestTensor("bias", (0..<32).map(Float.init), type: .f32)])
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let base = try gguf.repackedTensor(
+            at: 0, from: fileData,
+            cache: GGUF.RepackCache(directory: directory, for: gguf, fileData: fileData))
+        let repacked = try tunedModel.repackedTensor(
+            at: 0, from: tunedData,
+            cache: GGUF.RepackCache(directory: directory, for: tunedModel, fileData: tunedData))
+        #expect(base.dequantized() == (try gguf.tensorFloatArray(at: 0, from: fileData)))
+        #expect(
+            repacked.dequantized() == (try tunedModel.tensorFloatArray(at: 0, from: tunedData)))
+        #expect(repacked.dequantized() != base.dequantized())
+        #expect(try FileManager.default.contentsOfDirectory(atPath: directory.path).count == 2)
+    }
+
+    @Test func `cache file names should keep distinct tensor names apart`() {
+        let names = ["blk.0.attn_q", "blk-0-attn_q", "blk_0_attn_q", "blk/0/attn_q", "blk%2F0"]
+        let files = names.map {
+            GGUF.repackCacheFileName(name: $0, format: .q4_0, interleave: 4, tag: 1)
+        }
+        #expect(Set(files).count == names.count)
+        #expect(files[0] == "blk.0.attn_q.q4_0x4.0000000000000001.repack")
+        #expect(files[3] == "blk%2F0%2Fattn_q.q4_0x4.0000000000000001.repack")
+        #expect(files[4] == "blk%252F0.q4_0x4.0000000000000001.repack")
+    }
+}
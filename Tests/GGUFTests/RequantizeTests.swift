@@ -0,0 +1,91 @@
+import Foundation
+import Quants
+import Testing
+
+@testable import GGUF
+
+@Suite struct RequantizeTests {
+    /// A Q8_0 matrix, an f16 matrix, a norm and a bias whose length is no block multiple
+    func makeFile() throws -> (GGUF, Data) {
+        try makeGGUFFile(
+            metadata: [
+                .init(key: "general.name", value: .string("source"), valueType: .string),
+                .init(key: "general.alignment", value: .uint32(64), valueType: .uint32),
+                // Mostly Q8_0 in llama.cpp's numbering
+                .init(key: "general.file_type", value: .uint32(7), valueType: .uint32),
+            ],
+            tensors: [
+                .q8_0("blk.0.attn_q.weight", rows: 8),
+                TestTensor(
+                    "blk.0.ffn_up.weight", (0..<(1024 * 4)).map { Float16(sin(Float($0) * 0.01)) },
+                    type: .f16, dimensions: [1024, 4]),
+                TestTensor(
+                    "blk.0.attn_norm.weight", (0..<4096).map { 1 + Float($0 % 7) * 0.01 },
+                    type: .f32),
+                TestTensor("bias", (0..<100).map(Float.init), type: .f32),
+            ])
+    }
+
+    @Test func `tensors should be requantized by rule in bounded chunks`() throws {
+        let (gguf, fileData) = try makeFile()
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent("\(UUID().uuidString).gguf")
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        // Chunks much smaller than the matrices exercise the double-buffered pipeline
+        var options = GGUF.RequantizationOptions.preservingSensitiveTensors(as: .q4_K)
+        options.rules.append(GGUF.RequantizationRule("blk.*.ffn_*", .q5_0))
+        options.metadata = [.init(key: "general.name", value: .string("q4"), valueType: .string)]
+        options.chunkSize = 1000
+        options.parallelism = Parallelism(maxConcurrency: 3, minimumChunkSize: 256)
+        let plan = try gguf.requantize(from: fileData, to: url, options: options)
+        #expect(plan.map(\.type) == [.q4_K, .q5_0, .f32, .f32])
+
+        let outputData = try Data(contentsOf: url)
+        let output = try GGUF(parsing: outputData)
+        #expect(output.alignment == 64)
+        #expect(output.metadataValue(forKey: "general.name") == .string("q4"))
+        // The source's file type no longer describes the tensors
+        #expect(output.metadataValue(forKey: "general.file_type") == nil)
+        #expect(output.tensorInfos.dataTypes == [.q4_K, .q5_0, .f32, .f32])
+        for index in gguf.tensorInfos.indices {
+            #expect(output.tensorInfos[index].dimensions == gguf.tensorInfos[index].dimensions)
+            let values = try gguf.tensorFloatArray(at: index, from: fileData)
+            let expected =
+                switch plan[index].type {
+                case .f32: gguf.tensorData(at: index, from: fileData)
+                case let type:
+                    Quantize.quantize(values, format: type.blockFormat!)
+                }
+            #expect(output.tensorData(at: index, from: outputData) == expected)
+        }
+    }
+
+    @Test func `targets that cannot be written should throw`() throws {
+        let (gguf, _) = try makeFile()
+        #expect(throws: GGUF.Error.self) {
+            _ = try gguf.requantizationPlan(options: .init(defaultType: .iq2_XXS))
+        }
+        let keep = try gguf.requantizationPlan(options: .init(defaultType: nil))
+        #expect(keep.allSatisfy { $0.type == $0.sourceType })
+    }
+
+    @Test func `file type should be kept only while every tensor keeps its type`() throws {
+        let (gguf, fileData) = try makeFile()
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent("\(UUID().uuidString).gguf")
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        try gguf.requantize(from: fileData, to: url, options: .init(defaultType: nil))
+        var output = try GGUF(parsing: Data(contentsOf: url))
+        #expect(output.metadataValue(forKey: "general.file_type") == .uint32(7))
+
+        // A caller that knows the new mix can name it
+        let options = GGUF.RequantizationOptions(
+            defaultType: .q4_K,
+            metadata: [.init(key: "general.file_type", value: .uint32(15), valueType: .uint32)])
+        try gguf.requantize(from: fileData, to: url, options: options)
+        output = try GGUF(parsing: Data(contentsOf: url))
+        #expect(output.metadataValue(forKey: "general.file_type") == .uint32(15))
+    }
+}
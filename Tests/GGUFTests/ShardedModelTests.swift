@@ -0,0 +1,88 @@
+import Foundation
+import TestData
+import Testing
+
+@testable import GGUF
+
+@Suite struct ShardedModelTests {
+    func splitMetadata(_ index: Int, of count: Int, tensors: Int32) -> [GGUF.MetadataKeyValue] {
+        [
+            .init(key: "split.no", value: .uint16(UInt16(index)), valueType: .uint16),
+            .init(key: "split.count", value: .uint16(UInt16(count)), valueType: .uint16),
+            .init(key: "split.tensors.count", value: .int32(tensors), valueType: .int32),
+        ]
+    }
+
+    /// Writes three shards holding two tensors each and returns their directory
+    func writeShards() throws -> URL {
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        for shard in 0..<3 {
+            var metadata = splitMetadata(shard, of: 3, tensors: 6)
+            if shard == 0 {
+                metadata.append(
+                    .init(key: "general.name", value: .string("split"), valueType: .string))
+            }
+            var writer = try GGUF.Writer(metadata: metadata)
+            for tensor in 0..<2 {
+                let values = (0..<64).map { Float(shard * 100 + tensor * 10 + $0) }
+                try writer.addTensor(
+                    name: "blk.\(shard).w\(tensor)",
+                    dimensions: [64],
+                    dataType: .f32,
+                    source: .data(values.withUnsafeBytes { Data($0) })
+                )
+            }
+            let fileName = String(format: "model-%05d-of-00003.gguf", shard + 1)
+            try writer.write(to: directory.appendingPathComponent(fileName))
+        }
+        return directory
+    }
+
+    @Test(arguments: [1, 2, 3])
+    func `any shard should load the whole model`(_ openedShard: Int) throws {
+        let directory = try writeShards()
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let url = directory.appendingPathComponent(
+            String(format: "model-%05d-of-00003.gguf", openedShard))
+        let model = try GGUF.ShardedModel(contentsOf: url, maxConcurrency: 2)
+        #expect(model.shards.count == 3)
+        #expect(model.tensorLocations.count == 6)
+        #expect(model.metadataValue(forKey: "general.name") == .string("split"))
+
+        let location = try #require(model.tensorLocations["blk.2.w1"])
+        #expect(location.shardIndex == 2)
+        #expect(location.tensorIndex == 1)
+        #expect(try model.tensorFloatArray("blk.2.w1") == (0..<64).map { Float(210 + $0) })
+        #expect(model.tensorData("blk.1.w0")?.count == 256)
+        #expect(model.tensorData("missing") == nil)
+    }
+
+    @Test func `unsplit files should load as one shard`() throws {
+        var writer = try GGUF.Writer()
+        try writer.addTensor(
+            name: "t", dimensions: [4], dataType: .f32, source: .data(Data(count: 16)))
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString + ".gguf")
+        try writer.write(to: url)
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        let model = try GGUF.ShardedModel(contentsOf: url)
+        #expect(model.shards.count == 1)
+        #expect(model.tensorLocations["t"]?.fileOffset == model.shards[0].gguf.tensorDataOffset)
+    }
+
+    @Test func `missing shards should throw`() throws {
+        let directory = try writeShards()
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        try FileManager.default.removeItem(
+            at: directory.appendingPathComponent("model-00002-of-00003.gguf"))
+        #expect(throws: (any Error).self) {
+            try GGUF.ShardedModel(
+                contentsOf: directory.appendingPathComponent("model-00001-of-00003.gguf"))
+        }
+    }
+}
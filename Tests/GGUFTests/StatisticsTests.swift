@@ -0,0 +1,70 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+@testable import GGUF
+
+@Suite struct StatisticsTests {
+    /// A Q4_K matrix, an f16 vector and an i32 vector
+    func makeFile() throws -> (GGUF, Data) {
+        try makeGGUFFile(tensors: [
+            .q4_K("blk.0.ffn_up.weight", rows: 16),
+            TestTensor("norm", (0..<48).map { Float16(Float($0) - 24) }, type: .f16),
+            TestTensor("ids", (0..<10).map { Int32($0) }, type: .i32),
+        ])
+    }
+
+    @Test func `tensor statistics should match the dequantized values`() throws {
+        let (gguf, fileData) = try makeFile()
+        for index in gguf.tensorInfos.indices {
+            let values = try gguf.tensorFloatArray(at: index, from: fileData)
+            let tensor = try gguf.statistics(at: index, from: fileData, histogramBins: 8)
+            #expect(tensor.index == index)
+            #expect(tensor.name == gguf.tensorInfos.name(at: index))
+            #expect(tensor.statistics.count == values.count)
+            #expect(tensor.statistics.min == values.min())
+            #expect(tensor.statistics.max == values.max())
+            let mean = values.reduce(0.0) { $0 + Double($1) } / Double(values.count)
+            #expect(abs(tensor.statistics.mean - mean) <= 1e-6 * max(1, abs(mean)))
+
+            let histogram = try #require(tensor.histogram)
+            #expect(histogram.lowerBound == values.min())
+            #expect(histogram.upperBound == values.max())
+            #expect(histogram.counts.count == 8)
+            #expect(histogram.counts.reduce(0, +) == values.count)
+        }
+    }
+
+    @Test func `f32 tensors should be summarized from data at an odd address`() throws {
+        let fileData = try #require(testData(named: "F32", withExtension: "gguf"))
+        let gguf = try GGUF(parsing: fileData)
+        let expected = try gguf.statistics(at: 0, from: fileData, histogramBins: 4)
+
+        try withMisalignedCopy(of: fileData) { misaligned in
+            let tensor = try gguf.statistics(at: 0, from: misaligned, histogramBins: 4)
+            #expect(tensor == expected)
+            #expect(tensor.statistics.count == 32)
+        }
+    }
+
+    @Test func `an explicit histogram range should be used as is`() throws {
+        let (gguf, fileData) = try makeFile()
+        let tensor = try #require(
+            try gguf.statistics("ids", from: fileData, histogramBins: 2, histogramRange: 0...4))
+        #expect(tensor.histogram?.counts == [2, 8])
+        #expect(try gguf.statistics("missing", from: fileData) == nil)
+    }
+
+    @Test func `model statistics should merge every tensor`() throws {
+        let (gguf, fileData) = try makeFile()
+        let model = gguf.modelStatistics(from: fileData)
+        #expect(model.tensors.map(\.name) == ["blk.0.ffn_up.weight", "norm", "ids"])
+        #expect(model.tensors.allSatisfy { $0.histogram == nil })
+        #expect(model.total.count == 4096 * 16 + 48 + 10)
+        #expect(model.total.min == -24)
+        #expect(model.total.max == model.tensors.map(\.statistics.max).max())
+        let sumOfSquares = model.tensors.reduce(0.0) { $0 + $1.statistics.sumOfSquares }
+        #expect(abs(model.total.sumOfSquares - sumOfSquares) <= 1e-9 * sumOfSquares)
+    }
+}
@@ -0,0 +1,83 @@
+import Foundation
+import Quants
+import Synchronization
+import Testing
+
+@testable import GGUF
+
+@Suite struct TensorCacheTests {
+    /// Three f32 tensors of 256 values (1 KiB each) and one Q4_K tensor
+    func makeFile() throws -> (GGUF, Data) {
+        let vectors = ["a", "b", "c"].enumerated().map { index, name in
+            TestTensor(name, (0..<256).map { Float(index * 1000 + $0) }, type: .f32)
+        }
+        return try makeGGUFFile(tensors: vectors + [.q4_K("q")])
+    }
+
+    @Test func `repeated lookups should hit the cache`() throws {
+        let (gguf, fileData) = try makeFile()
+        let cache = GGUF.TensorCache(gguf: gguf, fileData: fileData, byteBudget: 1 << 22)
+
+        let first = try #require(try cache.tensorFloatArray("q"))
+        let second = try #require(try cache.tensorFloatArray("q"))
+        #expect(first == (try gguf.tensorFloatArray(at: 3, from: fileData)))
+        #expect(second == first)
+        #expect(try cache.tensorFloatArray("missing") == nil)
+
+        let statistics = cache.statistics
+        #expect(statistics.hits == 1)
+        #expect(statistics.misses == 1)
+        #expect(statistics.entryCount == 1)
+        #expect(statistics.byteCount == 4096 * 128 * 4)
+    }
+
+    @Test func `least recently used tensors should be evicted first`() throws {
+        let (gguf, fileData) = try makeFile()
+        let cache = GGUF.TensorCache(gguf: gguf, fileData: fileData, byteBudget: 2048)
+
+        _ = try cache.tensorFloatArray("a")
+        _ = try cache.tensorFloatArray("b")
+        _ = try cache.tensorFloatArray("a")
+        // Evicts "b", the least recently used
+        _ = try cache.tensorFloatArray("c")
+        _ = try cache.tensorFloatArray("a")
+        _ = try cache.tensorFloatArray("b")
+
+        #expect(
+            cache.statistics
+                == .init(hits: 2, misses: 4, evictions: 2, entryCount: 2, byteCount: 2048))
+    }
+
+    @Test func `tensors larger than the budget should not be cached`() throws {
+        let (gguf, fileData) = try makeFile()
+        let cache = GGUF.TensorCache(gguf: gguf, fileData: fileData, byteBudget: 4096)
+
+        _ = try cache.tensorFloatArray("a")
+        _ = try cache.tensorFloatArray("q")
+        _ = try cache.tensorFloatArray("q")
+
+        #expect(
+            cache.statistics
+                == .init(hits: 0, misses: 3, evictions: 0, entryCount: 1, byteCount: 1024))
+        cache.removeAll()
+        #expect(cache.statistics.entryCount == 0)
+        #expect(cache.statistics.byteCount == 0)
+    }
+
+    @Test func `concurrent lookups should share one dequantization`() throws {
+        let (gguf, fileData) = try makeFile()
+        let cache = GGUF.TensorCache(gguf: gguf, fileData: fileData, byteBudget: 1 << 22)
+        let expected = try gguf.tensorFloatArray(at: 3, from: fileData)
+
+        let matches = Mutex(0)
+        DispatchQueue.concurrentPerform(iterations: 16) { _ in
+            if (try? cache.tensorFloatArray(at: 3)) == expected {
+                matches.withLock { $0 += 1 }
+            }
+        }
+
+        #expect(matches.withLock { $0 } == 16)
+        #expect(cache.statistics.misses == 1)
+        #expect(cache.statistics.hits == 15)
+    }
+}
@@ -0,0 +1,107 @@
+import Foundation
+import Testing
+
+@testable import GGUF
+
+@Suite struct TensorTableTests {
+    static let perBlock = ["attn_q.weight", "ffn_gate_exps.weight", "ffn_up_exps.weight"]
+
+    /// Twelve blocks of three tensors plus the embedding and output tensors
+    func makeFile() throws -> GGUF {
+        let names =
+            ["token_embd.weight"]
+            + (0..<12).flatMap { block in Self.perBlock.map { "blk.\(block).\($0)" } }
+            + ["output.weight"]
+        let tensors = names.enumerated().map { index, name in
+            TestTensor(
+                name, [Float](repeating: 0, count: (index + 1) * 32), type: .f32,
+                dimensions: [32, UInt64(index + 1)])
+        }
+        return try makeGGUFFile(tensors: tensors).gguf
+    }
+
+    @Test func `columns should match the materialized tensor infos`() throws {
+        let gguf = try makeFile()
+        let table = gguf.tensorInfos
+
+        #expect(table.count == 38)
+        for index in table.indices {
+            let info = table[index]
+            #expect(table.name(at: index) == info.name)
+            #expect(Array(table.dimensions(at: index)) == info.dimensions)
+            #expect(table.elementCounts[index] == info.elementCount)
+            #expect(table.sizesInBytes[index] == info.sizeInBytes)
+            #expect(table.fileOffsets[index] == gguf.tensorDataOffset + Int(info.offset))
+            #expect(table.byteRange(at: index) == gguf.tensorByteRange(at: index))
+            #expect(table.rowLength(at: index) == info.rowLength)
+            #expect(table.rowCount(at: index) == info.rowCount)
+        }
+    }
+
+    @Test func `exact lookup should find every tensor by name`() throws {
+        let table = try makeFile().tensorInfos
+
+        for index in table.indices {
+            #expect(table.index(named: table.name(at: index)) == index)
+        }
+        #expect(table.index(named: "blk.12.attn_q.weight") == nil)
+        #expect(table.index(named: "blk.1") == nil)
+        #expect(table.index(named: "") == nil)
+    }
+
+    @Test func `prefix queries should return whole blocks`() throws {
+        let table = try makeFile().tensorInfos
+
+        #expect(table.indices(inBlock: 1) == [4, 5, 6])
+        // "blk.1." must not pick up blk.10 and blk.11
+        #expect(table.indices(withPrefix: "blk.1.").count == 3)
+        #expect(table.indices(withPrefix: "blk.1").count == 9)
+        #expect(table.indices(withPrefix: "blk.").count == 36)
+        #expect(table.indices(withPrefix: "").count == 38)
+        #expect(table.indices(withPrefix: "missing").isEmpty)
+    }
+
+    @Test func `wildcard queries should match across name segments`() throws {
+        let table = try makeFile().tensorInfos
+
+        let experts = table.indices(matching: "*.ffn_*_exps.*")
+        #expect(experts.count == 24)
+        #expect(experts.allSatisfy { table.name(at: $0).contains("_exps") })
+        #expect(table.indices(matching: "blk.17.*").isEmpty)
+        #expect(table.indices(matching: "blk.11.*_q.weight") == [34])
+        #expect(table.indices(matching: "*.weight").count == 38)
+        #expect(table.indices(matching: "output.weight") == [37])
+        #expect(table.indices(matching: "*") == Array(table.indices))
+    }
+
+    @Test func `leading wildcards should be answered by the reversed name index`() throws {
+        let table = try makeFile().tensorInfos
+
+        let gates = table.indices(matching: "*.ffn_gate_exps.weight")
+        #expect(gates == (0..<12).map { 2 + $0 * 3 })
+        #expect(table.indices(matching: "*_exps.weight").count == 24)
+        #expect(table.indices(matching: "*.ffn_*_exps.weight").count == 24)
+        #expect(table.indices(matching: "blk.1*_q.weight") == [4, 31, 34])
+        #expect(table.indices(matching: "*embd.weight") == [0])
+        #expect(table.indices(matching: "*.missing").isEmpty)
+        // Names shorter than the suffix, and the suffix equal to a whole name
+        #expect(table.indices(matching: "*output.weight") == [37])
+        #expect(table.indices(matching: "*x.output.weight").isEmpty)
+    }
+
+    @Test func `duplicate tensor names should throw`() throws {
+        var data = makeGGUFHeader(tensorCount: 2)
+        for _ in 0..<2 {
+            data += makeGGUFString("weight")
+            data += littleEndianBytes(UInt32(1))
+            data += littleEndianBytes(UInt64(8))
+            data += littleEndianBytes(UInt32(0))
+            data += littleEndianBytes(UInt64(0))
+        }
+        data += [UInt8](repeating: 0, count: (32 - data.count % 32) % 32 + 32)
+
+        #expect(throws: GGUF.Error.self) {
+            _ = try GGUF(parsing: Data(data))
+        }
+    }
+}
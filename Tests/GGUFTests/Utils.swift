@@ -1,6 +1,7 @@
 import Foundation
 import GGUF
 import Numerics
+import TestData
 import Testing
 
 /// Creates a GGUF header with the specified counts
@@ -56,7 +57,106 @@ func isClose(_ lhs: GGUF.MetadataValue, _ rhs: GGUF.MetadataValue) -> Bool {
         return lvalue == rvalue
     case (.array(let lvalue, let lmetadata), .array(let rvalue, let rmetadata)):
         return lvalue == rvalue && lmetadata == rmetadata
+    case (.array, .lazyArray), (.lazyArray, .array), (.lazyArray, .lazyArray):
+        // Lazy arrays match their eager form element by element
+        let elementType = { (value: GGUF.MetadataValue) -> GGUF.ValueType? in
+            switch value {
+            case .array(let type, _): type
+            case .lazyArray(let array): array.elementType
+            default: nil
+            }
+        }
+        guard elementType(lhs) == elementType(rhs), let lelements = lhs.arrayElements,
+            let relements = rhs.arrayElements, lelements.count == relements.count
+        else {
+            return false
+        }
+        return zip(lelements, relements).allSatisfy { isClose($0, $1) }
     default:
         return false
     }
 }
+
+/// Calls `body` with a copy of `data` whose first byte sits at an odd address, as a `Data`
+/// handed over by another library might
+func withMisalignedCopy<R>(of data: Data, _ body: (Data) throws -> R) rethrows -> R {
+    let buffer = UnsafeMutableRawBufferPointer.allocate(byteCount: data.count + 1, alignment: 16)
+    defer { buffer.deallocate() }
+    let bytes = UnsafeMutableRawBufferPointer(rebasing: buffer[1...])
+    _ = data.copyBytes(to: bytes)
+    return try body(Data(bytesNoCopy: bytes.baseAddress!, count: data.count, deallocator: .none))
+}
+
+/// Creates a GGUF file with a single tensor holding `payload`
+func makeGGUFFile(
+    tensorName: String = "tensor",
+    dimensions: [UInt64],
+    type: GGUF.TensorType,
+    payload: Data,
+    alignment: Int = 32
+) -> Data {
+    var data = makeGGUFHeader(tensorCount: 1, metadataCount: 0)
+    data += makeGGUFString(tensorName)
+    data += littleEndianBytes(UInt32(dimensions.count))
+    for dimension in dimensions {
+        data += littleEndianBytes(dimension)
+    }
+    data += littleEndianBytes(type.rawValue)
+    data += littleEndianBytes(UInt64(0))
+    let paddingNeeded = (alignment - (data.count % alignment)) % alignment
+    data += [UInt8](repeating: 0x00, count: paddingNeeded)
+    return Data(data) + payload
+}
+
+/// One tensor of a file built by `makeGGUFFile(metadata:tensors:)`
+struct TestTensor {
+    var name: String
+    var dimensions: [UInt64]
+    var type: GGUF.TensorType
+    var payload: Data
+}
+
+extension TestTensor {
+    /// A vector of `values` stored as `type`, or a tensor of the given dimensions
+    init<Element>(
+        _ name: String,
+        _ values: [Element],
+        type: GGUF.TensorType,
+        dimensions: [UInt64]? = nil
+    ) {
+        self.init(
+            name: name, dimensions: dimensions ?? [UInt64(values.count)], type: type,
+            payload: values.withUnsafeBytes { Data($0) })
+    }
+
+    /// `rows` rows of 4096 values from the Q4_K test data, which holds 128 rows
+    static func q4_K(_ name: String, rows: Int = 128) throws -> TestTensor {
+        let q4 = try #require(testData(named: "Q4_K", withExtension: "bin"))
+        return TestTensor(
+            name: name, dimensions: [4096, UInt64(rows)], type: .q4_K,
+            payload: q4.prefix(rows * 16 * 144))
+    }
+
+    /// `rows` rows of 4096 values from the Q8_0 test data
+    static func q8_0(_ name: String, rows: Int) throws -> TestTensor {
+        let q8 = try #require(testData(named: "Q8_0", withExtension: "bin"))
+        return TestTensor(
+            name: name, dimensions: [4096, UInt64(rows)], type: .q8_0,
+            payload: q8.prefix(rows * 128 * 34))
+    }
+}
+
+/// Writes `tensors` with GGUF.Writer and parses the result back
+func makeGGUFFile(
+    metadata: [GGUF.MetadataKeyValue] = [],
+    tensors: [TestTensor]
+) throws -> (gguf: GGUF, data: Data) {
+    var writer = try GGUF.Writer(metadata: metadata)
+    for tensor in tensors {
+        try writer.addTensor(
+            name: tensor.name, dimensions: tensor.dimensions, dataType: tensor.type,
+            source: .data(tensor.payload))
+    }
+    let data = try writer.serializedData()
+    return (try GGUF(parsing: data), data)
+}
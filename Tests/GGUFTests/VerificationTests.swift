@@ -0,0 +1,91 @@
+import Foundation
+import Quants
+import Testing
+
+@testable import GGUF
+
+@Suite struct VerificationTests {
+    /// A Q4_K matrix, an f16 vector and an f32 vector
+    func makeFile(f32Values: [Float] = Array(repeating: 1, count: 64)) throws -> (GGUF, Data) {
+        try makeGGUFFile(tensors: [
+            .q4_K("blk.0.ffn_up.weight", rows: 16),
+            TestTensor("norm", [UInt16](repeating: 0x3C00, count: 48), type: .f16),
+            TestTensor("bias", f32Values, type: .f32),
+        ])
+    }
+
+    /// `gguf` with its tensor infos replaced
+    func replacingTensors(of gguf: GGUF, with infos: [GGUF.TensorInfo]) -> GGUF {
+        GGUF(
+            header: gguf.header,
+            metadata: gguf.metadata,
+            tensorInfos: GGUF.TensorTable(infos),
+            metadataKeyToValue: gguf.metadataKeyToValue,
+            tensorDataOffset: gguf.tensorDataOffset,
+            alignment: gguf.alignment
+        )
+    }
+
+    @Test func `well-formed files should pass`() throws {
+        let (gguf, fileData) = try makeFile()
+        let report = gguf.verify(fileData: fileData)
+        #expect(report.isValid)
+        #expect(report.tensors.map(\.name) == ["blk.0.ffn_up.weight", "norm", "bias"])
+        #expect(report.failures.isEmpty)
+    }
+
+    @Test func `layout problems should be reported per tensor`() throws {
+        let (gguf, fileData) = try makeFile()
+        let dataSize = UInt64(fileData.count - gguf.tensorDataOffset)
+        func info(_ name: String, _ count: UInt64, at offset: UInt64) -> GGUF.TensorInfo {
+            GGUF.TensorInfo(
+                name: name, dimensionCount: 1, dimensions: [count], dataType: .f32,
+                offset: offset)
+        }
+        let broken = replacingTensors(
+            of: gguf,
+            with: [
+                info("first", 32, at: 0),
+                info("overlaps first", 32, at: 64),
+                info("misaligned", 8, at: 1000),
+                info("past the end", 32, at: dataSize - 64),
+                info("far past the end", 32, at: .max - 16),
+                info("empty", 0, at: 32),
+            ])
+        let report = broken.verify(fileData: fileData)
+        let issues = report.tensors.map(\.issues)
+        #expect(issues[0] == .overlapping)
+        #expect(issues[1] == .overlapping)
+        #expect(report.tensors[0].overlappingIndex == 1)
+        #expect(report.tensors[1].overlappingIndex == 0)
+        #expect(issues[2] == .misaligned)
+        #expect(issues[3] == .outOfBounds)
+        #expect(issues[4] == [.outOfBounds, .misaligned])
+        #expect(issues[5] == [])
+        #expect(report.failures.map(\.index) == [0, 1, 2, 3, 4])
+    }
+
+    @Test func `non-finite scales and values should be counted`() throws {
+        var values = [Float](repeating: 1, count: 64)
+        values[3] = .nan
+        values[63] = -.infinity
+        let (gguf, original) = try makeFile(f32Values: values)
+        var fileData = Data([UInt8](original))
+
+        // Corrupt the super-block scale of two Q4_K blocks and one f16 value
+        let matrix = gguf.tensorInfos.fileOffsets[0]
+        fileData.replaceSubrange(matrix..<(matrix + 2), with: [0x00, 0x7C])
+        let lastBlock = matrix + 255 * 144
+        fileData.replaceSubrange((lastBlock + 2)..<(lastBlock + 4), with: [0x01, 0xFE])
+        let norm = gguf.tensorInfos.fileOffsets[1] + 2 * 47
+        fileData.replaceSubrange(norm..<(norm + 2), with: [0x00, 0xFC])
+
+        for parallelism in [Parallelism.serial, Parallelism(maxConcurrency: 4, minimumChunkSize: 1)]
+        {
+            let report = gguf.verify(fileData: fileData, parallelism: parallelism)
+            #expect(report.tensors.map(\.nonFiniteCount) == [2, 1, 2])
+            #expect(report.tensors.allSatisfy { $0.issues == .nonFinite })
+        }
+        #expect(gguf.verify(fileData: fileData, scanValues: false).isValid)
+    }
+}
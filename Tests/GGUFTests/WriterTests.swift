@@ -0,0 +1,127 @@
+import BinaryParsing
+import Foundation
+import TestData
+import Testing
+
+@testable import GGUF
+
+@Suite struct WriterTests {
+    static let metadata: [GGUF.MetadataKeyValue] = [
+        .init(key: "general.alignment", value: .uint32(64), valueType: .uint32),
+        .init(key: "general.name", value: .string("writer"), valueType: .string),
+        .init(key: "test.int8", value: .int8(-3), valueType: .int8),
+        .init(key: "test.uint64", value: .uint64(1 << 40), valueType: .uint64),
+        .init(key: "test.float32", value: .float32(0.25), valueType: .float32),
+        .init(key: "test.float64", value: .float64(-1.5), valueType: .float64),
+        .init(key: "test.bool", value: .bool(true), valueType: .bool),
+        .init(
+            key: "test.array",
+            value: .array(.string, [.string("a"), .string("bc")]),
+            valueType: .array
+        ),
+    ]
+
+    func expectSameStructure(_ parsed: GGUF, _ expected: GGUF) {
+        #expect(parsed.header.tensorCount == expected.header.tensorCount)
+        #expect(parsed.header.metadataKeyValueCount == expected.header.metadataKeyValueCount)
+        #expect(parsed.metadata.map(\.key) == expected.metadata.map(\.key))
+        #expect(parsed.metadata.map(\.value) == expected.metadata.map(\.value))
+        #expect(parsed.metadata.map(\.valueType) == expected.metadata.map(\.valueType))
+        #expect(parsed.tensorInfos.map(\.name) == expected.tensorInfos.map(\.name))
+        #expect(parsed.tensorInfos.map(\.dimensions) == expected.tensorInfos.map(\.dimensions))
+        #expect(parsed.tensorInfos.map(\.dataType) == expected.tensorInfos.map(\.dataType))
+        #expect(parsed.tensorInfos.map(\.offset) == expected.tensorInfos.map(\.offset))
+        #expect(parsed.tensorDataOffset == expected.tensorDataOffset)
+        #expect(parsed.alignment == expected.alignment)
+    }
+
+    @Test func `written file should parse back to the same structure`() throws {
+        let q4 = try #require(testData(named: "Q4_K", withExtension: "bin"))
+        let f32 = Data((0..<100).flatMap { withUnsafeBytes(of: Float($0)) { Array($0) } })
+
+        var writer = try GGUF.Writer(metadata: Self.metadata)
+        try writer.addTensor(
+            name: "blk.0.weight",
+            dimensions: [4096, 128],
+            dataType: .q4_K,
+            source: .data(q4)
+        )
+        try writer.addTensor(name: "bias", dimensions: [100], dataType: .f32, source: .data(f32))
+        // Streamed in small uneven chunks
+        let streamed = GGUF.TensorSource.stream { emit in
+            try f32.withUnsafeBytes { bytes in
+                for start in stride(from: 0, to: bytes.count, by: 7) {
+                    let end = min(start + 7, bytes.count)
+                    try emit(UnsafeRawBufferPointer(rebasing: bytes[start..<end]))
+                }
+            }
+        }
+        try writer.addTensor(name: "streamed", dimensions: [100], dataType: .f32, source: streamed)
+
+        let data = try writer.serializedData()
+        #expect(data.count == writer.fileSize)
+        let gguf = try GGUF(parsing: data)
+        expectSameStructure(gguf, writer.layout)
+        #expect(gguf.alignment == 64)
+        #expect(gguf.tensorDataOffset % 64 == 0)
+        #expect(gguf.tensorInfos.allSatisfy { $0.offset % 64 == 0 })
+        #expect(gguf.tensorData(at: 0, from: data) == q4)
+        #expect(gguf.tensorData(at: 1, from: data) == f32)
+        #expect(gguf.tensorData(at: 2, from: data) == f32)
+        #expect(try gguf.tensorFloatArray("bias", from: data) == (0..<100).map(Float.init))
+    }
+
+    @Test func `file sources should be copied through a small buffer`() throws {
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let q6 = try #require(testData(named: "Q6_K", withExtension: "bin"))
+        let sourceURL = directory.appendingPathComponent("source.bin")
+        try (Data([1, 2, 3]) + q6).write(to: sourceURL)
+
+        var writer = try GGUF.Writer()
+        try writer.addTensor(
+            name: "weight",
+            dimensions: [256, 2048],
+            dataType: .q6_K,
+            source: .file(sourceURL, offset: 3)
+        )
+        let outputURL = directory.appendingPathComponent("model.gguf")
+        try writer.write(to: outputURL, bufferSize: 1000)
+
+        let data = try Data(contentsOf: outputURL)
+        let gguf = try GGUF(parsing: data)
+        expectSameStructure(gguf, writer.layout)
+        #expect(gguf.alignment == 32)
+        #expect(gguf.tensorData(at: 0, from: data) == q6)
+    }
+
+    @Test func `invalid input should throw`() throws {
+        #expect(throws: GGUF.Error.self) {
+            try GGUF.Writer(metadata: [
+                .init(key: "a", value: .uint8(1), valueType: .uint8),
+                .init(key: "a", value: .uint8(2), valueType: .uint8),
+            ])
+        }
+        #expect(throws: GGUF.Error.self) {
+            try GGUF.Writer(metadata: [.init(key: "a", value: .uint8(1), valueType: .int32)])
+        }
+        #expect(throws: GGUF.Error.self) {
+            try GGUF.Writer(metadata: [
+                .init(key: "a", value: .array(.int32, [.uint8(1)]), valueType: .array)
+            ])
+        }
+
+        var writer = try GGUF.Writer()
+        let short = GGUF.TensorSource.data(Data(count: 8))
+        try writer.addTensor(name: "t", dimensions: [4], dataType: .f32, source: short)
+        #expect(throws: GGUF.Error.self) {
+            try writer.addTensor(name: "t", dimensions: [4], dataType: .f32, source: .data(Data()))
+        }
+        #expect(throws: GGUF.Error.self) {
+            try writer.serializedData()
+        }
+    }
+}
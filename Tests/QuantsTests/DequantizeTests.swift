@@ -29,12 +29,36 @@ func deqantizeFn(byName name: String) -> (Data, Int) -> [Float] {
         return Dequantize.Q8_K
     case "IQ4_NL":
         return Dequantize.IQ4_NL
+    case "Q8_1":
+        return Dequantize.Q8_1
+    case "IQ2_XXS":
+        return Dequantize.IQ2_XXS
+    case "IQ2_XS":
+        return Dequantize.IQ2_XS
+    case "IQ2_S":
+        return Dequantize.IQ2_S
+    case "IQ3_XXS":
+        return Dequantize.IQ3_XXS
+    case "IQ3_S":
+        return Dequantize.IQ3_S
+    case "IQ1_S":
+        return Dequantize.IQ1_S
+    case "IQ1_M":
+        return Dequantize.IQ1_M
+    case "IQ4_XS":
+        return Dequantize.IQ4_XS
+    case "TQ1_0":
+        return Dequantize.TQ1_0
+    case "TQ2_0":
+        return Dequantize.TQ2_0
+    case "MXFP4":
+        return Dequantize.MXFP4
     default:
         fatalError("Unsupported quantized type: \(name)")
     }
 }
 
-@Test(arguments: quantizedValuesByName)
+@Test(arguments: quantizedValuesByName + dequantizedValuesByName)
 func `quantized tensor data should dequantize`(_ pair: (name: String, values: [Float])) throws {
     let tensorData = try #require(testData(named: pair.name, withExtension: "bin"))
     let deqantize = deqantizeFn(byName: pair.name)
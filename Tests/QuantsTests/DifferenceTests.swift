@@ -0,0 +1,120 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+@Suite struct DifferenceTests {
+    static let formats: [BlockFormat] = [.q4_0, .q8_0, .q4_K, .q6_K]
+
+    /// Test blocks of `format` with a quant byte flipped in two blocks, one at each end
+    func modified(_ data: Data, _ format: BlockFormat) -> Data {
+        var other = data
+        for block in [1, data.count / format.bytesPerBlock - 1] {
+            other[other.startIndex + (block * 2 + 1) * format.bytesPerBlock / 2] ^= 0x5A
+        }
+        return other
+    }
+
+    /// Double-precision reference over already decoded values
+    func reference(_ a: [Float], _ b: [Float]) -> (maxAbs: Float, sse: Double, cosine: Double) {
+        let pairs = zip(a, b).map { (Double($0), Double($1)) }
+        let maxAbs = zip(a, b).map { abs($0 - $1) }.max() ?? 0
+        let sse = pairs.reduce(0.0) { $0 + ($1.0 - $1.1) * ($1.0 - $1.1) }
+        let dot = pairs.reduce(0.0) { $0 + $1.0 * $1.1 }
+        let norms = pairs.reduce(0.0) { $0 + $1.0 * $1.0 }.squareRoot()
+            * pairs.reduce(0.0) { $0 + $1.1 * $1.1 }.squareRoot()
+        return (maxAbs, sse, dot / norms)
+    }
+
+    @Test(arguments: formats)
+    func `only differing tiles should be measured`(_ format: BlockFormat) throws {
+        let name = "\(format)".uppercased()
+        let data = try #require(testData(named: name, withExtension: "bin"))
+        let elementCount = data.count / format.bytesPerBlock * format.blockSize
+        let other = modified(data, format)
+
+        let same = Difference(
+            data, layout: .blocks(format), data, layout: .blocks(format),
+            elementCount: elementCount)
+        #expect(same.isIdentical)
+        #expect(same == Difference(identicalCount: elementCount))
+
+        let difference = Difference(
+            data, layout: .blocks(format), other, layout: .blocks(format),
+            elementCount: elementCount)
+        #expect(difference.count == elementCount)
+        #expect(difference.measuredTileCount == 2)
+        #expect(difference.measuredCount == 2 * Difference.comparisonTileSize)
+
+        let a = Dequantize.dequantize(data, format: format, elementCount: elementCount)
+        let b = Dequantize.dequantize(other, format: format, elementCount: elementCount)
+        let expected = reference(a, b)
+        #expect(difference.maxAbsoluteError == expected.maxAbs)
+        #expect(abs(difference.sumOfSquaredErrors - expected.sse) <= 1e-6 * expected.sse)
+        #expect(abs(difference.cosineSimilarity - expected.cosine) <= 1e-6)
+        let rmse = (expected.sse / Double(elementCount)).squareRoot()
+        #expect(abs(difference.rootMeanSquaredError - rmse) <= 1e-6 * rmse)
+    }
+
+    @Test(arguments: formats)
+    func `every SIMD level should return the same bits`(_ format: BlockFormat) throws {
+        let name = "\(format)".uppercased()
+        let data = try #require(testData(named: name, withExtension: "bin"))
+        let elementCount = data.count / format.bytesPerBlock * format.blockSize
+        let values = Dequantize.dequantize(data, format: format, elementCount: elementCount)
+        let parallelism = Parallelism(maxConcurrency: 4, minimumChunkSize: 4096)
+
+        // Different encodings compare every tile
+        let compare = { (level: SIMDLevel) in
+            values.withUnsafeBytes { f32 in
+                data.withUnsafeBytes { blocks in
+                    Difference(
+                        blocks, layout: .blocks(format), f32, layout: .f32,
+                        elementCount: elementCount, parallelism: parallelism, simdLevel: level)
+                }
+            }
+        }
+        let scalar = compare(.scalar)
+        #expect(scalar.measuredCount == elementCount)
+        #expect(scalar.maxAbsoluteError == 0)
+        #expect(scalar.sumOfSquaredErrors == 0)
+        #expect(scalar.sumOfSquaresA == scalar.sumOfSquaresB)
+        for level in SIMDLevel.allCases where level.isAvailable {
+            #expect(compare(level) == scalar, "\(format) at \(level)")
+        }
+    }
+
+    @Test func `parallel and merged differences should agree with the serial pass`() throws {
+        let data = try #require(testData(named: "Q4_K", withExtension: "bin"))
+        let elementCount = data.count / BlockFormat.q4_K.bytesPerBlock * 256
+        let other = Quantize.quantize(
+            Dequantize.dequantize(data, format: .q4_K, elementCount: elementCount)
+                .map { $0 * 1.01 },
+            format: .q4_K)
+        let serial = Difference(
+            data, layout: .blocks(.q4_K), other, layout: .blocks(.q4_K),
+            elementCount: elementCount)
+        let parallel = Difference(
+            data, layout: .blocks(.q4_K), other, layout: .blocks(.q4_K),
+            elementCount: elementCount,
+            parallelism: Parallelism(maxConcurrency: 8, minimumChunkSize: 256))
+        let half = data.count / 2
+        var merged = Difference(
+            data.prefix(half), layout: .blocks(.q4_K), other.prefix(half),
+            layout: .blocks(.q4_K), elementCount: elementCount / 2)
+        merged.merge(
+            Difference(
+                data.suffix(half), layout: .blocks(.q4_K), other.suffix(half),
+                layout: .blocks(.q4_K), elementCount: elementCount / 2))
+
+        for difference in [parallel, merged] {
+            #expect(difference.count == serial.count)
+            #expect(difference.measuredCount == serial.measuredCount)
+            #expect(difference.measuredTileCount == serial.measuredTileCount)
+            #expect(difference.maxAbsoluteError == serial.maxAbsoluteError)
+            let error = abs(difference.sumOfSquaredErrors - serial.sumOfSquaredErrors)
+            #expect(error <= 1e-9 * serial.sumOfSquaredErrors)
+            #expect(abs(difference.cosineSimilarity - serial.cosineSimilarity) <= 1e-12)
+        }
+    }
+}
@@ -0,0 +1,61 @@
+import Foundation
+import Quants
+import Testing
+
+@Suite struct ElementFormatTests {
+    /// Random bytes behind one leading pad byte, so every element is misaligned
+    static let bytes: [UInt8] = {
+        var generator = SystemRandomNumberGenerator()
+        return (0..<(8 * 10_007 + 1)).map { _ in generator.next() }
+    }()
+
+    /// Value `Float.init` gives for the element at `i`
+    func reference(_ input: UnsafeRawBufferPointer, _ format: ElementFormat, _ i: Int) -> Float {
+        func load<T: BitwiseCopyable>(_ type: T.Type) -> T {
+            input.loadUnaligned(fromByteOffset: i * format.bytesPerElement, as: T.self)
+        }
+        return switch format {
+        case .f16: Float(load(Float16.self))
+        case .bf16: Float(bitPattern: UInt32(load(UInt16.self)) << 16)
+        case .f64: Float(load(Double.self))
+        case .i8: Float(load(Int8.self))
+        case .i16: Float(load(Int16.self))
+        case .i32: Float(load(Int32.self))
+        case .i64: Float(load(Int64.self))
+        }
+    }
+
+    @Test(arguments: ElementFormat.allCases)
+    func `every SIMD level should match Float.init at any alignment`(_ format: ElementFormat) {
+        Self.bytes.withUnsafeBytes { bytes in
+            let input = UnsafeRawBufferPointer(rebasing: bytes[1...])
+            let count = input.count / format.bytesPerElement
+            let expected = (0..<count).map { reference(input, format, $0) }
+            for level in SIMDLevel.allCases where level.isAvailable {
+                let values = [Float](unsafeUninitializedCapacity: count) { output, initialized in
+                    Dequantize.convert(
+                        input, from: format,
+                        into: UnsafeMutableBufferPointer(rebasing: output[..<count]),
+                        simdLevel: level)
+                    initialized = count
+                }
+                // Hardware and software f16 widening may quiet signaling NaNs differently
+                let matches = zip(values, expected).allSatisfy {
+                    $0.bitPattern == $1.bitPattern || ($0.isNaN && $1.isNaN)
+                }
+                #expect(matches, "\(format) at \(level)")
+            }
+        }
+    }
+
+    @Test(arguments: ElementFormat.allCases)
+    func `parallel conversion should match serial conversion`(_ format: ElementFormat) {
+        let data = Data(Self.bytes)
+        let count = data.count / format.bytesPerElement
+        let serial = Dequantize.convert(data, from: format, elementCount: count)
+        let parallel = Dequantize.convert(
+            data, from: format, elementCount: count,
+            parallelism: Parallelism(maxConcurrency: 4, minimumChunkSize: 100))
+        #expect(parallel.map(\.bitPattern) == serial.map(\.bitPattern))
+    }
+}
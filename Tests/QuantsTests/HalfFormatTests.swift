@@ -0,0 +1,97 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+@Suite struct HalfFormatTests {
+    static let elementCount = 2048 * 256
+    static let names = quantizedValuesByName.map(\.name) + ["Q8_K"]
+
+    func format(named name: String) throws -> BlockFormat {
+        try #require(BlockFormat.allCases.first { "\($0)".uppercased() == name })
+    }
+
+    /// Every float class: random bit patterns cover NaNs, infinities and denormals
+    static let bitPatterns: [Float] = {
+        var generator = SystemRandomNumberGenerator()
+        return (0..<100_003).map { _ in Float(bitPattern: generator.next()) }
+    }()
+
+    func narrowed(_ values: [Float], as half: HalfFormat, simdLevel: SIMDLevel) -> [UInt16] {
+        [UInt16](unsafeUninitializedCapacity: values.count) { output, initializedCount in
+            values.withUnsafeBufferPointer { input in
+                Dequantize.narrow(
+                    input,
+                    into: UnsafeMutableBufferPointer(rebasing: output[..<values.count]),
+                    as: half,
+                    simdLevel: simdLevel
+                )
+            }
+            initializedCount = values.count
+        }
+    }
+
+    @Test(arguments: HalfFormat.allCases)
+    func `SIMD narrowing should match scalar output bit for bit`(_ half: HalfFormat) {
+        let reference = narrowed(Self.bitPatterns, as: half, simdLevel: .scalar)
+        for level in SIMDLevel.allCases where level != .scalar && level.isAvailable {
+            #expect(narrowed(Self.bitPatterns, as: half, simdLevel: level) == reference)
+        }
+    }
+
+    @Test func `narrowing should round to nearest even`() {
+        // 1 + 2^-11 lies halfway between two f16 values, 1 + 2^-8 between two bf16 values
+        let f16 = narrowed(
+            [1, 1 + 0x1p-11, 1 + 3 * 0x1p-11, 65520, -0.0], as: .f16, simdLevel: .best)
+        #expect(f16 == [0x3C00, 0x3C00, 0x3C02, 0x7C00, 0x8000])
+        let bf16 = narrowed([1, 1 + 0x1p-8, 1 + 3 * 0x1p-8, .infinity], as: .bf16, simdLevel: .best)
+        #expect(bf16 == [0x3F80, 0x3F80, 0x3F82, 0x7F80])
+    }
+
+    @Test(arguments: names)
+    func `dequantizing to half should match narrowing the f32 output`(_ name: String) throws {
+        let tensorData = try #require(testData(named: name, withExtension: "bin"))
+        let format = try format(named: name)
+        let values = Dequantize.dequantize(
+            tensorData, format: format, elementCount: Self.elementCount)
+
+        for half in HalfFormat.allCases {
+            let expected = narrowed(values, as: half, simdLevel: .scalar)
+            let result = Dequantize.dequantize(
+                tensorData,
+                format: format,
+                elementCount: Self.elementCount,
+                as: half,
+                parallelism: Parallelism(maxConcurrency: 3, minimumChunkSize: 1)
+            )
+            #expect(result == expected, "\(name) to \(half)")
+        }
+    }
+
+    @Test func `converting between half formats should round trip through f32`() {
+        let values = (0..<1000).map { Float($0) * 0.37 - 150 }
+        let f16 = narrowed(values, as: .f16, simdLevel: .scalar)
+        let widened = [Float](unsafeUninitializedCapacity: f16.count) { output, initializedCount in
+            f16.withUnsafeBytes { input in
+                Dequantize.widen(
+                    input,
+                    from: .f16,
+                    into: UnsafeMutableBufferPointer(rebasing: output[..<f16.count])
+                )
+            }
+            initializedCount = f16.count
+        }
+        let bf16 = [UInt16](unsafeUninitializedCapacity: f16.count) { output, initializedCount in
+            f16.withUnsafeBytes { input in
+                Dequantize.convert(
+                    input,
+                    from: .f16,
+                    into: UnsafeMutableBufferPointer(rebasing: output[..<f16.count]),
+                    as: .bf16
+                )
+            }
+            initializedCount = f16.count
+        }
+        #expect(bf16 == narrowed(widened, as: .bf16, simdLevel: .scalar))
+    }
+}
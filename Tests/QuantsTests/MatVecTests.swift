@@ -0,0 +1,121 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+@Suite struct MatVecTests {
+    static let elementCount = 2048 * 256
+    static let columns = 4096
+    static let rows = elementCount / columns
+    static let vector = (0..<columns).map { Float(sin(Double($0) * 0.37) * 1.5 + 0.1) }
+
+    /// Largest error of `result` relative to the dequantize-then-dot reference, scaled by the
+    /// magnitude of each row's products
+    func maxRelativeError(_ result: [Float], weights: [Float]) -> Double {
+        var maxError = 0.0
+        for row in 0..<Self.rows {
+            var expected = 0.0
+            var magnitude = 0.0
+            for column in 0..<Self.columns {
+                let weight = Double(weights[row * Self.columns + column])
+                let product = weight * Double(Self.vector[column])
+                expected += product
+                magnitude += abs(product)
+            }
+            maxError = max(maxError, abs(Double(result[row]) - expected) / magnitude)
+        }
+        return maxError
+    }
+
+    @Test(arguments: quantizedValuesByName.map(\.name))
+    func `fused matvec should match dequantize then dot`(_ name: String) throws {
+        let tensorData = try #require(testData(named: name, withExtension: "bin"))
+        let format = try #require(BlockFormat.allCases.first { "\($0)".uppercased() == name })
+        let weights = Dequantize.dequantize(
+            tensorData,
+            format: format,
+            elementCount: Self.elementCount
+        )
+
+        for level in SIMDLevel.allCases where level.isAvailable {
+            let f32 = MatVec.multiply(
+                tensorData,
+                format: format,
+                rows: Self.rows,
+                by: Self.vector,
+                simdLevel: level
+            )
+            #expect(maxRelativeError(f32, weights: weights) < 1e-5, "\(name) f32 at \(level)")
+
+            // Quantizing the activations to 8 bits costs some accuracy
+            let q8 = MatVec.multiply(
+                tensorData,
+                format: format,
+                rows: Self.rows,
+                by: Self.vector,
+                activations: .q8,
+                simdLevel: level
+            )
+            #expect(maxRelativeError(q8, weights: weights) < 1e-2, "\(name) q8 at \(level)")
+        }
+    }
+
+    @Test(arguments: quantizedValuesByName.map(\.name))
+    func `parallel matvec should match the serial path`(_ name: String) throws {
+        let tensorData = try #require(testData(named: name, withExtension: "bin"))
+        let format = try #require(BlockFormat.allCases.first { "\($0)".uppercased() == name })
+
+        for activations in [ActivationPrecision.f32, .q8] {
+            let serial = MatVec.multiply(
+                tensorData,
+                format: format,
+                rows: Self.rows,
+                by: Self.vector,
+                activations: activations
+            )
+            let parallel = MatVec.multiply(
+                tensorData,
+                format: format,
+                rows: Self.rows,
+                by: Self.vector,
+                activations: activations,
+                parallelism: Parallelism(maxConcurrency: 3, minimumChunkSize: 1)
+            )
+            #expect(parallel.map(\.bitPattern) == serial.map(\.bitPattern))
+        }
+    }
+
+    @Test func `row dot products should match the matvec output`() throws {
+        let tensorData = try #require(testData(named: "Q4_K", withExtension: "bin"))
+        let expected = MatVec.multiply(tensorData, format: .q4_K, rows: Self.rows, by: Self.vector)
+        let expectedQ8 = MatVec.multiply(
+            tensorData,
+            format: .q4_K,
+            rows: Self.rows,
+            by: Self.vector,
+            activations: .q8
+        )
+        let activations = QuantizedActivations(Self.vector, for: .q4_K)
+        let format = BlockFormat.q4_K
+        let rowSizeInBytes = Self.columns / format.blockSize * format.bytesPerBlock
+
+        tensorData.withUnsafeBytes { matrix in
+            Self.vector.withUnsafeBufferPointer { vector in
+                for row in [0, 1, Self.rows - 1] {
+                    let rowBytes = UnsafeRawBufferPointer(
+                        rebasing: matrix[(row * rowSizeInBytes)..<((row + 1) * rowSizeInBytes)])
+                    #expect(MatVec.dot(rowBytes, format: .q4_K, vector) == expected[row])
+                    #expect(MatVec.dot(rowBytes, format: .q4_K, activations) == expectedQ8[row])
+                }
+            }
+        }
+    }
+
+    @Test(arguments: [ActivationPrecision.f32, .q8])
+    func `zero columns should produce zero rows`(_ activations: ActivationPrecision) {
+        let result = MatVec.multiply(
+            Data(), format: .q4_K, rows: 3, by: [], activations: activations,
+            parallelism: Parallelism(maxConcurrency: 2, minimumChunkSize: 1))
+        #expect(result == [0, 0, 0])
+    }
+}
@@ -0,0 +1,73 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+@Suite struct NonFiniteTests {
+    /// Formats with the offset of one f16 scale field per block, or an f32 one for Q8_K
+    static let scaleFields: [(name: String, offset: Int)] = [
+        ("Q4_0", 0), ("Q4_1", 2), ("Q8_0", 0), ("Q2_K", 82), ("Q3_K", 108), ("Q4_K", 2),
+        ("Q6_K", 208), ("Q8_K", 0), ("IQ2_XXS", 0), ("TQ2_0", 64),
+    ]
+
+    @Test(arguments: scaleFields.map(\.name))
+    func `planted non-finite scales should be counted at every level`(_ name: String) throws {
+        let offset = try #require(Self.scaleFields.first { $0.name == name }).offset
+        let format = try #require(BlockFormat.allCases.first { "\($0)".uppercased() == name })
+        var data = Data([UInt8](try #require(testData(named: name, withExtension: "bin"))))
+        let blockCount = data.count / format.bytesPerBlock
+        #expect(NonFinite.countScales(in: data, format: format, simdLevel: .scalar) == 0)
+
+        // Blocks at both ends exercise the gathered body and the scalar tail
+        let planted = [0, 1, 7, 8, 9, 1000, blockCount - 2, blockCount - 1]
+        for (position, block) in planted.enumerated() {
+            let start = block * format.bytesPerBlock + offset
+            let pattern: [UInt8] =
+                format == .q8_K
+                ? (position.isMultiple(of: 2) ? [0, 0, 0x80, 0x7F] : [1, 0, 0xC0, 0xFF])
+                : (position.isMultiple(of: 2) ? [0x00, 0x7C] : [0x01, 0xFE])
+            data.replaceSubrange(start..<(start + pattern.count), with: pattern)
+        }
+        let parallelisms = [Parallelism.serial, Parallelism(maxConcurrency: 3, minimumChunkSize: 1)]
+        for level in SIMDLevel.allCases where level.isAvailable {
+            for parallelism in parallelisms {
+                let count = NonFinite.countScales(
+                    in: data, format: format, parallelism: parallelism, simdLevel: level)
+                #expect(count == planted.count, "\(name) at \(level)")
+            }
+        }
+    }
+
+    @Test(arguments: NonFinite.Encoding.allCases)
+    func `planted non-finite values should be counted at every level`(
+        _ encoding: NonFinite.Encoding
+    ) {
+        let count = 10_007
+        // Values start one byte in, so no kernel may assume aligned loads
+        var bytes = [UInt8](repeating: 0x3C, count: 1 + count * encoding.byteWidth)
+        let positions = [0, 15, 16, 31, 500, count - 17, count - 1]
+        for position in positions {
+            let start = 1 + position * encoding.byteWidth
+            let pattern: [UInt8] =
+                switch encoding {
+                case .f16: [0x00, 0x7C]
+                case .bf16: [0x80, 0xFF]
+                case .f32: [0x00, 0x00, 0xC0, 0x7F]
+                }
+            bytes.replaceSubrange(start..<(start + pattern.count), with: pattern)
+        }
+        for level in SIMDLevel.allCases where level.isAvailable {
+            for maxConcurrency in [1, 4] {
+                let found = bytes.withUnsafeBytes { raw in
+                    NonFinite.count(
+                        in: UnsafeRawBufferPointer(rebasing: raw[1...]),
+                        encoding: encoding,
+                        parallelism: Parallelism(
+                            maxConcurrency: maxConcurrency, minimumChunkSize: 100),
+                        simdLevel: level)
+                }
+                #expect(found == positions.count, "\(encoding) at \(level)")
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+@Suite struct ParallelDequantizeTests {
+    @Test(arguments: quantizedValuesByName.map(\.name) + ["Q8_K"])
+    func `parallel dequantization should match the serial path`(_ name: String) throws {
+        let tensorData = try #require(testData(named: name, withExtension: "bin"))
+        let format = try #require(BlockFormat.allCases.first { "\($0)".uppercased() == name })
+        let elementCount = 2048 * 256
+        let serial = Dequantize.dequantize(tensorData, format: format, elementCount: elementCount)
+
+        // Uneven chunk counts exercise ranges that do not divide the block count evenly
+        for maxConcurrency in [2, 3, 7, 64] {
+            let parallelism = Parallelism(maxConcurrency: maxConcurrency, minimumChunkSize: 1)
+            let parallel = Dequantize.dequantize(
+                tensorData,
+                format: format,
+                elementCount: elementCount,
+                parallelism: parallelism
+            )
+            #expect(parallel.map(\.bitPattern) == serial.map(\.bitPattern))
+        }
+    }
+
+    @Test func `serial parallelism should use a single worker`() {
+        #expect(Parallelism.serial.maxConcurrency == 1)
+        #expect(Parallelism(maxConcurrency: 0).maxConcurrency == 1)
+        #expect(Parallelism(minimumChunkSize: 0).minimumChunkSize == 1)
+    }
+}
+
+@Suite struct DequantizeIntoBufferTests {
+    @Test(arguments: quantizedValuesByName)
+    func `dequantizing into a buffer should match the array API`(
+        _ pair: (name: String, values: [Float])
+    ) throws {
+        let tensorData = try #require(testData(named: pair.name, withExtension: "bin"))
+        let format = try #require(BlockFormat.allCases.first { "\($0)".uppercased() == pair.name })
+        let elementCount = 2048 * 256
+        let expected = Dequantize.dequantize(tensorData, format: format, elementCount: elementCount)
+
+        var output = [Float](repeating: .nan, count: elementCount)
+        tensorData.withUnsafeBytes { input in
+            output.withUnsafeMutableBufferPointer { buffer in
+                Dequantize.dequantize(input, into: buffer, format: format)
+            }
+        }
+        #expect(output.map(\.bitPattern) == expected.map(\.bitPattern))
+        #expect(allClose(Array(output[..<32]), pair.values))
+    }
+}
@@ -0,0 +1,101 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+@Suite struct QuantizeTests {
+    static let elementCount = 2048 * 256
+    static let names = quantizedValuesByName.map(\.name) + ["Q8_K"]
+
+    /// Largest relative RMSE allowed when re-quantizing a dequantized fixture
+    static let maxRelativeRMSE: [BlockFormat: Double] = [
+        .q4_0: 0.06, .q4_1: 0.03, .q5_0: 0.03, .q5_1: 0.02, .q8_0: 0.005,
+        .q2_K: 0.08, .q3_K: 0.04, .q4_K: 0.01, .q5_K: 0.012, .q6_K: 0.004,
+        .q8_K: 0.006, .iq4_NL: 0.035,
+    ]
+
+    func format(named name: String) throws -> BlockFormat {
+        try #require(BlockFormat.allCases.first { "\($0)".uppercased() == name })
+    }
+
+    /// Dequantized fixture values. The fixtures hold random bytes, so some fp16 scales decode
+    /// to inf/NaN or to magnitudes fp16 cannot re-encode; those 256-element spans are zeroed.
+    func finiteValues(named name: String, format: BlockFormat) throws -> [Float] {
+        let tensorData = try #require(testData(named: name, withExtension: "bin"))
+        var values = Dequantize.dequantize(
+            tensorData,
+            format: format,
+            elementCount: Self.elementCount
+        )
+        for start in stride(from: 0, to: values.count, by: 256) {
+            let span = start..<(start + 256)
+            if values[span].contains(where: { !$0.isFinite || abs($0) > 1e4 }) {
+                values.replaceSubrange(span, with: repeatElement(0, count: 256))
+            }
+        }
+        return values
+    }
+
+    @Test(arguments: names)
+    func `SIMD quantization should match scalar output bit for bit`(_ name: String) throws {
+        let format = try format(named: name)
+        let values = try finiteValues(named: name, format: format)
+        let reference = Quantize.quantize(values, format: format, simdLevel: .scalar)
+
+        for level in SIMDLevel.allCases where level != .scalar && level.isAvailable {
+            let result = Quantize.quantize(values, format: format, simdLevel: level)
+            #expect(
+                result == reference,
+                "\(name) kernels for \(level) differ from the scalar reference"
+            )
+        }
+    }
+
+    @Test(arguments: names)
+    func `round trip error should stay within the format bound`(_ name: String) throws {
+        let format = try format(named: name)
+        let values = try finiteValues(named: name, format: format)
+        let quantized = Quantize.quantize(values, format: format)
+        let roundTrip = Dequantize.dequantize(
+            quantized,
+            format: format,
+            elementCount: Self.elementCount
+        )
+
+        var squaredError = 0.0
+        var squaredValue = 0.0
+        for (value, decoded) in zip(values, roundTrip) {
+            squaredError += Double(decoded - value) * Double(decoded - value)
+            squaredValue += Double(value) * Double(value)
+        }
+        let relativeRMSE = (squaredError / squaredValue).squareRoot()
+        let bound = try #require(Self.maxRelativeRMSE[format])
+        #expect(relativeRMSE < bound, "\(name) relative RMSE \(relativeRMSE)")
+    }
+
+    @Test(arguments: ["Q4_0", "Q5_0", "Q8_0"])
+    func `requantizing a symmetric fixture should reproduce it`(_ name: String) throws {
+        // Every value of these blocks sits exactly on the grid their own scale generates
+        let tensorData = try #require(testData(named: name, withExtension: "bin"))
+        let format = try format(named: name)
+        let values = Dequantize.dequantize(
+            tensorData,
+            format: format,
+            elementCount: Self.elementCount
+        )
+        #expect(Quantize.quantize(values, format: format) == tensorData)
+    }
+
+    @Test(arguments: names)
+    func `parallel quantization should match the serial path`(_ name: String) throws {
+        let format = try format(named: name)
+        let values = try finiteValues(named: name, format: format)
+        let serial = Quantize.quantize(values, format: format)
+        let parallel = Quantize.quantize(
+            values,
+            format: format,
+            parallelism: Parallelism(maxConcurrency: 3, minimumChunkSize: 1)
+        )
+        #expect(parallel == serial)
+    }
+}
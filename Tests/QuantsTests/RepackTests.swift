@@ -0,0 +1,104 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+@Suite struct RepackTests {
+    static let columns = 4096
+    /// Not a multiple of 4 or 8, so every matrix has trailing rows outside the groups
+    static let rows = 126
+    static let vector = (0..<columns).map { Float(sin(Double($0) * 0.37) * 1.5 + 0.1) }
+    static let formats: [(name: String, format: BlockFormat)] = [
+        ("Q4_0", .q4_0), ("Q8_0", .q8_0), ("Q4_K", .q4_K),
+    ]
+
+    func matrixData(named name: String, format: BlockFormat) throws -> Data {
+        let tensorData = try #require(testData(named: name, withExtension: "bin"))
+        let rowSizeInBytes = Self.columns / format.blockSize * format.bytesPerBlock
+        return tensorData.prefix(Self.rows * rowSizeInBytes)
+    }
+
+    @Test(arguments: formats.map(\.name))
+    func `repacked matvec should match the row-by-row q8 matvec`(_ name: String) throws {
+        let format = try #require(Self.formats.first { $0.name == name }).format
+        let data = try matrixData(named: name, format: format)
+        let expected = MatVec.multiply(
+            data,
+            format: format,
+            rows: Self.rows,
+            by: Self.vector,
+            activations: .q8,
+            simdLevel: .scalar
+        )
+
+        for interleave in [4, 8] {
+            let matrix = RepackedMatrix(
+                data, format: format, rows: Self.rows, columns: Self.columns,
+                interleave: interleave)
+            let scalar = matrix.multiply(by: Self.vector, simdLevel: .scalar)
+            #expect(scalar.map(\.bitPattern) == expected.map(\.bitPattern), "\(name)x\(interleave)")
+
+            for level in SIMDLevel.allCases where level.isAvailable {
+                let result = matrix.multiply(by: Self.vector, simdLevel: level)
+                for row in 0..<Self.rows {
+                    let error = abs(result[row] - expected[row])
+                    #expect(
+                        error <= 1e-4 * max(1, abs(expected[row])),
+                        "\(name)x\(interleave) row \(row) at \(level)")
+                }
+            }
+        }
+    }
+
+    @Test(arguments: formats.map(\.name))
+    func `repacked matrix should dequantize to the original values`(_ name: String) throws {
+        let format = try #require(Self.formats.first { $0.name == name }).format
+        let data = try matrixData(named: name, format: format)
+        let expected = Dequantize.dequantize(
+            data, format: format, elementCount: Self.rows * Self.columns, simdLevel: .scalar)
+
+        for interleave in [4, 8] {
+            let matrix = RepackedMatrix(
+                data, format: format, rows: Self.rows, columns: Self.columns,
+                interleave: interleave)
+            let values = matrix.dequantized(simdLevel: .scalar)
+            #expect(values.map(\.bitPattern) == expected.map(\.bitPattern), "\(name)x\(interleave)")
+        }
+    }
+
+    @Test func `parallel repacked matvec should match the serial path`() throws {
+        let data = try matrixData(named: "Q4_K", format: .q4_K)
+        let matrix = RepackedMatrix(data, format: .q4_K, rows: Self.rows, columns: Self.columns)
+
+        let serial = matrix.multiply(by: Self.vector)
+        let parallel = matrix.multiply(
+            by: Self.vector,
+            parallelism: Parallelism(maxConcurrency: 3, minimumChunkSize: 1)
+        )
+        #expect(parallel.map(\.bitPattern) == serial.map(\.bitPattern))
+    }
+
+    @Test func `serialized matrix should round trip through a file`() throws {
+        let data = try matrixData(named: "Q8_0", format: .q8_0)
+        let matrix = RepackedMatrix(
+            data, format: .q8_0, rows: Self.rows, columns: Self.columns, interleave: 8)
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString + ".repack")
+        defer { try? FileManager.default.removeItem(at: url) }
+        try matrix.write(to: url, tag: 42)
+
+        let loaded = try #require(RepackedMatrix(contentsOf: url, tag: 42))
+        #expect(loaded.format == .q8_0)
+        #expect(loaded.interleave == 8)
+        #expect(loaded.rows == Self.rows)
+        #expect(loaded.columns == Self.columns)
+        #expect(loaded.multiply(by: Self.vector) == matrix.multiply(by: Self.vector))
+
+        // A different tag, a truncated file or a missing file is a cache miss
+        #expect(RepackedMatrix(contentsOf: url, tag: 43) == nil)
+        let serialized = matrix.serializedData(tag: 42)
+        #expect(RepackedMatrix(serializedData: serialized.dropLast(), tag: 42) == nil)
+        #expect(RepackedMatrix(serializedData: serialized.prefix(16), tag: 42) == nil)
+        #expect(RepackedMatrix(contentsOf: url.appendingPathExtension("missing")) == nil)
+    }
+}
@@ -0,0 +1,85 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+func simdDequantizeFn(byName name: String) -> (Data, Int, SIMDLevel) -> [Float] {
+    switch name {
+    case "Q2_K":
+        return Dequantize.Q2_K
+    case "Q3_K":
+        return Dequantize.Q3_K
+    case "Q4_0":
+        return Dequantize.Q4_0
+    case "Q4_1":
+        return Dequantize.Q4_1
+    case "Q4_K":
+        return Dequantize.Q4_K
+    case "Q5_0":
+        return Dequantize.Q5_0
+    case "Q5_1":
+        return Dequantize.Q5_1
+    case "Q5_K":
+        return Dequantize.Q5_K
+    case "Q6_K":
+        return Dequantize.Q6_K
+    case "Q8_0":
+        return Dequantize.Q8_0
+    case "Q8_K":
+        return Dequantize.Q8_K
+    case "IQ4_NL":
+        return Dequantize.IQ4_NL
+    case "Q8_1":
+        return Dequantize.Q8_1
+    case "IQ2_XXS":
+        return Dequantize.IQ2_XXS
+    case "IQ2_XS":
+        return Dequantize.IQ2_XS
+    case "IQ2_S":
+        return Dequantize.IQ2_S
+    case "IQ3_XXS":
+        return Dequantize.IQ3_XXS
+    case "IQ3_S":
+        return Dequantize.IQ3_S
+    case "IQ1_S":
+        return Dequantize.IQ1_S
+    case "IQ1_M":
+        return Dequantize.IQ1_M
+    case "IQ4_XS":
+        return Dequantize.IQ4_XS
+    case "TQ1_0":
+        return Dequantize.TQ1_0
+    case "TQ2_0":
+        return Dequantize.TQ2_0
+    case "MXFP4":
+        return Dequantize.MXFP4
+    default:
+        fatalError("Unsupported quantized type: \(name)")
+    }
+}
+
+@Suite struct SIMDDequantizeTests {
+    @Test func `scalar level should always be available`() {
+        #expect(SIMDLevel.scalar.isAvailable)
+        #expect(SIMDLevel.best.isAvailable)
+    }
+
+    @Test(
+        arguments: quantizedValuesByName.map(\.name) + ["Q8_K"]
+            + dequantizedValuesByName.map(\.name)
+    )
+    func `SIMD kernels should match scalar output bit for bit`(_ name: String) throws {
+        let tensorData = try #require(testData(named: name, withExtension: "bin"))
+        let dequantize = simdDequantizeFn(byName: name)
+        let elementCount = 2048 * 256
+        let reference = dequantize(tensorData, elementCount, .scalar)
+
+        for level in SIMDLevel.allCases where level != .scalar && level.isAvailable {
+            let result = dequantize(tensorData, elementCount, level)
+            #expect(
+                result.map(\.bitPattern) == reference.map(\.bitPattern),
+                "\(name) kernels for \(level) differ from the scalar reference"
+            )
+        }
+    }
+}
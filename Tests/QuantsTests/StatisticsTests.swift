@@ -0,0 +1,123 @@
+import Foundation
+import Quants
+import TestData
+import Testing
+
+@Suite struct StatisticsTests {
+    static let formats: [BlockFormat] = [.q4_0, .q8_0, .q2_K, .q4_K, .q6_K, .iq4_XS, .tq2_0]
+
+    /// Double-precision reference over already decoded values
+    func reference(_ values: [Float]) -> (mean: Double, variance: Double, l2: Double) {
+        let mean = values.reduce(0.0) { $0 + Double($1) } / Double(values.count)
+        let variance =
+            values.reduce(0.0) { $0 + (Double($1) - mean) * (Double($1) - mean) }
+            / Double(values.count)
+        let l2 = values.reduce(0.0) { $0 + Double($1) * Double($1) }.squareRoot()
+        return (mean, variance, l2)
+    }
+
+    @Test(arguments: formats)
+    func `block statistics should match the dequantized values`(_ format: BlockFormat) throws {
+        let name = "\(format)".uppercased()
+        let data = try #require(testData(named: name, withExtension: "bin"))
+        let elementCount = data.count / format.bytesPerBlock * format.blockSize
+        let values = Dequantize.dequantize(data, format: format, elementCount: elementCount)
+        let expected = reference(values)
+
+        let statistics = Statistics(data, layout: .blocks(format), elementCount: elementCount)
+        #expect(statistics.count == elementCount)
+        #expect(statistics.min == values.min())
+        #expect(statistics.max == values.max())
+        #expect(abs(statistics.mean - expected.mean) <= 1e-6 * max(1, abs(expected.mean)))
+        #expect(abs(statistics.variance - expected.variance) <= 1e-5 * expected.variance)
+        #expect(abs(statistics.l2Norm - expected.l2) <= 1e-5 * expected.l2)
+    }
+
+    @Test(arguments: formats)
+    func `every SIMD level should return the same bits`(_ format: BlockFormat) throws {
+        let name = "\(format)".uppercased()
+        let data = try #require(testData(named: name, withExtension: "bin"))
+        let elementCount = data.count / format.bytesPerBlock * format.blockSize
+        let parallelism = Parallelism(maxConcurrency: 4, minimumChunkSize: 4096)
+        let scalar = Statistics(
+            data, layout: .blocks(format), elementCount: elementCount, parallelism: parallelism,
+            simdLevel: .scalar)
+        var histogram = Histogram(lowerBound: scalar.min, upperBound: scalar.max, binCount: 64)
+        histogram.add(
+            data, layout: .blocks(format), elementCount: elementCount, simdLevel: .scalar)
+        #expect(histogram.counts.reduce(0, +) == elementCount)
+
+        for level in SIMDLevel.allCases where level.isAvailable {
+            let statistics = Statistics(
+                data, layout: .blocks(format), elementCount: elementCount,
+                parallelism: parallelism, simdLevel: level)
+            #expect(statistics == scalar, "\(format) at \(level)")
+            var other = Histogram(lowerBound: scalar.min, upperBound: scalar.max, binCount: 64)
+            other.add(
+                data, layout: .blocks(format), elementCount: elementCount,
+                parallelism: parallelism, simdLevel: level)
+            #expect(other == histogram, "\(format) at \(level)")
+        }
+    }
+
+    @Test func `parallel and merged statistics should agree with the serial pass`() throws {
+        let data = try #require(testData(named: "Q4_K", withExtension: "bin"))
+        let elementCount = data.count / BlockFormat.q4_K.bytesPerBlock * 256
+        let serial = Statistics(data, layout: .blocks(.q4_K), elementCount: elementCount)
+        let parallel = Statistics(
+            data, layout: .blocks(.q4_K), elementCount: elementCount,
+            parallelism: Parallelism(maxConcurrency: 8, minimumChunkSize: 256))
+        let half = data.count / 2
+        var merged = Statistics(
+            data.prefix(half), layout: .blocks(.q4_K), elementCount: elementCount / 2)
+        merged.merge(
+            Statistics(data.suffix(half), layout: .blocks(.q4_K), elementCount: elementCount / 2))
+
+        for statistics in [parallel, merged] {
+            #expect(statistics.count == serial.count)
+            #expect(statistics.min == serial.min)
+            #expect(statistics.max == serial.max)
+            #expect(abs(statistics.mean - serial.mean) <= 1e-9 * max(1, abs(serial.mean)))
+            #expect(abs(statistics.variance - serial.variance) <= 1e-9 * serial.variance)
+            #expect(abs(statistics.l2Norm - serial.l2Norm) <= 1e-9 * serial.l2Norm)
+        }
+    }
+
+    @Test func `histograms should bin float values and skip NaNs`() {
+        // Unaligned tail lengths exercise the scalar remainder of the SIMD kernels
+        let values: [Float] = [-5, 0, 0.24, 0.25, 0.5, 0.99, 1, 7, .nan, -.infinity, .infinity]
+        for level in SIMDLevel.allCases where level.isAvailable {
+            var histogram = Histogram(lowerBound: 0, upperBound: 1, binCount: 4)
+            values.withUnsafeBytes {
+                histogram.add($0, layout: .f32, elementCount: values.count, simdLevel: level)
+            }
+            #expect(histogram.counts == [4, 1, 1, 4], "\(level)")
+
+            let statistics = values.withUnsafeBytes {
+                Statistics($0, layout: .f32, elementCount: values.count, simdLevel: level)
+            }
+            #expect(statistics.min == -.infinity)
+            #expect(statistics.max == .infinity)
+            #expect(statistics.count == values.count)
+        }
+    }
+
+    @Test func `half statistics should match the widened values`() {
+        let values = (0..<1000).map { Float16(Float($0 % 37) * 0.25 - 4) }
+        let statistics = values.withUnsafeBytes {
+            Statistics($0, layout: .half(.f16), elementCount: values.count)
+        }
+        let expected = reference(values.map(Float.init))
+        #expect(statistics.min == -4)
+        #expect(statistics.max == 5)
+        #expect(abs(statistics.mean - expected.mean) <= 1e-9)
+        #expect(abs(statistics.variance - expected.variance) <= 1e-6 * expected.variance)
+    }
+
+    @Test func `empty input should give empty statistics`() {
+        let statistics = Statistics(Data(), layout: .f32, elementCount: 0)
+        #expect(statistics == Statistics())
+        #expect(statistics.count == 0)
+        #expect(statistics.variance == 0)
+    }
+}